@@ -0,0 +1,207 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "ColumnarH5Writer.h"
+#include <array>
+#include <cstdio>
+#include <stdexcept>
+#include "Host/OutputManager.h"
+
+namespace qmcplusplus
+{
+void ColumnarBuffer::appendParticleValues(const std::string& name, const Vector<Real>& values)
+{
+  auto& column = particle_columns_[name];
+  column.resize(num_rows_ * num_particles_, 0.0);
+  // values of the wrong length are logged as zeros by endRow
+  if (values.size() == num_particles_)
+    column.insert(column.end(), values.begin(), values.end());
+}
+
+void ColumnarBuffer::endRow()
+{
+  ++num_rows_;
+  for (auto& [name, column] : particle_columns_)
+    column.resize(num_rows_ * num_particles_, 0.0);
+}
+
+void ColumnarBuffer::setNumParticles(int num_particles)
+{
+  if (num_rows_ > 0 && num_particles != num_particles_)
+    throw std::runtime_error("ColumnarBuffer requires the same number of particles for all rows");
+  num_particles_ = num_particles;
+}
+
+void ColumnarBuffer::clear()
+{
+  for (auto& [name, column] : integer_columns_)
+    column.clear();
+  for (auto& [name, column] : real_columns_)
+    column.clear();
+  for (auto& [name, column] : particle_columns_)
+    column.clear();
+  num_rows_ = 0;
+}
+
+void ColumnarBuffer::append(const ColumnarBuffer& other)
+{
+  if (other.num_rows_ == 0)
+    return;
+  setNumParticles(other.num_particles_);
+  auto appendColumn = [](auto& column, const auto& other_column) {
+    column.insert(column.end(), other_column.begin(), other_column.end());
+  };
+  for (auto& [name, other_column] : other.integer_columns_)
+    appendColumn(integer_columns_[name], other_column);
+  for (auto& [name, other_column] : other.real_columns_)
+    appendColumn(real_columns_[name], other_column);
+  for (auto& [name, other_column] : other.particle_columns_)
+  {
+    auto& column = particle_columns_[name];
+    column.resize(num_rows_ * num_particles_, 0.0);
+    appendColumn(column, other_column);
+  }
+  num_rows_ += other.num_rows_;
+  for (auto& [name, column] : particle_columns_)
+    column.resize(num_rows_ * num_particles_, 0.0);
+}
+
+ColumnarH5Writer::ColumnarH5Writer(const std::string& group_name, hsize_t chunk_rows, bool async)
+    : group_name_(group_name), chunk_rows_(chunk_rows), max_buffer_rows_(MAX_BUFFER_CHUNKS * chunk_rows)
+{
+  if (async)
+  {
+    // the file is only ever touched by one thread at a time but HDF5 keeps global state
+    hbool_t is_threadsafe = false;
+    H5is_library_threadsafe(&is_threadsafe);
+    if (is_threadsafe)
+      async_write_ = true;
+    else
+      app_warning() << "Asynchronous writing of " << group_name_ << " requires a thread-safe HDF5 library. "
+                    << "It is written synchronously." << std::endl;
+  }
+}
+
+ColumnarH5Writer::~ColumnarH5Writer()
+{
+  if (pending_write_.valid())
+    pending_write_.wait();
+}
+
+void ColumnarH5Writer::open(const std::string& file_name)
+{
+  const std::lock_guard<std::mutex> lock(write_mutex_);
+  waitForPendingWriteLocked();
+  file_.close();
+  rows_written_ = 0;
+  operator_names_.clear();
+  file_name_ = file_name;
+  if (!file_.create(file_name_))
+    throw std::runtime_error("ColumnarH5Writer failed to create " + file_name_);
+}
+
+std::string ColumnarH5Writer::makeRankFileName(const std::string& file_root, int rank, const std::string& name)
+{
+  std::array<char, 16> rank_token;
+  std::snprintf(rank_token.data(), rank_token.size(), ".p%03d.", rank);
+  return file_root + rank_token.data() + name + ".h5";
+}
+
+void ColumnarH5Writer::write(ColumnarBuffer& buffer)
+{
+  if (buffer.num_rows() == 0)
+    return;
+  const std::lock_guard<std::mutex> lock(write_mutex_);
+  if (!isOpen())
+    throw std::runtime_error("ColumnarH5Writer::write " + group_name_ + " has no open file");
+  // only block if the previous rows are still being written
+  waitForPendingWriteLocked();
+  std::swap(write_buffer_, buffer);
+  buffer.clear();
+  // the caller keeps appending rows of the same length
+  buffer.setNumParticles(write_buffer_.get_num_particles());
+  if (async_write_)
+    pending_write_ = std::async(std::launch::async, [this]() {
+      // the error stack of a thread-safe HDF5 is per thread, missing datasets are expected on the first append
+      H5Eset_auto2(H5E_DEFAULT, nullptr, nullptr);
+      writeBuffer();
+    });
+  else
+    writeBuffer();
+}
+
+void ColumnarH5Writer::writeIfFull(ColumnarBuffer& buffer)
+{
+  if (buffer.num_rows() >= max_buffer_rows_)
+    write(buffer);
+}
+
+void ColumnarH5Writer::waitForPendingWrite()
+{
+  const std::lock_guard<std::mutex> lock(write_mutex_);
+  waitForPendingWriteLocked();
+}
+
+void ColumnarH5Writer::waitForPendingWriteLocked()
+{
+  // get() rethrows any exception raised by the background write
+  if (pending_write_.valid())
+    pending_write_.get();
+}
+
+void ColumnarH5Writer::writeBuffer()
+{
+  const hsize_t num_rows = write_buffer_.num_rows();
+  file_.push(group_name_);
+  const auto& particle_columns = write_buffer_.get_particle_columns();
+  if (rows_written_ == 0 && !particle_columns.empty())
+  {
+    // header, particle columns first seen after the first write are not written
+    for (auto& [name, column] : particle_columns)
+      operator_names_.push_back(name);
+    int num_particles = write_buffer_.get_num_particles();
+    file_.write(num_particles, "num_particles");
+    file_.write(operator_names_, "operator_names");
+  }
+  auto appendColumn = [this, num_rows](const std::string& name, const auto& column) {
+    hsize_t current = rows_written_;
+    h5d_append(file_.top(), name, current, 1, &num_rows, column.data(), chunk_rows_);
+  };
+  for (auto& [name, column] : write_buffer_.get_integer_columns())
+    appendColumn(name, column);
+  for (auto& [name, column] : write_buffer_.get_real_columns())
+    appendColumn(name, column);
+  if (!operator_names_.empty())
+  {
+    file_.push("per_particle");
+    const int num_particles = write_buffer_.get_num_particles();
+    const hsize_t dims[2]{num_rows, static_cast<hsize_t>(num_particles)};
+    for (const auto& name : operator_names_)
+    {
+      auto column     = particle_columns.find(name);
+      hsize_t current = rows_written_;
+      if (column != particle_columns.end())
+        h5d_append(file_.top(), name, current, 2, dims, column->second.data(), chunk_rows_);
+      else
+      {
+        // the operator reported for none of these rows
+        const std::vector<ColumnarBuffer::Real> missing(num_rows * num_particles, 0.0);
+        h5d_append(file_.top(), name, current, 2, dims, missing.data(), chunk_rows_);
+      }
+    }
+    file_.pop();
+  }
+  file_.pop();
+  file_.flush();
+  rows_written_ += num_rows;
+}
+
+} // namespace qmcplusplus
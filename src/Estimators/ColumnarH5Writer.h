@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_COLUMNAR_H5_WRITER_H
+#define QMCPLUSPLUS_COLUMNAR_H5_WRITER_H
+
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Configuration.h"
+#include "OhmmsPETE/OhmmsVector.h"
+#include "hdf/hdf_archive.h"
+
+namespace qmcplusplus
+{
+
+/** Column oriented rows of per walker logs.
+ *
+ *  A row is built by appending one value to each integer and real column and the per particle
+ *  values of any number of particle columns, then calling endRow. Particle columns that did not
+ *  get values for a row hold zeros there. Columns are kept in name order.
+ */
+class ColumnarBuffer
+{
+public:
+  using Real         = QMCTraits::RealType;
+  using FullPrecReal = QMCTraits::FullPrecRealType;
+
+  void appendInteger(const std::string& name, long value) { integer_columns_[name].push_back(value); }
+  void appendReal(const std::string& name, FullPrecReal value) { real_columns_[name].push_back(value); }
+  /// values of all the particles for the current row
+  void appendParticleValues(const std::string& name, const Vector<Real>& values);
+  /// particle values of the current row, columns missing from it are padded with zeros
+  void endRow();
+
+  /// set the row length of the particle columns, it cannot change while there are rows
+  void setNumParticles(int num_particles);
+  int get_num_particles() const { return num_particles_; }
+  size_t num_rows() const { return num_rows_; }
+
+  /// remove all the rows, column names are kept
+  void clear();
+  /// append the rows of other, particle columns missing from either buffer hold zeros
+  void append(const ColumnarBuffer& other);
+
+  const std::map<std::string, std::vector<long>>& get_integer_columns() const { return integer_columns_; }
+  const std::map<std::string, std::vector<FullPrecReal>>& get_real_columns() const { return real_columns_; }
+  /// num_rows x num_particles
+  const std::map<std::string, std::vector<Real>>& get_particle_columns() const { return particle_columns_; }
+
+private:
+  std::map<std::string, std::vector<long>> integer_columns_;
+  std::map<std::string, std::vector<FullPrecReal>> real_columns_;
+  std::map<std::string, std::vector<Real>> particle_columns_;
+  int num_particles_ = 0;
+  size_t num_rows_   = 0;
+};
+
+/** Appends ColumnarBuffer rows to chunked, extendable datasets of a group of a per rank file.
+ *
+ *  Integer and real columns are 1D datasets of the group, particle columns are num_rows x num_particles
+ *  datasets of its per_particle subgroup. The particle columns are fixed by the first write, which also
+ *  writes num_particles and their names as operator_names; particle columns first seen later are dropped.
+ *
+ *  If the HDF5 library is thread safe and async is requested the append runs on a background thread and
+ *  only the next write waits for it. write may be called concurrently, e.g. by crowds flushing full buffers.
+ */
+class ColumnarH5Writer
+{
+public:
+  /// chunks a buffer may hold before writeIfFull writes it
+  static constexpr size_t MAX_BUFFER_CHUNKS = 16;
+
+  /** constructor
+   * @param group_name group of the datasets
+   * @param chunk_rows rows per HDF5 chunk
+   * @param async write on a background thread if the HDF5 library allows it
+   */
+  ColumnarH5Writer(const std::string& group_name, hsize_t chunk_rows, bool async);
+  ~ColumnarH5Writer();
+
+  /// create file_name, an open file is closed first
+  void open(const std::string& file_name);
+
+  /// <file_root>.p<rank>.<name>.h5, the per rank naming of the traces of the legacy drivers
+  static std::string makeRankFileName(const std::string& file_root, int rank, const std::string& name);
+
+  /// write a value to the group of the file
+  template<typename T>
+  void writeHeader(T& value, const std::string& name)
+  {
+    const std::lock_guard<std::mutex> lock(write_mutex_);
+    waitForPendingWriteLocked();
+    file_.push(group_name_);
+    file_.write(value, name);
+    file_.pop();
+  }
+
+  /// move the rows of buffer to the file, buffer is cleared
+  void write(ColumnarBuffer& buffer);
+  /// write buffer if it holds MAX_BUFFER_CHUNKS chunks or more, bounds the memory of crowd buffers
+  void writeIfFull(ColumnarBuffer& buffer);
+
+  /// block until the rows written so far are in the file
+  void waitForPendingWrite();
+
+  const std::string& get_file_name() const { return file_name_; }
+  bool isAsync() const { return async_write_; }
+  bool isOpen() const { return !file_name_.empty(); }
+  size_t get_max_buffer_rows() const { return max_buffer_rows_; }
+
+private:
+  void waitForPendingWriteLocked();
+  /// append write_buffer_ to the file
+  void writeBuffer();
+
+  const std::string group_name_;
+  const hsize_t chunk_rows_;
+  const size_t max_buffer_rows_;
+  bool async_write_ = false;
+  std::string file_name_;
+  hdf_archive file_;
+  /// rows in the file
+  hsize_t rows_written_ = 0;
+  /// particle columns in the file, fixed by the first write
+  std::vector<std::string> operator_names_;
+  /// rows being written, owned by the writing thread while pending_write_ is valid
+  ColumnarBuffer write_buffer_;
+  std::future<void> pending_write_;
+  std::mutex write_mutex_;
+};
+
+} // namespace qmcplusplus
+
+#endif
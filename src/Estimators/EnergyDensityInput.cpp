@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: EnergyDensityEstimator.cpp
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "EnergyDensityInput.h"
+#include "EstimatorInput.h"
+
+namespace qmcplusplus
+{
+namespace
+{
+std::any makeReferencePointsInput(xmlNodePtr cur, std::string& value_label)
+{
+  value_label = "reference_points";
+  return ReferencePointsInput{cur};
+}
+
+std::any makeSpaceGridInput(xmlNodePtr cur, std::string& value_label)
+{
+  value_label = "spacegrid";
+  return SpaceGridInput{cur};
+}
+} // namespace
+
+EnergyDensityInput::EnergyDensityInputSection::EnergyDensityInputSection()
+{
+  section_name = "EnergyDensity";
+  attributes   = {"name", "type", "dynamic", "static", "ion_points"};
+  strings      = {"name", "type", "dynamic", "static"};
+  bools        = {"ion_points"};
+  delegates    = {"reference_points", "spacegrid"};
+  multiple     = {"spacegrid"};
+  registerDelegate("reference_points", makeReferencePointsInput);
+  registerDelegate("spacegrid", makeSpaceGridInput);
+}
+
+EnergyDensityInput::EnergyDensityInput(xmlNodePtr cur)
+{
+  input_section_.readXML(cur);
+  auto setIfInInput = LAMBDA_setIfInInput;
+  setIfInInput(name_, "name");
+  setIfInInput(dynamic_, "dynamic");
+  setIfInInput(static_, "static");
+  setIfInInput(ion_points_, "ion_points");
+  if (input_section_.has("reference_points"))
+    ref_points_input_ = input_section_.get<ReferencePointsInput>("reference_points");
+  if (input_section_.has("spacegrid"))
+    for (auto& any_space_grid : input_section_.get<std::vector<std::any>>("spacegrid"))
+      space_grid_inputs_.push_back(std::any_cast<SpaceGridInput>(any_space_grid));
+  if (ion_points_ && static_.empty())
+    throw UniformCommunicateError("EnergyDensity input: ion_points requires a static particle set");
+}
+
+} // namespace qmcplusplus
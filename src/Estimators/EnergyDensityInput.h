@@ -0,0 +1,70 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: EnergyDensityEstimator.cpp
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_ENERGY_DENSITY_INPUT_H
+#define QMCPLUSPLUS_ENERGY_DENSITY_INPUT_H
+
+#include <optional>
+#include "Configuration.h"
+#include "InputSection.h"
+#include "SpaceGridInput.h"
+#include "ReferencePointsInput.h"
+
+namespace qmcplusplus
+{
+class NEEnergyDensityEstimator;
+
+/** Native representation of the batched EnergyDensity estimator input
+ *
+ *  <estimator type="EnergyDensity" name="EDcell" dynamic="e" static="ion0" ion_points="no">
+ *    <reference_points coord="cartesian"> ... </reference_points>
+ *    <spacegrid coord="cartesian"> ... </spacegrid>
+ *    ...
+ *  </estimator>
+ *
+ *  reference_points and spacegrid nodes are delegated to their own input classes.
+ */
+class EnergyDensityInput
+{
+public:
+  using Consumer = NEEnergyDensityEstimator;
+  using Real     = QMCTraits::RealType;
+
+  class EnergyDensityInputSection : public InputSection
+  {
+  public:
+    EnergyDensityInputSection();
+    EnergyDensityInputSection(const EnergyDensityInputSection&) = default;
+  };
+
+  EnergyDensityInput(xmlNodePtr cur);
+  EnergyDensityInput(const EnergyDensityInput&) = default;
+
+  const std::string& get_name() const { return name_; }
+  const std::string& get_dynamic() const { return dynamic_; }
+  const std::string& get_static() const { return static_; }
+  bool get_ion_points() const { return ion_points_; }
+  const std::optional<ReferencePointsInput>& get_ref_points_input() const { return ref_points_input_; }
+  const std::vector<SpaceGridInput>& get_space_grid_inputs() const { return space_grid_inputs_; }
+
+private:
+  EnergyDensityInputSection input_section_;
+  std::string name_    = "EnergyDensity";
+  std::string dynamic_ = "e";
+  /// empty if there is no static particle set
+  std::string static_;
+  bool ion_points_ = false;
+  std::optional<ReferencePointsInput> ref_points_input_;
+  std::vector<SpaceGridInput> space_grid_inputs_;
+};
+
+} // namespace qmcplusplus
+#endif
@@ -21,5 +21,9 @@
 #include "SpinDensityInput.h"
 #include "MagnetizationDensityInput.h"
 #include "PerParticleHamiltonianLoggerInput.h"
+#include "EnergyDensityInput.h"
+#include "StructureFactorInput.h"
+#include "PairCorrelationInput.h"
+#include "WalkerTraceWriterInput.h"
 
 #endif
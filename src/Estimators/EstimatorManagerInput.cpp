@@ -17,6 +17,10 @@
 #include "SpinDensityInput.h"
 #include "MagnetizationDensityInput.h"
 #include "PerParticleHamiltonianLoggerInput.h"
+#include "EnergyDensityInput.h"
+#include "StructureFactorInput.h"
+#include "PairCorrelationInput.h"
+#include "WalkerTraceWriterInput.h"
 #include "ModernStringUtils.hpp"
 
 namespace qmcplusplus
@@ -91,6 +95,14 @@ void EstimatorManagerInput::readXML(xmlNodePtr cur)
         appendEstimatorInput<PerParticleHamiltonianLoggerInput>(child);
       else if (atype == "magnetizationdensity")
         appendEstimatorInput<MagnetizationDensityInput>(child);
+      else if (atype == "energydensity")
+        appendEstimatorInput<EnergyDensityInput>(child);
+      else if (atype == "structurefactor")
+        appendEstimatorInput<StructureFactorInput>(child);
+      else if (atype == "paircorrelation")
+        appendEstimatorInput<PairCorrelationInput>(child);
+      else if (atype == "walkertraces")
+        appendEstimatorInput<WalkerTraceWriterInput>(child);
       else
         throw UniformCommunicateError(error_tag + "unparsable <estimator> node, name: " + aname + " type: " + atype +
                                       " in Estimators input.");
@@ -42,12 +42,20 @@ class MomentumDistributionInput;
 class OneBodyDensityMatricesInput;
 class MagnetizationDensityInput;
 class PerParticleHamiltonianLoggerInput;
+class EnergyDensityInput;
+class StructureFactorInput;
+class PairCorrelationInput;
+class WalkerTraceWriterInput;
 using EstimatorInput  = std::variant<std::monostate,
                                     MomentumDistributionInput,
                                     SpinDensityInput,
                                     OneBodyDensityMatricesInput,
                                     MagnetizationDensityInput,
-                                    PerParticleHamiltonianLoggerInput>;
+                                    PerParticleHamiltonianLoggerInput,
+                                    EnergyDensityInput,
+                                    StructureFactorInput,
+                                    PairCorrelationInput,
+                                    WalkerTraceWriterInput>;
 using EstimatorInputs = std::vector<EstimatorInput>;
 
 /** The scalar esimtator inputs
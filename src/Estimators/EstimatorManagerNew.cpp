@@ -21,6 +21,10 @@
 #include "OneBodyDensityMatrices.h"
 #include "MagnetizationDensity.h"
 #include "PerParticleHamiltonianLogger.h"
+#include "NEEnergyDensityEstimator.h"
+#include "StructureFactorEstimator.h"
+#include "PairCorrelationEstimator.h"
+#include "WalkerTraceWriter.h"
 #include "QMCHamiltonians/QMCHamiltonian.h"
 #include "Message/Communicate.h"
 #include "Message/CommOperators.h"
@@ -92,7 +96,7 @@ bool EstimatorManagerNew::createScalarEstimator(ScalarEstimatorInput& input, Arg
 EstimatorManagerNew::EstimatorManagerNew(Communicate* c,
                                          EstimatorManagerInput&& emi,
                                          const QMCHamiltonian& H,
-                                         const ParticleSet& pset,
+                                         ParticleSet& pset,
                                          const TrialWaveFunction& twf)
     : RecordCount(0), my_comm_(c), max4ascii(8), FieldWidth(20)
 {
@@ -103,7 +107,11 @@ EstimatorManagerNew::EstimatorManagerNew(Communicate* c,
           createEstimator<OneBodyDensityMatricesInput>(est_input, pset.getLattice(), pset.getSpeciesSet(),
                                                        twf.getSPOMap(), pset) ||
           createEstimator<MagnetizationDensityInput>(est_input, pset.getLattice()) ||
-          createEstimator<PerParticleHamiltonianLoggerInput>(est_input, my_comm_->rank())))
+          createEstimator<PerParticleHamiltonianLoggerInput>(est_input, my_comm_->rank()) ||
+          createEstimator<EnergyDensityInput>(est_input, pset) ||
+          createEstimator<StructureFactorInput>(est_input, pset) ||
+          createEstimator<PairCorrelationInput>(est_input, pset) ||
+          createEstimator<WalkerTraceWriterInput>(est_input, my_comm_->rank())))
       throw UniformCommunicateError(std::string(error_tag_) +
                                     "cannot construct an estimator from estimator input object.");
 
@@ -198,11 +206,15 @@ void EstimatorManagerNew::startDriverRun()
   RecordCount = 0;
   energyAccumulator.clear();
   varAccumulator.clear();
+  energy_reblocking_.clear();
   BlockAverages.setValues(0.0);
   AverageCache.resize(BlockAverages.size());
   PropertyCache.resize(BlockProperties.size());
   // Now Estimatormanager New is actually valid i.e. in the state you would expect after the constructor.
   // Until the put is dropped this isn't feasible to fix.
+  // the series is only advanced after the driver is constructed, per rank files are named here
+  for (auto& uope : operator_ests_)
+    uope->openOutput(my_comm_->getName());
 #if defined(DEBUG_ESTIMATOR_ARCHIVE)
   if (!DebugArchive)
   {
@@ -232,10 +244,41 @@ void EstimatorManagerNew::startDriverRun()
       scalar_ests_[i]->registerObservables(h5desc, *h_file);
     for (auto& uope : operator_ests_)
       uope->registerOperatorEstimator(*h_file);
+    for (auto& h5d : h5desc)
+      h5d.set_output_layout(stat_blocks_per_write_, stat_compression_level_, stat_use_zstd_);
+    for (auto& uope : operator_ests_)
+      uope->setOutputLayout(stat_blocks_per_write_, stat_compression_level_, stat_use_zstd_);
   }
 }
 
-void EstimatorManagerNew::stopDriverRun() { h_file.reset(); }
+void EstimatorManagerNew::setStatOutputLayout(int blocks_per_write, int compression_level, bool use_zstd)
+{
+  stat_blocks_per_write_  = std::max(blocks_per_write, 1);
+  stat_compression_level_ = std::max(compression_level, 0);
+  stat_use_zstd_          = use_zstd;
+  if (my_comm_->rank() == 0 && stat_use_zstd_ && stat_compression_level_ > 0 &&
+      H5Zfilter_avail(H5Z_FILTER_ZSTD_PLUGIN) <= 0)
+    app_warning() << "The zstd HDF5 filter plugin is not available, stat.h5 is compressed with deflate." << std::endl;
+}
+
+void EstimatorManagerNew::setReblockingEquilibration(int blocks) { reblocking_equilibration_ = std::max(blocks, 0); }
+
+void EstimatorManagerNew::stopDriverRun()
+{
+  if (my_comm_->rank() == 0 && energy_reblocking_.count() > 1)
+    app_log() << "  Reblocked local energy = " << energy_reblocking_.mean() << " +/- " << energy_reblocking_.error()
+              << ", autocorrelation time = " << energy_reblocking_.autocorrelationTime() << " blocks over "
+              << energy_reblocking_.count() << " blocks" << std::endl;
+  if (h_file)
+  {
+    // blocks of an incomplete batch
+    for (auto& h5d : h5desc)
+      h5d.flush(*h_file);
+    for (auto& uope : operator_ests_)
+      uope->flushWrites(*h_file);
+  }
+  h_file.reset();
+}
 
 void EstimatorManagerNew::startBlock(int steps) { block_timer_.restart(); }
 
@@ -294,18 +337,11 @@ void EstimatorManagerNew::collectOperatorEstimators(const std::vector<RefVector<
 void EstimatorManagerNew::makeBlockAverages(unsigned long accepts, unsigned long rejects)
 {
   // accumulate unsigned long counters over ranks.
-  // Blocks ends are infrequent, two MPI transfers to preserve type
-  // these could be replaced with a singple call MPI_struct_type some packing scheme or even
-  // a pack into and out of an fp type that can be assured to hold the integral type exactly
-  // IMHO they should not be primarily stored in a vector with magic indexes
-  std::vector<unsigned long> accepts_and_rejects(my_comm_->size() * 2, 0);
-  accepts_and_rejects[my_comm_->rank()]                    = accepts;
-  accepts_and_rejects[my_comm_->size() + my_comm_->rank()] = rejects;
-  my_comm_->allreduce(accepts_and_rejects);
-  unsigned long total_block_accept =
-      std::accumulate(accepts_and_rejects.begin(), accepts_and_rejects.begin() + my_comm_->size(), 0);
-  unsigned long total_block_reject = std::accumulate(accepts_and_rejects.begin() + my_comm_->size(),
-                                                     accepts_and_rejects.begin() + my_comm_->size() * 2, 0);
+  // reduced separately from the floating point data to preserve type
+  std::vector<unsigned long> accepts_and_rejects{accepts, rejects};
+  my_comm_->allreduce_hierarchical(accepts_and_rejects);
+  const unsigned long total_block_accept = accepts_and_rejects[0];
+  const unsigned long total_block_reject = accepts_and_rejects[1];
 
   //Transfer FullPrecisionRead data
   const size_t n1 = AverageCache.size();
@@ -320,10 +356,7 @@ void EstimatorManagerNew::makeBlockAverages(unsigned long accepts, unsigned long
     copy(PropertyCache.begin(), PropertyCache.end(), cur + n1);
   }
 
-  // This is necessary to use mpi3's C++ style reduce
-#ifdef HAVE_MPI
-  my_comm_->comm.reduce_in_place_n(reduce_buffer.begin(), reduce_buffer.size(), std::plus<>{});
-#endif
+  my_comm_->reduce_hierarchical(reduce_buffer);
   if (my_comm_->rank() == 0)
   {
     auto cur = reduce_buffer.begin();
@@ -343,6 +376,8 @@ void EstimatorManagerNew::makeBlockAverages(unsigned long accepts, unsigned long
   //add the block average to summarize
   energyAccumulator(AverageCache[0]);
   varAccumulator(AverageCache[1]);
+  if (RecordCount >= reblocking_equilibration_)
+    energy_reblocking_(AverageCache[0]);
 }
 
 void EstimatorManagerNew::writeScalarH5()
@@ -353,7 +388,8 @@ void EstimatorManagerNew::writeScalarH5()
     for (int o = 0; o < h5desc.size(); ++o)
       // cheating here, remove SquaredAverageCache from API
       h5desc[o].write(AverageCache.data(), *h_file);
-    h_file->flush();
+    if ((RecordCount + 1) % stat_blocks_per_write_ == 0)
+      h_file->flush();
   }
 
   if (Archive)
@@ -380,30 +416,21 @@ void EstimatorManagerNew::reduceOperatorEstimators()
     }
     // 1 larger because we put the weight in to avoid dependence of the Scalar estimators being reduced firt.
     size_t nops = *(std::max_element(operator_data_sizes.begin(), operator_data_sizes.end())) + 1;
-    std::vector<RealType> operator_send_buffer;
-    std::vector<RealType> operator_recv_buffer;
-    operator_send_buffer.reserve(nops);
-    operator_recv_buffer.reserve(nops);
+    std::vector<RealType> operator_reduce_buffer;
+    operator_reduce_buffer.reserve(nops);
     for (int iop = 0; iop < operator_ests_.size(); ++iop)
     {
       auto& estimator      = *operator_ests_[iop];
       auto& data           = estimator.get_data();
       size_t adjusted_size = data.size() + 1;
-      operator_send_buffer.resize(adjusted_size, 0.0);
-      operator_recv_buffer.resize(adjusted_size, 0.0);
-      std::copy_n(data.begin(), data.size(), operator_send_buffer.begin());
-      operator_send_buffer[data.size()] = estimator.get_walkers_weight();
-      // This is necessary to use mpi3's C++ style reduce
-#ifdef HAVE_MPI
-      my_comm_->comm.reduce_n(operator_send_buffer.begin(), adjusted_size, operator_recv_buffer.begin(), std::plus<>{},
-                              0);
-#else
-      operator_recv_buffer = operator_send_buffer;
-#endif
+      operator_reduce_buffer.resize(adjusted_size, 0.0);
+      std::copy_n(data.begin(), data.size(), operator_reduce_buffer.begin());
+      operator_reduce_buffer[data.size()] = estimator.get_walkers_weight();
+      my_comm_->reduce_hierarchical(operator_reduce_buffer);
       if (my_comm_->rank() == 0)
       {
-        std::copy_n(operator_recv_buffer.begin(), data.size(), data.begin());
-        size_t reduced_walker_weights = operator_recv_buffer[data.size()];
+        std::copy_n(operator_reduce_buffer.begin(), data.size(), data.begin());
+        size_t reduced_walker_weights = operator_reduce_buffer[data.size()];
         RealType invTotWgt            = 1.0 / static_cast<QMCT::RealType>(reduced_walker_weights);
         operator_ests_[iop]->normalize(invTotWgt);
       }
@@ -419,7 +446,8 @@ void EstimatorManagerNew::writeOperatorEstimators()
     {
       for (auto& op_est : operator_ests_)
         op_est->write(*h_file);
-      h_file->flush();
+      if ((RecordCount + 1) % stat_blocks_per_write_ == 0)
+        h_file->flush();
     }
   }
 }
@@ -20,6 +20,7 @@
 #include "Message/Communicate.h"
 #include "Estimators/ScalarEstimatorBase.h"
 #include "OperatorEstBase.h"
+#include "ReblockingAccumulator.hpp"
 #include "Particle/Walker.h"
 #include "OhmmsPETE/OhmmsVector.h"
 #include "type_traits/template_types.hpp"
@@ -61,13 +62,14 @@ public:
    *
    *  \param[in]  emi    EstimatorManagerInput consisting of merged global and local estimator definitions. Moved from!
    *  \param[in]  H      Fully Constructed Golden Hamiltonian.
-   *  \param[in]  pset   The electron or equiv. pset
+   *  \param[in]  pset   The electron or equiv. pset, estimators may request distance tables from it
+   *                     so it must be the golden pset the walker psets are later cloned from.
    *  \param[in]  twf    The fully constructed TrialWaveFunction.
    */
   EstimatorManagerNew(Communicate* comm,
                       EstimatorManagerInput&& emi,
                       const QMCHamiltonian& H,
-                      const ParticleSet& pset,
+                      ParticleSet& pset,
                       const TrialWaveFunction& twf);
   ///destructor
   ~EstimatorManagerNew();
@@ -112,6 +114,18 @@ public:
    */
   void stopBlock(unsigned long accept, unsigned long reject, RealType block_weight);
 
+  /** set the stat.h5 dataset layout, takes effect at the next startDriverRun
+   * @param blocks_per_write blocks buffered on rank 0 and appended by one write, also the chunk extent
+   * @param compression_level lossless compression level, 0 for none
+   * @param use_zstd compress with the zstd filter plugin if available instead of deflate
+   */
+  void setStatOutputLayout(int blocks_per_write, int compression_level, bool use_zstd);
+
+  /** leave the first blocks of each driver run out of the reblocked local energy
+   * @param blocks number of equilibration blocks whose energy contains the transient
+   */
+  void setReblockingEquilibration(int blocks);
+
   /** At end of block collect the main scalar estimators for the entire rank
    *
    *  One per crowd over multiple walkers
@@ -143,6 +157,12 @@ public:
 
   auto& get_AverageCache() { return AverageCache; }
 
+  /** online reblocking of the block averaged local energy, only valid on rank 0.
+   *  Drivers use its error bar to stop a section once a target error is reached.
+   *  The blocks set by setReblockingEquilibration are not included.
+   */
+  const ReblockingAccumulator<FullPrecRealType>& get_energy_reblocking() const { return energy_reblocking_; }
+
   std::size_t getNumEstimators() { return operator_ests_.size(); }
   std::size_t getNumScalarEstimators() { return scalar_ests_.size(); }
 
@@ -235,6 +255,10 @@ private:
   ScalarEstimatorBase::accumulator_type energyAccumulator;
   /** accumulator for the variance **/
   ScalarEstimatorBase::accumulator_type varAccumulator;
+  /// reblocking of the block averaged energy for error bar and autocorrelation time during the run
+  ReblockingAccumulator<FullPrecRealType> energy_reblocking_;
+  /// blocks at the start of a driver run left out of energy_reblocking_
+  int reblocking_equilibration_ = 0;
   ///cached block averages of the values
 
   Vector<RealType> AverageCache;
@@ -252,6 +276,12 @@ private:
   std::vector<UPtr<ScalarEstimatorBase>> scalar_ests_;
   ///convenient descriptors for hdf5
   std::vector<ObservableHelper> h5desc;
+  ///blocks appended to stat.h5 per write
+  int stat_blocks_per_write_ = 1;
+  ///compression level of the stat.h5 datasets
+  int stat_compression_level_ = 0;
+  ///use zstd instead of deflate for stat.h5
+  bool stat_use_zstd_ = false;
   /** OperatorEst Observables
    *
    * since the operator estimators are also a close set at compile time
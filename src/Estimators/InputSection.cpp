@@ -249,7 +249,7 @@ void InputSection::assignValue(const std::string& name, const T& value)
   else
   {
     if (has(name))
-      std::any_cast<std::vector<T>>(values_[name]).push_back(value);
+      std::any_cast<std::vector<T>&>(values_[name]).push_back(value);
     else
       values_[name] = std::vector<T>{value};
   }
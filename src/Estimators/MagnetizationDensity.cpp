@@ -10,6 +10,8 @@
 //////////////////////////////////////////////////////////////////////////////////////
 #include "Estimators/MagnetizationDensity.h"
 #include "Estimators/MagnetizationDensityInput.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
+#include "QMCHamiltonians/NLPPJob.h"
 
 namespace qmcplusplus
 {
@@ -17,6 +19,8 @@ MagnetizationDensity::MagnetizationDensity(MagnetizationDensityInput&& minput, c
     : OperatorEstBase(DataLocality::crowd), input_(minput), lattice_(lat)
 {
   my_name_ = "MagnetizationDensity";
+  if (input_.get_save_memory())
+    data_locality_ = DataLocality::rank;
   //Pull consistent corner, grids, etc., from already inititalized input.
   //DerivedParameters does the sanity checks and consistent initialization of these variables.
   MagnetizationDensityInput::DerivedParameters derived = minput.calculateDerivedParameters(lat);
@@ -51,48 +55,74 @@ void MagnetizationDensity::accumulate(const RefVector<MCPWalker>& walkers,
                                       const RefVector<TrialWaveFunction>& wfns,
                                       RandomGenerator& rng)
 {
-  for (int iw = 0; iw < walkers.size(); ++iw)
+  const size_t nw = walkers.size();
+  if (nw == 0)
+    return;
+  resizeCrowdWorkspace(psets);
+  generateQuadrature();
+
+  RefVectorWithLeader<ParticleSet> p_list(psets[0], psets);
+  RefVectorWithLeader<TrialWaveFunction> wf_list(wfns[0], wfns);
+  RefVectorWithLeader<VirtualParticleSet> vp_list(*crowd_vps_.sets[0]);
+  vp_list.reserve(nw);
+  for (int iw = 0; iw < nw; ++iw)
+    vp_list.push_back(*crowd_vps_.sets[iw]);
+  ResourceCollectionTeamLock<VirtualParticleSet> vp_res_lock(*crowd_vps_.resources, vp_list);
+
+  for (int iw = 0; iw < nw; ++iw)
   {
-    MCPWalker& walker      = walkers[iw];
-    ParticleSet& pset      = psets[iw];
-    TrialWaveFunction& wfn = wfns[iw];
-
-    QMCT::RealType weight = walker.Weight;
-    std::vector<Value> sxgrid(nsamples_, 0.0);
-    std::vector<Value> sygrid(nsamples_, 0.0);
-    std::vector<Value> szgrid(nsamples_, 0.0);
-
-    //Temporary variables to hold the integrated sx, sy, sz estimates.
-    //These are overwritten as needed in the loop over particles.
-    Value sx(0.0);
-    Value sy(0.0);
-    Value sz(0.0);
-
-    const int np = pset.getTotalNum();
-    assert(weight >= 0);
-
-    walkers_weight_ += weight;
-    for (int p = 0; p < np; ++p)
+    assert(walkers[iw].get().Weight >= 0);
+    walkers_weight_ += walkers[iw].get().Weight;
+  }
+
+  const int np = psets[0].get().getTotalNum();
+  for (int p = 0; p < np; ++p)
+  {
+    mw_integrateSpin(p_list, wf_list, vp_list, p);
+    for (int iw = 0; iw < nw; ++iw)
     {
-      size_t sxindex = computeBin(pset.R[p], 0);
-      generateSpinIntegrand(pset, wfn, p, sxgrid, sygrid, szgrid);
-      sx = integrateMagnetizationDensity(sxgrid);
-      sy = integrateMagnetizationDensity(sygrid);
-      sz = integrateMagnetizationDensity(szgrid);
-
-      data_[sxindex] += std::real(sx * weight);
-      data_[sxindex + 1] += std::real(sy * weight);
-      data_[sxindex + 2] += std::real(sz * weight);
+      const QMCT::RealType weight = walkers[iw].get().Weight;
+      const size_t sxindex        = computeBin(p_list[iw].R[p], 0);
+      for (int d = 0; d < DIM; ++d)
+        accumulateToData(sxindex + d, std::real(mw_spin_integrals_(iw, d) * weight));
     }
   }
 };
 
+void MagnetizationDensity::accumulateToData(size_t index, Real value)
+{
+  if (data_locality_ == DataLocality::crowd)
+    data_[index] += value;
+  else if (data_locality_ == DataLocality::queue)
+    crowd_blocks_.add(index, value);
+  else
+    throw std::runtime_error("You cannot accumulate to a MagnetizationDensity with datalocality of this type");
+}
+
 void MagnetizationDensity::collect(const RefVector<OperatorEstBase>& type_erased_operator_estimators)
 {
   if (data_locality_ == DataLocality::crowd)
   {
     OperatorEstBase::collect(type_erased_operator_estimators);
   }
+  else if (data_locality_ == DataLocality::rank)
+  {
+    RefVector<MagnetizationDensity> crowd_mds;
+    RefVector<const SparseBlockAccumulator<QMCT::RealType>> crowd_blocks;
+    for (OperatorEstBase& crowd_oeb : type_erased_operator_estimators)
+    {
+      auto& oeb = dynamic_cast<MagnetizationDensity&>(crowd_oeb);
+      crowd_mds.push_back(oeb);
+      crowd_blocks.push_back(oeb.crowd_blocks_);
+      walkers_weight_ += oeb.walkers_weight_;
+    }
+    SparseBlockAccumulator<QMCT::RealType>::reduceInto(data_, crowd_blocks);
+    for (MagnetizationDensity& oeb : crowd_mds)
+    {
+      oeb.crowd_blocks_.clear();
+      oeb.zero();
+    }
+  }
   else
   {
     throw std::runtime_error("You cannot call collect on MagnetizationDensity with this DataLocality");
@@ -114,51 +144,120 @@ size_t MagnetizationDensity::computeBin(const QMCT::PosType& r, const unsigned i
 
 std::unique_ptr<OperatorEstBase> MagnetizationDensity::spawnCrowdClone() const
 {
-  std::size_t data_size    = data_.size();
-  auto spawn_data_locality = data_locality_;
-
-  //Everyone else has this attempt to set up a non-implemented memory saving optimization.
-  //We won't rock the boat.
   if (data_locality_ == DataLocality::rank)
   {
-    // This is just a stub until a memory saving optimization is deemed necessary
-    spawn_data_locality = DataLocality::queue;
-    data_size           = 0;
-    throw std::runtime_error("There is no memory savings implementation for MagnetizationDensity");
+    // crowd clones only allocate the blocks of the grid their walkers visit
+    UPtr<MagnetizationDensity> spawn(std::make_unique<MagnetizationDensity>(*this, DataLocality::queue));
+    spawn->crowd_blocks_ = SparseBlockAccumulator<QMCT::RealType>(data_.size());
+    return spawn;
   }
 
-  UPtr<MagnetizationDensity> spawn(std::make_unique<MagnetizationDensity>(*this, spawn_data_locality));
-  spawn->get_data().resize(data_size);
+  UPtr<MagnetizationDensity> spawn(std::make_unique<MagnetizationDensity>(*this, data_locality_));
+  spawn->get_data().resize(data_.size());
   return spawn;
 };
 
-void MagnetizationDensity::generateSpinIntegrand(ParticleSet& pset_target,
-                                                 TrialWaveFunction& psi_target,
-                                                 const int iat,
-                                                 std::vector<Value>& sxgrid,
-                                                 std::vector<Value>& sygrid,
-                                                 std::vector<Value>& szgrid)
+void MagnetizationDensity::resizeCrowdWorkspace(const RefVector<ParticleSet>& psets)
+{
+  const size_t nw = psets.size();
+  auto& vps       = crowd_vps_;
+  bool same_psets = vps.ref_psets.size() == nw;
+  for (int iw = 0; same_psets && iw < nw; ++iw)
+    same_psets = vps.ref_psets[iw] == &psets[iw].get();
+  if (same_psets)
+    return;
+
+  vps.sets.clear();
+  vps.ref_psets.clear();
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    vps.sets.push_back(std::make_unique<VirtualParticleSet>(psets[iw], nsamples_));
+    vps.ref_psets.push_back(&psets[iw].get());
+  }
+  vps.resources = std::make_unique<ResourceCollection>("MagnetizationDensity::VirtualParticleSet");
+  vps.sets[0]->createResource(*vps.resources);
 
+  mw_deltas_s_.resize(nw, std::vector<Real>(nsamples_));
+  mw_deltas_v_.resize(nw, std::vector<Position>(nsamples_, 0));
+  mw_ratios_.resize(nw, std::vector<Value>(nsamples_));
+  mw_spin_integrals_.resize(nw, DIM);
+}
+
+void MagnetizationDensity::generateQuadrature()
+{
+  generateGrid(sgrid_);
+  // the weights reproduce integrateMagnetizationDensity
+  std::vector<Real> weights(nsamples_);
+  switch (integrator_)
+  {
+  case Integrator::SIMPSONS: {
+    const Real dx = Real(2.0 * M_PI) / (nsamples_ - 1.0);
+    for (int is = 1; is < nsamples_ - 1; ++is)
+      weights[is] = (is % 2 ? Real(4. / 3.) : Real(2. / 3.)) * dx;
+    weights[0]             = Real(1. / 3.) * dx;
+    weights[nsamples_ - 1] = Real(1. / 3.) * dx;
+    for (auto& weight : weights)
+      weight /= Real(2.0 * M_PI);
+    break;
+  }
+  case Integrator::MONTECARLO:
+    std::fill(weights.begin(), weights.end(), Real(1.0) / nsamples_);
+    break;
+  }
+  weights_cos_.resize(nsamples_);
+  weights_sin_.resize(nsamples_);
+  for (int is = 0; is < nsamples_; ++is)
+  {
+    weights_cos_[is] = weights[is] * std::cos(sgrid_[is]);
+    weights_sin_[is] = weights[is] * std::sin(sgrid_[is]);
+  }
+}
+
+void MagnetizationDensity::mw_integrateSpin(const RefVectorWithLeader<ParticleSet>& p_list,
+                                            const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                                            const RefVectorWithLeader<VirtualParticleSet>& vp_list,
+                                            const int iat)
 {
-  std::vector<Real> sgrid(nsamples_);
-  std::vector<Real> ds(nsamples_, 0.0);
-  std::vector<Value> ratios(nsamples_, 0);
-  generateGrid(sgrid);
-  for (int samp = 0; samp < nsamples_; samp++)
-    ds[samp] = sgrid[samp] - pset_target.spins[iat];
-
-  VirtualParticleSet vp(pset_target, nsamples_);
-  std::vector<Position> dV(nsamples_, 0);
-  vp.makeMovesWithSpin(pset_target, iat, dV, ds);
-  psi_target.evaluateRatios(vp, ratios);
+  const size_t nw = p_list.size();
+  RefVectorWithLeader<const VirtualParticleSet> const_vp_list(vp_list.getLeader());
+  const_vp_list.reserve(nw);
+  for (int iw = 0; iw < nw; ++iw)
+    const_vp_list.push_back(vp_list[iw]);
+
+  // move electron iat of every walker to all the spin samples
+  std::vector<NLPPJob<Real>> jobs;
+  jobs.reserve(nw);
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    const Real spin = p_list[iw].spins[iat];
+    for (int is = 0; is < nsamples_; ++is)
+      mw_deltas_s_[iw][is] = sgrid_[is] - spin;
+    jobs.emplace_back(-1, iat, 0, Position());
+  }
+  VirtualParticleSet::mw_makeMovesWithSpin(vp_list, p_list, makeRefVector<const std::vector<Position>>(mw_deltas_v_),
+                                           makeRefVector<const std::vector<Real>>(mw_deltas_s_),
+                                           makeRefVector<const NLPPJob<Real>>(jobs), false);
+  TrialWaveFunction::mw_evaluateRatios(wf_list, const_vp_list, makeRefVector<std::vector<Value>>(mw_ratios_));
 
+  // with c = sum_s' w cos(s') ratio and s = sum_s' w sin(s') ratio
+  // sx = 2 (cos(s) c - sin(s) s), sy = 2 (sin(s) c + cos(s) s), sz = -2i (cos(s) s - sin(s) c)
   const std::complex<Real> eye(0, 1.0);
-
-  for (int samp = 0; samp < nsamples_; samp++)
+  for (int iw = 0; iw < nw; ++iw)
   {
-    sxgrid[samp] = std::real(Real(2.0) * Real(std::cos(sgrid[samp] + pset_target.spins[iat])) * ratios[samp]);
-    sygrid[samp] = std::real(Real(2.0) * Real(std::sin(sgrid[samp] + pset_target.spins[iat])) * ratios[samp]);
-    szgrid[samp] = std::real(Real(-2.0) * eye * std::sin(ds[samp]) * ratios[samp]);
+    const Value* ratios = mw_ratios_[iw].data();
+    Value c_sum(0);
+    Value s_sum(0);
+    for (int is = 0; is < nsamples_; ++is)
+    {
+      c_sum += weights_cos_[is] * ratios[is];
+      s_sum += weights_sin_[is] * ratios[is];
+    }
+    const Real spin           = p_list[iw].spins[iat];
+    const Real cos_s          = std::cos(spin);
+    const Real sin_s          = std::sin(spin);
+    mw_spin_integrals_(iw, 0) = std::real(Real(2.0) * (cos_s * c_sum - sin_s * s_sum));
+    mw_spin_integrals_(iw, 1) = std::real(Real(2.0) * (sin_s * c_sum + cos_s * s_sum));
+    mw_spin_integrals_(iw, 2) = std::real(Real(-2.0) * eye * (cos_s * s_sum - sin_s * c_sum));
   }
 }
 
@@ -254,7 +353,7 @@ template void MagnetizationDensity::generateRandomGrid<RandomGenerator>(std::vec
                                                                         Real start,
                                                                         Real stop) const;
 
-#if defined(USE_FAKE_RNG) || defined(QMC_RNG_BOOST)
+#if defined(USE_FAKE_RNG) || defined(QMC_RNG_BOOST) || defined(QMC_RNG_PHILOX)
 template void MagnetizationDensity::generateRandomGrid<StdRandom<double>>(std::vector<Real>& sgrid,
                                                                           StdRandom<double>& rng,
                                                                           Real start,
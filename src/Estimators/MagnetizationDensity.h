@@ -14,10 +14,15 @@
 
 #include <vector>
 #include <functional>
+#include <memory>
 
 #include "Estimators/OperatorEstBase.h"
+#include "Estimators/SparseBlockAccumulator.hpp"
 #include "type_traits/complex_help.hpp"
 #include "ParticleBase/RandomSeqGenerator.h"
+#include "OhmmsPETE/OhmmsMatrix.h"
+#include "Particle/VirtualParticleSet.h"
+#include "ResourceCollection.h"
 #include <SpeciesSet.h>
 #include <StdRandom.h>
 #include "Estimators/MagnetizationDensityInput.h"
@@ -38,6 +43,12 @@ class MagnetizationDensityTests;
  * triple the length of this array.  If grid_i is the index of the real space gridpoint i, then the data is layed out like:
  * [grid_0_x, grid_0_y, grid_0_z, grid_1_x, ..., grid_N_x, grid_N_y, grid_N_z].  This is also the way it is stored in HDF5.  
  *
+ * With save_memory the crowd estimators only hold the grid blocks their walkers visit, see SparseBlockAccumulator.
+ *
+ * accumulate moves electron i of all the walkers of a crowd to all the spin samples at once through a pool of
+ * VirtualParticleSet kept by the crowd estimator and evaluates the ratios with the multi walker API.
+ * Since \langle s|\hat{\sigma}|s'\rangle only depends on cos and sin of s' and s, the quadrature of all three
+ * components reduces to two weighted sums over the spin samples per walker and electron.
  */
 class MagnetizationDensity : public OperatorEstBase
 {
@@ -90,24 +101,30 @@ private:
   MagnetizationDensity(const MagnetizationDensity& magdens) = default;
 
 
+  /** build the crowd's virtual particle sets and workspace
+   *  nothing is done if they were built against the same particle sets.
+   */
+  void resizeCrowdWorkspace(const RefVector<ParticleSet>& psets);
+
   /**
-  * Generates the spin integrand \Psi(s')/Psi(s)* \langle s | \vec{\sigma} | s'\rangle for a specific
-  *  electron iat.  Since this is a vectorial quantity, this function returns sx, sy, and sz in their own
-  *  arrays.  
+  * Integrates the spin integrand \Psi(s')/Psi(s)* \langle s | \vec{\sigma} | s'\rangle over s' for electron iat
+  * of every walker of the crowd. The results go to mw_spin_integrals_, row: walker col: sx, sy, sz.
   *
-  * @param[in] pset ParticleSet  
-  * @param[in] wfn TrialWaveFunction
+  * @param[in] p_list ParticleSets of the crowd
+  * @param[in] wf_list TrialWaveFunctions of the crowd
+  * @param[in] vp_list VirtualParticleSets of the crowd, resources acquired
   * @param[in] iat electron index
-  * @param[out] sx x component of spin integrand
-  * @param[out] sy y component of spin integrand
-  * @param[out] sz z component of spin integrand
   */
-  void generateSpinIntegrand(ParticleSet& pset,
-                             TrialWaveFunction& wfn,
-                             const int iat,
-                             std::vector<Value>& sx,
-                             std::vector<Value>& sy,
-                             std::vector<Value>& sz);
+  void mw_integrateSpin(const RefVectorWithLeader<ParticleSet>& p_list,
+                        const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                        const RefVectorWithLeader<VirtualParticleSet>& vp_list,
+                        const int iat);
+
+  /**
+  * Generates the spin grid and the quadrature weights times cos(s') and sin(s') of the grid points.
+  * The weights include the 1/2pi normalization, see integrateMagnetizationDensity.
+  */
+  void generateQuadrature();
 
   /**
   *  Implementation of Simpson's 1/3 rule to integrate a function on a uniform grid. 
@@ -158,6 +175,10 @@ private:
   * @return Index of appropriate bin for this position and spin component 
   */
   size_t computeBin(const Position& r, const unsigned int component) const;
+
+  /// add value to the crowd data or for DataLocality::queue to the crowd blocks
+  void accumulateToData(size_t index, Real value);
+
   MagnetizationDensityInput input_;
   //These are the same variables as in SpinDensityNew.
   Integrator integrator_;
@@ -168,6 +189,38 @@ private:
   TinyVector<int, DIM> gdims_;
   size_t npoints_;
   int nsamples_;
+  /// touched blocks of the grid, only used with DataLocality::queue
+  SparseBlockAccumulator<QMCT::RealType> crowd_blocks_;
+
+  /** @ingroup CrowdWorkspace batched accumulation over the walkers of a crowd
+   *  @{ */
+  /** one VirtualParticleSet per walker of the crowd, each holds all the spin samples of its walker.
+   *  The sets are built against the crowd's particle sets on first use, copies start empty.
+   */
+  struct CrowdVirtualParticleSets
+  {
+    std::vector<std::unique_ptr<VirtualParticleSet>> sets;
+    std::vector<const ParticleSet*> ref_psets;
+    std::unique_ptr<ResourceCollection> resources;
+
+    CrowdVirtualParticleSets() = default;
+    CrowdVirtualParticleSets(const CrowdVirtualParticleSets&) {}
+  };
+  CrowdVirtualParticleSets crowd_vps_;
+  /// spin grid
+  std::vector<Real> sgrid_;
+  /// quadrature weights times cos and sin of the spin grid
+  std::vector<Real> weights_cos_;
+  std::vector<Real> weights_sin_;
+  /// spin displacements of the samples from the reference electron of each walker
+  std::vector<std::vector<Real>> mw_deltas_s_;
+  /// the samples are not displaced in space
+  std::vector<std::vector<Position>> mw_deltas_v_;
+  /// ratios of the virtual moves of each walker
+  std::vector<std::vector<Value>> mw_ratios_;
+  /// spin integrals of the current electron, row: walker col: component
+  Matrix<Value> mw_spin_integrals_;
+  /** @} */
 
   friend class testing::MagnetizationDensityTests;
 };
@@ -27,6 +27,7 @@ MagnetizationDensityInput::MagnetizationDensityInput(xmlNodePtr cur)
   have_corner_ = setIfInInput(corner_, "corner");
   have_grid_   = setIfInInput(grid_real_, "grid");
   have_dr_     = setIfInInput(dr_, "dr");
+  setIfInInput(save_memory_, "save_memory");
 }
 
 
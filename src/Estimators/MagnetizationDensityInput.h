@@ -86,9 +86,9 @@ public:
       section_name  = "MagnetizationDensity";
       attributes    = {"name", "type"};
       parameters    = {"integrator", 
-                       "corner", "center", "samples", "grid", "dr"
+                       "corner", "center", "samples", "grid", "dr", "save_memory"
                       };
-      bools         = {};
+      bools         = {"save_memory"};
       enums         = {"integrator"};
       strings       = {"name", "type"};
       multi_strings = {};
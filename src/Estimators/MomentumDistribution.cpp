@@ -11,6 +11,8 @@
 
 #include "MomentumDistribution.h"
 #include "CPU/e2iphi.h"
+#include "CPU/BLAS.hpp"
+#include "type_traits/complex_help.hpp"
 #include "TrialWaveFunction.h"
 
 #include <iostream>
@@ -156,14 +158,15 @@ MomentumDistribution::MomentumDistribution(MomentumDistributionInput&& mdi,
 
   // resize arrays
   nofK.resize(kPoints.size());
-  kdotp.resize(kPoints.size());
+  const int k_tile = std::min(static_cast<int>(kPoints.size()), K_TILE);
+  kdotp.resize(k_tile);
   auto samples = input_.get_samples();
   vPos.resize(samples);
-  phases.resize(kPoints.size());
-  phases_vPos.resize(samples);
-  for (int im = 0; im < samples; im++)
-    phases_vPos[im].resize(kPoints.size());
-  psi_ratios_all.resize(samples, psi_ratios.size());
+  phases.resize(np, 2 * k_tile);
+  phases_vPos.resize(k_tile);
+  const int ratio_rows = IsComplex_t<ValueType>::value ? 2 * samples : samples;
+  psi_ratios_all.resize(ratio_rows, np);
+  ratios_phases.resize(ratio_rows, 2 * k_tile);
 
   // allocate data storage
   size_t data_size = nofK.size();
@@ -230,12 +233,16 @@ void MomentumDistribution::startBlock(int steps)
 
 /** Gets called every step and writes to thread local data.
  *
+ *  n(k) = sum_{i,s} Re[ e^{ik.r_i} e^{-ik.v_s} psi(..v_s..)/psi(..r_i..) ], the sum over particles is
+ *  the matrix product of the samples x np ratios with the np x nk phases of the particles. It is done
+ *  with one real GEMM per tile of k-points, complex ratios contribute their imaginary parts as extra rows.
  */
 void MomentumDistribution::accumulate(const RefVector<MCPWalker>& walkers,
                                       const RefVector<ParticleSet>& psets,
                                       const RefVector<TrialWaveFunction>& wfns,
                                       RandomGenerator& rng)
 {
+  constexpr bool is_complex = IsComplex_t<ValueType>::value;
   for (int iw = 0; iw < walkers.size(); ++iw)
   {
     MCPWalker& walker      = walkers[iw];
@@ -251,7 +258,7 @@ void MomentumDistribution::accumulate(const RefVector<MCPWalker>& walkers,
     walkers_weight_ += weight;
 
     auto samples = input_.get_samples();
-    // compute phase factors
+    // compute ratios
     for (int s = 0; s < samples; ++s)
     {
       PosType newpos;
@@ -262,34 +269,57 @@ void MomentumDistribution::accumulate(const RefVector<MCPWalker>& walkers,
       pset.makeVirtualMoves(vPos[s]);
       psi.evaluateRatiosAlltoOne(pset, psi_ratios);
       for (int i = 0; i < np; ++i)
-        psi_ratios_all[s][i] = psi_ratios[i];
-
-      for (int ik = 0; ik < nk; ++ik)
-        kdotp[ik] = -dot(kPoints[ik], vPos[s]);
-      eval_e2iphi(nk, kdotp.data(), phases_vPos[s].data(0), phases_vPos[s].data(1));
+      {
+        const ComplexType one_ratio(psi_ratios[i]);
+        psi_ratios_all[s][i] = one_ratio.real();
+        if constexpr (is_complex)
+          psi_ratios_all[samples + s][i] = one_ratio.imag();
+      }
     }
 
-    // update n(k)
-    std::fill_n(nofK.begin(), nk, RealType(0));
-    for (int i = 0; i < np; ++i)
+    // update n(k) tile by tile
+    const int ratio_rows = psi_ratios_all.rows();
+    const int ld_phases  = phases.cols();
+    for (int k0 = 0; k0 < nk; k0 += K_TILE)
     {
-      for (int ik = 0; ik < nk; ++ik)
-        kdotp[ik] = dot(kPoints[ik], pset.R[i]);
-      eval_e2iphi(nk, kdotp.data(), phases.data(0), phases.data(1));
+      const int kt = std::min(K_TILE, nk - k0);
+      for (int i = 0; i < np; ++i)
+      {
+        for (int ik = 0; ik < kt; ++ik)
+          kdotp[ik] = dot(kPoints[k0 + ik], pset.R[i]);
+        eval_e2iphi(kt, kdotp.data(), phases[i], phases[i] + kt);
+      }
+      // row major ratios_phases = psi_ratios_all x phases
+      BLAS::gemm('N', 'N', 2 * kt, ratio_rows, np, RealType(1), phases.data(), ld_phases, psi_ratios_all.data(), np,
+                 RealType(0), ratios_phases.data(), ld_phases);
+
+      RealType* restrict nofK_here = nofK.data() + k0;
+      std::fill_n(nofK_here, kt, RealType(0));
       for (int s = 0; s < samples; ++s)
       {
-        const ComplexType one_ratio(psi_ratios_all[s][i]);
-        const RealType ratio_c                 = one_ratio.real();
-        const RealType ratio_s                 = one_ratio.imag();
-        const RealType* restrict phases_c      = phases.data(0);
-        const RealType* restrict phases_s      = phases.data(1);
-        const RealType* restrict phases_vPos_c = phases_vPos[s].data(0);
-        const RealType* restrict phases_vPos_s = phases_vPos[s].data(1);
-        RealType* restrict nofK_here           = nofK.data();
-#pragma omp simd aligned(nofK_here, phases_c, phases_s, phases_vPos_c, phases_vPos_s : QMC_SIMD_ALIGNMENT)
-        for (int ik = 0; ik < nk; ++ik)
-          nofK_here[ik] += (phases_c[ik] * phases_vPos_c[ik] - phases_s[ik] * phases_vPos_s[ik]) * ratio_c -
-              (phases_s[ik] * phases_vPos_c[ik] + phases_c[ik] * phases_vPos_s[ik]) * ratio_s;
+        for (int ik = 0; ik < kt; ++ik)
+          kdotp[ik] = -dot(kPoints[k0 + ik], vPos[s]);
+        eval_e2iphi(kt, kdotp.data(), phases_vPos.data(0), phases_vPos.data(1));
+        const RealType* restrict phases_vPos_c = phases_vPos.data(0);
+        const RealType* restrict phases_vPos_s = phases_vPos.data(1);
+        // sum_i ratio_i e^{ik.r_i}, the imaginary part of the ratios adds the rows of sample s + samples
+        const RealType* restrict re_c = ratios_phases[s];
+        const RealType* restrict re_s = ratios_phases[s] + kt;
+        if constexpr (is_complex)
+        {
+          const RealType* restrict im_c = ratios_phases[samples + s];
+          const RealType* restrict im_s = ratios_phases[samples + s] + kt;
+#pragma omp simd
+          for (int ik = 0; ik < kt; ++ik)
+            nofK_here[ik] +=
+                phases_vPos_c[ik] * (re_c[ik] - im_s[ik]) - phases_vPos_s[ik] * (re_s[ik] + im_c[ik]);
+        }
+        else
+        {
+#pragma omp simd
+          for (int ik = 0; ik < kt; ++ik)
+            nofK_here[ik] += phases_vPos_c[ik] * re_c[ik] - phases_vPos_s[ik] * re_s[ik];
+        }
       }
     }
 
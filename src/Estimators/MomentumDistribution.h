@@ -59,16 +59,22 @@ public:
   std::vector<PosType> vPos;
   ///wavefunction ratios
   std::vector<ValueType> psi_ratios;
-  ///wavefunction ratios all samples
-  Matrix<ValueType> psi_ratios_all;
-  ///nofK internal
+  /** wavefunction ratios of all samples, samples x np
+   *  the imaginary parts of complex ratios follow as another samples x np rows
+   */
+  Matrix<RealType> psi_ratios_all;
+  ///nofK internal, one k tile
   Vector<RealType> kdotp;
-  ///phases
-  VectorSoaContainer<RealType, 2> phases;
-  ///phases of vPos
-  std::vector<VectorSoaContainer<RealType, 2>> phases_vPos;
+  ///phases of the particle positions for one k tile, np x [cos | sin]
+  Matrix<RealType> phases;
+  ///phases of vPos for one k tile
+  VectorSoaContainer<RealType, 2> phases_vPos;
+  ///psi_ratios_all x phases
+  Matrix<RealType> ratios_phases;
   ///nofK
   aligned_vector<RealType> nofK;
+  ///k-points per tile of the n(k) matrix product
+  static constexpr int K_TILE = 256;
 
 public:
   /** Constructor for MomentumDistributionInput 
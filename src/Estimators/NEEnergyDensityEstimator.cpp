@@ -0,0 +1,224 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: EnergyDensityEstimator.cpp
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "NEEnergyDensityEstimator.h"
+#include "Particle/DistanceTable.h"
+#include "Message/UniformCommunicateError.h"
+
+namespace qmcplusplus
+{
+NEEnergyDensityEstimator::NEEnergyDensityEstimator(EnergyDensityInput&& edi,
+                                                   const ParticleSet& pset_dynamic,
+                                                   DataLocality dl)
+    : OperatorEstBase(dl),
+      input_(std::move(edi)),
+      pset_static_(input_.get_static().empty() ? nullptr : findStaticParticleSet(pset_dynamic, input_.get_static())),
+      n_particles_(pset_dynamic.getTotalNum()),
+      ref_points_(input_.get_ref_points_input(),
+                  pset_dynamic,
+                  pset_static_ ? RefVector<const ParticleSet>{*pset_static_} : RefVector<const ParticleSet>{})
+{
+  requires_listener_ = true;
+  my_name_           = input_.get_name();
+  if (data_locality_ != DataLocality::crowd)
+    throw std::runtime_error("NEEnergyDensityEstimator only supports DataLocality::crowd");
+  if (input_.get_dynamic() != pset_dynamic.getName())
+    throw UniformCommunicateError("EnergyDensity dynamic particle set " + input_.get_dynamic() +
+                                  " is not the particle set of the walkers, " + pset_dynamic.getName());
+
+  if (pset_static_)
+  {
+    if (input_.get_ion_points())
+    {
+      n_ions_ = pset_static_->getTotalNum();
+      r_ion_.resize(n_ions_, QMCTraits::DIM);
+      for (int i = 0; i < n_ions_; i++)
+        for (int d = 0; d < QMCTraits::DIM; d++)
+          r_ion_(i, d) = pset_static_->R[i][d];
+    }
+    else
+      n_particles_ += pset_static_->getTotalNum();
+  }
+
+  // data layout: outside | spacegrid1 | spacegrid2 | ... | ions
+  const bool periodic    = pset_dynamic.getLattice().SuperCellEnum != SUPERCELL_OPEN;
+  int offset             = 0;
+  outside_buffer_offset_ = offset;
+  offset += N_EDVALS;
+  for (auto& sgi : input_.get_space_grid_inputs())
+  {
+    spacegrids_.emplace_back(sgi, ref_points_.get_points(), N_EDVALS, offset, periodic);
+    offset += spacegrids_.back().getDataSize();
+  }
+  ion_buffer_offset_ = offset;
+  offset += n_ions_ * N_EDVALS;
+  data_.resize(offset, 0.0);
+
+  r_work_.resize(n_particles_);
+  ed_values_.resize(n_particles_, N_EDVALS);
+  ed_ion_values_.resize(n_ions_, N_EDVALS);
+  particles_outside_.resize(n_particles_);
+}
+
+NEEnergyDensityEstimator::NEEnergyDensityEstimator(const NEEnergyDensityEstimator& ede, DataLocality dl)
+    : NEEnergyDensityEstimator(ede)
+{
+  data_locality_ = dl;
+}
+
+const ParticleSet* NEEnergyDensityEstimator::findStaticParticleSet(const ParticleSet& pset_dynamic,
+                                                                   const std::string& name)
+{
+  for (int i = 0; i < pset_dynamic.getNumDistTables(); i++)
+    if (pset_dynamic.getDistTable(i).get_origin().getName() == name)
+      return &pset_dynamic.getDistTable(i).get_origin();
+  throw UniformCommunicateError("EnergyDensity static particle set " + name +
+                                " is not the source of any distance table of " + pset_dynamic.getName());
+}
+
+ListenerVector<QMCTraits::RealType>::ReportingFunction NEEnergyDensityEstimator::getListener(
+    CrowdEnergyValues& local_values)
+{
+  return [&local_values](const int walker_index, const std::string& name, const Vector<Real>& inputV) {
+    if (walker_index >= local_values[name].size())
+      local_values[name].resize(walker_index + 1);
+    local_values[name][walker_index] = inputV;
+  };
+}
+
+void NEEnergyDensityEstimator::registerListeners(QMCHamiltonian& ham_leader)
+{
+  QMCHamiltonian::mw_registerKineticListener(ham_leader, {my_name_, getListener(kinetic_values_)});
+  QMCHamiltonian::mw_registerLocalPotentialListener(ham_leader, {my_name_, getListener(local_pot_values_)});
+  if (pset_static_)
+    QMCHamiltonian::mw_registerLocalIonPotentialListener(ham_leader, {my_name_, getListener(local_ion_pot_values_)});
+}
+
+void NEEnergyDensityEstimator::accumulate(const RefVector<MCPWalker>& walkers,
+                                          const RefVector<ParticleSet>& psets,
+                                          const RefVector<TrialWaveFunction>& wfns,
+                                          RandomGenerator& rng)
+{
+  // Each operator overwrites its values at every evaluation, so only the last report of each one is summed.
+  // Not every operator reports per particle values, i.e. only the nonlocal pseudopotentials report ion values.
+  // Missing values contribute nothing.
+  auto reported = [](const CrowdEnergyValues& values, int iw, int i) -> Real {
+    Real sum = 0.0;
+    for (const auto& [name, walker_values] : values)
+      if (iw < walker_values.size() && i < walker_values[iw].size())
+        sum += walker_values[iw][i];
+    return sum;
+  };
+
+  for (int iw = 0; iw < walkers.size(); ++iw)
+  {
+    MCPWalker& walker = walkers[iw];
+    ParticleSet& pset = psets[iw];
+    const Real weight = walker.Weight;
+    walkers_weight_ += weight;
+
+    //Collect positions from ParticleSets
+    const int n_dynamic = pset.getTotalNum();
+    int p               = 0;
+    for (int i = 0; i < n_dynamic; i++, p++)
+      r_work_[p] = pset.R[i];
+    if (pset_static_ && n_ions_ == 0)
+      for (int i = 0; i < pset_static_->getTotalNum(); i++, p++)
+        r_work_[p] = pset_static_->R[i];
+    if (pset.getLattice().SuperCellEnum != SUPERCELL_OPEN)
+      pset.applyMinimumImage(r_work_);
+
+    //Convert the reported per particle energies into EnergyDensity quantities
+    for (p = 0; p < n_dynamic; p++)
+    {
+      ed_values_(p, W) = weight;
+      ed_values_(p, T) = weight * reported(kinetic_values_, iw, p);
+      ed_values_(p, V) = weight * reported(local_pot_values_, iw, p);
+    }
+    if (pset_static_)
+    {
+      Matrix<Real>& static_values = (n_ions_ == 0) ? ed_values_ : ed_ion_values_;
+      const int first             = (n_ions_ == 0) ? n_dynamic : 0;
+      for (int i = 0; i < pset_static_->getTotalNum(); i++)
+      {
+        static_values(first + i, W) = weight;
+        static_values(first + i, T) = 0.0;
+        static_values(first + i, V) = weight * reported(local_ion_pot_values_, iw, i);
+      }
+    }
+
+    //Accumulate energy density in spacegrids
+    std::fill(particles_outside_.begin(), particles_outside_.end(), true);
+    for (auto& spacegrid : spacegrids_)
+      spacegrid.accumulate(r_work_, ed_values_, data_, particles_outside_);
+
+    //Accumulate energy density of particles outside any spacegrid
+    for (p = 0; p < n_particles_; p++)
+      if (particles_outside_[p])
+        for (int v = 0; v < N_EDVALS; v++)
+          data_[outside_buffer_offset_ + v] += ed_values_(p, v);
+
+    // Accumulate energy density for ions at a point field
+    for (int i = 0, bi = ion_buffer_offset_; i < n_ions_; i++)
+      for (int v = 0; v < N_EDVALS; v++, bi++)
+        data_[bi] += ed_ion_values_(i, v);
+  }
+}
+
+std::unique_ptr<OperatorEstBase> NEEnergyDensityEstimator::spawnCrowdClone() const
+{
+  auto spawn = std::make_unique<NEEnergyDensityEstimator>(*this, data_locality_);
+  spawn->get_data().resize(data_.size(), 0.0);
+  return spawn;
+}
+
+void NEEnergyDensityEstimator::registerOperatorEstimator(hdf_archive& file)
+{
+  hdf_path hdf_name{my_name_};
+  h5desc_.emplace_back(hdf_name / "variables");
+  auto& oh        = h5desc_.back();
+  int nparticles  = n_particles_;
+  int nspacegrids = spacegrids_.size();
+  oh.addProperty(nparticles, "nparticles", file);
+  oh.addProperty(nspacegrids, "nspacegrids", file);
+  if (n_ions_ > 0)
+  {
+    int nions = n_ions_;
+    oh.addProperty(nions, "nions", file);
+    oh.addProperty(r_ion_, "ion_positions", file);
+  }
+
+  ref_points_.save(h5desc_, file, hdf_name);
+
+  h5desc_.emplace_back(hdf_name / "outside");
+  h5desc_.back().set_dimensions({N_EDVALS}, outside_buffer_offset_);
+  for (int i = 0; i < spacegrids_.size(); i++)
+    spacegrids_[i].registerGrid(file, h5desc_, hdf_name, i);
+  if (n_ions_ > 0)
+  {
+    h5desc_.emplace_back(hdf_name / "ions");
+    h5desc_.back().set_dimensions({n_ions_, N_EDVALS}, ion_buffer_offset_);
+  }
+}
+
+void NEEnergyDensityEstimator::write_description(std::ostream& os) const
+{
+  const std::string indent = "    ";
+  os << "  EnergyDensityEstimator details" << std::endl;
+  os << indent + "nparticles  = " << n_particles_ << std::endl;
+  os << indent + "nspacegrids = " << spacegrids_.size() << std::endl;
+  ref_points_.write_description(os, indent);
+  for (auto& spacegrid : spacegrids_)
+    spacegrid.write_description(os, indent);
+  os << "  end EnergyDensityEstimator details" << std::endl;
+}
+
+} // namespace qmcplusplus
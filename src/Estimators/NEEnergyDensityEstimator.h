@@ -0,0 +1,127 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: EnergyDensityEstimator.h
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_NEENERGY_DENSITY_ESTIMATOR_H
+#define QMCPLUSPLUS_NEENERGY_DENSITY_ESTIMATOR_H
+
+#include <string>
+#include <unordered_map>
+#include "OperatorEstBase.h"
+#include "EnergyDensityInput.h"
+#include "NEReferencePoints.h"
+#include "NESpaceGrid.h"
+#include "QMCHamiltonians/Listener.hpp"
+
+namespace qmcplusplus
+{
+/** Batched driver version of the EnergyDensityEstimator
+ *
+ *  Per particle kinetic and local potential energies are reported to each crowd's estimator
+ *  by the crowd's lead QMCHamiltonian through listeners instead of the TraceManager.
+ *  Each step the weight, weighted kinetic and weighted potential energy of every particle
+ *  are binned into the spacegrids, particles outside of all grids into "outside" and with
+ *  ion_points the static particle values into "ions".
+ *
+ *  The data is crowd local and reduced to the rank estimator in collect.
+ */
+class NEEnergyDensityEstimator : public OperatorEstBase
+{
+public:
+  using Real        = QMCTraits::RealType;
+  using ParticlePos = PtclOnLatticeTraits::ParticlePos;
+  /// per operator name, per walker in the crowd, per particle values reported by the hamiltonian
+  using CrowdEnergyValues = std::unordered_map<std::string, std::vector<Vector<Real>>>;
+
+  /// energy density quantities accumulated per domain
+  enum
+  {
+    W = 0,
+    T,
+    V,
+    N_EDVALS
+  };
+
+  /** constructor
+   *  \param[in] edi           energy density input
+   *  \param[in] pset_dynamic  the golden electron particle set, the static particle set must be
+   *                           the source of one of its distance tables.
+   *  \param[in] dl            only DataLocality::crowd is supported
+   */
+  NEEnergyDensityEstimator(EnergyDensityInput&& edi,
+                           const ParticleSet& pset_dynamic,
+                           DataLocality dl = DataLocality::crowd);
+
+  /** Constructor used when spawing crowd clones
+   *  needs to be public so std::make_unique can call it.
+   */
+  NEEnergyDensityEstimator(const NEEnergyDensityEstimator& ede, DataLocality dl);
+
+  void accumulate(const RefVector<MCPWalker>& walkers,
+                  const RefVector<ParticleSet>& psets,
+                  const RefVector<TrialWaveFunction>& wfns,
+                  RandomGenerator& rng) override;
+
+  std::unique_ptr<OperatorEstBase> spawnCrowdClone() const override;
+
+  void startBlock(int steps) override {}
+
+  /** registers kinetic, local potential and local ion potential listeners
+   *  these must be registered separately since T and V are binned separately.
+   */
+  void registerListeners(QMCHamiltonian& ham_leader) override;
+
+  void registerOperatorEstimator(hdf_archive& file) override;
+
+  /** return lambda function to register as listener
+   *  the purpose of this function is to factor out the production of the lambda for unit testing
+   *  \param[out] values   the last values reported by each operator, summed over operators in accumulate
+   */
+  ListenerVector<Real>::ReportingFunction getListener(CrowdEnergyValues& values);
+
+  CrowdEnergyValues& get_kinetic_values() { return kinetic_values_; }
+  CrowdEnergyValues& get_local_pot_values() { return local_pot_values_; }
+  CrowdEnergyValues& get_local_ion_pot_values() { return local_ion_pot_values_; }
+  const std::vector<NESpaceGrid>& get_spacegrids() const { return spacegrids_; }
+  int get_outside_buffer_offset() const { return outside_buffer_offset_; }
+  int get_ion_buffer_offset() const { return ion_buffer_offset_; }
+
+  void write_description(std::ostream& os) const;
+
+private:
+  NEEnergyDensityEstimator(const NEEnergyDensityEstimator& ede) = default;
+
+  static const ParticleSet* findStaticParticleSet(const ParticleSet& pset_dynamic, const std::string& name);
+
+  EnergyDensityInput input_;
+  /// static particle set if any, i.e. the ions
+  const ParticleSet* pset_static_ = nullptr;
+  /// particles binned into the grids, dynamic + static unless ion_points
+  int n_particles_;
+  int n_ions_ = 0;
+  NEReferencePoints ref_points_;
+  std::vector<NESpaceGrid> spacegrids_;
+  int outside_buffer_offset_ = 0;
+  int ion_buffer_offset_     = 0;
+  Matrix<Real> r_ion_;
+
+  CrowdEnergyValues kinetic_values_;
+  CrowdEnergyValues local_pot_values_;
+  CrowdEnergyValues local_ion_pot_values_;
+
+  /// per walker scratch
+  ParticlePos r_work_;
+  Matrix<Real> ed_values_;
+  Matrix<Real> ed_ion_values_;
+  std::vector<bool> particles_outside_;
+};
+
+} // namespace qmcplusplus
+#endif
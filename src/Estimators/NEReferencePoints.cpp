@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: ReferencePoints.cpp
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "NEReferencePoints.h"
+
+namespace qmcplusplus
+{
+NEReferencePoints::NEReferencePoints(const std::optional<ReferencePointsInput>& rpi,
+                                     const ParticleSet& pset,
+                                     const RefVector<const ParticleSet>& ref_psets)
+{
+  constexpr int DIM = QMCTraits::DIM;
+  const auto& lattice = pset.getLattice();
+  //get axes and origin information from the ParticleSet
+  points_["zero"] = 0 * lattice.a(0);
+  points_["a1"]   = lattice.a(0);
+  points_["a2"]   = lattice.a(1);
+  points_["a3"]   = lattice.a(2);
+  //set points on face centers
+  points_["f1p"] = points_["zero"] + .5 * points_["a1"];
+  points_["f1m"] = points_["zero"] - .5 * points_["a1"];
+  points_["f2p"] = points_["zero"] + .5 * points_["a2"];
+  points_["f2m"] = points_["zero"] - .5 * points_["a2"];
+  points_["f3p"] = points_["zero"] + .5 * points_["a3"];
+  points_["f3m"] = points_["zero"] - .5 * points_["a3"];
+  //set points on cell corners
+  points_["cmmm"] = points_["zero"] + .5 * (-1 * points_["a1"] - points_["a2"] - points_["a3"]);
+  points_["cpmm"] = points_["zero"] + .5 * (points_["a1"] - points_["a2"] - points_["a3"]);
+  points_["cmpm"] = points_["zero"] + .5 * (-1 * points_["a1"] + points_["a2"] - points_["a3"]);
+  points_["cmmp"] = points_["zero"] + .5 * (-1 * points_["a1"] - points_["a2"] + points_["a3"]);
+  points_["cmpp"] = points_["zero"] + .5 * (-1 * points_["a1"] + points_["a2"] + points_["a3"]);
+  points_["cpmp"] = points_["zero"] + .5 * (points_["a1"] - points_["a2"] + points_["a3"]);
+  points_["cppm"] = points_["zero"] + .5 * (points_["a1"] + points_["a2"] - points_["a3"]);
+  points_["cppp"] = points_["zero"] + .5 * (points_["a1"] + points_["a2"] + points_["a3"]);
+  //get points from requested particle sets
+  for (const ParticleSet& ref_pset : ref_psets)
+    for (int p = 0; p < ref_pset.getTotalNum(); p++)
+      points_[ref_pset.getName() + std::to_string(p + 1)] = ref_pset.R[p];
+
+  if (!rpi)
+    return;
+  Tensor_t crd;
+  if (rpi->get_coord_form() == ReferencePointsInput::Coord::CELL)
+  {
+    for (int i = 0; i < DIM; i++)
+      for (int d = 0; d < DIM; d++)
+        crd(d, i) = lattice.a(i)[d];
+  }
+  else
+    crd.diagonal(1.0);
+  for (const auto& [label, point] : rpi->get_points())
+    points_[label] = dot(crd, point);
+}
+
+void NEReferencePoints::write_description(std::ostream& os, const std::string& indent) const
+{
+  os << indent + "reference_points" << std::endl;
+  for (const auto& [name, point] : points_)
+    os << indent + "  " << name << ": " << point << std::endl;
+  os << indent + "end reference_points" << std::endl;
+}
+
+void NEReferencePoints::save(std::vector<ObservableHelper>& h5desc, hdf_archive& file, const hdf_path& path) const
+{
+  h5desc.emplace_back(path / "reference_points");
+  auto& oh = h5desc.back();
+  for (auto& [label, point] : points_)
+    oh.addProperty(const_cast<Point&>(point), label, file);
+}
+
+} // namespace qmcplusplus
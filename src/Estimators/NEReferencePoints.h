@@ -0,0 +1,51 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: ReferencePoints.h
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_NEREFERENCE_POINTS_H
+#define QMCPLUSPLUS_NEREFERENCE_POINTS_H
+
+#include <optional>
+#include "Configuration.h"
+#include "Particle/ParticleSet.h"
+#include "QMCHamiltonians/ObservableHelper.h"
+#include "ReferencePointsInput.h"
+
+namespace qmcplusplus
+{
+/** Named points used to define the origin and axes of the batched SpaceGrids
+ *
+ *  Always contains the cell derived points (zero, a1-a3, face centers f1p..f3m, corners cmmm..cppp)
+ *  and the positions of the particles of the reference particle sets, i.e. ion01, ion02...
+ *  Points from a <reference_points> input are added on top of those.
+ */
+class NEReferencePoints
+{
+public:
+  using Real     = QMCTraits::RealType;
+  using Point    = ReferencePointsInput::Point;
+  using Points   = ReferencePointsInput::Points;
+  using Tensor_t = Tensor<Real, QMCTraits::DIM>;
+
+  NEReferencePoints(const std::optional<ReferencePointsInput>& rpi,
+                    const ParticleSet& pset,
+                    const RefVector<const ParticleSet>& ref_psets);
+
+  const Points& get_points() const { return points_; }
+  void write_description(std::ostream& os, const std::string& indent) const;
+  /// write the points as properties of path / "reference_points"
+  void save(std::vector<ObservableHelper>& h5desc, hdf_archive& file, const hdf_path& path) const;
+
+private:
+  Points points_;
+};
+
+} // namespace qmcplusplus
+#endif
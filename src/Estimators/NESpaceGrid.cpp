@@ -0,0 +1,347 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: SpaceGrid.cpp
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "NESpaceGrid.h"
+#include <cmath>
+#include "Message/UniformCommunicateError.h"
+
+namespace qmcplusplus
+{
+NESpaceGrid::NESpaceGrid(const SpaceGridInput& sgi,
+                         const Points& points,
+                         int nvalues,
+                         int buffer_offset,
+                         bool is_periodic)
+    : coord_form_(sgi.get_coord_form()),
+      nvalues_per_domain_(nvalues),
+      buffer_offset_(buffer_offset),
+      periodic_(is_periodic)
+{
+  if (sgi.get_periodic())
+    periodic_ = *sgi.get_periodic();
+  if (coord_form_ != CoordForm::CARTESIAN)
+    periodic_ = false;
+  initializeRectilinear(sgi, points);
+}
+
+void NESpaceGrid::initializeRectilinear(const SpaceGridInput& sgi, const Points& points)
+{
+  auto getPoint = [&points](const std::string& label) -> const Point& {
+    auto point_iter = points.find(label);
+    if (point_iter == points.end())
+      throw UniformCommunicateError("SpaceGrid: reference point " + label + " is not defined");
+    return point_iter->second;
+  };
+
+  const auto& origin = sgi.get_origin();
+  origin_ = getPoint(origin.p1) + origin.fraction * (getPoint(origin.p2) - getPoint(origin.p1));
+
+  const auto& axes       = sgi.get_axes();
+  const auto& axis_grids = sgi.get_axis_grids();
+  for (int iaxis = 0; iaxis < DIM; iaxis++)
+  {
+    const Point axis = axes[iaxis].scale * (getPoint(axes[iaxis].p1) - getPoint(axes[iaxis].p2));
+    for (int d = 0; d < DIM; d++)
+      axes_(d, iaxis) = axis[d];
+    axlabel_[iaxis]    = axes[iaxis].label;
+    gmap_[iaxis]       = axis_grids[iaxis].gmap;
+    odu_[iaxis]        = axis_grids[iaxis].odu;
+    umin_[iaxis]       = axis_grids[iaxis].umin;
+    umax_[iaxis]       = axis_grids[iaxis].umax;
+    dimensions_[iaxis] = axis_grids[iaxis].dimension;
+  }
+  axinv_ = inverse(axes_);
+
+  // C/Python style indexing
+  dm_[0]    = dimensions_[1] * dimensions_[2];
+  dm_[1]    = dimensions_[2];
+  dm_[2]    = 1;
+  ndomains_ = dimensions_[0] * dimensions_[1] * dimensions_[2];
+
+  //compute domain volumes, centers, and widths
+  domain_volumes_.resize(ndomains_, 1);
+  domain_centers_.resize(ndomains_, DIM);
+  domain_uwidths_.resize(ndomains_, DIM);
+  std::array<std::vector<Real>, DIM> interval_centers;
+  std::array<std::vector<Real>, DIM> interval_widths;
+  for (int d = 0; d < DIM; d++)
+  {
+    const auto& ndu_per_interval = axis_grids[d].ndu_per_interval;
+    const int nintervals         = ndu_per_interval.size();
+    interval_centers[d].resize(nintervals);
+    interval_widths[d].resize(nintervals);
+    interval_widths[d][0]  = ndu_per_interval[0] / odu_[d];
+    interval_centers[d][0] = interval_widths[d][0] / 2.0 + umin_[d];
+    for (int i = 1; i < nintervals; i++)
+    {
+      interval_widths[d][i]  = ndu_per_interval[i] / odu_[d];
+      interval_centers[d][i] = interval_centers[d][i - 1] + .5 * (interval_widths[d][i] + interval_widths[d][i - 1]);
+    }
+  }
+
+  // volume of a domain given its reduced center and widths, uc and du are transformed to angles in place
+  auto domainVolume = [coord_form = coord_form_](Point& uc, Point& du) -> Real {
+    switch (coord_form)
+    {
+    case CoordForm::CYLINDRICAL:
+      uc[1] = 2.0 * M_PI * uc[1] - M_PI;
+      du[1] = 2.0 * M_PI * du[1];
+      return uc[0] * du[0] * du[1] * du[2];
+    case CoordForm::SPHERICAL:
+      uc[1] = 2.0 * M_PI * uc[1] - M_PI;
+      du[1] = 2.0 * M_PI * du[1];
+      uc[2] = M_PI * uc[2];
+      du[2] = M_PI * du[2];
+      return (uc[0] * uc[0] + du[0] * du[0] / 12.0) * du[0] //r
+          * du[1]                                           //theta
+          * 2.0 * std::sin(uc[2]) * std::sin(.5 * du[2]);   //phi
+    default:
+      return du[0] * du[1] * du[2];
+    }
+  };
+
+  Point du, uc, ubc;
+  const Real vscale = std::abs(det(axes_));
+  for (int i = 0; i < dimensions_[0]; i++)
+    for (int j = 0; j < dimensions_[1]; j++)
+      for (int k = 0; k < dimensions_[2]; k++)
+      {
+        const int idomain = dm_[0] * i + dm_[1] * j + dm_[2] * k;
+        du                = {interval_widths[0][i], interval_widths[1][j], interval_widths[2][k]};
+        uc                = {interval_centers[0][i], interval_centers[1][j], interval_centers[2][k]};
+        const Real vol    = domainVolume(uc, du) * vscale;
+        switch (coord_form_)
+        {
+        case CoordForm::CYLINDRICAL:
+          ubc = {uc[0] * std::cos(uc[1]), uc[0] * std::sin(uc[1]), uc[2]};
+          break;
+        case CoordForm::SPHERICAL:
+          ubc = {uc[0] * std::sin(uc[2]) * std::cos(uc[1]), uc[0] * std::sin(uc[2]) * std::sin(uc[1]),
+                 uc[0] * std::cos(uc[2])};
+          break;
+        default:
+          ubc = uc;
+        }
+        const Point rc              = dot(axes_, ubc) + origin_;
+        domain_volumes_(idomain, 0) = vol;
+        for (int d = 0; d < DIM; d++)
+        {
+          domain_uwidths_(idomain, d) = du[d];
+          domain_centers_(idomain, d) = rc[d];
+        }
+      }
+
+  //find the actual volume of the grid
+  for (int d = 0; d < DIM; d++)
+  {
+    du[d] = umax_[d] - umin_[d];
+    uc[d] = .5 * (umax_[d] + umin_[d]);
+  }
+  volume_ = domainVolume(uc, du) * det(axes_);
+
+  if (!checkGrid())
+    throw UniformCommunicateError("SpaceGrid: cells do not map onto themselves");
+}
+
+void NESpaceGrid::computeDomainIndexes(const ParticlePos& R)
+{
+  const int nparticles = R.size();
+  for (int d = 0; d < DIM; d++)
+    u_[d].resize(nparticles);
+  domain_index_.resize(nparticles);
+
+  // reduced cartesian coordinates, ub = axinv.(r - origin)
+  for (int d = 0; d < DIM; d++)
+  {
+    Real* restrict ud = u_[d].data();
+    for (int p = 0; p < nparticles; p++)
+    {
+      Real ub = 0.0;
+      for (int k = 0; k < DIM; k++)
+        ub += axinv_(d, k) * (R[p][k] - origin_[k]);
+      ud[p] = ub;
+    }
+  }
+
+  constexpr Real o2pi = 1.0 / (2.0 * M_PI);
+  Real* restrict u0   = u_[0].data();
+  Real* restrict u1   = u_[1].data();
+  Real* restrict u2   = u_[2].data();
+  switch (coord_form_)
+  {
+  case CoordForm::CYLINDRICAL:
+    for (int p = 0; p < nparticles; p++)
+    {
+      const Real x = u0[p];
+      const Real y = u1[p];
+      u0[p]        = std::sqrt(x * x + y * y);
+      u1[p]        = std::atan2(y, x) * o2pi + .5;
+    }
+    break;
+  case CoordForm::SPHERICAL:
+    for (int p = 0; p < nparticles; p++)
+    {
+      const Real x = u0[p];
+      const Real y = u1[p];
+      const Real z = u2[p];
+      u0[p]        = std::sqrt(x * x + y * y + z * z);
+      u1[p]        = std::atan2(y, x) * o2pi + .5;
+      u2[p]        = std::acos(z / u0[p]) * o2pi * 2.0;
+    }
+    break;
+  default:
+    break;
+  }
+
+  std::fill(domain_index_.begin(), domain_index_.end(), 0);
+  for (int d = 0; d < DIM; d++)
+  {
+    const Real* restrict ud = u_[d].data();
+    const int* gmap         = gmap_[d].data();
+    const int gsize         = gmap_[d].size();
+    for (int p = 0; p < nparticles; p++)
+    {
+      const Real gu     = (ud[p] - umin_[d]) * odu_[d];
+      const bool inside = (periodic_ || (ud[p] > umin_[d] && ud[p] < umax_[d])) && gu >= 0 && gu < gsize;
+      const int iu      = inside ? static_cast<int>(gu) : 0;
+      domain_index_[p]  = (inside && domain_index_[p] >= 0) ? domain_index_[p] + dm_[d] * gmap[iu] : -1;
+    }
+  }
+}
+
+void NESpaceGrid::accumulate(const ParticlePos& R,
+                             const Matrix<Real>& values,
+                             std::vector<Real>& data,
+                             std::vector<bool>& particles_outside)
+{
+  computeDomainIndexes(R);
+  const int nparticles = values.rows();
+  const int nvalues    = values.cols();
+  for (int p = 0; p < nparticles; p++)
+  {
+    if (domain_index_[p] < 0)
+      continue;
+    particles_outside[p] = false;
+    Real* restrict domain_data = data.data() + buffer_offset_ + nvalues * domain_index_[p];
+    const Real* restrict vals  = values[p];
+    for (int v = 0; v < nvalues; v++)
+      domain_data[v] += vals[v];
+  }
+}
+
+void NESpaceGrid::sum(const std::vector<Real>& data, Real* vals) const
+{
+  for (int v = 0; v < nvalues_per_domain_; v++)
+    vals[v] = 0.0;
+  for (int i = 0, n = buffer_offset_; i < ndomains_; i++, n += nvalues_per_domain_)
+    for (int v = 0; v < nvalues_per_domain_; v++)
+      vals[v] += data[n + v];
+}
+
+bool NESpaceGrid::checkGrid()
+{
+  ParticlePos centers(ndomains_);
+  for (int i = 0; i < ndomains_; i++)
+    for (int d = 0; d < DIM; d++)
+      centers[i][d] = domain_centers_(i, d);
+  // the domain centers must be binned regardless of the periodicity of the grid
+  const bool periodic = periodic_;
+  periodic_           = false;
+  computeDomainIndexes(centers);
+  periodic_ = periodic;
+  bool ok   = true;
+  for (int i = 0; i < ndomains_; i++)
+    if (domain_index_[i] != i)
+    {
+      app_log() << "  cell mismatch " << i << " " << domain_index_[i] << std::endl;
+      ok = false;
+    }
+  return ok;
+}
+
+void NESpaceGrid::registerGrid(hdf_archive& file,
+                               std::vector<ObservableHelper>& h5desc,
+                               const hdf_path& path,
+                               int grid_index) const
+{
+  using iMatrix = Matrix<int>;
+  h5desc.emplace_back(path / ("spacegrid" + std::to_string(grid_index + 1)));
+  auto& oh = h5desc.back();
+  std::vector<int> ng(1, getDataSize());
+  oh.set_dimensions(ng, buffer_offset_);
+
+  int coord    = static_cast<int>(coord_form_);
+  int ndomains = ndomains_;
+  int nvalues  = nvalues_per_domain_;
+  Real volume  = volume_;
+  oh.addProperty(coord, "coordinate", file);
+  oh.addProperty(ndomains, "ndomains", file);
+  oh.addProperty(nvalues, "nvalues_per_domain", file);
+  oh.addProperty(volume, "volume", file);
+  oh.addProperty(const_cast<Matrix<Real>&>(domain_volumes_), "domain_volumes", file);
+  oh.addProperty(const_cast<Matrix<Real>&>(domain_centers_), "domain_centers", file);
+  oh.addProperty(const_cast<Point&>(origin_), "origin", file);
+  oh.addProperty(const_cast<Tensor<Real, DIM>&>(axes_), "axes", file);
+  oh.addProperty(const_cast<Tensor<Real, DIM>&>(axinv_), "axinv", file);
+  oh.addProperty(const_cast<Matrix<Real>&>(domain_uwidths_), "domain_uwidths", file);
+
+  //add dimensioned quantities
+  const std::map<std::string, int> axtmap{{"x", 0}, {"y", 1}, {"z", 2}, {"r", 3}, {"phi", 4}, {"theta", 5}};
+  iMatrix imat(DIM, 1);
+  for (int d = 0; d < DIM; d++)
+    imat(d, 0) = axtmap.at(axlabel_[d]);
+  oh.addProperty(imat, "axtypes", file);
+  for (int d = 0; d < DIM; d++)
+    imat(d, 0) = dimensions_[d];
+  oh.addProperty(imat, "dimensions", file);
+  for (int d = 0; d < DIM; d++)
+    imat(d, 0) = dm_[d];
+  oh.addProperty(imat, "dm", file);
+  Matrix<Real> rmat(DIM, 1);
+  for (auto& [rvar, rname] : {std::pair{&odu_, "odu"}, std::pair{&umin_, "umin"}, std::pair{&umax_, "umax"}})
+  {
+    for (int d = 0; d < DIM; d++)
+      rmat(d, 0) = (*rvar)[d];
+    oh.addProperty(rmat, rname, file);
+  }
+  for (int d = 0; d < DIM; d++)
+  {
+    iMatrix gmat(gmap_[d].size(), 1);
+    std::copy(gmap_[d].begin(), gmap_[d].end(), gmat.begin());
+    oh.addProperty(gmat, "gmap" + std::to_string(d + 1), file);
+  }
+}
+
+void NESpaceGrid::write_description(std::ostream& os, const std::string& indent) const
+{
+  const std::array<std::string, 3> coord_names{"cartesian", "cylindrical", "spherical"};
+  os << indent + "SpaceGrid" << std::endl;
+  os << indent + "  coordinates   = " + coord_names[static_cast<int>(coord_form_)] << std::endl;
+  os << indent + "  buffer_offset = " << buffer_offset_ << std::endl;
+  os << indent + "  ndomains      = " << ndomains_ << std::endl;
+  os << indent + "  axes  = " << axes_ << std::endl;
+  os << indent + "  axinv = " << axinv_ << std::endl;
+  for (int d = 0; d < DIM; d++)
+  {
+    os << indent + "  axis " << axlabel_[d] << ":" << std::endl;
+    os << indent + "    umin = " << umin_[d] << std::endl;
+    os << indent + "    umax = " << umax_[d] << std::endl;
+    os << indent + "    du   = " << 1.0 / odu_[d] << std::endl;
+    os << indent + "    dm   = " << dm_[d] << std::endl;
+    os << indent + "    gmap = ";
+    for (int g : gmap_[d])
+      os << g << " ";
+    os << std::endl;
+  }
+  os << indent + "end SpaceGrid" << std::endl;
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,116 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: SpaceGrid.h
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_NESPACEGRID_H
+#define QMCPLUSPLUS_NESPACEGRID_H
+
+#include <array>
+#include "Configuration.h"
+#include "OhmmsPETE/Tensor.h"
+#include "OhmmsPETE/OhmmsMatrix.h"
+#include "QMCHamiltonians/ObservableHelper.h"
+#include "SpaceGridInput.h"
+#include "NEReferencePoints.h"
+
+namespace qmcplusplus
+{
+/** Batched driver version of SpaceGrid
+ *
+ *  Only holds the geometry of the grid, the accumulated values live in the data of the owning
+ *  OperatorEstBase at [buffer_offset, buffer_offset + getDataSize()). Each crowd scope
+ *  estimator copies its grids so the scratch used to bin a walker's particles is crowd local.
+ *
+ *  Cartesian, cylindrical and spherical grids are supported, voronoi and particle number
+ *  resolved (chempot) grids are not.
+ */
+class NESpaceGrid
+{
+public:
+  using Real               = QMCTraits::RealType;
+  static constexpr int DIM = QMCTraits::DIM;
+  using Point              = TinyVector<Real, DIM>;
+  using Points             = NEReferencePoints::Points;
+  using ParticlePos        = PtclOnLatticeTraits::ParticlePos;
+  using CoordForm          = SpaceGridInput::CoordForm;
+
+  /** constructor
+   *  \param[in] sgi            spacegrid input
+   *  \param[in] points         named points the origin and axes of the input refer to
+   *  \param[in] nvalues        number of values accumulated per domain
+   *  \param[in] buffer_offset  start of the grid values in the owning estimator data
+   *  \param[in] is_periodic    periodicity of the particle set, may be overridden by the input for cartesian grids
+   */
+  NESpaceGrid(const SpaceGridInput& sgi, const Points& points, int nvalues, int buffer_offset, bool is_periodic);
+
+  int getDataSize() const { return nvalues_per_domain_ * ndomains_; }
+  int getBufferOffset() const { return buffer_offset_; }
+  int nDomains() const { return ndomains_; }
+  Real getVolume() const { return volume_; }
+  const Matrix<Real>& getDomainVolumes() const { return domain_volumes_; }
+  const Matrix<Real>& getDomainCenters() const { return domain_centers_; }
+
+  /** accumulate the values of each particle into the domain its position falls in
+   *
+   *  The domain index of every particle is computed first, one pass over all particles per
+   *  step of the coordinate transform, then the values are scattered into data.
+   *  \param[in]    R                  positions, one per row of values
+   *  \param[in]    values             nparticles x nvalues_per_domain
+   *  \param[inout] data               data of the owning estimator
+   *  \param[inout] particles_outside  set to false for the particles binned into this grid
+   */
+  void accumulate(const ParticlePos& R,
+                  const Matrix<Real>& values,
+                  std::vector<Real>& data,
+                  std::vector<bool>& particles_outside);
+
+  /// sum of the values over all domains of the grid
+  void sum(const std::vector<Real>& data, Real* vals) const;
+
+  void registerGrid(hdf_archive& file,
+                    std::vector<ObservableHelper>& h5desc,
+                    const hdf_path& path,
+                    int grid_index) const;
+  void write_description(std::ostream& os, const std::string& indent) const;
+
+private:
+  void initializeRectilinear(const SpaceGridInput& sgi, const Points& points);
+  /// domain index of the particles in domain_index_, -1 for those outside the grid
+  void computeDomainIndexes(const ParticlePos& R);
+  bool checkGrid();
+
+  CoordForm coord_form_;
+  int nvalues_per_domain_;
+  int buffer_offset_;
+  int ndomains_ = 0;
+  bool periodic_;
+
+  Point origin_;
+  Tensor<Real, DIM> axes_;
+  Tensor<Real, DIM> axinv_;
+  Real volume_ = 0.0;
+  Matrix<Real> domain_volumes_;
+  Matrix<Real> domain_centers_;
+  Matrix<Real> domain_uwidths_;
+  std::array<std::string, DIM> axlabel_;
+  std::array<std::vector<int>, DIM> gmap_;
+  std::array<Real, DIM> odu_;
+  std::array<Real, DIM> umin_;
+  std::array<Real, DIM> umax_;
+  std::array<int, DIM> dimensions_;
+  std::array<int, DIM> dm_;
+
+  /// reduced coordinates of the particles, one contiguous array per dimension
+  std::array<std::vector<Real>, DIM> u_;
+  std::vector<int> domain_index_;
+};
+
+} // namespace qmcplusplus
+#endif
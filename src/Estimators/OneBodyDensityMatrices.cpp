@@ -19,6 +19,8 @@
 #include "Utilities/string_utils.h"
 #include "type_traits/complex_help.hpp"
 #include "Concurrency/OpenMP.h"
+#include "QMCHamiltonians/NLPPJob.h"
+#include "type_traits/template_types.hpp"
 
 namespace qmcplusplus
 {
@@ -407,10 +409,208 @@ void OneBodyDensityMatrices::implAccumulate(const RefVector<MCPWalker>& walkers,
                                             const RefVector<TrialWaveFunction>& wfns,
                                             RNG_GEN& rng)
 {
-  for (int iw = 0; iw < walkers.size(); ++iw)
+  const size_t nw = walkers.size();
+  if (nw == 0)
+    return;
+  resizeCrowdWorkspace(psets);
+
+  // samples are drawn walker by walker in the same order as evaluateMatrix would draw them
+  for (int iw = 0; iw < nw; ++iw)
   {
-    walkers_weight_ += walkers[iw].get().Weight;
-    evaluateMatrix(psets[iw], wfns[iw], walkers[iw], rng);
+    const MCPWalker& walker = walkers[iw];
+    walkers_weight_ += walker.Weight;
+    warmupSampling(psets[iw], rng);
+    generateSamples(walker.Weight * metric_, psets[iw], rng);
+    std::copy(rsamples_.begin(), rsamples_.end(), mw_rsamples_[iw].begin());
+    std::copy(samples_weights_.begin(), samples_weights_.end(), mw_samples_weights_[iw]);
+  }
+
+  RefVectorWithLeader<ParticleSet> p_list(psets[0], psets);
+  RefVectorWithLeader<TrialWaveFunction> wf_list(wfns[0], wfns);
+  RefVectorWithLeader<VirtualParticleSet> vp_list(*crowd_vps_.sets[0]);
+  vp_list.reserve(nw);
+  for (int iw = 0; iw < nw; ++iw)
+    vp_list.push_back(*crowd_vps_.sets[iw]);
+  ResourceCollectionTeamLock<VirtualParticleSet> vp_res_lock(*crowd_vps_.resources, vp_list);
+  RefVectorWithLeader<SPOSet> basis_list(*crowd_vps_.basis_sets[0]);
+  basis_list.reserve(nw);
+  for (int iw = 0; iw < nw; ++iw)
+    basis_list.push_back(*crowd_vps_.basis_sets[iw]);
+  ResourceCollectionTeamLock<SPOSet> basis_res_lock(*crowd_vps_.basis_resources, basis_list);
+
+  mw_generateSampleBasis(basis_list, p_list, vp_list);
+  mw_generateSampleRatios(p_list, wf_list, vp_list);
+  mw_generateParticleBasis(basis_list, p_list);
+
+  // perform the integration of the whole crowd, one GEMM per walker for the samples
+  // and one GEMM over all the walkers' particles for the basis_size^2 contributions.
+  {
+    ScopedTimer local_timer(timers_.matrix_products_timer);
+    for (int s = 0; s < species_.size(); ++s)
+    {
+      const int specs_size = species_sizes_[s];
+      for (int iw = 0; iw < nw; ++iw)
+      {
+        Matrix<Value>& Psi_nm = mw_Psi_NM_[iw][s];
+        const Vector<Real> weights(mw_samples_weights_[iw], samples_);
+        Matrix<Value> Phi_Psi_nb(mw_Phi_Psi_NB_[s][iw * specs_size], specs_size, basis_size_);
+        diag_product(Psi_nm, weights, Psi_nm);
+        product(Psi_nm, mw_Phi_MB_[iw], Phi_Psi_nb); // ratio*basis : particles x basis_size
+      }
+      product_AtB(mw_Phi_NB_[s], mw_Phi_Psi_NB_[s], N_BB_[s]); // conj(basis)^T*ratio*basis : basis_size^2
+    }
+  }
+  accumulateNumberMatrices();
+}
+
+void OneBodyDensityMatrices::resizeCrowdWorkspace(const RefVector<ParticleSet>& psets)
+{
+  const size_t nw = psets.size();
+  auto& vps       = crowd_vps_;
+  bool same_psets = vps.ref_psets.size() == nw;
+  for (int iw = 0; same_psets && iw < nw; ++iw)
+    same_psets = vps.ref_psets[iw] == &psets[iw].get();
+  if (same_psets)
+    return;
+
+  // the virtual particle sets compute their distance tables against the particle set they are built from
+  vps.sets.clear();
+  vps.ref_psets.clear();
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    vps.sets.push_back(std::make_unique<VirtualParticleSet>(psets[iw], samples_));
+    vps.ref_psets.push_back(&psets[iw].get());
+  }
+  vps.resources = std::make_unique<ResourceCollection>("OneBodyDensityMatrices::VirtualParticleSet");
+  vps.sets[0]->createResource(*vps.resources);
+  vps.basis_sets.clear();
+  for (int iw = 0; iw < nw; ++iw)
+    vps.basis_sets.push_back(basis_functions_.makeClone());
+  vps.basis_resources = std::make_unique<ResourceCollection>("OneBodyDensityMatrices::basis");
+  vps.basis_sets[0]->createResource(*vps.basis_resources);
+
+  const int nspecies = species_.size();
+  mw_rsamples_.resize(nw, std::vector<Position>(samples_));
+  mw_deltas_.resize(nw, std::vector<Position>(samples_));
+  mw_samples_weights_.resize(nw, samples_);
+  mw_basis_values_.resize(nw, Vector<Value>(basis_size_));
+  mw_ratios_.resize(nw, std::vector<Value>(samples_));
+  mw_Phi_MB_.resize(nw, Matrix<Value>(samples_, basis_size_));
+  mw_Psi_NM_.resize(nw);
+  for (auto& Psi_NM : mw_Psi_NM_)
+  {
+    Psi_NM.clear();
+    for (int s = 0; s < nspecies; ++s)
+      Psi_NM.emplace_back(species_sizes_[s], samples_);
+  }
+  mw_Phi_NB_.clear();
+  mw_Phi_Psi_NB_.clear();
+  for (int s = 0; s < nspecies; ++s)
+  {
+    mw_Phi_NB_.emplace_back(nw * species_sizes_[s], basis_size_);
+    mw_Phi_Psi_NB_.emplace_back(nw * species_sizes_[s], basis_size_);
+  }
+  N_BB_.resize(nspecies, Matrix<Value>(basis_size_, basis_size_));
+}
+
+void OneBodyDensityMatrices::mw_generateSampleBasis(const RefVectorWithLeader<SPOSet>& basis_list,
+                                                    const RefVectorWithLeader<ParticleSet>& p_list,
+                                                    const RefVectorWithLeader<VirtualParticleSet>& vp_list)
+{
+  ScopedTimer local_timer(timers_.gen_sample_basis_timer);
+  const size_t nw = p_list.size();
+  std::vector<NLPPJob<Real>> jobs;
+  jobs.reserve(nw);
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    const Position& r0 = p_list[iw].R[0];
+    for (int m = 0; m < samples_; ++m)
+      mw_deltas_[iw][m] = mw_rsamples_[iw][m] - r0;
+    jobs.emplace_back(-1, 0, 0, Position());
+  }
+  VirtualParticleSet::mw_makeMoves(vp_list, p_list, makeRefVector<const std::vector<Position>>(mw_deltas_),
+                                   makeRefVector<const NLPPJob<Real>>(jobs), false);
+
+  RefVectorWithLeader<ParticleSet> vp_p_list(vp_list.getLeader());
+  vp_p_list.reserve(nw);
+  for (int iw = 0; iw < nw; ++iw)
+    vp_p_list.push_back(vp_list[iw]);
+  const auto values_list = makeRefVector<Vector<Value>>(mw_basis_values_);
+  for (int m = 0; m < samples_; ++m)
+  {
+    basis_list.getLeader().mw_evaluateValue(basis_list, vp_p_list, m, values_list);
+    for (int iw = 0; iw < nw; ++iw)
+    {
+      const Vector<Value>& values = mw_basis_values_[iw];
+      Value* row                  = mw_Phi_MB_[iw][m];
+      for (int b = 0; b < basis_size_; ++b)
+        row[b] = values[b] * basis_norms_[b];
+    }
+  }
+}
+
+void OneBodyDensityMatrices::mw_generateSampleRatios(const RefVectorWithLeader<ParticleSet>& p_list,
+                                                     const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                                                     const RefVectorWithLeader<VirtualParticleSet>& vp_list)
+{
+  ScopedTimer local_timer(timers_.gen_sample_ratios_timer);
+  const size_t nw = p_list.size();
+  RefVectorWithLeader<const VirtualParticleSet> const_vp_list(vp_list.getLeader());
+  const_vp_list.reserve(nw);
+  for (int iw = 0; iw < nw; ++iw)
+    const_vp_list.push_back(vp_list[iw]);
+  const auto ratios_list = makeRefVector<std::vector<Value>>(mw_ratios_);
+
+  std::vector<NLPPJob<Real>> jobs;
+  jobs.reserve(nw);
+  int p = 0;
+  for (int s = 0; s < species_.size(); ++s)
+    for (int n = 0; n < species_sizes_[s]; ++n, ++p)
+    {
+      // move particle p of every walker to all of the walker's samples
+      jobs.clear();
+      for (int iw = 0; iw < nw; ++iw)
+      {
+        const Position& rp = p_list[iw].R[p];
+        for (int m = 0; m < samples_; ++m)
+          mw_deltas_[iw][m] = mw_rsamples_[iw][m] - rp;
+        jobs.emplace_back(-1, p, 0, Position());
+      }
+      VirtualParticleSet::mw_makeMoves(vp_list, p_list, makeRefVector<const std::vector<Position>>(mw_deltas_),
+                                       makeRefVector<const NLPPJob<Real>>(jobs), false);
+      TrialWaveFunction::mw_evaluateRatios(wf_list, const_vp_list, ratios_list);
+
+      for (int iw = 0; iw < nw; ++iw)
+      {
+        Matrix<Value>& P_nm = mw_Psi_NM_[iw][s];
+        for (int m = 0; m < samples_; ++m)
+          P_nm(n, m) = qmcplusplus::conj(mw_ratios_[iw][m]);
+      }
+    }
+}
+
+void OneBodyDensityMatrices::mw_generateParticleBasis(const RefVectorWithLeader<SPOSet>& basis_list,
+                                                      const RefVectorWithLeader<ParticleSet>& p_list)
+{
+  ScopedTimer local_timer(timers_.gen_particle_basis_timer);
+  const size_t nw        = p_list.size();
+  const auto values_list = makeRefVector<Vector<Value>>(mw_basis_values_);
+  int p                  = 0;
+  for (int s = 0; s < species_.size(); ++s)
+  {
+    Matrix<Value>& P_nb = mw_Phi_NB_[s];
+    for (int n = 0; n < species_sizes_[s]; ++n, ++p)
+    {
+      // the particles are at rest, the basis is evaluated from their distance table rows
+      basis_list.getLeader().mw_evaluateValue(basis_list, p_list, p, values_list);
+      for (int iw = 0; iw < nw; ++iw)
+      {
+        const Vector<Value>& values = mw_basis_values_[iw];
+        Value* row                  = P_nb[iw * species_sizes_[s] + n];
+        for (int b = 0; b < basis_size_; ++b)
+          row[b] = qmcplusplus::conj(values[b] * basis_norms_[b]);
+      }
+    }
   }
 }
 
@@ -447,24 +647,27 @@ void OneBodyDensityMatrices::evaluateMatrix(ParticleSet& pset_target,
     }
   }
   // accumulate data for this walker
+  accumulateNumberMatrices();
+}
+
+void OneBodyDensityMatrices::accumulateNumberMatrices()
+{
+  ScopedTimer local_timer(timers_.accumulate_timer);
+  const int basis_size_sq = basis_size_ * basis_size_;
+  int ij                  = 0;
+  for (int s = 0; s < species_.size(); ++s)
   {
-    ScopedTimer local_timer(timers_.accumulate_timer);
-    const int basis_size_sq = basis_size_ * basis_size_;
-    int ij                  = 0;
-    for (int s = 0; s < species_.size(); ++s)
+    //int ij=nindex; // for testing
+    const Matrix<Value>& NDM = N_BB_[s];
+    for (int n = 0; n < basis_size_sq; ++n)
     {
-      //int ij=nindex; // for testing
-      const Matrix<Value>& NDM = N_BB_[s];
-      for (int n = 0; n < basis_size_sq; ++n)
-      {
-        Value val = NDM(n);
-        data_[ij] += real(val);
-        ij++;
+      Value val = NDM(n);
+      data_[ij] += real(val);
+      ij++;
 #if defined(QMC_COMPLEX)
-        data_[ij] += imag(val);
-        ij++;
+      data_[ij] += imag(val);
+      ij++;
 #endif
-      }
     }
   }
 }
@@ -636,7 +839,7 @@ template void OneBodyDensityMatrices::implAccumulate<RandomGenerator>(const RefV
                                                                       const RefVector<ParticleSet>& psets,
                                                                       const RefVector<TrialWaveFunction>& wfns,
                                                                       RandomGenerator& rng);
-#if defined(USE_FAKE_RNG) || defined(QMC_RNG_BOOST)
+#if defined(USE_FAKE_RNG) || defined(QMC_RNG_BOOST) || defined(QMC_RNG_PHILOX)
 template void OneBodyDensityMatrices::generateSamples<StdRandom<double>>(Real weight,
                                                                          ParticleSet& pset_target,
                                                                          StdRandom<double>& rng,
@@ -22,6 +22,8 @@
 #include "QMCWaveFunctions/SPOSetBuilderFactory.h"
 #include "OneBodyDensityMatricesInput.h"
 #include "OhmmsPETE/OhmmsMatrix.h"
+#include "Particle/VirtualParticleSet.h"
+#include "ResourceCollection.h"
 #include <SpeciesSet.h>
 #include <StdRandom.h>
 
@@ -122,6 +124,44 @@ private:
   Matrix<Value> Phi_MB_;
   /** @} */
 
+  /** @ingroup CrowdWorkspace batched accumulation over the walkers of a crowd
+   *  @{ */
+  /** one VirtualParticleSet per walker of the crowd, each holds all the integration samples of its walker,
+   *  and one clone of the basis per walker for the batched basis evaluation.
+   *  The sets are built against the crowd's particle sets on first use, copies start empty.
+   */
+  struct CrowdVirtualParticleSets
+  {
+    std::vector<std::unique_ptr<VirtualParticleSet>> sets;
+    std::vector<const ParticleSet*> ref_psets;
+    std::unique_ptr<ResourceCollection> resources;
+    std::vector<std::unique_ptr<SPOSet>> basis_sets;
+    std::unique_ptr<ResourceCollection> basis_resources;
+
+    CrowdVirtualParticleSets() = default;
+    CrowdVirtualParticleSets(const CrowdVirtualParticleSets&) {}
+  };
+  CrowdVirtualParticleSets crowd_vps_;
+  /// integration samples of each walker
+  std::vector<std::vector<Position>> mw_rsamples_;
+  /// displacements of the samples from the reference particle of each walker
+  std::vector<std::vector<Position>> mw_deltas_;
+  /// sample weights, row: walker col: sample
+  Matrix<Real> mw_samples_weights_;
+  /// ratios of the virtual moves of each walker
+  std::vector<std::vector<Value>> mw_ratios_;
+  /// unnormalized basis values of each walker at one position
+  std::vector<Vector<Value>> mw_basis_values_;
+  /// basis values at the samples of each walker, vector is over walkers, each matrix row: sample col: basis_value
+  std::vector<Matrix<Value>> mw_Phi_MB_;
+  /// conj(Psi ratio), vector is over walkers then species, each matrix row: particle col: sample
+  std::vector<std::vector<Matrix<Value>>> mw_Psi_NM_;
+  /** conj(basis_values) and ratio weighted sample basis of all the walkers stacked by rows
+   *  vector is over species, each matrix row: walker * species size + particle col: basis_value
+   */
+  std::vector<Matrix<Value>> mw_Phi_NB_, mw_Phi_Psi_NB_;
+  /** @} */
+
   /** @ingroup DensityIntegration only used for density integration
    *  @{
    */
@@ -202,6 +242,31 @@ private:
   void report(const std::string& pad = "");
   template<class RNG_GEN>
   void evaluateMatrix(ParticleSet& pset_target, TrialWaveFunction& psi_target, const MCPWalker& walker, RNG_GEN& rng);
+  /// add N_BB_ of all the species to data_
+  void accumulateNumberMatrices();
+  //  batched evaluation over the walkers of a crowd
+  /** size the crowd workspace and build the virtual particle sets when the crowd's particle sets change
+   */
+  void resizeCrowdWorkspace(const RefVector<ParticleSet>& psets);
+  /** set mw_Phi_MB_ to the basis values at the samples of each walker
+   *  the virtual particles of every walker are moved onto its samples once and the basis of the whole crowd
+   *  is evaluated there by one SPOSet::mw_evaluateValue per sample, the target particle sets are not touched.
+   */
+  void mw_generateSampleBasis(const RefVectorWithLeader<SPOSet>& basis_list,
+                              const RefVectorWithLeader<ParticleSet>& p_list,
+                              const RefVectorWithLeader<VirtualParticleSet>& vp_list);
+  /** set mw_Psi_NM_ to conj(ratio) of moving each particle to each sample
+   *  for every particle the virtual particles of all the walkers are moved and the ratios
+   *  of the whole crowd are computed by one TrialWaveFunction::mw_evaluateRatios.
+   */
+  void mw_generateSampleRatios(const RefVectorWithLeader<ParticleSet>& p_list,
+                               const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                               const RefVectorWithLeader<VirtualParticleSet>& vp_list);
+  /** set mw_Phi_NB_ to conj(basis_values) at the particles of each walker
+   *  the basis of the whole crowd is evaluated by one SPOSet::mw_evaluateValue per particle
+   */
+  void mw_generateParticleBasis(const RefVectorWithLeader<SPOSet>& basis_list,
+                                const RefVectorWithLeader<ParticleSet>& p_list);
   //  sample generation
   /** Dispatch method to difference methods of generating samples.
    *  dispatch determined by Integrator.
@@ -332,7 +397,7 @@ extern template void OneBodyDensityMatrices::implAccumulate<RandomGenerator>(con
                                                                              const RefVector<ParticleSet>& psets,
                                                                              const RefVector<TrialWaveFunction>& wfns,
                                                                              RandomGenerator& rng);
-#if defined(USE_FAKE_RNG) || defined(QMC_RNG_BOOST)
+#if defined(USE_FAKE_RNG) || defined(QMC_RNG_BOOST) || defined(QMC_RNG_PHILOX)
 extern template void OneBodyDensityMatrices::generateSamples<StdRandom<double>>(Real weight,
                                                                                 ParticleSet& pset_target,
                                                                                 StdRandom<double>& rng,
@@ -39,6 +39,18 @@ void OperatorEstBase::normalize(QMCT::RealType invTotWgt)
     elem *= invTotWgt;
 }
 
+void OperatorEstBase::setOutputLayout(int blocks_per_write, int compression_level, bool use_zstd)
+{
+  for (auto& h5d : h5desc_)
+    h5d.set_output_layout(blocks_per_write, compression_level, use_zstd);
+}
+
+void OperatorEstBase::flushWrites(hdf_archive& file)
+{
+  for (auto& h5d : h5desc_)
+    h5d.flush(file);
+}
+
 void OperatorEstBase::write(hdf_archive& file)
 {
   if (h5desc_.empty())
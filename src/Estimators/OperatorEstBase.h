@@ -99,6 +99,13 @@ public:
    */
   virtual void registerOperatorEstimator(hdf_archive& file) {}
 
+  /** open the files an estimator writes besides stat.h5, called on every rank at the start of a driver run
+   * @param file_root project id and series of the run, also the root of stat.h5
+   *
+   * The default implementation does nothing.
+   */
+  virtual void openOutput(const std::string& file_root) {}
+
   virtual std::unique_ptr<OperatorEstBase> spawnCrowdClone() const = 0;
 
   /** Write to previously registered observable_helper hdf5 wrapper.
@@ -108,6 +115,15 @@ public:
    */
   void write(hdf_archive& file);
 
+  /** set the stat.h5 layout of the registered observable_helpers, see ObservableHelper::set_output_layout
+   *  call after registerOperatorEstimator.
+   */
+  void setOutputLayout(int blocks_per_write, int compression_level, bool use_zstd);
+
+  /** append block results still buffered by the observable_helpers
+   */
+  void flushWrites(hdf_archive& file);
+
   /** zero data appropriately for the DataLocality
    */
   void zero();
@@ -141,6 +157,7 @@ protected:
    *  DataLocality::Rank,  This estimator has the full representation of the data but its crowd spawn will have
    *  One per crowd:
    *  DataLocality::Queue  This estimator accumulates queue of values to collect to the Rank estimator data
+   *                       for gridded estimators these are the touched blocks of a SparseBlockAccumulator
    *  DataLocality::?      Another way to reduce memory use on thread/crowd local estimators.
    */
   DataLocality data_locality_;
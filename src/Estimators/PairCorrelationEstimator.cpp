@@ -0,0 +1,184 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: PairCorrEstimator.cpp
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "PairCorrelationEstimator.h"
+#include <cmath>
+#include "Particle/DistanceTable.h"
+
+namespace qmcplusplus
+{
+PairCorrelationEstimator::PairCorrelationEstimator(PairCorrelationInput&& pci, ParticleSet& pset, DataLocality dl)
+    : OperatorEstBase(dl),
+      input_(std::move(pci)),
+      d_aa_id_(pset.addTable(pset, DTModes::NEED_FULL_TABLE_ON_HOST_AFTER_DONEPBYP)),
+      num_species_(pset.groups()),
+      num_pairs_(num_species_ * (num_species_ + 1) / 2)
+{
+  my_name_ = input_.get_name();
+  if (data_locality_ != DataLocality::crowd)
+    throw std::runtime_error("PairCorrelationEstimator only supports DataLocality::crowd");
+
+  // use the simulation cell radius if any direction is periodic
+  const auto& lattice = pset.getLattice();
+  Real volume         = 1.0;
+  rmax_               = 10.0;
+  if (lattice.SuperCellEnum)
+  {
+    rmax_  = lattice.WignerSeitzRadius;
+    volume = lattice.Volume;
+  }
+  if (input_.get_rmax())
+    rmax_ = *input_.get_rmax();
+  if (input_.get_num_bin())
+    num_bins_ = *input_.get_num_bin();
+  else
+    num_bins_ = static_cast<int>(std::ceil(rmax_ / input_.get_dr()));
+  delta_     = rmax_ / static_cast<Real>(num_bins_);
+  delta_inv_ = 1.0 / delta_;
+
+  const auto& species = pset.getSpeciesSet();
+  std::vector<int> species_size(num_species_);
+  for (int i = 0; i < num_species_; ++i)
+    species_size[i] = pset.groupsize(i);
+  pair_names_.resize(num_pairs_);
+  for (int i = 0; i < num_species_; ++i)
+    for (int j = i; j < num_species_; ++j)
+      pair_names_[gen_pair_id(i, j, num_species_)] = species.speciesName[i] + "_" + species.speciesName[j];
+  setNormFactor(species_size, volume);
+
+  data_.resize(num_pairs_ * num_bins_, 0.0);
+  bin_index_.resize(pset.getTotalNum());
+  pair_counts_.resize(num_pairs_ * (num_bins_ + 1));
+}
+
+PairCorrelationEstimator::PairCorrelationEstimator(const PairCorrelationEstimator& pce, DataLocality dl)
+    : PairCorrelationEstimator(pce)
+{
+  data_locality_ = dl;
+}
+
+// The value should match the index to norm_factor in setNormFactor
+int PairCorrelationEstimator::gen_pair_id(const int ig, const int jg, const int ns)
+{
+  if (jg < ig)
+    return ns * (ns - 1) / 2 - (ns - jg) * (ns - jg - 1) / 2 + ig;
+  else
+    return ns * (ns - 1) / 2 - (ns - ig) * (ns - ig - 1) / 2 + jg;
+}
+
+void PairCorrelationEstimator::setNormFactor(const std::vector<int>& species_size, Real volume)
+{
+  /* The normalization is V/Npairs/Nid, with
+     V the volume of the system
+     Npairs the number of (unique) pairs of particles of given types
+     Nid the number of particles expected for a uniformly random distribution
+     with the same number density
+  */
+  norm_factor_.resize(num_pairs_, num_bins_);
+  constexpr Real ftpi = 4. / 3 * M_PI;
+  for (int ib = 0; ib < num_bins_; ++ib)
+  {
+    const Real r = static_cast<Real>(ib) * delta_;
+    // Volume of spherical shell of thickness delta_
+    const Real bin_volume = ftpi * (std::pow(r + delta_, 3) - std::pow(r, 3));
+    for (int m = 0; m < num_species_; ++m)
+      for (int n = m; n < num_species_; ++n)
+      {
+        const Real nm     = species_size[m];
+        const Real nn     = species_size[n];
+        const Real npairs = (m == n) ? nn * (nn - 1) / 2. : nn * nm;
+        // Expected number of pairs separated by r for uniformly randomly distributed particles
+        const Real nid = npairs / volume * bin_volume;
+        norm_factor_(gen_pair_id(m, n, num_species_), ib) = (npairs > 0) ? 1. / nid : 0.0;
+      }
+  }
+}
+
+std::unique_ptr<OperatorEstBase> PairCorrelationEstimator::spawnCrowdClone() const
+{
+  auto spawn = std::make_unique<PairCorrelationEstimator>(*this, data_locality_);
+  spawn->get_data().resize(data_.size(), 0.0);
+  return spawn;
+}
+
+void PairCorrelationEstimator::accumulate(const RefVector<MCPWalker>& walkers,
+                                          const RefVector<ParticleSet>& psets,
+                                          const RefVector<TrialWaveFunction>& wfns,
+                                          RandomGenerator& rng)
+{
+  const int hist_stride = num_bins_ + 1;
+  for (int iw = 0; iw < walkers.size(); ++iw)
+  {
+    MCPWalker& walker       = walkers[iw];
+    const ParticleSet& pset = psets[iw];
+    const Real weight       = walker.Weight;
+    walkers_weight_ += weight;
+
+    std::fill(pair_counts_.begin(), pair_counts_.end(), 0);
+    const auto& dii = pset.getDistTableAA(d_aa_id_);
+    for (int iat = 1; iat < dii.centers(); ++iat)
+    {
+      const Real* restrict dist = dii.getDistRow(iat).data();
+      int* restrict loc         = bin_index_.data();
+      const Real rmax           = rmax_;
+      const Real delta_inv      = delta_inv_;
+      const int overflow_bin    = num_bins_;
+#pragma omp simd
+      for (int j = 0; j < iat; ++j)
+        loc[j] = (dist[j] < rmax) ? static_cast<int>(delta_inv * dist[j]) : overflow_bin;
+
+      // particles are grouped by species so each species of j is a contiguous range
+      const int ig = pset.getGroupID(iat);
+      for (int jg = 0; jg < num_species_; ++jg)
+      {
+        int* restrict counts = pair_counts_.data() + gen_pair_id(ig, jg, num_species_) * hist_stride;
+        const int j_end      = std::min(pset.last(jg), iat);
+        for (int j = pset.first(jg); j < j_end; ++j)
+          ++counts[loc[j]];
+      }
+    }
+
+    for (int ip = 0; ip < num_pairs_; ++ip)
+    {
+      const int* restrict counts = pair_counts_.data() + ip * hist_stride;
+      const Real* restrict norm  = norm_factor_[ip];
+      Real* restrict gofr        = data_.data() + ip * num_bins_;
+      for (int ib = 0; ib < num_bins_; ++ib)
+        gofr[ib] += weight * norm[ib] * counts[ib];
+    }
+  }
+}
+
+void PairCorrelationEstimator::registerOperatorEstimator(hdf_archive& file)
+{
+  hdf_path hdf_name{my_name_};
+  std::vector<int> ng(1, num_bins_);
+  for (int ip = 0; ip < num_pairs_; ++ip)
+  {
+    h5desc_.emplace_back(hdf_name / pair_names_[ip]);
+    auto& oh = h5desc_.back();
+    oh.set_dimensions(ng, ip * num_bins_);
+    oh.addProperty(delta_, "delta", file);
+    oh.addProperty(rmax_, "cutoff", file);
+  }
+}
+
+void PairCorrelationEstimator::report(const std::string& pad) const
+{
+  app_log() << pad << "PairCorrelationEstimator report" << std::endl;
+  app_log() << pad << "  num_species = " << num_species_ << std::endl;
+  app_log() << pad << "  rmax        = " << rmax_ << std::endl;
+  app_log() << pad << "  num_bins    = " << num_bins_ << std::endl;
+  app_log() << pad << "  delta       = " << delta_ << std::endl;
+  app_log() << pad << "end PairCorrelationEstimator report" << std::endl;
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,95 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: PairCorrEstimator.h
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_PAIR_CORRELATION_ESTIMATOR_H
+#define QMCPLUSPLUS_PAIR_CORRELATION_ESTIMATOR_H
+
+#include "OperatorEstBase.h"
+#include "PairCorrelationInput.h"
+#include "OhmmsPETE/OhmmsMatrix.h"
+
+namespace qmcplusplus
+{
+/** Batched driver version of the PairCorrEstimator, g(r) for each pair of species of the target particle set
+ *
+ *  Pair distances are read from the AA distance table. For each walker the bin of every pair
+ *  of a distance table row is computed in one vectorizable pass, then the pairs are counted
+ *  into a walker histogram per species pair. The histogram is normalized and weighted once
+ *  per walker into the crowd's data, crowds are reduced by the default collect.
+ *
+ *  Source particle sets (AB tables) are not supported.
+ */
+class PairCorrelationEstimator : public OperatorEstBase
+{
+public:
+  using Real = QMCTraits::RealType;
+
+  /** constructor
+   *  \param[in]    pci   input
+   *  \param[inout] pset  the golden electron particle set, the AA distance table is requested from it
+   *                      so it must be constructed before the walker particle sets are cloned.
+   *  \param[in]    dl    only DataLocality::crowd is supported
+   */
+  PairCorrelationEstimator(PairCorrelationInput&& pci, ParticleSet& pset, DataLocality dl = DataLocality::crowd);
+
+  /** Constructor used when spawing crowd clones
+   *  needs to be public so std::make_unique can call it.
+   */
+  PairCorrelationEstimator(const PairCorrelationEstimator& pce, DataLocality dl);
+
+  void accumulate(const RefVector<MCPWalker>& walkers,
+                  const RefVector<ParticleSet>& psets,
+                  const RefVector<TrialWaveFunction>& wfns,
+                  RandomGenerator& rng) override;
+
+  std::unique_ptr<OperatorEstBase> spawnCrowdClone() const override;
+
+  void startBlock(int steps) override {}
+
+  void registerOperatorEstimator(hdf_archive& file) override;
+
+  /// generate the unique pair id from the group ids of particle i and j and the number of species
+  static int gen_pair_id(const int ig, const int jg, const int ns);
+
+  int get_num_bins() const { return num_bins_; }
+  int get_num_pairs() const { return num_pairs_; }
+  Real get_rmax() const { return rmax_; }
+  Real get_delta() const { return delta_; }
+  const Matrix<Real>& get_norm_factor() const { return norm_factor_; }
+
+  void report(const std::string& pad) const;
+
+private:
+  PairCorrelationEstimator(const PairCorrelationEstimator& pce) = default;
+
+  /// sets norm_factor_, the inverse of the number of pairs in a bin's shell for a uniform density
+  void setNormFactor(const std::vector<int>& species_size, Real volume);
+
+  const PairCorrelationInput input_;
+  const int d_aa_id_;
+  const int num_species_;
+  const int num_pairs_;
+  Real rmax_;
+  Real delta_;
+  Real delta_inv_;
+  int num_bins_;
+  std::vector<std::string> pair_names_;
+  /// num_pairs_ x num_bins_
+  Matrix<Real> norm_factor_;
+
+  /// per walker scratch, bin of each distance in a table row, num_bins_ for r >= rmax
+  std::vector<int> bin_index_;
+  /// per walker scratch, num_pairs_ x (num_bins_ + 1) pair counts
+  std::vector<int> pair_counts_;
+};
+
+} // namespace qmcplusplus
+#endif
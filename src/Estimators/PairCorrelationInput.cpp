@@ -0,0 +1,39 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "PairCorrelationInput.h"
+#include "EstimatorInput.h"
+
+namespace qmcplusplus
+{
+PairCorrelationInput::PairCorrelationInput(xmlNodePtr cur)
+{
+  input_section_.readXML(cur);
+  auto setIfInInput = LAMBDA_setIfInInput;
+  setIfInInput(name_, "name");
+  setIfInInput(dr_, "dr");
+  if (input_section_.has("rmax"))
+    rmax_ = input_section_.get<Real>("rmax");
+  if (input_section_.has("num_bin"))
+    num_bin_ = input_section_.get<int>("num_bin");
+}
+
+void PairCorrelationInput::PairCorrelationInputSection::checkParticularValidity()
+{
+  const std::string error_tag{"PairCorrelation input: "};
+  if (has("rmax") && get<Real>("rmax") <= 0.0)
+    throw UniformCommunicateError(error_tag + "rmax must be positive");
+  if (has("dr") && get<Real>("dr") <= 0.0)
+    throw UniformCommunicateError(error_tag + "dr must be positive");
+  if (has("num_bin") && get<int>("num_bin") < 1)
+    throw UniformCommunicateError(error_tag + "num_bin must be at least 1");
+}
+} // namespace qmcplusplus
@@ -0,0 +1,73 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_PAIR_CORRELATION_INPUT_H
+#define QMCPLUSPLUS_PAIR_CORRELATION_INPUT_H
+
+#include <optional>
+#include "Configuration.h"
+#include "InputSection.h"
+
+namespace qmcplusplus
+{
+class PairCorrelationEstimator;
+
+/** Native representation of the batched PairCorrelation (g(r)) estimator input
+ *
+ *  <estimator type="PairCorrelation" name="gofr" rmax="5.0" dr="0.05"/>
+ *
+ *  rmax defaults to the Wigner-Seitz radius of a periodic cell and 10 for open boundaries.
+ *  num_bin if present takes precedence over dr.
+ */
+class PairCorrelationInput
+{
+public:
+  using Consumer = PairCorrelationEstimator;
+  using Real     = QMCTraits::RealType;
+
+  class PairCorrelationInputSection : public InputSection
+  {
+  public:
+    PairCorrelationInputSection()
+    {
+      section_name = "PairCorrelation";
+      attributes   = {"type", "name", "rmax", "dr", "num_bin"};
+      strings      = {"type", "name"};
+      reals        = {"rmax", "dr"};
+      integers     = {"num_bin"};
+    }
+    PairCorrelationInputSection(const PairCorrelationInputSection& other) = default;
+
+  private:
+    void checkParticularValidity() override;
+  };
+
+  PairCorrelationInput(const PairCorrelationInput& other) = default;
+  PairCorrelationInput(xmlNodePtr cur);
+
+  /** For this input class its valid with just its defaults
+   */
+  PairCorrelationInput() = default;
+
+  const std::string& get_name() const { return name_; }
+  const std::optional<Real>& get_rmax() const { return rmax_; }
+  Real get_dr() const { return dr_; }
+  const std::optional<int>& get_num_bin() const { return num_bin_; }
+
+private:
+  PairCorrelationInputSection input_section_;
+  std::string name_ = "gofr";
+  std::optional<Real> rmax_;
+  Real dr_ = 0.5;
+  std::optional<int> num_bin_;
+};
+} // namespace qmcplusplus
+#endif
@@ -12,30 +12,48 @@
 #include "PerParticleHamiltonianLogger.h"
 #include <algorithm>
 #include <functional>
+#include <cmath>
 #include "Utilities/for_testing/NativeInitializerPrint.hpp"
+#include "QMCDrivers/WalkerProperties.h"
 
 namespace qmcplusplus
 {
+using WP = WalkerProperties::Indexes;
+
 PerParticleHamiltonianLogger::PerParticleHamiltonianLogger(PerParticleHamiltonianLoggerInput&& input, int rank)
     : OperatorEstBase(DataLocality::crowd), rank_estimator_(nullptr), input_(input), rank_(rank)
 {
   requires_listener_ = true;
   my_name_           = "PerParticleHamiltonianLogger";
 
-  std::string filename("rank_" + std::to_string(rank_) + "_" + input_.get_name() + ".dat");
-  rank_fstream_.open(filename, std::ios::out);
+  if (input_.get_format() == Format::TEXT)
+  {
+    std::string filename("rank_" + std::to_string(rank_) + "_" + input_.get_name() + ".dat");
+    rank_fstream_.open(filename, std::ios::out);
+    return;
+  }
+
+  // the file is opened per section by openOutput
+  writer_ = std::make_shared<ColumnarH5Writer>(input_.get_name(), CHUNK_ROWS, true);
 }
 
 PerParticleHamiltonianLogger::PerParticleHamiltonianLogger(const PerParticleHamiltonianLogger& pphl, DataLocality dl)
-    : OperatorEstBase(dl), rank_estimator_(const_cast<PerParticleHamiltonianLogger*>(&pphl)), input_(pphl.input_)
+    : OperatorEstBase(dl),
+      rank_estimator_(const_cast<PerParticleHamiltonianLogger*>(&pphl)),
+      input_(pphl.input_),
+      rank_(pphl.rank_),
+      writer_(pphl.writer_)
 {
   requires_listener_ = true;
   my_name_           = pphl.name_;
   data_locality_     = dl;
 }
 
-void PerParticleHamiltonianLogger::write(CrowdLogValues& cl_values, const std::vector<long>& walker_ids)
+void PerParticleHamiltonianLogger::write(CrowdLogValues& cl_values,
+                                         const std::vector<long>& walker_ids,
+                                         const std::vector<bool>& selected)
 {
+  auto isSelected = [&selected](int iw) { return selected.empty() || (iw < selected.size() && selected[iw]); };
   // fstream is not thread safe but it is buffered.  If the buffer isn't too small this
   // should mostly return quickly and the contention for the lock should be manageable.
   const std::lock_guard<std::mutex> lock(write_lock);
@@ -43,7 +61,8 @@ void PerParticleHamiltonianLogger::write(CrowdLogValues& cl_values, const std::v
   {
     rank_fstream_ << "operator: " << component << '\n'; // " crowd: " << crowd_id <<
     for (int iw = 0; iw < values.size(); ++iw)
-      rank_fstream_ << " walker:" << walker_ids[iw] << " " << NativePrint(values[iw]) << '\n';
+      if (isSelected(iw))
+        rank_fstream_ << " walker:" << walker_ids[iw] << " " << NativePrint(values[iw]) << '\n';
   }
   if (input_.get_to_stdout())
   {
@@ -51,27 +70,72 @@ void PerParticleHamiltonianLogger::write(CrowdLogValues& cl_values, const std::v
     {
       std::cout << component << '\n';
       for (int iw = 0; iw < values.size(); ++iw)
-        std::cout << " walker: " << walker_ids[iw] << "  " << NativePrint(values[iw]) << '\n';
+        if (isSelected(iw))
+          std::cout << " walker: " << walker_ids[iw] << "  " << NativePrint(values[iw]) << '\n';
     }
   }
 }
 
+bool PerParticleHamiltonianLogger::isLogged(FullPrecReal local_energy) const
+{
+  if (input_.get_energy_sigma() <= 0 || energy_reference_.count() < 2)
+    return true;
+  auto [mean, variance] = energy_reference_.mean_and_variance();
+  return std::abs(local_energy - mean) > input_.get_energy_sigma() * std::sqrt(std::max(variance, FullPrecReal(0)));
+}
+
 void PerParticleHamiltonianLogger::accumulate(const RefVector<MCPWalker>& walkers,
                                               const RefVector<ParticleSet>& psets,
                                               const RefVector<TrialWaveFunction>& wfns,
                                               RandomGenerator& rng)
 
 {
-  // The hamiltonian doesn't know the walker ID only its index in the walker elements of the crowd
-  // build mapping from that index to global walker id.
-  // This could change every call for DMC.
-  walker_ids_.clear();
-  for (MCPWalker& walker : walkers)
-    walker_ids_.push_back(walker.ID);
-  rank_estimator_->write(values_, walker_ids_);
-
-  // \todo some per crowd reduction.
-  //       clear log values
+  const long step = step_++;
+  const int nw    = walkers.size();
+  selected_.resize(nw);
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    const FullPrecReal local_energy = walkers[iw].get().Properties(WP::LOCALENERGY);
+    selected_[iw]                   = rank_estimator_->isLogged(local_energy);
+    if (input_.get_energy_sigma() > 0)
+      crowd_energies_(local_energy);
+  }
+
+  if (input_.get_format() == Format::TEXT)
+  {
+    // The hamiltonian doesn't know the walker ID only its index in the walker elements of the crowd
+    // build mapping from that index to global walker id.
+    // This could change every call for DMC.
+    walker_ids_.clear();
+    for (MCPWalker& walker : walkers)
+      walker_ids_.push_back(walker.ID);
+    rank_estimator_->write(values_, walker_ids_, selected_);
+  }
+  else
+  {
+    for (int iw = 0; iw < nw; ++iw)
+    {
+      if (!selected_[iw])
+        continue;
+      MCPWalker& walker = walkers[iw];
+      buffer_.appendInteger("block", rank_estimator_->get_block());
+      buffer_.appendInteger("step", step);
+      buffer_.appendInteger("walker_id", walker.ID);
+      buffer_.appendReal("local_energy", walker.Properties(WP::LOCALENERGY));
+      // operators that did not report for this walker are logged as zeros
+      buffer_.setNumParticles(psets[iw].get().getTotalNum());
+      for (auto& [component, values] : values_)
+        buffer_.appendParticleValues(component, iw < values.size() ? values[iw] : Vector<Real>());
+      buffer_.endRow();
+    }
+    // a long block does not grow the crowd buffer without bound
+    writer_->writeIfFull(buffer_);
+  }
+
+  // the reports are per step, a walker missing from the next report must not repeat these values
+  for (auto& [component, values] : values_)
+    for (auto& walker_values : values)
+      walker_values.resize(0);
 }
 
 std::unique_ptr<OperatorEstBase> PerParticleHamiltonianLogger::spawnCrowdClone() const
@@ -96,7 +160,39 @@ ListenerVector<QMCTraits::RealType>::ReportingFunction PerParticleHamiltonianLog
 
 void PerParticleHamiltonianLogger::collect(const RefVector<OperatorEstBase>& type_erased_operator_estimators)
 {
-  int crowd_count = 0;
+  // the filter reference only changes between blocks so all the crowds see the same one
+  accumulator_set<FullPrecReal> block_energies;
+  for (OperatorEstBase& crowd_oeb : type_erased_operator_estimators)
+  {
+    auto& crowd_logger = dynamic_cast<PerParticleHamiltonianLogger&>(crowd_oeb);
+    const auto& crowd_energies = crowd_logger.crowd_energies_;
+    block_energies.reset(block_energies.result() + crowd_energies.result(),
+                         block_energies.result2() + crowd_energies.result2(),
+                         block_energies.count() + crowd_energies.count());
+    crowd_logger.crowd_energies_.clear();
+  }
+  energy_reference_.reset(energy_reference_.result() + block_energies.result(),
+                          energy_reference_.result2() + block_energies.result2(),
+                          energy_reference_.count() + block_energies.count());
+
+  if (input_.get_format() == Format::TEXT)
+    return;
+
+  // crowd order fixes the row order of what the crowds did not flush during the block
+  for (OperatorEstBase& crowd_oeb : type_erased_operator_estimators)
+  {
+    auto& crowd_logger = dynamic_cast<PerParticleHamiltonianLogger&>(crowd_oeb);
+    buffer_.append(crowd_logger.buffer_);
+    crowd_logger.buffer_.clear();
+  }
+  // only blocks if the previous block's rows are still being written
+  writer_->write(buffer_);
+}
+
+void PerParticleHamiltonianLogger::openOutput(const std::string& file_root)
+{
+  if (input_.get_format() == Format::HDF5)
+    writer_->open(ColumnarH5Writer::makeRankFileName(file_root, rank_, input_.get_name()));
 }
 
 void PerParticleHamiltonianLogger::registerListeners(QMCHamiltonian& ham_leader)
@@ -108,7 +204,8 @@ void PerParticleHamiltonianLogger::registerListeners(QMCHamiltonian& ham_leader)
 void PerParticleHamiltonianLogger::startBlock(int steps)
 {
   ++block_;
-  rank_fstream_ << "starting block:  " << block_ << " steps: " << steps << "\n";
+  if (input_.get_format() == Format::TEXT)
+    rank_fstream_ << "starting block:  " << block_ << " steps: " << steps << "\n";
 }
 
 } // namespace qmcplusplus
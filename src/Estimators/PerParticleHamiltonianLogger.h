@@ -15,21 +15,46 @@
 #include "PerParticleHamiltonianLoggerInput.h"
 #include <string>
 #include <fstream>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <optional>
 #include <StdRandom.h>
 #include "OhmmsPETE/OhmmsVector.h"
 #include "QMCHamiltonians/Listener.hpp"
+#include "accumulators.h"
+#include "ColumnarH5Writer.h"
 
 namespace qmcplusplus
 {
 
+/** Logs the per particle values each Hamiltonian operator reports to a local energy listener.
+ *
+ *  With format="text" each crowd writes its walkers' values as text to rank_<rank>_<name>.dat
+ *  under a rank wide lock every step.
+ *
+ *  With format="hdf5" each crowd appends one row per logged walker and step to a columnar buffer:
+ *  block, step, walker id, local energy and for each operator the values of all particles.
+ *  A crowd buffer holding ColumnarH5Writer::MAX_BUFFER_CHUNKS chunks is flushed right away, the rest
+ *  is moved in crowd order to the rank at the end of each block. The ColumnarH5Writer appends the rows
+ *  to chunked, extendable datasets of <file_root>.p<rank>.<name>.h5, where file_root is the project id and
+ *  series of the section so every section has its own file, on a background thread if the HDF5
+ *  library is thread safe. The header of the file is the num_particles and the operator_names of
+ *  the per_particle datasets.
+ *
+ *  With energy_sigma > 0 only walkers whose local energy differs from the mean by more than
+ *  energy_sigma standard deviations are logged. The mean and standard deviation are over all walkers
+ *  and steps of this rank in the previous blocks, nothing is filtered during the first block.
+ */
 class PerParticleHamiltonianLogger : public OperatorEstBase
 {
 public:
-  using Real = QMCTraits::RealType;
+  using Real           = QMCTraits::RealType;
+  using FullPrecReal   = QMCTraits::FullPrecRealType;
   using CrowdLogValues = std::unordered_map<std::string, std::vector<Vector<Real>>>;
+  using Format         = PerParticleHamiltonianLoggerInput::Format;
+  /// rows per HDF5 chunk of the log datasets
+  static constexpr hsize_t CHUNK_ROWS = 256;
 
   
   PerParticleHamiltonianLogger(PerParticleHamiltonianLoggerInput&& input, int rank);
@@ -43,6 +68,9 @@ public:
   UPtr<OperatorEstBase> spawnCrowdClone() const override;
   void startBlock(int steps) override;
 
+  /// hdf5 format only, create the log file of the rank, an open log file is closed first
+  void openOutput(const std::string& file_root) override;
+
   void registerListeners(QMCHamiltonian& ham_leader) override;
   /** return lambda function to register as listener
    *  the purpose of this function is to factor out the production of the lambda for unit testing
@@ -52,20 +80,45 @@ public:
 
   void collect(const RefVector<OperatorEstBase>& type_erased_operator_estimators) override;
 
-  void write(CrowdLogValues& values, const std::vector<long>& walkers_ids);
+  /** write the values of the selected walkers in text format
+   *  \param[in] selected  per walker, if empty all walkers are written
+   */
+  void write(CrowdLogValues& values, const std::vector<long>& walkers_ids, const std::vector<bool>& selected = {});
+
+  /// is a walker with local_energy logged, only meaningful on the rank estimator
+  bool isLogged(FullPrecReal local_energy) const;
+
+  /// block until the rows collected so far are in the file
+  void waitForPendingWrite() { writer_->waitForPendingWrite(); }
 
   int get_block() { return block_; }
+  const ColumnarBuffer& get_buffer() const { return buffer_; }
+  const accumulator_set<FullPrecReal>& get_energy_reference() const { return energy_reference_; }
+
 private:
   bool crowd_clone = false;
   PerParticleHamiltonianLogger  * const rank_estimator_;
   PerParticleHamiltonianLoggerInput input_;
-  int rank_;
+  int rank_ = 0;
   CrowdLogValues values_;
   std::vector<long> walker_ids_;
+  /// walkers of the current step passing the energy filter
+  std::vector<bool> selected_;
   const std::string name_{"PerParticleHamiltonianLogger"};
   std::fstream rank_fstream_;
   std::mutex write_lock;
   int block_ = 0;
+  /// steps seen by this crowd
+  long step_ = 0;
+  ColumnarBuffer buffer_;
+  /// local energies of the crowd's walkers in the current block
+  accumulator_set<FullPrecReal> crowd_energies_;
+
+  // rank scope only
+  /// local energies of all walkers in the previous blocks
+  accumulator_set<FullPrecReal> energy_reference_;
+  /// hdf5 format only, shared by the rank estimator and its crowd clones
+  std::shared_ptr<ColumnarH5Writer> writer_;
 };
   
 }
@@ -11,6 +11,7 @@
 
 #include "PerParticleHamiltonianLoggerInput.h"
 #include "EstimatorInput.h"
+#include "Message/UniformCommunicateError.h"
 
 namespace qmcplusplus {
   PerParticleHamiltonianLoggerInput::PerParticleHamiltonianLoggerInput(xmlNodePtr cur)
@@ -19,5 +20,19 @@ namespace qmcplusplus {
     auto setIfInInput = LAMBDA_setIfInInput;
     setIfInInput(to_stdout_, "to_stdout");
     setIfInInput(name_, "name");
+    setIfInInput(format_, "format");
+    setIfInInput(energy_sigma_, "energy_sigma");
+  }
+
+  std::any PerParticleHamiltonianLoggerInput::PerParticleHamiltonianLoggerInputSection::assignAnyEnum(
+      const std::string& name) const
+  {
+    return lookupAnyEnum(name, get<std::string>(name), lookup_input_enum_value);
+  }
+
+  void PerParticleHamiltonianLoggerInput::PerParticleHamiltonianLoggerInputSection::checkParticularValidity()
+  {
+    if (has("energy_sigma") && get<Real>("energy_sigma") < 0)
+      throw UniformCommunicateError("PerParticleHamiltonianLogger input: energy_sigma must not be negative");
   }
 }
@@ -22,6 +22,16 @@ class PerParticleHamiltonianLogger;
 class PerParticleHamiltonianLoggerInput
 {
 public:
+  enum class Format
+  {
+    TEXT,
+    HDF5
+  };
+  // clang-format off
+  inline static const std::unordered_map<std::string, std::any>
+      lookup_input_enum_value{{"format-text", Format::TEXT},
+                              {"format-hdf5", Format::HDF5}};
+  // clang-format on
   using Consumer = PerParticleHamiltonianLogger;
   using Real     = QMCTraits::RealType;
 
@@ -31,11 +41,16 @@ public:
     PerParticleHamiltonianLoggerInputSection()
     {
       section_name = "PerParticleHamiltonianLogger";
-      attributes   = {"to_stdout", "validate_per_particle_sum", "type", "name"};
+      attributes   = {"to_stdout", "validate_per_particle_sum", "type", "name", "format", "energy_sigma"};
       bools        = {"to_stdout", "validate_per_particle_sum"};
-      strings      = {"type", "name"};
+      strings      = {"type", "name", "format"};
+      reals        = {"energy_sigma"};
+      enums        = {"format"};
     }
     PerParticleHamiltonianLoggerInputSection(const PerParticleHamiltonianLoggerInputSection& other) = default;
+    std::any assignAnyEnum(const std::string& name) const override;
+    /** do parse time checks of input */
+    void checkParticularValidity() override;
   };
   PerParticleHamiltonianLoggerInput(const PerParticleHamiltonianLoggerInput& other) = default;
   PerParticleHamiltonianLoggerInput(xmlNodePtr cur);
@@ -46,11 +61,16 @@ public:
   
   const std::string& get_name() const { return name_; }
   bool get_to_stdout() const { return to_stdout_; }
+  Format get_format() const { return format_; }
+  Real get_energy_sigma() const { return energy_sigma_; }
 
 private:
   PerParticleHamiltonianLoggerInputSection input_section_;
   std::string name_               = "per_particle_log";
   bool to_stdout_                 = false;
+  Format format_                  = Format::TEXT;
+  /// only walkers whose local energy is more than energy_sigma standard deviations from the mean are logged
+  Real energy_sigma_ = 0.0;
 };
 } // namespace qmcplusplus
 #endif
@@ -0,0 +1,114 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+#ifndef QMCPLUSPLUS_REBLOCKINGACCUMULATOR_H
+#define QMCPLUSPLUS_REBLOCKINGACCUMULATOR_H
+
+#include <vector>
+#include <cmath>
+#include "accumulators.h"
+
+namespace qmcplusplus
+{
+
+/** online reblocking of a series of block averages.
+ *
+ *  Level 0 accumulates the block averages as they are added, level l+1 the averages of
+ *  consecutive pairs of level l (Flyvbjerg and Petersen). Only the accumulator_set and one
+ *  pending value are kept per level so the memory is logarithmic in the number of blocks.
+ *
+ *  The error bar of the mean is the largest standard error of the levels with at least
+ *  MIN_SAMPLES_PER_LEVEL samples, which is where the standard error of a correlated
+ *  series plateaus. The ratio of its square to the naive level 0 squared error is the
+ *  integrated autocorrelation time in units of blocks.
+ */
+template<typename T>
+class ReblockingAccumulator
+{
+public:
+  /// minimum number of samples of a level to enter the error estimate
+  static constexpr int MIN_SAMPLES_PER_LEVEL = 16;
+
+  /// add a block average
+  void operator()(T x)
+  {
+    for (int level = 0;; ++level)
+    {
+      if (level == levels_.size())
+        levels_.emplace_back();
+      Level& current = levels_[level];
+      current.samples(x);
+      if (!current.has_pending)
+      {
+        current.pending     = x;
+        current.has_pending = true;
+        return;
+      }
+      x                   = 0.5 * (current.pending + x);
+      current.has_pending = false;
+    }
+  }
+
+  void clear() { levels_.clear(); }
+
+  /// number of block averages added
+  T count() const { return levels_.empty() ? T(0) : levels_[0].samples.count(); }
+
+  T mean() const { return levels_.empty() ? T(0) : levels_[0].samples.mean(); }
+
+  int get_num_levels() const { return levels_.size(); }
+
+  /// standard error of the mean from the samples of level, 0 with less than two samples
+  T levelError(int level) const
+  {
+    const auto& samples = levels_[level].samples;
+    if (samples.count() < 2)
+      return T(0);
+    return std::sqrt(std::max(samples.variance(), T(0)) / (samples.count() - 1));
+  }
+
+  /// reblocked error of the mean
+  T error() const
+  {
+    T err = levels_.empty() ? T(0) : levelError(0);
+    for (int level = 1; level < levels_.size(); ++level)
+      if (levels_[level].samples.count() >= MIN_SAMPLES_PER_LEVEL)
+        err = std::max(err, levelError(level));
+    return err;
+  }
+
+  /// integrated autocorrelation time of the block averages in units of blocks
+  T autocorrelationTime() const
+  {
+    const T naive_error = levels_.empty() ? T(0) : levelError(0);
+    if (naive_error <= T(0))
+      return T(1);
+    const T ratio = error() / naive_error;
+    return ratio * ratio;
+  }
+
+  /** is error() based on at least one reblocked level
+   *  before that the error of correlated block averages is underestimated.
+   */
+  bool isReliable() const { return levels_.size() > 1 && levels_[1].samples.count() >= MIN_SAMPLES_PER_LEVEL; }
+
+private:
+  struct Level
+  {
+    accumulator_set<T> samples;
+    T pending        = T(0);
+    bool has_pending = false;
+  };
+  std::vector<Level> levels_;
+};
+
+} // namespace qmcplusplus
+#endif
@@ -0,0 +1,50 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: ReferencePoints.cpp
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "ReferencePointsInput.h"
+#include <sstream>
+#include "EstimatorInput.h"
+#include "OhmmsData/XMLParsingString.h"
+#include "Utilities/string_utils.h"
+
+namespace qmcplusplus
+{
+std::any ReferencePointsInput::ReferencePointsInputSection::assignAnyEnum(const std::string& name) const
+{
+  return lookupAnyEnum(name, get<std::string>(name), lookup_input_enum_value);
+}
+
+ReferencePointsInput::ReferencePointsInput(xmlNodePtr cur)
+{
+  input_section_.readXML(cur);
+  coord_form_ = input_section_.get<Coord>("coord");
+  readRefPointsXML(cur);
+}
+
+void ReferencePointsInput::readRefPointsXML(xmlNodePtr cur)
+{
+  std::vector<std::string> lines = split(strip(XMLNodeString{cur}), "\n");
+  for (auto& line : lines)
+  {
+    std::vector<std::string> tokens = split(strip(line));
+    if (tokens.empty())
+      continue;
+    if (tokens.size() != DIM + 1)
+      throw UniformCommunicateError("ReferencePoints input: reference point should have " + std::to_string(DIM + 1) +
+                                    " entries, given " + std::to_string(tokens.size()) + ": " + line);
+    Point rp;
+    for (int d = 0; d < DIM; d++)
+      rp[d] = string2real(tokens[d + 1]);
+    points_[tokens[0]] = rp;
+  }
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,80 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: ReferencePoints.h
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_REFERENCE_POINTS_INPUT_H
+#define QMCPLUSPLUS_REFERENCE_POINTS_INPUT_H
+
+#include <map>
+#include "Configuration.h"
+#include "InputSection.h"
+
+namespace qmcplusplus
+{
+class NEReferencePoints;
+
+/** Native representation of the <reference_points> input of the EnergyDensity estimator
+ *
+ *  <reference_points coord="cell|cartesian">
+ *    label x y z
+ *    ...
+ *  </reference_points>
+ */
+class ReferencePointsInput
+{
+public:
+  using Consumer           = NEReferencePoints;
+  using Real               = QMCTraits::RealType;
+  static constexpr int DIM = QMCTraits::DIM;
+  using Point              = TinyVector<Real, DIM>;
+  using Points             = std::map<std::string, Point>;
+
+  enum class Coord
+  {
+    CELL = 0,
+    CARTESIAN
+  };
+  // clang-format off
+  inline static const std::unordered_map<std::string, std::any>
+      lookup_input_enum_value{{"coord-cell", Coord::CELL},
+                              {"coord-cartesian", Coord::CARTESIAN}};
+  // clang-format on
+
+  class ReferencePointsInputSection : public InputSection
+  {
+  public:
+    ReferencePointsInputSection()
+    {
+      section_name = "reference_points";
+      attributes   = {"coord"};
+      enums        = {"coord"};
+      required     = {"coord"};
+    }
+    ReferencePointsInputSection(const ReferencePointsInputSection&) = default;
+    std::any assignAnyEnum(const std::string& name) const override;
+  };
+
+  ReferencePointsInput(xmlNodePtr cur);
+  ReferencePointsInput(const ReferencePointsInput&) = default;
+
+  Coord get_coord_form() const { return coord_form_; }
+  /// points as given in the input, i.e. in cell or cartesian coordinates depending on coord
+  const Points& get_points() const { return points_; }
+
+private:
+  void readRefPointsXML(xmlNodePtr cur);
+
+  ReferencePointsInputSection input_section_;
+  Coord coord_form_;
+  Points points_;
+};
+
+} // namespace qmcplusplus
+#endif
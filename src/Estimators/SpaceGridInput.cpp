@@ -0,0 +1,268 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: SpaceGrid.cpp
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "SpaceGridInput.h"
+#include <algorithm>
+#include <cmath>
+#include "EstimatorInput.h"
+#include "Utilities/string_utils.h"
+
+namespace qmcplusplus
+{
+namespace
+{
+using Real = SpaceGridInput::Real;
+
+class SpaceGridOriginInputSection : public InputSection
+{
+public:
+  SpaceGridOriginInputSection()
+  {
+    section_name   = "origin";
+    attributes     = {"p1", "p2", "fraction"};
+    strings        = {"p1", "p2"};
+    reals          = {"fraction"};
+    required       = {"p1"};
+    default_values = {{"p2", std::string("zero")}, {"fraction", Real(0.0)}};
+  }
+};
+
+class SpaceGridAxisInputSection : public InputSection
+{
+public:
+  SpaceGridAxisInputSection()
+  {
+    section_name   = "axis";
+    attributes     = {"label", "grid", "p1", "p2", "scale"};
+    strings        = {"label", "p1", "p2"};
+    multi_strings  = {"grid"};
+    reals          = {"scale"};
+    required       = {"label", "p1"};
+    default_values = {{"p2", std::string("zero")},
+                      {"scale", Real(1.0)},
+                      {"grid", std::vector<std::string>{"0", "1"}}};
+  }
+};
+
+std::any makeSpaceGridOrigin(xmlNodePtr cur, std::string& value_label)
+{
+  SpaceGridOriginInputSection input_section;
+  input_section.readXML(cur);
+  SpaceGridInput::Origin origin;
+  origin.p1       = input_section.get<std::string>("p1");
+  origin.p2       = input_section.get<std::string>("p2");
+  origin.fraction = input_section.get<Real>("fraction");
+  value_label     = "origin";
+  return origin;
+}
+
+std::any makeSpaceGridAxis(xmlNodePtr cur, std::string& value_label)
+{
+  SpaceGridAxisInputSection input_section;
+  input_section.readXML(cur);
+  SpaceGridInput::Axis axis;
+  axis.label = input_section.get<std::string>("label");
+  axis.p1    = input_section.get<std::string>("p1");
+  axis.p2    = input_section.get<std::string>("p2");
+  axis.scale = input_section.get<Real>("scale");
+  axis.grid.clear();
+  for (auto& token : input_section.get<std::vector<std::string>>("grid"))
+    axis.grid += token + ' ';
+  value_label = "axis";
+  return axis;
+}
+} // namespace
+
+SpaceGridInput::SpaceGridInputSection::SpaceGridInputSection()
+{
+  section_name = "SpaceGrid";
+  attributes   = {"coord", "periodic"};
+  enums        = {"coord"};
+  bools        = {"periodic"};
+  required     = {"coord"};
+  delegates    = {"origin", "axis"};
+  multiple     = {"axis"};
+  registerDelegate("origin", makeSpaceGridOrigin);
+  registerDelegate("axis", makeSpaceGridAxis);
+}
+
+std::any SpaceGridInput::SpaceGridInputSection::assignAnyEnum(const std::string& name) const
+{
+  return lookupAnyEnum(name, get<std::string>(name), lookup_input_enum_value);
+}
+
+SpaceGridInput::SpaceGridInput(xmlNodePtr cur)
+{
+  input_section_.readXML(cur);
+  coord_form_ = input_section_.get<CoordForm>("coord");
+  if (input_section_.has("periodic"))
+    periodic_ = input_section_.get<bool>("periodic");
+  if (input_section_.has("origin"))
+    origin_ = input_section_.get<Origin>("origin");
+  else
+    origin_.p1 = "zero";
+
+  const std::string error_tag{"SpaceGrid input: "};
+  if (!input_section_.has("axis"))
+    throw UniformCommunicateError(error_tag + "spacegrid must contain " + std::to_string(DIM) + " axes");
+  auto any_axes = input_section_.get<std::vector<std::any>>("axis");
+  if (any_axes.size() != DIM)
+    throw UniformCommunicateError(error_tag + "spacegrid must contain " + std::to_string(DIM) + " axes, " +
+                                  std::to_string(any_axes.size()) + " provided");
+
+  const auto& labels = axes_labels[static_cast<int>(coord_form_)];
+  std::array<bool, DIM> axis_defined{};
+  for (auto& any_axis : any_axes)
+  {
+    auto axis       = std::any_cast<Axis>(any_axis);
+    auto label_iter = std::find(labels.begin(), labels.end(), axis.label);
+    if (label_iter == labels.end())
+      throw UniformCommunicateError(error_tag + "grid label " + axis.label + " is invalid for coord " +
+                                    input_section_.get<std::string>("coord"));
+    const int iaxis = label_iter - labels.begin();
+    if (axis_defined[iaxis])
+      throw UniformCommunicateError(error_tag + "axis " + axis.label + " is defined more than once");
+    axis_defined[iaxis] = true;
+    axis_grids_[iaxis]  = parseAxisGrid(axis.grid, axis.label);
+    axes_[iaxis]        = std::move(axis);
+  }
+}
+
+SpaceGridInput::AxisGrid SpaceGridInput::parseAxisGrid(const std::string& grid_in, const std::string& label)
+{
+  const std::string error_tag{"SpaceGrid input: axis " + label + " grid \"" + grid_in + "\" "};
+  constexpr Real utol = 1e-5;
+  AxisGrid axis_grid;
+
+  // remove spaces inside of parentheses so each interval specification is a single token
+  std::string grid;
+  bool inparen = false;
+  for (char gc : grid_in)
+  {
+    if (gc == '(')
+    {
+      inparen = true;
+      grid += ' ';
+    }
+    if (!(inparen && gc == ' '))
+      grid += gc;
+    if (gc == ')')
+    {
+      inparen = false;
+      grid += ' ';
+    }
+  }
+  std::vector<std::string> tokens = split(grid);
+  if (tokens.size() < 2 || tokens.front()[0] == '(' || tokens.back()[0] == '(')
+    throw UniformCommunicateError(error_tag + "must begin and end with an interval endpoint");
+
+  // determine the number of domains in each interval and the width of each domain
+  std::vector<int> ndom_int;
+  std::vector<Real> du_int;
+  Real u1        = string2real(tokens[0]);
+  axis_grid.umin = u1;
+  axis_grid.umax = u1;
+  if (std::abs(u1) > 1.0000001)
+    throw UniformCommunicateError(error_tag + "interval endpoints cannot be greater than 1");
+  bool is_int        = false;
+  bool has_paren_val = false;
+  Real du_i          = 0.0;
+  int ndom_i         = 1;
+  for (int i = 1; i < tokens.size(); i++)
+  {
+    if (tokens[i][0] != '(')
+    {
+      Real u2        = string2real(tokens[i]);
+      axis_grid.umax = u2;
+      if (!has_paren_val)
+      {
+        du_i   = u2 - u1;
+        is_int = false;
+      }
+      has_paren_val = false;
+      if (u2 < u1)
+        throw UniformCommunicateError(error_tag + "contains a negative interval");
+      if (std::abs(u2) > 1.0000001)
+        throw UniformCommunicateError(error_tag + "interval endpoints cannot be greater than 1");
+      if (is_int)
+      {
+        du_int.push_back((u2 - u1) / ndom_i);
+        ndom_int.push_back(ndom_i);
+      }
+      else
+      {
+        du_int.push_back(du_i);
+        ndom_int.push_back(std::floor((u2 - u1) / du_i + .5));
+        if (std::abs(u2 - u1 - du_i * ndom_int.back()) > utol)
+          throw UniformCommunicateError(error_tag + "interval ending at " + tokens[i] +
+                                        " is not divisible by its domain width");
+      }
+      u1 = u2;
+    }
+    else
+    {
+      has_paren_val         = true;
+      std::string paren_val = tokens[i].substr(1, tokens[i].length() - 2);
+      is_int                = tokens[i].find(".") == std::string::npos;
+      if (is_int)
+        ndom_i = string2int(paren_val);
+      else
+        du_i = string2real(paren_val);
+      if ((is_int && ndom_i < 1) || (!is_int && du_i <= 0.0))
+        throw UniformCommunicateError(error_tag + "interval widths and domain counts must be positive");
+    }
+  }
+
+  // find the smallest domain width and make sure it divides into all other domain widths
+  Real du_min = 1.0;
+  for (Real du : du_int)
+    du_min = std::min(du_min, du);
+  axis_grid.odu = 1.0 / du_min;
+  std::vector<int> ndu_int(du_int.size());
+  for (int i = 0; i < du_int.size(); i++)
+  {
+    ndu_int[i] = std::floor(du_int[i] / du_min + .5);
+    if (std::abs(du_int[i] - ndu_int[i] * du_min) > utol)
+      throw UniformCommunicateError(error_tag + "interval " + std::to_string(i + 1) +
+                                    " is not divisible by the smallest subinterval");
+  }
+
+  // set up the interval map such that gmap[u/du]==domain index
+  axis_grid.gmap.resize(std::floor((axis_grid.umax - axis_grid.umin) * axis_grid.odu + .5));
+  int n  = 0;
+  int nd = -1;
+  for (int i = 0; i < ndom_int.size(); i++)
+    for (int j = 0; j < ndom_int[i]; j++)
+    {
+      nd++;
+      axis_grid.ndu_per_interval.push_back(ndu_int[i]);
+      for (int k = 0; k < ndu_int[i]; k++, n++)
+        axis_grid.gmap[n] = nd;
+    }
+  axis_grid.dimension = nd + 1;
+
+  // check that the axis grid values fall in the allowed range for the coordinate
+  if (label == "x" || label == "y" || label == "z")
+  {
+    if (axis_grid.umin < -1.0 || axis_grid.umax > 1.0)
+      throw UniformCommunicateError(error_tag + "grid values must fall in [-1,1]");
+  }
+  else if (label == "phi")
+  {
+    if (std::abs(axis_grid.umin) + std::abs(axis_grid.umax) > 1.0)
+      throw UniformCommunicateError(error_tag + "phi interval cannot be longer than 1");
+  }
+  else if (axis_grid.umin < 0.0 || axis_grid.umax > 1.0)
+    throw UniformCommunicateError(error_tag + "grid values must fall in [0,1]");
+  return axis_grid;
+}
+
+} // namespace qmcplusplus
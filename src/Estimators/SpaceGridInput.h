@@ -0,0 +1,123 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: SpaceGrid.cpp
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_SPACEGRID_INPUT_H
+#define QMCPLUSPLUS_SPACEGRID_INPUT_H
+
+#include <array>
+#include <optional>
+#include "Configuration.h"
+#include "InputSection.h"
+
+namespace qmcplusplus
+{
+class NESpaceGrid;
+
+/** Native representation of the <spacegrid> input of the EnergyDensity estimator
+ *
+ *  Besides holding the user input this class parses the axis grid specifications,
+ *  i.e. "-1 (.1) 1" or "0 (10) 1", into the integer maps used to bin a reduced
+ *  coordinate. None of this depends on the particle sets so input errors are
+ *  caught at parse time.
+ */
+class SpaceGridInput
+{
+public:
+  using Consumer           = NESpaceGrid;
+  using Real               = QMCTraits::RealType;
+  static constexpr int DIM = QMCTraits::DIM;
+
+  /** legacy integer values of the coordinate enum are written to hdf5, keep the order */
+  enum class CoordForm
+  {
+    CARTESIAN = 0,
+    CYLINDRICAL,
+    SPHERICAL
+  };
+  // clang-format off
+  inline static const std::unordered_map<std::string, std::any>
+      lookup_input_enum_value{{"coord-cartesian", CoordForm::CARTESIAN},
+                              {"coord-cylindrical", CoordForm::CYLINDRICAL},
+                              {"coord-spherical", CoordForm::SPHERICAL}};
+  // clang-format on
+
+  /// the labels an axis may have for each coordinate form, the position of the label is the axis index
+  inline static const std::array<std::array<std::string, DIM>, 3> axes_labels{
+      {{"x", "y", "z"}, {"r", "phi", "z"}, {"r", "phi", "theta"}}};
+
+  /** <origin p1="" p2="" fraction=""/> origin = p1 + fraction * (p2 - p1) */
+  struct Origin
+  {
+    std::string p1;
+    std::string p2 = "zero";
+    Real fraction  = 0.0;
+  };
+
+  /** <axis label="" p1="" p2="" scale="" grid=""/> axis = scale * (p1 - p2) */
+  struct Axis
+  {
+    std::string label;
+    std::string p1;
+    std::string p2 = "zero";
+    Real scale     = 1.0;
+    std::string grid{"0 1"};
+  };
+
+  /** Binning of one reduced coordinate derived from the axis grid input.
+   *  gmap[floor((u - umin) * odu)] is the domain index along the axis.
+   */
+  struct AxisGrid
+  {
+    Real umin = 0.0;
+    Real umax = 0.0;
+    /// one over the smallest domain width
+    Real odu = 1.0;
+    std::vector<int> gmap;
+    /// number of smallest widths spanned by each domain
+    std::vector<int> ndu_per_interval;
+    int dimension = 0;
+  };
+
+  class SpaceGridInputSection : public InputSection
+  {
+  public:
+    SpaceGridInputSection();
+    SpaceGridInputSection(const SpaceGridInputSection&) = default;
+    std::any assignAnyEnum(const std::string& name) const override;
+  };
+
+  SpaceGridInput(xmlNodePtr cur);
+  SpaceGridInput(const SpaceGridInput&) = default;
+
+  CoordForm get_coord_form() const { return coord_form_; }
+  std::optional<bool> get_periodic() const { return periodic_; }
+  const Origin& get_origin() const { return origin_; }
+  /// axes ordered by the axis index of their label
+  const std::array<Axis, DIM>& get_axes() const { return axes_; }
+  const std::array<AxisGrid, DIM>& get_axis_grids() const { return axis_grids_; }
+
+  /** parse an axis grid specification, throws UniformCommunicateError on invalid input
+   *  \param[in] grid     the grid attribute i.e. "0 (0.1) 1" or "-1 (5) 0 (.25) 1"
+   *  \param[in] label    axis label, determines the allowed range of the reduced coordinate
+   */
+  static AxisGrid parseAxisGrid(const std::string& grid, const std::string& label);
+
+private:
+  SpaceGridInputSection input_section_;
+  CoordForm coord_form_;
+  std::optional<bool> periodic_;
+  Origin origin_;
+  std::array<Axis, DIM> axes_;
+  std::array<AxisGrid, DIM> axis_grids_;
+};
+
+} // namespace qmcplusplus
+#endif
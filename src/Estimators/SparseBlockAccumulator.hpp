@@ -0,0 +1,166 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+#ifndef QMCPLUSPLUS_SPARSEBLOCKACCUMULATOR_H
+#define QMCPLUSPLUS_SPARSEBLOCKACCUMULATOR_H
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cassert>
+#include <stdexcept>
+#include "type_traits/template_types.hpp"
+
+namespace qmcplusplus
+{
+
+/** crowd scope write buffer for large gridded estimator data.
+ *
+ *  The index space of the rank estimator data is divided into fixed size blocks and a block
+ *  is only allocated once a sample lands in it. A crowd then holds the blocks it touched
+ *  during a Monte Carlo block instead of a full copy of the grid.
+ *
+ *  Once a crowd has touched more than MAX_SPARSE_FRACTION of the blocks the block bookkeeping no longer
+ *  saves memory and the buffer switches to a dense copy of the grid, so the storage never exceeds the
+ *  DataLocality::crowd buffer it replaces.
+ *
+ *  reduceInto adds the buffers to the rank data in the order they are passed. Every element
+ *  is summed in the same order as the DataLocality::crowd reduction, so the result is bitwise
+ *  identical to it and reproducible for a fixed crowd order. Blocks of the rank data are
+ *  disjoint and reduced concurrently so neither atomics nor locks are needed.
+ */
+template<typename T>
+class SparseBlockAccumulator
+{
+public:
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 512;
+  /// fraction of touched blocks beyond which the buffer becomes dense
+  static constexpr double MAX_SPARSE_FRACTION = 0.75;
+
+  SparseBlockAccumulator(size_t full_size = 0, size_t block_size = DEFAULT_BLOCK_SIZE)
+      : full_size_(full_size),
+        block_size_(block_size),
+        block_slots_((full_size + block_size - 1) / block_size, -1),
+        max_sparse_blocks_(static_cast<size_t>(MAX_SPARSE_FRACTION * block_slots_.size()))
+  {}
+
+  /// add value to element index of the full data
+  inline void add(size_t index, T value)
+  {
+    assert(index < full_size_);
+    const size_t ib = index / block_size_;
+    if (block_slots_[ib] < 0)
+      allocateBlock(ib);
+    blocks_[block_slots_[ib] * block_size_ + index % block_size_] += value;
+  }
+
+  /** release all touched blocks, the storage capacity is kept for the next Monte Carlo block
+   *  a dense buffer stays dense, the crowd is likely to cover the grid again.
+   */
+  void clear()
+  {
+    if (dense_)
+    {
+      std::fill(blocks_.begin(), blocks_.end(), T(0));
+      return;
+    }
+    for (size_t ib : touched_blocks_)
+      block_slots_[ib] = -1;
+    touched_blocks_.clear();
+    blocks_.clear();
+  }
+
+  size_t get_full_size() const { return full_size_; }
+  size_t get_block_size() const { return block_size_; }
+  size_t get_num_blocks() const { return block_slots_.size(); }
+  size_t get_num_touched_blocks() const { return touched_blocks_.size(); }
+  bool isDense() const { return dense_; }
+  /// number of elements allocated for the block storage
+  size_t get_storage_capacity() const { return blocks_.capacity(); }
+
+  /** add the buffers to data in the order given
+   *  \param[inout] data     full data, i.e. the rank estimator's data
+   *  \param[in]    buffers  crowd buffers, their order fixes the summation order
+   */
+  static void reduceInto(std::vector<T>& data, const RefVector<const SparseBlockAccumulator>& buffers)
+  {
+    if (buffers.empty())
+      return;
+    const SparseBlockAccumulator& first = buffers[0];
+    for (const SparseBlockAccumulator& buffer : buffers)
+      if (buffer.full_size_ != data.size() || buffer.block_size_ != first.block_size_)
+        throw std::runtime_error("SparseBlockAccumulator::reduceInto buffers do not match the data layout");
+
+    const size_t block_size = first.block_size_;
+    const size_t num_blocks = first.block_slots_.size();
+#pragma omp parallel for
+    for (size_t ib = 0; ib < num_blocks; ++ib)
+    {
+      const size_t offset = ib * block_size;
+      const size_t length = std::min(block_size, data.size() - offset);
+      T* target           = data.data() + offset;
+      for (const SparseBlockAccumulator& buffer : buffers)
+        if (const int slot = buffer.block_slots_[ib]; slot >= 0)
+        {
+          const T* source = buffer.blocks_.data() + slot * block_size;
+          for (size_t i = 0; i < length; ++i)
+            target[i] += source[i];
+        }
+    }
+  }
+
+private:
+  void allocateBlock(size_t ib)
+  {
+    if (touched_blocks_.size() >= max_sparse_blocks_)
+    {
+      makeDense();
+      return;
+    }
+    block_slots_[ib] = touched_blocks_.size();
+    touched_blocks_.push_back(ib);
+    // the growth of the storage is capped so the sparse buffer never holds more than the dense one
+    const size_t needed = blocks_.size() + block_size_;
+    if (needed > blocks_.capacity())
+      blocks_.reserve(std::min(2 * needed, max_sparse_blocks_ * block_size_));
+    blocks_.resize(needed, T(0));
+  }
+
+  /// move the touched blocks to their place in a dense copy of the grid, every block is touched afterwards
+  void makeDense()
+  {
+    const size_t num_blocks = block_slots_.size();
+    std::vector<T> dense(num_blocks * block_size_, T(0));
+    for (size_t ib : touched_blocks_)
+      std::copy_n(blocks_.data() + block_slots_[ib] * block_size_, block_size_, dense.data() + ib * block_size_);
+    blocks_.swap(dense);
+    std::iota(block_slots_.begin(), block_slots_.end(), 0);
+    touched_blocks_.resize(num_blocks);
+    std::iota(touched_blocks_.begin(), touched_blocks_.end(), 0);
+    dense_ = true;
+  }
+
+  size_t full_size_;
+  size_t block_size_;
+  /// slot of each block in blocks_, -1 if the block has not been touched
+  std::vector<int> block_slots_;
+  /// block indexes in order of first touch
+  std::vector<size_t> touched_blocks_;
+  /// touched blocks allowed before the buffer becomes dense
+  size_t max_sparse_blocks_;
+  /// storage of touched blocks
+  std::vector<T> blocks_;
+  /// every block is allocated and block ib is stored in slot ib
+  bool dense_ = false;
+};
+
+} // namespace qmcplusplus
+#endif
@@ -25,9 +25,8 @@ SpinDensityNew::SpinDensityNew(SpinDensityInput&& input, const SpeciesSet& speci
 {
   my_name_ = "SpinDensity";
 
-  data_locality_ = DataLocality::crowd;
   if (input_.get_save_memory())
-    dl = DataLocality::rank;
+    data_locality_ = DataLocality::rank;
 
   if (input_.get_cell().explicitly_defined == true)
     lattice_ = input_.get_cell();
@@ -53,8 +52,9 @@ SpinDensityNew::SpinDensityNew(SpinDensityInput&& input,
       species_size_(getSpeciesSize(species)),
       lattice_(lattice)
 {
-  my_name_       = "SpinDensity";
-  data_locality_ = dl;
+  my_name_ = "SpinDensity";
+  if (input_.get_save_memory())
+    data_locality_ = DataLocality::rank;
   if (input_.get_cell().explicitly_defined == true)
     lattice_ = input_.get_cell();
   derived_parameters_ = input_.calculateDerivedParameters(lattice_);
@@ -83,32 +83,18 @@ size_t SpinDensityNew::getFullDataSize() { return species_.size() * derived_para
 
 std::unique_ptr<OperatorEstBase> SpinDensityNew::spawnCrowdClone() const
 {
-  std::size_t data_size    = data_.size();
-  auto spawn_data_locality = data_locality_;
   if (data_locality_ == DataLocality::rank)
   {
-    spawn_data_locality = DataLocality::queue;
-    // at construction we don't know what the data requirement is going to be
-    // since its steps per block  dependent. so start with 10 steps worth.
-    int num_particles = std::accumulate(species_size_.begin(), species_size_.end(), 0);
-    data_size         = num_particles * 20;
+    // crowd clones only allocate the blocks of the grid their walkers visit
+    UPtr<SpinDensityNew> spawn(std::make_unique<SpinDensityNew>(*this, DataLocality::queue));
+    spawn->crowd_blocks_ = SparseBlockAccumulator<QMCT::RealType>(data_.size());
+    return spawn;
   }
-  UPtr<SpinDensityNew> spawn(std::make_unique<SpinDensityNew>(*this, spawn_data_locality));
-  spawn->get_data().resize(data_size);
+  UPtr<SpinDensityNew> spawn(std::make_unique<SpinDensityNew>(*this, data_locality_));
+  spawn->get_data().resize(data_.size());
   return spawn;
 }
 
-void SpinDensityNew::startBlock(int steps)
-{
-  if (data_locality_ == DataLocality::rank)
-  {
-    int num_particles = std::accumulate(species_size_.begin(), species_size_.end(), 0);
-    size_t data_size  = num_particles * steps * 2;
-    data_.reserve(data_size);
-    data_.resize(0);
-  }
-}
-
 /** Gets called every step and writes to thread local data.
  *
  *  I tried for readable and not doing the optimizers job.
@@ -150,8 +136,7 @@ void SpinDensityNew::accumulateToData(size_t point, QMCT::RealType weight)
   }
   else if (data_locality_ == DataLocality::queue)
   {
-    data_.push_back(point);
-    data_.push_back(weight);
+    crowd_blocks_.add(point, weight);
   }
   else
   {
@@ -163,6 +148,8 @@ void SpinDensityNew::collect(const RefVector<OperatorEstBase>& type_erased_opera
 {
   if (data_locality_ == DataLocality::rank)
   {
+    RefVector<SpinDensityNew> crowd_sdns;
+    RefVector<const SparseBlockAccumulator<QMCT::RealType>> crowd_blocks;
     for (OperatorEstBase& crowd_oeb : type_erased_operator_estimators)
     {
       // This will throw a std::bad_cast in debug if the calling code hands the
@@ -173,15 +160,14 @@ void SpinDensityNew::collect(const RefVector<OperatorEstBase>& type_erased_opera
 #else
       auto& oeb = static_cast<SpinDensityNew&>(crowd_oeb);
 #endif
-      auto& data = oeb.get_data();
-      for (int id = 0; id < data.size(); id += 2)
-      {
-        // This is a smell
-        size_t point{static_cast<size_t>(data[id])};
-        const QMCT::RealType weight{data[id + 1]};
-        data_[point] += weight;
-        walkers_weight_ += weight;
-      }
+      crowd_sdns.push_back(oeb);
+      crowd_blocks.push_back(oeb.crowd_blocks_);
+      walkers_weight_ += oeb.walkers_weight_;
+    }
+    SparseBlockAccumulator<QMCT::RealType>::reduceInto(data_, crowd_blocks);
+    for (SpinDensityNew& oeb : crowd_sdns)
+    {
+      oeb.crowd_blocks_.clear();
       oeb.zero();
     }
   }
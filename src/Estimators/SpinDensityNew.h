@@ -18,6 +18,7 @@
 
 #include "Configuration.h"
 #include "OperatorEstBase.h"
+#include "SparseBlockAccumulator.hpp"
 #include "Containers/OhmmsPETE/TinyVector.h"
 
 namespace qmcplusplus
@@ -30,7 +31,10 @@ class SpinDensityNewTests;
 /** Class that collects density per species of particle
  *
  *  commonly used for spin up and down electrons
- *  
+ *
+ *  With save_memory the rank estimator has DataLocality::rank and its crowd clones
+ *  DataLocality::queue. The clones only hold the blocks of the grid their walkers visit
+ *  in a SparseBlockAccumulator, these are reduced in crowd order by collect.
  */
 class SpinDensityNew : public OperatorEstBase
 {
@@ -71,9 +75,7 @@ public:
    */
   SpinDensityNew(const SpinDensityNew& sdn, DataLocality dl);
 
-  /** This allows us to allocate the necessary data for the DataLocality::queue 
-   */
-  void startBlock(int steps) override;
+  void startBlock(int steps) override {}
 
   /** standard interface
    */
@@ -89,8 +91,8 @@ public:
   /** this allows the EstimatorManagerNew to reduce without needing to know the details
    *  of SpinDensityNew's data.
    *
-   *  can use base class default until crowd level SpinDensity
-   *  estimators don't have a copy of the density grid.
+   *  For DataLocality::rank the crowd block buffers are added in the order of operator_estimators
+   *  which gives the same result as DataLocality::crowd.
    */
   void collect(const RefVector<OperatorEstBase>& operator_estimators) override;
 
@@ -138,6 +140,9 @@ private:
   SpinDensityInput::DerivedParameters derived_parameters_;
   /**}@*/
 
+  /// touched blocks of the density grid, only used with DataLocality::queue
+  SparseBlockAccumulator<QMCT::RealType> crowd_blocks_;
+
   friend class testing::SpinDensityNewTests;
 };
 
@@ -0,0 +1,135 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: SkEstimator.cpp, StaticStructureFactor.cpp
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "StructureFactorEstimator.h"
+#include "LongRange/StructFact.h"
+#include "LongRange/KContainer.h"
+#include "Message/UniformCommunicateError.h"
+
+namespace qmcplusplus
+{
+StructureFactorEstimator::StructureFactorEstimator(StructureFactorInput&& sfi,
+                                                   const ParticleSet& pset,
+                                                   DataLocality dl)
+    : OperatorEstBase(dl),
+      input_(std::move(sfi)),
+      num_species_(pset.groups()),
+      num_k_(pset.getSimulationCell().getKLists().numk),
+      one_over_n_(1.0 / static_cast<Real>(pset.getTotalNum()))
+{
+  my_name_ = input_.get_name();
+  if (data_locality_ != DataLocality::crowd)
+    throw std::runtime_error("StructureFactorEstimator only supports DataLocality::crowd");
+  if (!pset.hasSK())
+    throw UniformCommunicateError("StructureFactor estimator requires the structure factor of particle set " +
+                                  pset.getName() + ", a long range interaction is needed to set it up.");
+
+  const auto& species = pset.getSpeciesSet();
+  for (int s = 0; s < num_species_; ++s)
+    species_names_.push_back(species.speciesName[s]);
+
+  const auto& kpts_cart = pset.getSimulationCell().getKLists().kpts_cart;
+  kpoints_.resize(num_k_, OHMMS_DIM);
+  for (int ik = 0; ik < num_k_; ++ik)
+    for (int d = 0; d < OHMMS_DIM; ++d)
+      kpoints_(ik, d) = kpts_cart[ik][d];
+
+  const int data_size = input_.get_write_rhok() ? num_k_ * (1 + 2 * num_species_) : num_k_;
+  data_.resize(data_size, 0.0);
+  rhok_tot_r_.resize(num_k_);
+  rhok_tot_i_.resize(num_k_);
+}
+
+StructureFactorEstimator::StructureFactorEstimator(const StructureFactorEstimator& sfe, DataLocality dl)
+    : StructureFactorEstimator(sfe)
+{
+  data_locality_ = dl;
+}
+
+std::unique_ptr<OperatorEstBase> StructureFactorEstimator::spawnCrowdClone() const
+{
+  auto spawn = std::make_unique<StructureFactorEstimator>(*this, data_locality_);
+  spawn->get_data().resize(data_.size(), 0.0);
+  return spawn;
+}
+
+void StructureFactorEstimator::accumulate(const RefVector<MCPWalker>& walkers,
+                                          const RefVector<ParticleSet>& psets,
+                                          const RefVector<TrialWaveFunction>& wfns,
+                                          RandomGenerator& rng)
+{
+  const int nk = num_k_;
+  for (int iw = 0; iw < walkers.size(); ++iw)
+  {
+    MCPWalker& walker    = walkers[iw];
+    const Real weight    = walker.Weight;
+    const StructFact& sk = psets[iw].get().getSK();
+    walkers_weight_ += weight;
+
+    //sum over species
+    Real* restrict rhok_r = rhok_tot_r_.data();
+    Real* restrict rhok_i = rhok_tot_i_.data();
+    std::copy_n(sk.rhok_r[0], nk, rhok_r);
+    std::copy_n(sk.rhok_i[0], nk, rhok_i);
+    for (int s = 1; s < num_species_; ++s)
+    {
+      const Real* restrict species_rhok_r = sk.rhok_r[s];
+      const Real* restrict species_rhok_i = sk.rhok_i[s];
+#pragma omp simd
+      for (int ik = 0; ik < nk; ++ik)
+      {
+        rhok_r[ik] += species_rhok_r[ik];
+        rhok_i[ik] += species_rhok_i[ik];
+      }
+    }
+
+    const Real weight_over_n = weight * one_over_n_;
+    Real* restrict sk_data   = data_.data();
+#pragma omp simd
+    for (int ik = 0; ik < nk; ++ik)
+      sk_data[ik] += weight_over_n * (rhok_r[ik] * rhok_r[ik] + rhok_i[ik] * rhok_i[ik]);
+
+    if (input_.get_write_rhok())
+      for (int s = 0; s < num_species_; ++s)
+      {
+        const Real* restrict species_rhok_r = sk.rhok_r[s];
+        const Real* restrict species_rhok_i = sk.rhok_i[s];
+        Real* restrict rhok_r_data          = data_.data() + nk * (1 + 2 * s);
+        Real* restrict rhok_i_data          = rhok_r_data + nk;
+#pragma omp simd
+        for (int ik = 0; ik < nk; ++ik)
+        {
+          rhok_r_data[ik] += weight * species_rhok_r[ik];
+          rhok_i_data[ik] += weight * species_rhok_i[ik];
+        }
+      }
+  }
+}
+
+void StructureFactorEstimator::registerOperatorEstimator(hdf_archive& file)
+{
+  hdf_path hdf_name{my_name_};
+  std::vector<int> ng(1, num_k_);
+  h5desc_.emplace_back(hdf_name / "sk");
+  auto& oh = h5desc_.back();
+  oh.set_dimensions(ng, 0);
+  oh.addProperty(kpoints_, "kpoints", file);
+  if (input_.get_write_rhok())
+    for (int s = 0; s < num_species_; ++s)
+    {
+      h5desc_.emplace_back(hdf_name / ("rhok_r_" + species_names_[s]));
+      h5desc_.back().set_dimensions(ng, num_k_ * (1 + 2 * s));
+      h5desc_.emplace_back(hdf_name / ("rhok_i_" + species_names_[s]));
+      h5desc_.back().set_dimensions(ng, num_k_ * (2 + 2 * s));
+    }
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,78 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// Some code refactored from: SkEstimator.h, StaticStructureFactor.h
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_STRUCTURE_FACTOR_ESTIMATOR_H
+#define QMCPLUSPLUS_STRUCTURE_FACTOR_ESTIMATOR_H
+
+#include "OperatorEstBase.h"
+#include "StructureFactorInput.h"
+#include "OhmmsPETE/OhmmsMatrix.h"
+
+namespace qmcplusplus
+{
+/** Batched driver version of the SkEstimator and StaticStructureFactor
+ *
+ *  S(k) = 1/N |rho_k|^2 with rho_k = sum_species rho_k^species.
+ *  rho_k is not recomputed, it is read from each walker's StructFact which the
+ *  batched drivers have already updated through StructFact::mw_updateAllPart.
+ *
+ *  data layout: S(k) [nk] | optionally per species Re rho_k [nk], Im rho_k [nk]
+ */
+class StructureFactorEstimator : public OperatorEstBase
+{
+public:
+  using Real = QMCTraits::RealType;
+
+  /** constructor
+   *  \param[in] sfi   input
+   *  \param[in] pset  the golden electron particle set, it must have a structure factor
+   *  \param[in] dl    only DataLocality::crowd is supported
+   */
+  StructureFactorEstimator(StructureFactorInput&& sfi,
+                           const ParticleSet& pset,
+                           DataLocality dl = DataLocality::crowd);
+
+  /** Constructor used when spawing crowd clones
+   *  needs to be public so std::make_unique can call it.
+   */
+  StructureFactorEstimator(const StructureFactorEstimator& sfe, DataLocality dl);
+
+  void accumulate(const RefVector<MCPWalker>& walkers,
+                  const RefVector<ParticleSet>& psets,
+                  const RefVector<TrialWaveFunction>& wfns,
+                  RandomGenerator& rng) override;
+
+  std::unique_ptr<OperatorEstBase> spawnCrowdClone() const override;
+
+  void startBlock(int steps) override {}
+
+  void registerOperatorEstimator(hdf_archive& file) override;
+
+  int get_num_k() const { return num_k_; }
+
+private:
+  StructureFactorEstimator(const StructureFactorEstimator& sfe) = default;
+
+  const StructureFactorInput input_;
+  const int num_species_;
+  const int num_k_;
+  const Real one_over_n_;
+  std::vector<std::string> species_names_;
+  /// cartesian k points, num_k_ x DIM, for the output
+  Matrix<Real> kpoints_;
+
+  /// per walker scratch, rho_k summed over species
+  std::vector<Real> rhok_tot_r_;
+  std::vector<Real> rhok_tot_i_;
+};
+
+} // namespace qmcplusplus
+#endif
@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_STRUCTURE_FACTOR_INPUT_H
+#define QMCPLUSPLUS_STRUCTURE_FACTOR_INPUT_H
+
+#include "Configuration.h"
+#include "InputSection.h"
+
+namespace qmcplusplus
+{
+class StructureFactorEstimator;
+
+/** Native representation of the batched StructureFactor estimator input
+ *
+ *  <estimator type="StructureFactor" name="sk" rhok="yes"/>
+ *
+ *  rhok requests the weighted per species rho_k as well so the disconnected
+ *  part of S(k) can be removed in post processing.
+ */
+class StructureFactorInput
+{
+public:
+  using Consumer = StructureFactorEstimator;
+  using Real     = QMCTraits::RealType;
+
+  class StructureFactorInputSection : public InputSection
+  {
+  public:
+    StructureFactorInputSection()
+    {
+      section_name = "StructureFactor";
+      attributes   = {"type", "name", "rhok"};
+      strings      = {"type", "name"};
+      bools        = {"rhok"};
+    }
+    StructureFactorInputSection(const StructureFactorInputSection& other) = default;
+  };
+
+  StructureFactorInput(const StructureFactorInput& other) = default;
+  StructureFactorInput(xmlNodePtr cur);
+
+  /** For this input class its valid with just its defaults
+   */
+  StructureFactorInput() = default;
+
+  const std::string& get_name() const { return name_; }
+  bool get_write_rhok() const { return write_rhok_; }
+
+private:
+  StructureFactorInputSection input_section_;
+  std::string name_ = "sk";
+  bool write_rhok_  = false;
+};
+} // namespace qmcplusplus
+#endif
@@ -0,0 +1,118 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "WalkerTraceWriter.h"
+#include <algorithm>
+#include "QMCDrivers/WalkerProperties.h"
+#include "QMCHamiltonians/QMCHamiltonian.h"
+
+namespace qmcplusplus
+{
+using WP = WalkerProperties::Indexes;
+
+WalkerTraceWriter::WalkerTraceWriter(WalkerTraceWriterInput&& input, int rank)
+    : OperatorEstBase(DataLocality::crowd), input_(std::move(input)), rank_(rank)
+{
+  my_name_           = input_.get_name();
+  requires_listener_ = !input_.get_particle_quantities().empty();
+  writer_            = std::make_shared<ColumnarH5Writer>(input_.get_name(), input_.get_chunk_rows(), input_.get_async());
+}
+
+WalkerTraceWriter::WalkerTraceWriter(const WalkerTraceWriter& wtw, DataLocality dl)
+    : OperatorEstBase(dl), input_(wtw.input_), rank_(wtw.rank_), writer_(wtw.writer_)
+{
+  my_name_           = wtw.my_name_;
+  requires_listener_ = wtw.requires_listener_;
+  reported_.resize(input_.get_particle_quantities().size());
+}
+
+std::unique_ptr<OperatorEstBase> WalkerTraceWriter::spawnCrowdClone() const
+{
+  return std::make_unique<WalkerTraceWriter>(*this, data_locality_);
+}
+
+void WalkerTraceWriter::openOutput(const std::string& file_root)
+{
+  writer_->open(ColumnarH5Writer::makeRankFileName(file_root, rank_, input_.get_name()));
+  int period = input_.get_period();
+  writer_->writeHeader(period, "period");
+}
+
+ListenerVector<QMCTraits::RealType>::ReportingFunction WalkerTraceWriter::getListener()
+{
+  return [this](const int walker_index, const std::string& name, const Vector<Real>& inputV) {
+    const auto& quantities = input_.get_particle_quantities();
+    const auto found       = std::find(quantities.begin(), quantities.end(), name);
+    if (found == quantities.end())
+      return;
+    auto& component_values = reported_[found - quantities.begin()];
+    if (walker_index >= component_values.size())
+      component_values.resize(walker_index + 1);
+    component_values[walker_index] = inputV;
+  };
+}
+
+void WalkerTraceWriter::registerListeners(QMCHamiltonian& ham_leader)
+{
+  if (requires_listener_)
+    QMCHamiltonian::mw_registerLocalEnergyListener(ham_leader, {my_name_, getListener()});
+}
+
+void WalkerTraceWriter::accumulate(const RefVector<MCPWalker>& walkers,
+                                   const RefVector<ParticleSet>& psets,
+                                   const RefVector<TrialWaveFunction>& wfns,
+                                   RandomGenerator& rng)
+{
+  if (step_++ % input_.get_period() == 0)
+  {
+    const auto& quantities = input_.get_particle_quantities();
+    const Vector<Real> not_reported;
+    for (int iw = 0; iw < walkers.size(); ++iw)
+    {
+      MCPWalker& walker = walkers[iw];
+      buffer_.appendInteger("step", step_ - 1);
+      buffer_.appendInteger("walker_id", walker.ID);
+      buffer_.appendInteger("parent_id", walker.ParentID);
+      buffer_.appendInteger("age", walker.Age);
+      buffer_.appendReal("weight", walker.Weight);
+      buffer_.appendReal("multiplicity", walker.Multiplicity);
+      buffer_.appendReal("local_energy", walker.Properties(WP::LOCALENERGY));
+      buffer_.appendReal("local_potential", walker.Properties(WP::LOCALPOTENTIAL));
+      // components that did not report for this walker are traced as zeros
+      if (!quantities.empty())
+        buffer_.setNumParticles(psets[iw].get().getTotalNum());
+      for (int ic = 0; ic < reported_.size(); ++ic)
+        buffer_.appendParticleValues(quantities[ic], iw < reported_[ic].size() ? reported_[ic][iw] : not_reported);
+      buffer_.endRow();
+    }
+    // a long block does not grow the crowd buffer without bound
+    writer_->writeIfFull(buffer_);
+  }
+  // the reports are per step, a walker missing from the next report must not repeat these values
+  for (auto& component_values : reported_)
+    for (auto& walker_values : component_values)
+      walker_values.resize(0);
+}
+
+void WalkerTraceWriter::collect(const RefVector<OperatorEstBase>& type_erased_operator_estimators)
+{
+  // crowd order fixes the row order of what the crowds did not flush during the block
+  for (OperatorEstBase& crowd_oeb : type_erased_operator_estimators)
+  {
+    auto& crowd_writer = dynamic_cast<WalkerTraceWriter&>(crowd_oeb);
+    buffer_.append(crowd_writer.buffer_);
+    crowd_writer.buffer_.clear();
+  }
+  // only blocks if the previous block's traces are still being written
+  writer_->write(buffer_);
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,94 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_WALKER_TRACE_WRITER_H
+#define QMCPLUSPLUS_WALKER_TRACE_WRITER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "WalkerTraceWriterInput.h"
+#include "OperatorEstBase.h"
+#include "ColumnarH5Writer.h"
+#include "OhmmsPETE/OhmmsVector.h"
+#include "QMCHamiltonians/Listener.hpp"
+
+namespace qmcplusplus
+{
+
+/** Per walker, per step traces for the batched drivers.
+ *
+ *  Each crowd clone appends one row per walker every period steps to its ColumnarBuffer:
+ *  step, walker id, parent id, age, weight, multiplicity, local energy and local potential
+ *  plus, for each requested Hamiltonian component, the per particle values reported through
+ *  a local energy listener. Nothing is shared between crowds during accumulation except the
+ *  writer, which a crowd uses to flush its buffer once it holds ColumnarH5Writer::MAX_BUFFER_CHUNKS
+ *  chunks, so the rows of a long block are not all held in memory.
+ *
+ *  At the end of each block collect moves the crowd buffers in crowd order into the rank
+ *  buffer which the ColumnarH5Writer appends to <file_root>.p<rank>.<name>.h5,
+ *  where file_root is the project id and series of the section, so every section has its own file.
+ *
+ *  The rank estimator's data_ is empty, the traces do not go through the stat.h5 reduction.
+ */
+class WalkerTraceWriter : public OperatorEstBase
+{
+public:
+  using Real         = QMCTraits::RealType;
+  using FullPrecReal = QMCTraits::FullPrecRealType;
+
+  WalkerTraceWriter(WalkerTraceWriterInput&& input, int rank);
+  WalkerTraceWriter(const WalkerTraceWriter& other, DataLocality data_locality);
+
+  void accumulate(const RefVector<MCPWalker>& walkers,
+                  const RefVector<ParticleSet>& psets,
+                  const RefVector<TrialWaveFunction>& wfns,
+                  RandomGenerator& rng) override;
+
+  UPtr<OperatorEstBase> spawnCrowdClone() const override;
+  void startBlock(int steps) override {}
+
+  /// create the trace file of the rank, an open trace file is closed first
+  void openOutput(const std::string& file_root) override;
+
+  void registerListeners(QMCHamiltonian& ham_leader) override;
+  /** return lambda function to register as listener
+   *  the purpose of this function is to factor out the production of the lambda for unit testing
+   */
+  ListenerVector<Real>::ReportingFunction getListener();
+
+  /** move the crowd traces to the rank and append them to the trace file
+   *  the crowd buffers are cleared.
+   */
+  void collect(const RefVector<OperatorEstBase>& type_erased_operator_estimators) override;
+
+  /// block until the traces collected so far are in the file
+  void waitForPendingWrite() { writer_->waitForPendingWrite(); }
+
+  const ColumnarBuffer& get_buffer() const { return buffer_; }
+  const std::string& get_file_name() const { return writer_->get_file_name(); }
+  bool isAsync() const { return writer_->isAsync(); }
+
+private:
+  WalkerTraceWriterInput input_;
+  int rank_ = 0;
+  /// steps seen by this crowd
+  long step_ = 0;
+  ColumnarBuffer buffer_;
+  /// per particle values reported during the current step, [component][walker]
+  std::vector<std::vector<Vector<Real>>> reported_;
+  /// shared by the rank estimator and its crowd clones
+  std::shared_ptr<ColumnarH5Writer> writer_;
+};
+
+} // namespace qmcplusplus
+
+#endif
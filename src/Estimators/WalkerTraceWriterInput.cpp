@@ -0,0 +1,37 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "WalkerTraceWriterInput.h"
+#include "EstimatorInput.h"
+#include "Message/UniformCommunicateError.h"
+
+namespace qmcplusplus
+{
+WalkerTraceWriterInput::WalkerTraceWriterInput(xmlNodePtr cur)
+{
+  input_section_.readXML(cur);
+  auto setIfInInput = LAMBDA_setIfInInput;
+  setIfInInput(name_, "name");
+  setIfInInput(period_, "period");
+  setIfInInput(particle_quantities_, "particle_quantities");
+  setIfInInput(chunk_rows_, "chunk_rows");
+  setIfInInput(async_, "async");
+}
+
+void WalkerTraceWriterInput::WalkerTraceWriterInputSection::checkParticularValidity()
+{
+  const std::string error_tag{"WalkerTraces input: "};
+  if (has("period") && get<int>("period") < 1)
+    throw UniformCommunicateError(error_tag + "period must be at least 1");
+  if (has("chunk_rows") && get<int>("chunk_rows") < 1)
+    throw UniformCommunicateError(error_tag + "chunk_rows must be at least 1");
+}
+} // namespace qmcplusplus
@@ -0,0 +1,78 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_WALKER_TRACE_WRITER_INPUT_H
+#define QMCPLUSPLUS_WALKER_TRACE_WRITER_INPUT_H
+
+#include "Configuration.h"
+#include "InputSection.h"
+
+namespace qmcplusplus
+{
+class WalkerTraceWriter;
+
+/** Native representation of the WalkerTraces estimator input
+ *
+ *  <estimator type="WalkerTraces" name="walker_traces">
+ *    <parameter name="period">         10                </parameter>
+ *    <parameter name="particle_quantities"> Kinetic LocalECP </parameter>
+ *  </estimator>
+ */
+class WalkerTraceWriterInput
+{
+public:
+  using Consumer = WalkerTraceWriter;
+  using Real     = QMCTraits::RealType;
+
+  class WalkerTraceWriterInputSection : public InputSection
+  {
+  public:
+    WalkerTraceWriterInputSection()
+    {
+      section_name  = "WalkerTraces";
+      attributes    = {"type", "name"};
+      parameters    = {"period", "particle_quantities", "chunk_rows", "async"};
+      strings       = {"type", "name"};
+      multi_strings = {"particle_quantities"};
+      integers      = {"period", "chunk_rows"};
+      bools         = {"async"};
+    }
+    WalkerTraceWriterInputSection(const WalkerTraceWriterInputSection& other) = default;
+    /** do parse time checks of input */
+    void checkParticularValidity() override;
+  };
+
+  WalkerTraceWriterInput(const WalkerTraceWriterInput& other) = default;
+  WalkerTraceWriterInput(xmlNodePtr cur);
+  /** For this input class its valid with just its defaults
+   */
+  WalkerTraceWriterInput() = default;
+
+  const std::string& get_name() const { return name_; }
+  int get_period() const { return period_; }
+  const std::vector<std::string>& get_particle_quantities() const { return particle_quantities_; }
+  int get_chunk_rows() const { return chunk_rows_; }
+  bool get_async() const { return async_; }
+
+private:
+  WalkerTraceWriterInputSection input_section_;
+  std::string name_ = "walker_traces";
+  /// a row is written for each walker every period steps
+  int period_ = 1;
+  /// names of the Hamiltonian components whose per particle values are traced
+  std::vector<std::string> particle_quantities_;
+  /// rows per HDF5 chunk of the trace datasets
+  int chunk_rows_ = 1024;
+  /// write the traces from a background thread
+  bool async_ = true;
+};
+} // namespace qmcplusplus
+#endif
@@ -0,0 +1,126 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QMCPLUSPLUS_VALID_ENERGYDENSITY_INPUT_H
+#define QMCPLUSPLUS_VALID_ENERGYDENSITY_INPUT_H
+
+#include <array>
+#include <string_view>
+
+namespace qmcplusplus
+{
+namespace testing
+{
+namespace energydensity
+{
+enum Inputs
+{
+  valid_cell_input = 0,
+  valid_cylindrical_input,
+  valid_spherical_ion_points_input
+};
+
+// clang-format: off
+constexpr std::array<std::string_view, 3> valid_energy_density_input_sections{
+    R"XML(
+<estimator type="EnergyDensity" name="EDcell" dynamic="e" static="ion">
+  <spacegrid coord="cartesian">
+    <origin p1="zero"/>
+    <axis p1="a1" scale=".5" label="x" grid="-1 (.1) 1"/>
+    <axis p1="a2" scale=".5" label="y" grid="-1 (.1) 1"/>
+    <axis p1="a3" scale=".5" label="z" grid="-1 (.1) 1"/>
+  </spacegrid>
+</estimator>
+)XML",
+    R"XML(
+<estimator type="EnergyDensity" name="EDcyl" dynamic="e" static="ion">
+  <reference_points coord="cartesian">
+    r1 1 0 0
+    r2 0 1 0
+    r3 0 0 1
+  </reference_points>
+  <spacegrid coord="cylindrical">
+    <origin p1="ion1"/>
+    <axis p1="r1" scale="2.0" label="r"   grid="0 (.5) 1"/>
+    <axis p1="r2" scale="2.0" label="phi" grid="0 (.25) 1"/>
+    <axis p1="r3" scale="2.0" label="z"   grid="-1 (1.0) 1"/>
+  </spacegrid>
+  <spacegrid coord="cartesian">
+    <origin p1="zero"/>
+    <axis p1="a1" scale=".5" label="x" grid="-1 (4) 1"/>
+    <axis p1="a2" scale=".5" label="y" grid="-1 (4) 1"/>
+    <axis p1="a3" scale=".5" label="z" grid="-1 (4) 1"/>
+  </spacegrid>
+</estimator>
+)XML",
+    R"XML(
+<estimator type="EnergyDensity" name="EDsph" dynamic="e" static="ion" ion_points="yes">
+  <reference_points coord="cell">
+    r1 1 0 0
+    r2 0 1 0
+    r3 0 0 1
+  </reference_points>
+  <spacegrid coord="spherical">
+    <origin p1="ion2"/>
+    <axis p1="r1" scale="1.0" label="r"     grid="0 (.25) 1"/>
+    <axis p1="r2" scale="1.0" label="phi"   grid="0 (.5) 1"/>
+    <axis p1="r3" scale="1.0" label="theta" grid="0 (.5) 1"/>
+  </spacegrid>
+</estimator>
+)XML"
+    // clang-format: on
+};
+
+// clang-format: off
+constexpr std::array<std::string_view, 4> invalid_energy_density_input_sections{
+    R"XML(
+<estimator type="EnergyDensity" name="EDcell" dynamic="e" ion_points="yes">
+  <spacegrid coord="cartesian">
+    <axis p1="a1" scale=".5" label="x" grid="-1 (.1) 1"/>
+    <axis p1="a2" scale=".5" label="y" grid="-1 (.1) 1"/>
+    <axis p1="a3" scale=".5" label="z" grid="-1 (.1) 1"/>
+  </spacegrid>
+</estimator>
+)XML",
+    R"XML(
+<estimator type="EnergyDensity" name="EDcell" dynamic="e">
+  <spacegrid coord="cartesian">
+    <axis p1="a1" scale=".5" label="x" grid="-1 (.1) 1"/>
+    <axis p1="a2" scale=".5" label="y" grid="-1 (.1) 1"/>
+  </spacegrid>
+</estimator>
+)XML",
+    R"XML(
+<estimator type="EnergyDensity" name="EDcell" dynamic="e">
+  <spacegrid coord="cylindrical">
+    <axis p1="a1" scale=".5" label="x" grid="-1 (.1) 1"/>
+    <axis p1="a2" scale=".5" label="y" grid="-1 (.1) 1"/>
+    <axis p1="a3" scale=".5" label="z" grid="-1 (.1) 1"/>
+  </spacegrid>
+</estimator>
+)XML",
+    R"XML(
+<estimator type="EnergyDensity" name="EDcell" dynamic="e">
+  <spacegrid coord="cartesian">
+    <axis p1="a1" scale=".5" label="x" grid="-1 (.3) 1"/>
+    <axis p1="a2" scale=".5" label="y" grid="-1 (.1) 1"/>
+    <axis p1="a3" scale=".5" label="z" grid="-1 (.1) 1"/>
+  </spacegrid>
+</estimator>
+)XML"
+    // clang-format: on
+};
+} // namespace energydensity
+
+} // namespace testing
+} // namespace qmcplusplus
+
+#endif
@@ -26,11 +26,12 @@ enum Inputs
   valid_magdensity_input = 0,
   valid_magdensity_input_dr,
   valid_magdensity_input_grid,
-  valid_magdensity_input_unittest
+  valid_magdensity_input_unittest,
+  valid_magdensity_input_save_memory
 };
 
 // clang-format: off
-constexpr std::array<std::string_view, 4> valid_mag_density_input_sections{
+constexpr std::array<std::string_view, 5> valid_mag_density_input_sections{
     R"XML(
 <estimator type="MagnetizationDensity" name="magdensity">
   <parameter name="integrator"   >  simpsons       </parameter>
@@ -60,6 +61,13 @@ constexpr std::array<std::string_view, 4> valid_mag_density_input_sections{
   <parameter name="corner"       >  0.0 0.0 0.0   </parameter>
   <parameter name="grid"         >  2 2 2         </parameter>
 </estimator>
+)XML",
+    R"XML(
+<estimator type="MagnetizationDensity" name="magdensity">
+  <parameter name="samples"      >  9             </parameter>
+  <parameter name="grid"         >  4 3 2         </parameter>
+  <parameter name="save_memory"  >  yes           </parameter>
+</estimator>
 )XML"
     // clang-format: on
 };
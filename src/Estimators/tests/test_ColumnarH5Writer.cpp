@@ -0,0 +1,131 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "ColumnarH5Writer.h"
+
+#include <array>
+#include <filesystem>
+
+namespace qmcplusplus
+{
+
+using Real = QMCTraits::RealType;
+
+TEST_CASE("ColumnarBuffer", "[estimators]")
+{
+  ColumnarBuffer buffer;
+  buffer.setNumParticles(2);
+  Vector<Real> values{1.0, 2.0};
+  buffer.appendInteger("step", 0);
+  buffer.appendParticleValues("first", values);
+  buffer.endRow();
+  buffer.appendInteger("step", 1);
+  // wrong length and missing values are zeros
+  buffer.appendParticleValues("first", Vector<Real>(3));
+  buffer.appendParticleValues("second", values);
+  buffer.endRow();
+  CHECK(buffer.num_rows() == 2);
+  CHECK_THROWS_AS(buffer.setNumParticles(3), std::runtime_error);
+
+  ColumnarBuffer other;
+  other.setNumParticles(2);
+  other.appendInteger("step", 2);
+  other.appendParticleValues("third", values);
+  other.endRow();
+  buffer.append(other);
+  CHECK(buffer.num_rows() == 3);
+  CHECK(buffer.get_integer_columns().at("step") == std::vector<long>{0, 1, 2});
+  CHECK(buffer.get_particle_columns().at("first") == std::vector<Real>{1.0, 2.0, 0.0, 0.0, 0.0, 0.0});
+  CHECK(buffer.get_particle_columns().at("second") == std::vector<Real>{0.0, 0.0, 1.0, 2.0, 0.0, 0.0});
+  CHECK(buffer.get_particle_columns().at("third") == std::vector<Real>{0.0, 0.0, 0.0, 0.0, 1.0, 2.0});
+
+  buffer.clear();
+  CHECK(buffer.num_rows() == 0);
+  CHECK(buffer.get_integer_columns().at("step").empty());
+}
+
+TEST_CASE("ColumnarH5Writer_makeRankFileName", "[estimators]")
+{
+  CHECK(ColumnarH5Writer::makeRankFileName("proj.s002", 7, "log") == "proj.s002.p007.log.h5");
+}
+
+TEST_CASE("ColumnarH5Writer_writeIfFull", "[estimators]")
+{
+  const std::string file_name("columnar_h5_writer_test.h5");
+  const hsize_t chunk_rows = 4;
+  const int nparticle      = 2;
+  ColumnarH5Writer writer("columns", chunk_rows, false);
+  const size_t max_rows = writer.get_max_buffer_rows();
+  CHECK(max_rows == ColumnarH5Writer::MAX_BUFFER_CHUNKS * chunk_rows);
+
+  ColumnarBuffer buffer;
+  buffer.setNumParticles(nparticle);
+  auto appendRow = [&buffer](long row) {
+    buffer.appendInteger("row", row);
+    buffer.appendReal("value", 0.5 * row);
+    buffer.appendParticleValues("particle", Vector<Real>{Real(row), -Real(row)});
+    buffer.endRow();
+  };
+  appendRow(0);
+  CHECK_THROWS_AS(writer.write(buffer), std::runtime_error);
+
+  if (std::filesystem::exists(file_name))
+    std::filesystem::remove(file_name);
+  writer.open(file_name);
+  REQUIRE(writer.isOpen());
+  int header = 3;
+  writer.writeHeader(header, "header");
+
+  // a buffer is only flushed once it holds the row limit
+  for (long row = 1; row < max_rows - 1; ++row)
+    appendRow(row);
+  writer.writeIfFull(buffer);
+  CHECK(buffer.num_rows() == max_rows - 1);
+  appendRow(max_rows - 1);
+  writer.writeIfFull(buffer);
+  CHECK(buffer.num_rows() == 0);
+  appendRow(max_rows);
+  writer.write(buffer);
+  CHECK(buffer.num_rows() == 0);
+  writer.waitForPendingWrite();
+
+  const size_t nrows = max_rows + 1;
+  hdf_archive hd;
+  bool okay = hd.open(file_name);
+  REQUIRE(okay);
+  header = 0;
+  hd.read(header, "columns/header");
+  CHECK(header == 3);
+  int num_particles = 0;
+  hd.read(num_particles, "columns/num_particles");
+  CHECK(num_particles == nparticle);
+  std::vector<long> rows;
+  std::vector<QMCTraits::FullPrecRealType> values;
+  std::vector<Real> particle;
+  hd.read(rows, "columns/row");
+  hd.read(values, "columns/value");
+  hd.readSlabReshaped(particle, std::array<size_t, 2>{nrows, nparticle}, "columns/per_particle/particle");
+  REQUIRE(rows.size() == nrows);
+  REQUIRE(particle.size() == nrows * nparticle);
+  for (int row = 0; row < nrows; ++row)
+  {
+    CHECK(rows[row] == row);
+    CHECK(values[row] == Approx(0.5 * row));
+    CHECK(particle[row * nparticle] == Approx(row));
+    CHECK(particle[row * nparticle + 1] == Approx(-row));
+  }
+  hd.close();
+  std::filesystem::remove(file_name);
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,324 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "NEEnergyDensityEstimator.h"
+#include "EnergyDensityInput.h"
+#include "ValidEnergyDensityInput.h"
+#include "ParticleSet.h"
+#include "TrialWaveFunction.h"
+#include "OhmmsData/Libxml2Doc.h"
+#include "Message/UniformCommunicateError.h"
+#include "Particle/tests/MinimalParticlePool.h"
+
+namespace qmcplusplus
+{
+using Real = QMCTraits::RealType;
+
+namespace
+{
+EnergyDensityInput makeEnergyDensityInput(std::string_view xml)
+{
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(xml);
+  REQUIRE(okay);
+  return EnergyDensityInput(doc.getRoot());
+}
+
+SpaceGridInput makeSpaceGridInput(std::string_view xml)
+{
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(xml);
+  REQUIRE(okay);
+  return SpaceGridInput(doc.getRoot());
+}
+} // namespace
+
+TEST_CASE("EnergyDensityInput::from_xml", "[estimators]")
+{
+  using namespace testing::energydensity;
+  for (auto input_xml : valid_energy_density_input_sections)
+    makeEnergyDensityInput(input_xml);
+
+  for (auto input_xml : invalid_energy_density_input_sections)
+  {
+    Libxml2Document doc;
+    bool okay = doc.parseFromString(input_xml);
+    REQUIRE(okay);
+    xmlNodePtr node = doc.getRoot();
+    CHECK_THROWS_AS(EnergyDensityInput(node), UniformCommunicateError);
+  }
+
+  auto edi = makeEnergyDensityInput(valid_energy_density_input_sections[valid_cylindrical_input]);
+  CHECK(edi.get_name() == "EDcyl");
+  CHECK(edi.get_dynamic() == "e");
+  CHECK(edi.get_static() == "ion");
+  CHECK(!edi.get_ion_points());
+  REQUIRE(edi.get_ref_points_input());
+  CHECK(edi.get_ref_points_input()->get_coord_form() == ReferencePointsInput::Coord::CARTESIAN);
+  CHECK(edi.get_ref_points_input()->get_points().size() == 3);
+  auto& sgis = edi.get_space_grid_inputs();
+  REQUIRE(sgis.size() == 2);
+  CHECK(sgis[0].get_coord_form() == SpaceGridInput::CoordForm::CYLINDRICAL);
+  CHECK(sgis[0].get_origin().p1 == "ion1");
+  CHECK(sgis[0].get_axes()[1].label == "phi");
+  CHECK(sgis[0].get_axis_grids()[1].dimension == 4);
+  CHECK(sgis[1].get_coord_form() == SpaceGridInput::CoordForm::CARTESIAN);
+  CHECK(sgis[1].get_axis_grids()[0].dimension == 4);
+  CHECK(sgis[1].get_axis_grids()[0].odu == Approx(2.0));
+
+  auto edi_sph = makeEnergyDensityInput(valid_energy_density_input_sections[valid_spherical_ion_points_input]);
+  CHECK(edi_sph.get_ion_points());
+  CHECK(edi_sph.get_space_grid_inputs()[0].get_axes()[2].label == "theta");
+}
+
+TEST_CASE("SpaceGridInput::parseAxisGrid", "[estimators]")
+{
+  auto grid = SpaceGridInput::parseAxisGrid("0 (0.1) 0.5 (5) 1", "r");
+  CHECK(grid.umin == Approx(0.0));
+  CHECK(grid.umax == Approx(1.0));
+  CHECK(grid.odu == Approx(10.0));
+  CHECK(grid.dimension == 10);
+  CHECK(grid.gmap.size() == 10);
+  CHECK(grid.gmap[4] == 4);
+  CHECK(grid.gmap[9] == 9);
+
+  auto coarse = SpaceGridInput::parseAxisGrid("-1 (.25) 0 (.5) 1", "x");
+  CHECK(coarse.dimension == 6);
+  CHECK(coarse.gmap.size() == 8);
+  CHECK(coarse.gmap[4] == 4);
+  CHECK(coarse.gmap[5] == 4);
+  CHECK(coarse.gmap[7] == 5);
+
+  CHECK_THROWS_AS(SpaceGridInput::parseAxisGrid("0 (.3) 1", "r"), UniformCommunicateError);
+  CHECK_THROWS_AS(SpaceGridInput::parseAxisGrid("-1 (.5) 1", "r"), UniformCommunicateError);
+  CHECK_THROWS_AS(SpaceGridInput::parseAxisGrid("0 (.5) 2", "x"), UniformCommunicateError);
+}
+
+TEST_CASE("NESpaceGrid::accumulate", "[estimators]")
+{
+  using Point = NESpaceGrid::Point;
+  NESpaceGrid::Points points{{"zero", {0.0, 0.0, 0.0}},
+                             {"x", {1.0, 0.0, 0.0}},
+                             {"y", {0.0, 1.0, 0.0}},
+                             {"z", {0.0, 0.0, 1.0}}};
+  constexpr int nvalues = 2;
+  constexpr int offset  = 3;
+
+  SECTION("cartesian")
+  {
+    auto sgi = makeSpaceGridInput(R"XML(
+<spacegrid coord="cartesian">
+  <axis p1="x" scale="2.0" label="x" grid="-1 (.5) 1"/>
+  <axis p1="y" scale="2.0" label="y" grid="-1 (.5) 1"/>
+  <axis p1="z" scale="2.0" label="z" grid="-1 (.5) 1"/>
+</spacegrid>
+)XML");
+    NESpaceGrid grid(sgi, points, nvalues, offset, false);
+    CHECK(grid.nDomains() == 64);
+    CHECK(grid.getDataSize() == 128);
+    CHECK(grid.getVolume() == Approx(64.0));
+    CHECK(grid.getDomainVolumes()(42, 0) == Approx(1.0));
+    CHECK(grid.getDomainCenters()(42, 0) == Approx(0.5));
+
+    NESpaceGrid::ParticlePos R(3);
+    R[0] = Point{0.1, 0.1, 0.1};
+    R[1] = Point{-1.9, 0.6, 1.9};
+    R[2] = Point{2.5, 0.0, 0.0};
+    Matrix<Real> values(3, nvalues);
+    for (int p = 0; p < 3; p++)
+      for (int v = 0; v < nvalues; v++)
+        values(p, v) = p + 1 + v * 0.5;
+    std::vector<Real> data(offset + grid.getDataSize(), 0.0);
+    std::vector<bool> particles_outside(3, true);
+    grid.accumulate(R, values, data, particles_outside);
+
+    // domain index is 16 * i + 4 * j + k
+    CHECK(data[offset + nvalues * 42] == Approx(1.0));
+    CHECK(data[offset + nvalues * 42 + 1] == Approx(1.5));
+    CHECK(data[offset + nvalues * 11] == Approx(2.0));
+    CHECK(data[offset + nvalues * 11 + 1] == Approx(2.5));
+    CHECK(!particles_outside[0]);
+    CHECK(!particles_outside[1]);
+    CHECK(particles_outside[2]);
+    std::array<Real, nvalues> sums;
+    grid.sum(data, sums.data());
+    CHECK(sums[0] == Approx(3.0));
+    CHECK(sums[1] == Approx(4.0));
+  }
+
+  SECTION("cylindrical")
+  {
+    auto sgi = makeSpaceGridInput(R"XML(
+<spacegrid coord="cylindrical">
+  <axis p1="x" scale="2.0" label="r"   grid="0 (.5) 1"/>
+  <axis p1="y" scale="2.0" label="phi" grid="0 (.25) 1"/>
+  <axis p1="z" scale="2.0" label="z"   grid="-1 (1.0) 1"/>
+</spacegrid>
+)XML");
+    NESpaceGrid grid(sgi, points, nvalues, offset, true);
+    CHECK(grid.nDomains() == 16);
+
+    NESpaceGrid::ParticlePos R(3);
+    R[0] = Point{0.6, 0.0, 0.5};
+    R[1] = Point{-0.6, -1.2, -0.5};
+    R[2] = Point{3.0, 0.0, 0.0};
+    Matrix<Real> values(3, nvalues);
+    for (int p = 0; p < 3; p++)
+      for (int v = 0; v < nvalues; v++)
+        values(p, v) = p + 1;
+    std::vector<Real> data(offset + grid.getDataSize(), 0.0);
+    std::vector<bool> particles_outside(3, true);
+    grid.accumulate(R, values, data, particles_outside);
+
+    // domain index is 8 * ir + 2 * iphi + iz
+    CHECK(data[offset + nvalues * 5] == Approx(1.0));
+    CHECK(data[offset + nvalues * 8] == Approx(2.0));
+    CHECK(!particles_outside[0]);
+    CHECK(!particles_outside[1]);
+    CHECK(particles_outside[2]);
+  }
+}
+
+TEST_CASE("NEEnergyDensityEstimator::accumulate", "[estimators]")
+{
+  using namespace testing::energydensity;
+  using MCPWalker = OperatorEstBase::MCPWalker;
+
+  Communicate* comm  = OHMMS::Controller;
+  auto particle_pool = MinimalParticlePool::make_diamondC_1x1x1(comm);
+  auto& pset_target  = *(particle_pool.getParticleSet("e"));
+  auto& pset_source  = *(particle_pool.getParticleSet("ion"));
+  // the static particle set is found through the distance tables of the dynamic one
+  pset_target.addTable(pset_source);
+
+  const int nelec        = pset_target.getTotalNum();
+  const int nions        = pset_source.getTotalNum();
+  constexpr int nwalkers = 3;
+
+  std::vector<MCPWalker> walkers;
+  for (int iw = 0; iw < nwalkers; ++iw)
+    walkers.emplace_back(nelec);
+  std::vector<ParticleSet> psets(nwalkers, pset_target);
+  for (int iw = 0; iw < nwalkers; ++iw)
+    for (int ip = 0; ip < nelec; ++ip)
+      psets[iw].R[ip] = ParticleSet::PosType(0.3 * ip - 0.5 * iw, 0.2 * ip + 0.1, -0.4 * ip + 0.7 * iw);
+  std::vector<TrialWaveFunction> wfns;
+  auto ref_walkers = makeRefVector<MCPWalker>(walkers);
+  auto ref_psets   = makeRefVector<ParticleSet>(psets);
+  auto ref_wfns    = makeRefVector<TrialWaveFunction>(wfns);
+  RandomGenerator rng;
+
+  // Two local potential operators report for each walker, only one reports ion values.
+  auto reportEnergies = [&](NEEnergyDensityEstimator& ede) {
+    ListenerVector<Real> kinetic("kinetic", ede.getListener(ede.get_kinetic_values()));
+    ListenerVector<Real> local_pot("local_pot", ede.getListener(ede.get_local_pot_values()));
+    ListenerVector<Real> local_ion_pot("local_ion_pot", ede.getListener(ede.get_local_ion_pot_values()));
+    Vector<Real> elec_values(nelec, 1.0);
+    Vector<Real> ion_values(nions, 0.5);
+    for (int iw = 0; iw < nwalkers; ++iw)
+    {
+      kinetic.report(iw, "Kinetic", elec_values);
+      local_pot.report(iw, "ElecElec", elec_values);
+      local_pot.report(iw, "LocalECP", elec_values);
+      local_ion_pot.report(iw, "NonLocalECP", ion_values);
+    }
+  };
+
+  auto sumValues = [](NEEnergyDensityEstimator& ede) {
+    std::array<Real, NEEnergyDensityEstimator::N_EDVALS> sums;
+    const auto& data = ede.get_data();
+    for (int v = 0; v < NEEnergyDensityEstimator::N_EDVALS; v++)
+      sums[v] = data[ede.get_outside_buffer_offset() + v];
+    for (auto& spacegrid : ede.get_spacegrids())
+    {
+      std::array<Real, NEEnergyDensityEstimator::N_EDVALS> grid_sums{};
+      spacegrid.sum(data, grid_sums.data());
+      for (int v = 0; v < NEEnergyDensityEstimator::N_EDVALS; v++)
+        sums[v] += grid_sums[v];
+    }
+    for (int i = 0; i < (data.size() - ede.get_ion_buffer_offset()) / NEEnergyDensityEstimator::N_EDVALS; i++)
+      for (int v = 0; v < NEEnergyDensityEstimator::N_EDVALS; v++)
+        sums[v] += data[ede.get_ion_buffer_offset() + i * NEEnergyDensityEstimator::N_EDVALS + v];
+    return sums;
+  };
+
+  SECTION("cell grid")
+  {
+    NEEnergyDensityEstimator ede(makeEnergyDensityInput(valid_energy_density_input_sections[valid_cell_input]),
+                                 pset_target);
+    REQUIRE(ede.get_spacegrids().size() == 1);
+    CHECK(ede.get_spacegrids()[0].nDomains() == 8000);
+    CHECK(ede.get_data().size() == NEEnergyDensityEstimator::N_EDVALS * (1 + 8000));
+
+    auto crowd_ede = ede.spawnCrowdClone();
+    auto& crowd_ed = dynamic_cast<NEEnergyDensityEstimator&>(*crowd_ede);
+    reportEnergies(crowd_ed);
+    crowd_ed.accumulate(ref_walkers, ref_psets, ref_wfns, rng);
+
+    // every particle is binned once, either in the grid or outside of it
+    auto sums = sumValues(crowd_ed);
+    CHECK(sums[NEEnergyDensityEstimator::W] == Approx(nwalkers * (nelec + nions)));
+    CHECK(sums[NEEnergyDensityEstimator::T] == Approx(nwalkers * nelec));
+    CHECK(sums[NEEnergyDensityEstimator::V] == Approx(nwalkers * (2.0 * nelec + 0.5 * nions)));
+
+    // repeated reports, i.e. the initial evaluation and warm-up steps, overwrite instead of accumulate
+    reportEnergies(crowd_ed);
+    reportEnergies(crowd_ed);
+    crowd_ed.accumulate(ref_walkers, ref_psets, ref_wfns, rng);
+    auto sums_twice = sumValues(crowd_ed);
+    for (int v = 0; v < NEEnergyDensityEstimator::N_EDVALS; v++)
+      CHECK(sums_twice[v] == Approx(2.0 * sums[v]));
+
+    RefVector<OperatorEstBase> crowd_edes{*crowd_ede};
+    ede.collect(crowd_edes);
+    auto rank_sums = sumValues(ede);
+    for (int v = 0; v < NEEnergyDensityEstimator::N_EDVALS; v++)
+      CHECK(rank_sums[v] == Approx(sums_twice[v]));
+  }
+
+  SECTION("spherical grid with ion points")
+  {
+    NEEnergyDensityEstimator ede(makeEnergyDensityInput(
+                                     valid_energy_density_input_sections[valid_spherical_ion_points_input]),
+                                 pset_target);
+    CHECK(ede.get_data().size() - ede.get_ion_buffer_offset() == nions * NEEnergyDensityEstimator::N_EDVALS);
+
+    auto crowd_ede = ede.spawnCrowdClone();
+    auto& crowd_ed = dynamic_cast<NEEnergyDensityEstimator&>(*crowd_ede);
+    reportEnergies(crowd_ed);
+    crowd_ed.accumulate(ref_walkers, ref_psets, ref_wfns, rng);
+
+    auto sums = sumValues(crowd_ed);
+    CHECK(sums[NEEnergyDensityEstimator::W] == Approx(nwalkers * (nelec + nions)));
+    CHECK(sums[NEEnergyDensityEstimator::T] == Approx(nwalkers * nelec));
+    CHECK(sums[NEEnergyDensityEstimator::V] == Approx(nwalkers * (2.0 * nelec + 0.5 * nions)));
+    const auto& data = crowd_ed.get_data();
+    for (int i = 0; i < nions; i++)
+    {
+      const int bi = crowd_ed.get_ion_buffer_offset() + i * NEEnergyDensityEstimator::N_EDVALS;
+      CHECK(data[bi + NEEnergyDensityEstimator::W] == Approx(nwalkers));
+      CHECK(data[bi + NEEnergyDensityEstimator::T] == Approx(0.0));
+      CHECK(data[bi + NEEnergyDensityEstimator::V] == Approx(nwalkers * 0.5));
+    }
+  }
+
+  SECTION("dynamic particle set mismatch")
+  {
+    CHECK_THROWS_AS(NEEnergyDensityEstimator(makeEnergyDensityInput(
+                                                 valid_energy_density_input_sections[valid_cell_input]),
+                                             pset_source),
+                    UniformCommunicateError);
+  }
+}
+
+} // namespace qmcplusplus
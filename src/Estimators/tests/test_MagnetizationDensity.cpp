@@ -150,6 +150,19 @@ TEST_CASE("MagnetizationDensity::spawnCrowdClone()", "[estimators]")
   REQUIRE(clone != nullptr);
   REQUIRE(clone.get() != &original);
   REQUIRE(dynamic_cast<decltype(&original)>(clone.get()) != nullptr);
+  CHECK(clone->get_data().size() == original.get_data().size());
+
+  Libxml2Document doc_save_memory;
+  okay = doc_save_memory.parseFromString(
+      magdensity::valid_mag_density_input_sections[magdensity::Inputs::valid_magdensity_input_save_memory]);
+  REQUIRE(okay);
+  MagnetizationDensityInput mdi_save_memory(doc_save_memory.getRoot());
+  CHECK(mdi_save_memory.get_save_memory());
+  MagnetizationDensity rank_magdens(std::move(mdi_save_memory), lattice);
+  CHECK(rank_magdens.get_data_locality() == DataLocality::rank);
+  auto queue_clone = rank_magdens.spawnCrowdClone();
+  CHECK(queue_clone->get_data_locality() == DataLocality::queue);
+  CHECK(queue_clone->get_data().empty());
 }
 TEST_CASE("MagnetizationDensity::integrals", "[estimators]")
 {
@@ -460,6 +473,12 @@ TEST_CASE("MagnetizationDensity::IntegrationTest", "[estimators]")
 
   MagnetizationDensityTests magdenstest;
   magdenstest.testData(magdensity, ref_data);
+
+  //The second accumulation reuses the crowd's virtual particle sets.
+  magdensity.accumulate(ref_walkers, ref_psets, ref_twfcs, rng);
+  for (auto& value : ref_data)
+    value *= 2;
+  magdenstest.testData(magdensity, ref_data);
 }
 #endif
 } // namespace qmcplusplus
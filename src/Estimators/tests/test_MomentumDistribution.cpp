@@ -213,6 +213,77 @@ TEST_CASE("MomentumDistribution::accumulate", "[estimators]")
   outputManager.resume();
 }
 
+TEST_CASE("MomentumDistribution::accumulate_k_tiles", "[estimators]")
+{
+  using MCPWalker = OperatorEstBase::MCPWalker;
+
+  // enough k-points for several tiles of the n(k) matrix product
+  const char* xml = R"(
+<estimator type="MomentumDistribution" name="nofk" samples="3" kmax="12"/>
+)";
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(xml);
+  REQUIRE(okay);
+  MomentumDistributionInput mdi(doc.getRoot());
+
+  ProjectData test_project("test", ProjectData::DriverVersion::BATCH);
+  Communicate* comm = OHMMS::Controller;
+  outputManager.pause();
+  auto particle_pool = MinimalParticlePool::make_diamondC_1x1x1(comm);
+  auto wavefunction_pool =
+      MinimalWaveFunctionPool::make_diamondC_1x1x1(test_project.getRuntimeOptions(), comm, particle_pool);
+  auto& pset = *(particle_pool.getParticleSet("e"));
+  pset.R     = ParticleSet::ParticlePos{{1.751870349, 4.381521229, 2.865202269}, {3.244515371, 4.382273176, 4.21105285},
+                                    {3.000459944, 3.329603408, 4.265030556}, {3.748660329, 3.63420622, 5.393637791},
+                                    {3.033228526, 3.391869137, 4.654413566}, {3.114198787, 2.654334594, 5.231075822},
+                                    {3.657151589, 4.883870516, 4.201243939}, {2.97317591, 4.245644974, 4.284564732}};
+
+  MomentumDistribution md(std::move(mdi), pset.getTotalNum(), pset.getTwist(), pset.getLattice(),
+                          DataLocality::crowd);
+  const int nk = md.kPoints.size();
+  REQUIRE(nk > 2 * MomentumDistribution::K_TILE);
+
+  std::vector<MCPWalker> walkers;
+  walkers.emplace_back(8);
+  std::vector<ParticleSet> psets{pset};
+  auto psi = wavefunction_pool.getPrimary()->makeClone(psets[0]);
+  psets[0].update(true);
+  psets[0].donePbyP();
+  psi->evaluateLog(psets[0]);
+  psets[0].saveWalker(walkers[0]);
+  walkers[0].Weight = 1.0;
+
+  RandomGenerator rng;
+  RandomGenerator rng_ref(rng);
+  std::vector<UPtr<TrialWaveFunction>> wfns;
+  wfns.push_back(std::move(psi));
+  md.accumulate(makeRefVector<MCPWalker>(walkers), makeRefVector<ParticleSet>(psets), convertUPtrToRefVector(wfns),
+                rng);
+
+  // direct sum over particles, samples and k-points
+  const int np = psets[0].getTotalNum();
+  std::vector<QMCTraits::ValueType> ratios(np);
+  std::vector<std::complex<double>> ref_nofk(nk);
+  for (int s = 0; s < 3; ++s)
+  {
+    PosType newpos;
+    for (int i = 0; i < OHMMS_DIM; ++i)
+      newpos[i] = rng_ref();
+    const PosType vpos = md.Lattice.toCart(newpos);
+    psets[0].makeVirtualMoves(vpos);
+    wfns[0]->evaluateRatiosAlltoOne(psets[0], ratios);
+    for (int i = 0; i < np; ++i)
+      for (int ik = 0; ik < nk; ++ik)
+        ref_nofk[ik] += std::complex<double>(ratios[i]) *
+            std::exp(std::complex<double>(0, dot(md.kPoints[ik], psets[0].R[i] - vpos)));
+  }
+
+  std::vector<RealType>& data = md.get_data();
+  for (int ik = 0; ik < nk; ++ik)
+    CHECK(data[ik] == Approx(ref_nofk[ik].real() / 3.0).margin(1.e-4));
+  outputManager.resume();
+}
+
 TEST_CASE("MomentumDistribution::spawnCrowdClone", "[estimators]")
 {
   // clang-format: off
@@ -36,6 +36,7 @@
 #include "Utilities/StlPrettyPrint.hpp"
 #include "Utilities/ProjectData.h"
 #include "Utilities/for_testing/NativeInitializerPrint.hpp"
+#include <ResourceCollection.h>
 #include <iostream>
 
 namespace qmcplusplus
@@ -445,6 +446,16 @@ TEST_CASE("OneBodyDensityMatrices::accumulate", "[estimators]")
   auto ref_psets(makeRefVector<ParticleSet>(psets));
   auto ref_twfcs(convertUPtrToRefVector(twfcs));
 
+  // accumulate is batched over the crowd, as in the drivers the crowd's resources are acquired around it.
+  ResourceCollection pset_res("test_pset_res");
+  ResourceCollection twf_res("test_twf_res");
+  psets[0].createResource(pset_res);
+  twfcs[0]->createResource(twf_res);
+  RefVectorWithLeader<ParticleSet> p_list(psets[0], ref_psets);
+  RefVectorWithLeader<TrialWaveFunction> wf_list(*twfcs[0], ref_twfcs);
+  ResourceCollectionTeamLock<ParticleSet> mw_pset_lock(pset_res, p_list);
+  ResourceCollectionTeamLock<TrialWaveFunction> mw_twf_lock(twf_res, wf_list);
+
   OneBodyDensityMatricesTests<double> obdmt;
   obdmt.testAccumulate(obdm, ref_walkers, ref_psets, ref_twfcs, rng);
 
@@ -0,0 +1,128 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "PairCorrelationEstimator.h"
+#include "PairCorrelationInput.h"
+#include "ParticleSet.h"
+#include "TrialWaveFunction.h"
+#include "Particle/DistanceTable.h"
+#include "OhmmsData/Libxml2Doc.h"
+#include "Message/UniformCommunicateError.h"
+#include "Particle/tests/MinimalParticlePool.h"
+
+namespace qmcplusplus
+{
+using Real = QMCTraits::RealType;
+
+TEST_CASE("PairCorrelationInput::from_xml", "[estimators]")
+{
+  {
+    std::string_view xml{R"XML(
+<estimator type="PairCorrelation" name="gofr_e" rmax="2.0" num_bin="40"/>
+)XML"};
+    Libxml2Document doc;
+    bool okay = doc.parseFromString(xml);
+    REQUIRE(okay);
+    PairCorrelationInput pci(doc.getRoot());
+    CHECK(pci.get_name() == "gofr_e");
+    REQUIRE(pci.get_rmax());
+    CHECK(*pci.get_rmax() == Approx(2.0));
+    REQUIRE(pci.get_num_bin());
+    CHECK(*pci.get_num_bin() == 40);
+  }
+  {
+    std::string_view xml{R"XML(
+<estimator type="PairCorrelation" rmax="-2.0"/>
+)XML"};
+    Libxml2Document doc;
+    bool okay = doc.parseFromString(xml);
+    REQUIRE(okay);
+    CHECK_THROWS_AS(PairCorrelationInput(doc.getRoot()), UniformCommunicateError);
+  }
+}
+
+TEST_CASE("PairCorrelationEstimator::accumulate", "[estimators]")
+{
+  using MCPWalker = OperatorEstBase::MCPWalker;
+
+  Communicate* comm  = OHMMS::Controller;
+  auto particle_pool = MinimalParticlePool::make_diamondC_1x1x1(comm);
+  auto& pset_target  = *(particle_pool.getParticleSet("e"));
+
+  PairCorrelationInput pci;
+  PairCorrelationEstimator pce(std::move(pci), pset_target);
+  const auto& lattice = pset_target.getLattice();
+  CHECK(pce.get_rmax() == Approx(lattice.WignerSeitzRadius));
+  CHECK(pce.get_num_bins() == static_cast<int>(std::ceil(lattice.WignerSeitzRadius / 0.5)));
+  // u_u, u_d, d_d
+  CHECK(pce.get_num_pairs() == 3);
+  CHECK(pce.get_data().size() == 3 * pce.get_num_bins());
+
+  const int nelec        = pset_target.getTotalNum();
+  constexpr int nwalkers = 2;
+  std::vector<MCPWalker> walkers;
+  for (int iw = 0; iw < nwalkers; ++iw)
+  {
+    walkers.emplace_back(nelec);
+    walkers.back().Weight = 1.0 + iw;
+  }
+  // the walker psets must be cloned after the estimator has requested the AA table
+  std::vector<ParticleSet> psets(nwalkers, pset_target);
+  for (int iw = 0; iw < nwalkers; ++iw)
+  {
+    for (int ip = 0; ip < nelec; ++ip)
+      psets[iw].R[ip] = ParticleSet::PosType(0.3 * ip - 0.5 * iw, 0.2 * ip + 0.1, -0.4 * ip + 0.7 * iw);
+    psets[iw].update();
+  }
+  std::vector<TrialWaveFunction> wfns;
+  auto ref_walkers = makeRefVector<MCPWalker>(walkers);
+  auto ref_psets   = makeRefVector<ParticleSet>(psets);
+  auto ref_wfns    = makeRefVector<TrialWaveFunction>(wfns);
+  RandomGenerator rng;
+
+  auto crowd_oeb = pce.spawnCrowdClone();
+  crowd_oeb->accumulate(ref_walkers, ref_psets, ref_wfns, rng);
+
+  // histogram the pairs one at a time
+  const int nbins = pce.get_num_bins();
+  std::vector<Real> gofr_ref(3 * nbins, 0.0);
+  for (int iw = 0; iw < nwalkers; ++iw)
+  {
+    const auto& dii = psets[iw].getDistTableAA(0);
+    for (int i = 1; i < nelec; ++i)
+      for (int j = 0; j < i; ++j)
+      {
+        const Real r = dii.getDistRow(i)[j];
+        if (r >= pce.get_rmax())
+          continue;
+        const int bin     = static_cast<int>(r / pce.get_delta());
+        const int pair_id = PairCorrelationEstimator::gen_pair_id(psets[iw].getGroupID(i), psets[iw].getGroupID(j), 2);
+        gofr_ref[pair_id * nbins + bin] += walkers[iw].Weight * pce.get_norm_factor()(pair_id, bin);
+      }
+  }
+  auto& data = crowd_oeb->get_data();
+  Real total = 0.0;
+  for (int i = 0; i < gofr_ref.size(); ++i)
+  {
+    CHECK(data[i] == Approx(gofr_ref[i]));
+    total += data[i];
+  }
+  CHECK(total > 0.0);
+
+  RefVector<OperatorEstBase> crowd_oebs{*crowd_oeb};
+  pce.collect(crowd_oebs);
+  for (int i = 0; i < gofr_ref.size(); ++i)
+    CHECK(pce.get_data()[i] == Approx(gofr_ref[i]));
+}
+
+} // namespace qmcplusplus
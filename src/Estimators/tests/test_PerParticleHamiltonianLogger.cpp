@@ -15,6 +15,8 @@
 
 #include <filesystem>
 
+#include "Message/UniformCommunicateError.h"
+#include "QMCDrivers/WalkerProperties.h"
 #include "Utilities/StdRandom.h"
 
 namespace qmcplusplus
@@ -137,4 +139,126 @@ TEST_CASE("PerParticleHamiltonianLogger_sum", "[estimators]")
   CHECK(std::filesystem::exists("rank_0_per_particle_log.dat"));
 }
 
+TEST_CASE("PerParticleHamiltonianLogger_hdf5", "[estimators]")
+{
+  std::string_view xml{R"XML(
+<PerParticleHamiltonianLogger format="hdf5" energy_sigma="2.0"/>
+)XML"};
+
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(xml);
+  REQUIRE(okay);
+  PerParticleHamiltonianLoggerInput pphli(doc.getRoot());
+  CHECK(pphli.get_format() == PerParticleHamiltonianLoggerInput::Format::HDF5);
+  CHECK(pphli.get_energy_sigma() == Approx(2.0));
+
+  std::string_view bad_xml{R"XML(
+<PerParticleHamiltonianLogger energy_sigma="-1.0"/>
+)XML"};
+  okay = doc.parseFromString(bad_xml);
+  REQUIRE(okay);
+  CHECK_THROWS_AS(PerParticleHamiltonianLoggerInput(doc.getRoot()), UniformCommunicateError);
+
+  const std::string file_name("per_particle_log_test.s000.p000.per_particle_log.h5");
+  const int ncrowds   = 2;
+  const int nwalkers  = 3;
+  const int nparticle = 2;
+  {
+    PerParticleHamiltonianLogger rank_logger(std::move(pphli), 0);
+    // every section writes its own file
+    rank_logger.openOutput("per_particle_log_test.s001");
+    rank_logger.openOutput("per_particle_log_test.s000");
+    UPtrVector<OperatorEstBase> crowd_loggers;
+    for (int ic = 0; ic < ncrowds; ++ic)
+      crowd_loggers.emplace_back(rank_logger.spawnCrowdClone());
+
+    const SimulationCell simulation_cell;
+    std::vector<OperatorEstBase::MCPWalker> walkers;
+    std::vector<ParticleSet> psets;
+    for (int iw = 0; iw < nwalkers; ++iw)
+    {
+      walkers.emplace_back(nparticle);
+      psets.emplace_back(simulation_cell);
+      psets.back().create({nparticle});
+    }
+    std::vector<TrialWaveFunction> wfns;
+    auto ref_walkers = makeRefVector<OperatorEstBase::MCPWalker>(walkers);
+    auto ref_psets   = makeRefVector<ParticleSet>(psets);
+    auto ref_wfns    = makeRefVector<TrialWaveFunction>(wfns);
+    RandomGenerator rng;
+
+    std::vector<ListenerVector<Real>> listeners;
+    for (auto& crowd_oeb : crowd_loggers)
+      listeners.emplace_back("Talker", dynamic_cast<PerParticleHamiltonianLogger&>(*crowd_oeb).getLogger());
+
+    // the first block is not filtered, in the second only the walker with local energy 0 is an outlier
+    auto localEnergy = [](int block, int iw) { return (block == 2 && iw == 2) ? 0.0 : -10.0 + 0.1 * iw; };
+    for (int block = 1; block <= 2; ++block)
+    {
+      rank_logger.startBlock(1);
+      for (int ic = 0; ic < ncrowds; ++ic)
+      {
+        for (int iw = 0; iw < nwalkers; ++iw)
+        {
+          OperatorEstBase::MCPWalker& walker                        = walkers[iw];
+          walker.ID                                                 = ic * nwalkers + iw;
+          walker.Properties(WalkerProperties::Indexes::LOCALENERGY) = localEnergy(block, iw);
+          Vector<Real> values(nparticle);
+          values[0] = walker.ID;
+          values[1] = block;
+          listeners[ic].report(iw, "Kinetic", values);
+          listeners[ic].report(iw, "LocalECP", values);
+        }
+        crowd_loggers[ic]->accumulate(ref_walkers, ref_psets, ref_wfns, rng);
+      }
+      rank_logger.collect(convertUPtrToRefVector(crowd_loggers));
+      for (auto& crowd_oeb : crowd_loggers)
+        CHECK(dynamic_cast<PerParticleHamiltonianLogger&>(*crowd_oeb).get_buffer().num_rows() == 0);
+    }
+    CHECK(rank_logger.get_energy_reference().count() == Approx(2 * ncrowds * nwalkers));
+    rank_logger.waitForPendingWrite();
+  }
+
+  const size_t nrows = ncrowds * nwalkers + ncrowds;
+  hdf_archive hd;
+  okay = hd.open(file_name);
+  REQUIRE(okay);
+  int num_particles = 0;
+  std::vector<std::string> operator_names;
+  hd.read(num_particles, "per_particle_log/num_particles");
+  hd.read(operator_names, "per_particle_log/operator_names");
+  CHECK(num_particles == nparticle);
+  CHECK(operator_names == std::vector<std::string>{"Kinetic", "LocalECP"});
+  std::vector<long> blocks;
+  std::vector<long> walker_ids;
+  std::vector<QMCT::FullPrecRealType> local_energies;
+  std::vector<Real> kinetic;
+  hd.read(blocks, "per_particle_log/block");
+  hd.read(walker_ids, "per_particle_log/walker_id");
+  hd.read(local_energies, "per_particle_log/local_energy");
+  hd.readSlabReshaped(kinetic, std::array<size_t, 2>{nrows, nparticle}, "per_particle_log/per_particle/Kinetic");
+  REQUIRE(walker_ids.size() == nrows);
+  REQUIRE(kinetic.size() == nrows * nparticle);
+  int row = 0;
+  for (int ic = 0; ic < ncrowds; ++ic)
+    for (int iw = 0; iw < nwalkers; ++iw, ++row)
+    {
+      CHECK(blocks[row] == 1);
+      CHECK(walker_ids[row] == ic * nwalkers + iw);
+      CHECK(kinetic[row * nparticle] == Approx(ic * nwalkers + iw));
+      CHECK(kinetic[row * nparticle + 1] == Approx(1));
+    }
+  for (int ic = 0; ic < ncrowds; ++ic, ++row)
+  {
+    CHECK(blocks[row] == 2);
+    CHECK(walker_ids[row] == ic * nwalkers + 2);
+    CHECK(local_energies[row] == Approx(0.0));
+    CHECK(kinetic[row * nparticle + 1] == Approx(2));
+  }
+  hd.close();
+  std::filesystem::remove(file_name);
+  CHECK(std::filesystem::exists("per_particle_log_test.s001.p000.per_particle_log.h5"));
+  std::filesystem::remove("per_particle_log_test.s001.p000.per_particle_log.h5");
+}
+
 } // namespace qmcplusplus
@@ -0,0 +1,69 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "ReblockingAccumulator.hpp"
+#include "RandomForTest.h"
+
+namespace qmcplusplus
+{
+
+TEST_CASE("ReblockingAccumulator", "[estimators]")
+{
+  ReblockingAccumulator<double> reblocking;
+  CHECK(reblocking.count() == 0);
+  CHECK(reblocking.error() == 0.0);
+  CHECK(reblocking.autocorrelationTime() == 1.0);
+
+  for (double x : {1.0, 2.0, 3.0, 4.0, 5.0})
+    reblocking(x);
+  // 5 samples, 2 pairs, 1 pair of pairs
+  CHECK(reblocking.count() == 5);
+  CHECK(reblocking.get_num_levels() == 3);
+  CHECK(reblocking.mean() == Approx(3.0));
+  // population variance 2, standard error sqrt(2 / 4)
+  CHECK(reblocking.levelError(0) == Approx(std::sqrt(0.5)));
+  // level 1 holds 1.5 and 3.5
+  CHECK(reblocking.levelError(1) == Approx(1.0));
+  // too few samples for the higher levels to enter the error
+  CHECK(reblocking.error() == Approx(std::sqrt(0.5)));
+  CHECK(!reblocking.isReliable());
+
+  reblocking.clear();
+  CHECK(reblocking.count() == 0);
+  CHECK(reblocking.get_num_levels() == 0);
+}
+
+TEST_CASE("ReblockingAccumulator correlated series", "[estimators]")
+{
+  const int num_blocks  = 1024;
+  const int correlation = 8;
+  testing::RandomForTest<double> rng_for_test;
+  std::vector<double> rng_reals(num_blocks);
+  rng_for_test.fillVecRng(rng_reals);
+
+  ReblockingAccumulator<double> uncorrelated;
+  ReblockingAccumulator<double> correlated;
+  for (int i = 0; i < num_blocks; ++i)
+  {
+    uncorrelated(rng_reals[i]);
+    // every value is repeated correlation times
+    correlated(rng_reals[i / correlation]);
+  }
+  CHECK(uncorrelated.isReliable());
+  CHECK(correlated.isReliable());
+  CHECK(uncorrelated.autocorrelationTime() < 2.0);
+  // the naive error of the repeated series underestimates its error by about sqrt(correlation)
+  CHECK(correlated.autocorrelationTime() > correlation / 2);
+  CHECK(correlated.error() > correlated.levelError(0));
+}
+
+} // namespace qmcplusplus
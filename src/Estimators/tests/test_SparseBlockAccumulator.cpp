@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "SparseBlockAccumulator.hpp"
+#include "RandomForTest.h"
+
+#include <functional>
+#include <numeric>
+
+namespace qmcplusplus
+{
+
+TEST_CASE("SparseBlockAccumulator", "[estimators]")
+{
+  // last block is partial
+  SparseBlockAccumulator<double> buffer(1000, 64);
+  CHECK(buffer.get_num_blocks() == 16);
+  CHECK(buffer.get_num_touched_blocks() == 0);
+  buffer.add(3, 1.0);
+  buffer.add(5, 2.0);
+  buffer.add(999, 3.0);
+  buffer.add(3, 0.5);
+  CHECK(buffer.get_num_touched_blocks() == 2);
+
+  std::vector<double> data(1000, 1.0);
+  SparseBlockAccumulator<double>::reduceInto(data, {buffer});
+  CHECK(data[3] == 2.5);
+  CHECK(data[5] == 3.0);
+  CHECK(data[999] == 4.0);
+  CHECK(data[4] == 1.0);
+  CHECK(data[998] == 1.0);
+
+  buffer.clear();
+  CHECK(buffer.get_num_touched_blocks() == 0);
+  buffer.add(998, 1.0);
+  CHECK(buffer.get_num_touched_blocks() == 1);
+  SparseBlockAccumulator<double>::reduceInto(data, {buffer});
+  CHECK(data[998] == 2.0);
+  CHECK(data[999] == 4.0);
+
+  std::vector<double> wrong_size(10);
+  CHECK_THROWS_AS(SparseBlockAccumulator<double>::reduceInto(wrong_size, {buffer}), std::runtime_error);
+}
+
+TEST_CASE("SparseBlockAccumulator storage is bounded", "[estimators]")
+{
+  const size_t full_size  = 1000;
+  const size_t block_size = 64;
+  SparseBlockAccumulator<double> buffer(full_size, block_size);
+  std::vector<double> full_data(full_size, 0.0);
+  // a crowd that covers the whole grid
+  for (int sweep = 0; sweep < 3; ++sweep)
+    for (size_t i = 0; i < full_size; i += 7)
+    {
+      const size_t index = (i * 13 + sweep) % full_size;
+      buffer.add(index, 0.5 + sweep);
+      full_data[index] += 0.5 + sweep;
+      CHECK(buffer.get_storage_capacity() <= buffer.get_num_blocks() * block_size);
+    }
+  CHECK(buffer.isDense());
+  CHECK(buffer.get_num_touched_blocks() == buffer.get_num_blocks());
+
+  std::vector<double> reduction(full_size, 0.0);
+  SparseBlockAccumulator<double>::reduceInto(reduction, {buffer});
+  for (size_t i = 0; i < full_size; ++i)
+    CHECK(reduction[i] == full_data[i]);
+
+  // a dense buffer is zeroed for the next Monte Carlo block
+  buffer.clear();
+  CHECK(buffer.isDense());
+  buffer.add(10, 1.0);
+  std::fill(reduction.begin(), reduction.end(), 0.0);
+  SparseBlockAccumulator<double>::reduceInto(reduction, {buffer});
+  CHECK(reduction[10] == 1.0);
+  CHECK(std::accumulate(reduction.begin(), reduction.end(), 0.0) == 1.0);
+}
+
+TEST_CASE("SparseBlockAccumulator::reduceInto matches full crowd data", "[estimators]")
+{
+  const size_t full_size = 5000;
+  const int ncrowds      = 4;
+  const int nsamples     = 300;
+
+  testing::RandomForTest<double> rng_for_test;
+  std::vector<std::vector<double>> crowd_data(ncrowds, std::vector<double>(full_size, 0.0));
+  std::vector<SparseBlockAccumulator<double>> crowd_buffers(ncrowds, SparseBlockAccumulator<double>(full_size, 128));
+  for (int ic = 0; ic < ncrowds; ++ic)
+  {
+    std::vector<double> rng_reals(nsamples * 2);
+    rng_for_test.fillVecRng(rng_reals);
+    // samples are clustered in the first half of the grid so some blocks are never touched
+    for (int is = 0; is < nsamples; ++is)
+    {
+      size_t index = static_cast<size_t>(rng_reals[2 * is] * full_size / 2);
+      crowd_data[ic][index] += rng_reals[2 * is + 1];
+      crowd_buffers[ic].add(index, rng_reals[2 * is + 1]);
+    }
+    CHECK(crowd_buffers[ic].get_num_touched_blocks() < crowd_buffers[ic].get_num_blocks());
+  }
+
+  // the crowd DataLocality reduction
+  std::vector<double> full_reduction(full_size, 0.0);
+  for (auto& data : crowd_data)
+    std::transform(full_reduction.begin(), full_reduction.end(), data.begin(), full_reduction.begin(), std::plus<>{});
+
+  std::vector<double> sparse_reduction(full_size, 0.0);
+  RefVector<const SparseBlockAccumulator<double>> buffer_refs(crowd_buffers.begin(), crowd_buffers.end());
+  SparseBlockAccumulator<double>::reduceInto(sparse_reduction, buffer_refs);
+
+  // the summation order is the same so the results must be bitwise identical
+  for (size_t i = 0; i < full_size; ++i)
+    if (full_reduction[i] != sparse_reduction[i])
+      FAIL_CHECK("full " << full_reduction[i] << " != sparse " << sparse_reduction[i] << " at index " << i);
+}
+
+} // namespace qmcplusplus
@@ -340,7 +340,14 @@ TEST_CASE("SpinDensityNew algorithm comparison", "[estimators]")
   sdn_rank.collect(crowd_oeb_refs_rank);
   std::vector<QMCT::RealType>& data_ref_rank = sdn_rank.get_data();
 
-  SpinDensityNew sdn_crowd(std::move(sdi), species_set, DataLocality::crowd);
+  // crowd clones of a rank estimator only hold the grid blocks their walkers visited
+  for (auto& crowd_sdn : crowd_sdns_rank)
+  {
+    CHECK(crowd_sdn->get_data_locality() == DataLocality::queue);
+    CHECK(crowd_sdn->get_data().empty());
+  }
+
+  SpinDensityNew sdn_crowd(std::move(sdi_copy), species_set, DataLocality::crowd);
   UPtrVector<OperatorEstBase> crowd_sdns_crowd;
   accumulateFromPsets(ncrowds, sdn_crowd, crowd_sdns_crowd);
   testing::RandomForTest<QMCT::RealType> rng_for_test_crowd;
@@ -354,8 +361,8 @@ TEST_CASE("SpinDensityNew algorithm comparison", "[estimators]")
   {
     if (data_ref_crowd[i] != data_ref_rank[i])
       FAIL_CHECK("crowd local " << data_ref_crowd[i] << " != rank local " << data_ref_rank[i] << " at index " << i);
-    break;
   }
+  CHECK(sdn_rank.get_walkers_weight() == sdn_crowd.get_walkers_weight());
 }
 
 
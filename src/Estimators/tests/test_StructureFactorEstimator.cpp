@@ -0,0 +1,121 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "StructureFactorEstimator.h"
+#include "StructureFactorInput.h"
+#include "ParticleSet.h"
+#include "TrialWaveFunction.h"
+#include "LongRange/KContainer.h"
+#include "OhmmsData/Libxml2Doc.h"
+#include "Particle/tests/MinimalParticlePool.h"
+
+namespace qmcplusplus
+{
+using Real = QMCTraits::RealType;
+
+TEST_CASE("StructureFactorInput::from_xml", "[estimators]")
+{
+  std::string_view xml{R"XML(
+<estimator type="StructureFactor" name="sk_e" rhok="yes"/>
+)XML"};
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(xml);
+  REQUIRE(okay);
+  StructureFactorInput sfi(doc.getRoot());
+  CHECK(sfi.get_name() == "sk_e");
+  CHECK(sfi.get_write_rhok());
+
+  StructureFactorInput sfi_default;
+  CHECK(sfi_default.get_name() == "sk");
+  CHECK(!sfi_default.get_write_rhok());
+}
+
+TEST_CASE("StructureFactorEstimator::accumulate", "[estimators]")
+{
+  using MCPWalker = OperatorEstBase::MCPWalker;
+
+  Communicate* comm  = OHMMS::Controller;
+  auto particle_pool = MinimalParticlePool::make_diamondC_1x1x1(comm);
+  auto& pset_target  = *(particle_pool.getParticleSet("e"));
+
+  if (!pset_target.hasSK())
+    pset_target.createSK();
+
+  std::string_view xml{R"XML(
+<estimator type="StructureFactor" name="sk" rhok="yes"/>
+)XML"};
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(xml);
+  REQUIRE(okay);
+  StructureFactorEstimator sfe(StructureFactorInput(doc.getRoot()), pset_target);
+  const auto& k_lists = pset_target.getSimulationCell().getKLists();
+  const int nk        = k_lists.numk;
+  const int nelec     = pset_target.getTotalNum();
+  const int nspecies  = pset_target.groups();
+  CHECK(sfe.get_num_k() == nk);
+  CHECK(sfe.get_data().size() == nk * (1 + 2 * nspecies));
+
+  constexpr int nwalkers = 2;
+  std::vector<MCPWalker> walkers;
+  for (int iw = 0; iw < nwalkers; ++iw)
+  {
+    walkers.emplace_back(nelec);
+    walkers.back().Weight = 0.5 + iw;
+  }
+  std::vector<ParticleSet> psets(nwalkers, pset_target);
+  for (int iw = 0; iw < nwalkers; ++iw)
+  {
+    for (int ip = 0; ip < nelec; ++ip)
+      psets[iw].R[ip] = ParticleSet::PosType(0.3 * ip - 0.5 * iw, 0.2 * ip + 0.1, -0.4 * ip + 0.7 * iw);
+    psets[iw].update();
+  }
+  std::vector<TrialWaveFunction> wfns;
+  auto ref_walkers = makeRefVector<MCPWalker>(walkers);
+  auto ref_psets   = makeRefVector<ParticleSet>(psets);
+  auto ref_wfns    = makeRefVector<TrialWaveFunction>(wfns);
+  RandomGenerator rng;
+
+  auto crowd_oeb = sfe.spawnCrowdClone();
+  crowd_oeb->accumulate(ref_walkers, ref_psets, ref_wfns, rng);
+  auto& data = crowd_oeb->get_data();
+
+  // S(k) computed directly from the positions
+  std::vector<Real> sk_ref(nk, 0.0);
+  std::vector<Real> rhok_r_ref(nk * nspecies, 0.0);
+  for (int iw = 0; iw < nwalkers; ++iw)
+    for (int ik = 0; ik < nk; ++ik)
+    {
+      Real rhok_r = 0.0;
+      Real rhok_i = 0.0;
+      for (int ip = 0; ip < nelec; ++ip)
+      {
+        const Real phase = dot(k_lists.kpts_cart[ik], psets[iw].R[ip]);
+        rhok_r += std::cos(phase);
+        rhok_i += std::sin(phase);
+        rhok_r_ref[psets[iw].getGroupID(ip) * nk + ik] += walkers[iw].Weight * std::cos(phase);
+      }
+      sk_ref[ik] += walkers[iw].Weight * (rhok_r * rhok_r + rhok_i * rhok_i) / nelec;
+    }
+  for (int ik = 0; ik < nk; ++ik)
+    CHECK(data[ik] == Approx(sk_ref[ik]));
+  for (int is = 0; is < nspecies; ++is)
+    for (int ik = 0; ik < nk; ++ik)
+      CHECK(data[nk * (1 + 2 * is) + ik] == Approx(rhok_r_ref[is * nk + ik]).margin(1e-12));
+
+  RefVector<OperatorEstBase> crowd_oebs{*crowd_oeb};
+  sfe.collect(crowd_oebs);
+  for (int ik = 0; ik < nk; ++ik)
+    CHECK(sfe.get_data()[ik] == Approx(sk_ref[ik]));
+}
+
+} // namespace qmcplusplus
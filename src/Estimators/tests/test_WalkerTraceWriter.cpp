@@ -0,0 +1,176 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "WalkerTraceWriter.h"
+
+#include <filesystem>
+
+#include "OhmmsData/Libxml2Doc.h"
+#include "Message/UniformCommunicateError.h"
+#include "QMCDrivers/WalkerProperties.h"
+#include "Utilities/StdRandom.h"
+
+namespace qmcplusplus
+{
+
+using QMCT = QMCTraits;
+using Real = QMCT::RealType;
+
+TEST_CASE("WalkerTraceWriterInput", "[estimators]")
+{
+  std::string_view xml{R"XML(
+<estimator type="WalkerTraces" name="traces">
+  <parameter name="period">2</parameter>
+  <parameter name="particle_quantities">Kinetic LocalECP</parameter>
+  <parameter name="chunk_rows">16</parameter>
+  <parameter name="async">no</parameter>
+</estimator>
+)XML"};
+
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(xml);
+  REQUIRE(okay);
+  WalkerTraceWriterInput wtwi(doc.getRoot());
+  CHECK(wtwi.get_name() == "traces");
+  CHECK(wtwi.get_period() == 2);
+  CHECK(wtwi.get_particle_quantities() == std::vector<std::string>{"Kinetic", "LocalECP"});
+  CHECK(wtwi.get_chunk_rows() == 16);
+  CHECK(!wtwi.get_async());
+
+  std::string_view bad_xml{R"XML(
+<estimator type="WalkerTraces" name="traces">
+  <parameter name="period">0</parameter>
+</estimator>
+)XML"};
+  okay = doc.parseFromString(bad_xml);
+  REQUIRE(okay);
+  CHECK_THROWS_AS(WalkerTraceWriterInput(doc.getRoot()), UniformCommunicateError);
+}
+
+TEST_CASE("WalkerTraceWriter_write", "[estimators]")
+{
+  std::string_view xml{R"XML(
+<estimator type="WalkerTraces" name="traces">
+  <parameter name="period">2</parameter>
+  <parameter name="particle_quantities">Talker</parameter>
+  <parameter name="chunk_rows">4</parameter>
+</estimator>
+)XML"};
+
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(xml);
+  REQUIRE(okay);
+  WalkerTraceWriterInput wtwi(doc.getRoot());
+
+  const int ncrowds   = 2;
+  const int nwalkers  = 3;
+  const int nsteps    = 4;
+  const int nblocks   = 2;
+  const int nparticle = 2;
+  std::string file_name;
+  {
+    WalkerTraceWriter rank_writer(std::move(wtwi), 0);
+    // the file is only created at the start of the driver run, named after the section
+    rank_writer.openOutput("walker_trace_test.s000");
+    file_name = rank_writer.get_file_name();
+    CHECK(file_name == "walker_trace_test.s000.p000.traces.h5");
+
+    UPtrVector<OperatorEstBase> crowd_writers;
+    for (int ic = 0; ic < ncrowds; ++ic)
+      crowd_writers.emplace_back(rank_writer.spawnCrowdClone());
+
+    const SimulationCell simulation_cell;
+    std::vector<OperatorEstBase::MCPWalker> walkers;
+    std::vector<ParticleSet> psets;
+    for (int iw = 0; iw < nwalkers; ++iw)
+    {
+      walkers.emplace_back(nparticle);
+      psets.emplace_back(simulation_cell);
+      psets.back().create({nparticle});
+    }
+    std::vector<TrialWaveFunction> wfns;
+    auto ref_walkers = makeRefVector<OperatorEstBase::MCPWalker>(walkers);
+    auto ref_psets   = makeRefVector<ParticleSet>(psets);
+    auto ref_wfns    = makeRefVector<TrialWaveFunction>(wfns);
+    RandomGenerator rng;
+
+    std::vector<ListenerVector<Real>> listeners;
+    for (auto& crowd_oeb : crowd_writers)
+      listeners.emplace_back("Talker", dynamic_cast<WalkerTraceWriter&>(*crowd_oeb).getListener());
+
+    for (int ib = 0; ib < nblocks; ++ib)
+    {
+      for (int is = 0; is < nsteps; ++is)
+        for (int ic = 0; ic < ncrowds; ++ic)
+        {
+          for (int iw = 0; iw < nwalkers; ++iw)
+          {
+            OperatorEstBase::MCPWalker& walker = walkers[iw];
+            walker.ID                          = ic * nwalkers + iw;
+            walker.Weight                      = ib * nsteps + is;
+            walker.Properties(WalkerProperties::Indexes::LOCALENERGY) = -walker.ID;
+            Vector<Real> values(nparticle);
+            values[0] = walker.ID;
+            values[1] = is;
+            listeners[ic].report(iw, "Talker", values);
+            // components not asked for are ignored
+            listeners[ic].report(iw, "Other", values);
+          }
+          crowd_writers[ic]->accumulate(ref_walkers, ref_psets, ref_wfns, rng);
+        }
+      rank_writer.collect(convertUPtrToRefVector(crowd_writers));
+      for (auto& crowd_oeb : crowd_writers)
+        CHECK(dynamic_cast<WalkerTraceWriter&>(*crowd_oeb).get_buffer().num_rows() == 0);
+    }
+    rank_writer.waitForPendingWrite();
+  }
+
+  // rows of a block are in crowd order, steps are decimated by the period
+  const size_t nrows = nblocks * (nsteps / 2) * ncrowds * nwalkers;
+  hdf_archive hd;
+  okay = hd.open(file_name);
+  REQUIRE(okay);
+  int period = 0;
+  hd.read(period, "traces/period");
+  CHECK(period == 2);
+  std::vector<long> steps;
+  std::vector<long> walker_ids;
+  std::vector<QMCT::FullPrecRealType> weights;
+  std::vector<QMCT::FullPrecRealType> local_energies;
+  std::vector<Real> talker;
+  hd.read(steps, "traces/step");
+  hd.read(walker_ids, "traces/walker_id");
+  hd.read(weights, "traces/weight");
+  hd.read(local_energies, "traces/local_energy");
+  hd.readSlabReshaped(talker, std::array<size_t, 2>{nrows, nparticle}, "traces/per_particle/Talker");
+  REQUIRE(steps.size() == nrows);
+  REQUIRE(talker.size() == nrows * nparticle);
+  int row = 0;
+  for (int ib = 0; ib < nblocks; ++ib)
+    for (int ic = 0; ic < ncrowds; ++ic)
+      for (int is = 0; is < nsteps; is += 2)
+        for (int iw = 0; iw < nwalkers; ++iw, ++row)
+        {
+          const long walker_id = ic * nwalkers + iw;
+          CHECK(steps[row] == ib * nsteps + is);
+          CHECK(walker_ids[row] == walker_id);
+          CHECK(weights[row] == Approx(ib * nsteps + is));
+          CHECK(local_energies[row] == Approx(-walker_id));
+          CHECK(talker[row * nparticle] == Approx(walker_id));
+          CHECK(talker[row * nparticle + 1] == Approx(is));
+        }
+  hd.close();
+  std::filesystem::remove(file_name);
+}
+
+} // namespace qmcplusplus
@@ -16,6 +16,7 @@
 #ifndef OHMMS_COMMUNICATION_OPERATORS_MPI_H
 #define OHMMS_COMMUNICATION_OPERATORS_MPI_H
 #include "Pools/PooledData.h"
+#include "Message/HierarchicalReducer.h"
 #include <stdint.h>
 ///dummy declarations to be specialized
 template<typename T>
@@ -1042,4 +1043,16 @@ inline void Communicate::bcast(std::complex<float>& g)
   MPI_Bcast(&g, 2, MPI_FLOAT, 0, myMPI);
 }
 
+template<typename T>
+inline void Communicate::allreduce_hierarchical(T* restrict buf, int n)
+{
+  getHierarchicalReducer().sum(buf, n, true);
+}
+
+template<typename T>
+inline void Communicate::reduce_hierarchical(T* restrict buf, int n)
+{
+  getHierarchicalReducer().sum(buf, n, false);
+}
+
 #endif
@@ -111,4 +111,12 @@ template<typename T>
 void gsum(T&)
 {}
 
+template<typename T>
+inline void Communicate::allreduce_hierarchical(T* restrict buf, int n)
+{}
+
+template<typename T>
+inline void Communicate::reduce_hierarchical(T* restrict buf, int n)
+{}
+
 #endif
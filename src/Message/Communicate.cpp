@@ -28,6 +28,7 @@
 
 #ifdef HAVE_MPI
 #include "mpi3/shared_communicator.hpp"
+#include "HierarchicalReducer.h"
 #endif
 
 
@@ -87,6 +88,13 @@ Communicate Communicate::NodeComm() const {
   return Communicate{comm.split_shared()};
 }
 
+HierarchicalReducer& Communicate::getHierarchicalReducer()
+{
+  if (!hierarchical_reducer_)
+    hierarchical_reducer_ = std::make_unique<HierarchicalReducer>(*this);
+  return *hierarchical_reducer_;
+}
+
 void Communicate::finalize()
 {
   static bool has_finalized = false;
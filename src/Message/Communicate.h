@@ -57,6 +57,10 @@ struct CommunicatorTraits
 
 #include "Message/AppAbort.h"
 
+#ifdef HAVE_MPI
+class HierarchicalReducer;
+#endif
+
 /**@class Communicate
  * @ingroup Message
  * @brief
@@ -205,6 +209,26 @@ public:
   template<typename T>
   void gsum(T&);
 
+  /** sum over all ranks in two levels, first within each shared-memory node then among node leaders only
+   *  @param buf in: local contribution, out: sum over all ranks on every rank
+   *  The first call is collective and creates the node and node leader communicators.
+   */
+  template<typename T>
+  void allreduce_hierarchical(T* restrict buf, int n);
+  template<typename T>
+  void allreduce_hierarchical(std::vector<T>& buf)
+  {
+    allreduce_hierarchical(buf.data(), buf.size());
+  }
+  /// same as allreduce_hierarchical but the sum is only available on rank 0
+  template<typename T>
+  void reduce_hierarchical(T* restrict buf, int n);
+  template<typename T>
+  void reduce_hierarchical(std::vector<T>& buf)
+  {
+    reduce_hierarchical(buf.data(), buf.size());
+  }
+
 protected:
   /** Raw communicator
    *
@@ -224,6 +248,11 @@ protected:
   int d_ngroups;
   /// Group Leader Communicator
   std::unique_ptr<Communicate> GroupLeaderComm;
+#ifdef HAVE_MPI
+  /// node-then-global reduction engine, created on first use
+  std::unique_ptr<HierarchicalReducer> hierarchical_reducer_;
+  HierarchicalReducer& getHierarchicalReducer();
+#endif
 
 public:
   // Avoid public access to unique_ptr.
@@ -0,0 +1,71 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "HierarchicalReducer.h"
+#include <cstddef>
+#include <stdexcept>
+#include "mpi3/shared_communicator.hpp"
+
+HierarchicalReducer::HierarchicalReducer(Communicate& parent)
+    : parent_comm_(parent.getMPI()), window_(MPI_WIN_NULL), shared_base_(nullptr), slot_bytes_(0)
+{
+  node_comm_ = std::make_unique<Communicate>(parent.comm.split_shared(parent.rank()));
+  // every rank must take part in the split, only node leaders receive a valid communicator
+  const int color                = node_comm_->rank() == 0 ? 0 : MPI_UNDEFINED;
+  mpi3::communicator leader_comm = parent.comm.split(color, parent.rank());
+  if (node_comm_->rank() == 0)
+    leader_comm_ = std::make_unique<Communicate>(std::move(leader_comm));
+}
+
+HierarchicalReducer::~HierarchicalReducer() { freeWindow(); }
+
+void HierarchicalReducer::reserve(size_t bytes)
+{
+  constexpr size_t align = alignof(std::max_align_t);
+  bytes                  = std::max(align, (bytes + align - 1) / align * align);
+  if (bytes <= slot_bytes_ && bytes * 4 > slot_bytes_)
+    return;
+
+  freeWindow();
+  const int node_size = node_comm_->size();
+  // the node leader owns the whole contiguous window, the others map it
+  const MPI_Aint local_bytes = node_comm_->rank() == 0 ? (node_size + 1) * bytes : 0;
+  char* local_base           = nullptr;
+  if (MPI_Win_allocate_shared(local_bytes, 1, MPI_INFO_NULL, node_comm_->getMPI(), &local_base, &window_) !=
+      MPI_SUCCESS)
+    throw std::runtime_error("HierarchicalReducer::reserve failed to allocate the node shared window.");
+  MPI_Aint window_size;
+  int disp_unit;
+  MPI_Win_shared_query(window_, 0, &window_size, &disp_unit, &shared_base_);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, window_);
+  slot_bytes_ = bytes;
+}
+
+void HierarchicalReducer::synchronize() const
+{
+  MPI_Win_sync(window_);
+  node_comm_->barrier();
+  MPI_Win_sync(window_);
+}
+
+void HierarchicalReducer::freeWindow()
+{
+  if (window_ == MPI_WIN_NULL)
+    return;
+  // no rank may still be reading the window of the previous reduction
+  node_comm_->barrier();
+  MPI_Win_unlock_all(window_);
+  MPI_Win_free(&window_);
+  window_      = MPI_WIN_NULL;
+  shared_base_ = nullptr;
+  slot_bytes_  = 0;
+}
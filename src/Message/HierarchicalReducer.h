@@ -0,0 +1,163 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_HIERARCHICAL_REDUCER_H
+#define QMCPLUSPLUS_HIERARCHICAL_REDUCER_H
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include "Message/Communicate.h"
+#include "mpi3/detail/datatype.hpp"
+
+/** Two-level (node then global) sum reduction over the ranks of a parent Communicate.
+ *
+ *  Ranks sharing a node first combine their contributions through an MPI-3 shared-memory window.
+ *  Every rank deposits its buffer in its own slot and each node rank sums a disjoint stripe of all the slots.
+ *  Only the node leaders then take part in the inter-node collective so its payload is one buffer per node.
+ *  The node split is keyed by the parent rank so rank 0 of the parent is both a node leader and rank 0 of
+ *  the leader communicator.  Summation order is fixed by the node rank so results are reproducible.
+ *
+ *  The shared-memory path only pays off for mid-sized buffers. Buffers below MIN_SHARED_BYTES are latency
+ *  bound and would pay for the node barriers, buffers above MAX_SHARED_BYTES would make every node hold
+ *  node size + 1 copies of them. Both, and any reduction on a node with a single rank, use the plain MPI
+ *  collective of the parent communicator. The window is reallocated once it is four times larger than the
+ *  last shared-memory reduction needed.
+ *
+ *  All member functions are collective over the parent communicator.
+ */
+class HierarchicalReducer
+{
+public:
+  HierarchicalReducer(Communicate& parent);
+  ~HierarchicalReducer();
+
+  HierarchicalReducer(const HierarchicalReducer&)            = delete;
+  HierarchicalReducer& operator=(const HierarchicalReducer&) = delete;
+
+  /** sum buf[0:n) over all the ranks of the parent communicator
+   *  @param buf      in: local contribution, out: global sum where available
+   *  @param n        number of elements, must be the same on all ranks
+   *  @param all_ranks if true every rank receives the sum, otherwise only rank 0 of the parent does
+   */
+  template<typename T>
+  void sum(T* buf, size_t n, bool all_ranks);
+
+  /// smallest buffer in bytes reduced through the node shared window
+  static constexpr size_t MIN_SHARED_BYTES = 4096;
+  /// largest buffer in bytes reduced through the node shared window, caps the slot size
+  static constexpr size_t MAX_SHARED_BYTES = size_t(1) << 20;
+
+  /// number of ranks on this node
+  int getNodeSize() const { return node_comm_->size(); }
+  /// rank within this node
+  int getNodeRank() const { return node_comm_->rank(); }
+  /// true if this rank takes part in the inter-node reduction
+  bool isNodeLeader() const { return static_cast<bool>(leader_comm_); }
+  /// bytes per slot of the current shared window, 0 if none is allocated
+  size_t getSlotBytes() const { return slot_bytes_; }
+
+private:
+  /// sum with the plain MPI collective of the parent communicator
+  template<typename T>
+  void sumParent(T* buf, size_t n, bool all_ranks);
+
+  /** make the shared window slots hold bytes, collective over the node
+   *  the window grows as needed and is shrunk when it is four times larger than bytes
+   */
+  void reserve(size_t bytes);
+  /// make the stores to the shared window visible to the whole node
+  void synchronize() const;
+  /// release the shared window, collective over the node
+  void freeWindow();
+
+  /// the parent communicator
+  MPI_Comm parent_comm_;
+  /// node-local shared-memory communicator
+  std::unique_ptr<Communicate> node_comm_;
+  /// communicator among node leaders, nullptr on the other ranks
+  std::unique_ptr<Communicate> leader_comm_;
+  /// shared window holding node size contribution slots followed by the result slot
+  MPI_Win window_;
+  /// start of the shared window on this rank
+  char* shared_base_;
+  /// bytes per slot, kept a multiple of the largest scalar alignment
+  size_t slot_bytes_;
+};
+
+template<typename T>
+void HierarchicalReducer::sum(T* buf, size_t n, bool all_ranks)
+{
+  static_assert(std::is_arithmetic<T>::value, "HierarchicalReducer::sum only supports arithmetic types");
+  const int node_size = node_comm_->size();
+  const size_t bytes  = n * sizeof(T);
+  if (node_size == 1 || bytes < MIN_SHARED_BYTES || bytes > MAX_SHARED_BYTES)
+  {
+    sumParent(buf, n, all_ranks);
+    return;
+  }
+  reserve(bytes);
+
+  const int node_rank = node_comm_->rank();
+  auto slot           = [this](int i) { return reinterpret_cast<T*>(shared_base_ + i * slot_bytes_); };
+  T* result           = slot(node_size);
+
+  std::copy_n(buf, n, slot(node_rank));
+  synchronize();
+  // each node rank sums one stripe over all the slots
+  const size_t stripe = (n + node_size - 1) / node_size;
+  const size_t first  = std::min(n, stripe * node_rank);
+  const size_t last   = std::min(n, first + stripe);
+  for (size_t i = first; i < last; ++i)
+  {
+    T val = slot(0)[i];
+    for (int ir = 1; ir < node_size; ++ir)
+      val += slot(ir)[i];
+    result[i] = val;
+  }
+  synchronize();
+
+  if (leader_comm_ && leader_comm_->size() > 1)
+  {
+    const MPI_Datatype datatype = boost::mpi3::detail::basic_datatype<T>{};
+    if (all_ranks)
+      MPI_Allreduce(MPI_IN_PLACE, result, n, datatype, MPI_SUM, leader_comm_->getMPI());
+    else if (leader_comm_->rank() == 0)
+      MPI_Reduce(MPI_IN_PLACE, result, n, datatype, MPI_SUM, 0, leader_comm_->getMPI());
+    else
+      MPI_Reduce(result, nullptr, n, datatype, MPI_SUM, 0, leader_comm_->getMPI());
+  }
+
+  if (all_ranks)
+  {
+    synchronize();
+    std::copy_n(result, n, buf);
+  }
+  else if (leader_comm_ && leader_comm_->rank() == 0)
+    std::copy_n(result, n, buf);
+}
+
+template<typename T>
+void HierarchicalReducer::sumParent(T* buf, size_t n, bool all_ranks)
+{
+  const MPI_Datatype datatype = boost::mpi3::detail::basic_datatype<T>{};
+  int parent_rank;
+  MPI_Comm_rank(parent_comm_, &parent_rank);
+  if (all_ranks)
+    MPI_Allreduce(MPI_IN_PLACE, buf, n, datatype, MPI_SUM, parent_comm_);
+  else if (parent_rank == 0)
+    MPI_Reduce(MPI_IN_PLACE, buf, n, datatype, MPI_SUM, 0, parent_comm_);
+  else
+    MPI_Reduce(buf, nullptr, n, datatype, MPI_SUM, 0, parent_comm_);
+}
+
+#endif
@@ -12,6 +12,7 @@
 
 #include "catch.hpp"
 #include "Message/Communicate.h"
+#include "Message/CommOperators.h"
 
 namespace qmcplusplus
 {
@@ -129,4 +130,30 @@ TEST_CASE("test_communicate_split_four", "[message]")
   }
 }
 
+TEST_CASE("test_communicate_reduce_hierarchical", "[message]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  const int nranks = c->size();
+  const int rank   = c->rank();
+
+  std::vector<double> dvals{1.0, static_cast<double>(rank), 0.5 * rank};
+  c->allreduce_hierarchical(dvals);
+  CHECK(dvals[0] == Approx(nranks));
+  CHECK(dvals[1] == Approx(nranks * (nranks - 1) / 2));
+  CHECK(dvals[2] == Approx(0.25 * nranks * (nranks - 1)));
+
+  // a longer buffer grows the shared slots
+  std::vector<unsigned long> lvals(1000, rank + 1);
+  c->allreduce_hierarchical(lvals);
+  for (auto val : lvals)
+    CHECK(val == nranks * (nranks + 1) / 2);
+
+  std::vector<float> fvals(7, 1.0f);
+  c->reduce_hierarchical(fvals);
+  if (rank == 0)
+    for (auto val : fvals)
+      CHECK(val == Approx(nranks));
+}
+
 } // namespace qmcplusplus
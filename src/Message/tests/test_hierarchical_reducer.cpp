@@ -0,0 +1,76 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include <functional>
+#include <vector>
+#include "Message/Communicate.h"
+#include "Message/HierarchicalReducer.h"
+
+namespace qmcplusplus
+{
+/** compare the sum of n values with the mpi3 reduction of the same contributions
+ *  the contributions are small integers so any summation order is exact
+ */
+template<typename T>
+void checkSum(HierarchicalReducer& reducer, Communicate& comm, size_t n, bool all_ranks)
+{
+  std::vector<T> buf(n), ref(n);
+  for (size_t i = 0; i < n; ++i)
+    buf[i] = static_cast<T>((comm.rank() + 1) * (i % 7 + 1));
+  if (all_ranks)
+    comm.comm.all_reduce_n(buf.data(), n, ref.data(), std::plus<>());
+  else
+    comm.comm.reduce_n(buf.data(), n, ref.data(), std::plus<>(), 0);
+  reducer.sum(buf.data(), n, all_ranks);
+  if (all_ranks || comm.rank() == 0)
+    CHECK(buf == ref);
+}
+
+TEST_CASE("HierarchicalReducer multi rank", "[message]")
+{
+  Communicate* c = OHMMS::Controller;
+  HierarchicalReducer reducer(*c);
+  const bool shared = reducer.getNodeSize() > 1;
+
+  // small buffers use the plain MPI collective and leave no window behind
+  const size_t small_n = HierarchicalReducer::MIN_SHARED_BYTES / sizeof(double) / 2;
+  checkSum<double>(reducer, *c, small_n, true);
+  checkSum<double>(reducer, *c, small_n, false);
+  CHECK(reducer.getSlotBytes() == 0);
+
+  // mid-sized buffers go through the node shared window
+  const size_t mid_n = HierarchicalReducer::MIN_SHARED_BYTES / sizeof(double) * 4;
+  checkSum<double>(reducer, *c, mid_n, true);
+  checkSum<long>(reducer, *c, mid_n, false);
+  checkSum<float>(reducer, *c, mid_n + 3, true);
+  if (shared)
+    CHECK(reducer.getSlotBytes() >= mid_n * sizeof(double));
+
+  // large buffers use the plain MPI collective and do not grow the window beyond the cap
+  const size_t large_n = HierarchicalReducer::MAX_SHARED_BYTES / sizeof(double) + 5;
+  checkSum<double>(reducer, *c, large_n, true);
+  checkSum<double>(reducer, *c, large_n, false);
+  CHECK(reducer.getSlotBytes() <= HierarchicalReducer::MAX_SHARED_BYTES);
+
+  // a grown window shrinks back for a much smaller reduction
+  if (shared)
+  {
+    const size_t grown_n = HierarchicalReducer::MAX_SHARED_BYTES / sizeof(double);
+    checkSum<double>(reducer, *c, grown_n, true);
+    CHECK(reducer.getSlotBytes() == HierarchicalReducer::MAX_SHARED_BYTES);
+    checkSum<double>(reducer, *c, mid_n, true);
+    CHECK(reducer.getSlotBytes() < HierarchicalReducer::MAX_SHARED_BYTES);
+  }
+}
+
+} // namespace qmcplusplus
@@ -19,7 +19,9 @@
 #include "mpi/collectives.h"
 #include "Utilities/FairDivide.h"
 
+#include <algorithm>
 #include <array>
+#include <unordered_map>
 
 namespace qmcplusplus
 {
@@ -155,11 +157,21 @@ bool HDFWalkerInput_0_4::read_hdf5(const std::filesystem::path& h5name)
   Buffer_t posin(dims[0] * dims[1] * dims[2]);
   hin.readSlabReshaped(posin, dims, hdf::walkers);
   std::vector<QMCTraits::FullPrecRealType> weights_in(nw_in);
-  const bool has_weights = hin.readEntry(weights_in, hdf::walker_weights);
+  bool has_weights = hin.readEntry(weights_in, hdf::walker_weights);
 
   std::vector<int> woffsets;
   hin.read(woffsets, "walker_partition");
 
+  hin.pop();
+  if (apply_deltas(hin, posin, weights_in))
+  {
+    // the partition of the snapshot does not hold for the walkers after the deltas
+    nw_in       = weights_in.size();
+    dims[0]     = nw_in;
+    has_weights = true;
+    woffsets.clear();
+  }
+
   int np1 = myComm->size() + 1;
   if (woffsets.size() != np1)
   {
@@ -280,6 +292,7 @@ bool HDFWalkerInput_0_4::read_phdf5(const std::filesystem::path& h5name)
   std::vector<int> woffsets;
   int woffsets_size = 0;
   bool success      = false;
+  bool has_deltas   = false;
 
   { // handle small dataset with master rank
     hdf_archive hin(myComm, false);
@@ -292,6 +305,7 @@ bool HDFWalkerInput_0_4::read_phdf5(const std::filesystem::path& h5name)
       hin.read(aversion, hdf::version);
       if (!(aversion < i_info.version))
       {
+        has_deltas      = hin.is_group(hdf::walker_deltas);
         int found_group = hin.is_group(hdf::main_state);
         hin.push(hdf::main_state);
         hin.read(nw_in, hdf::num_walkers);
@@ -310,6 +324,10 @@ bool HDFWalkerInput_0_4::read_phdf5(const std::filesystem::path& h5name)
     mpi::bcast(*myComm, success);
     if (!success)
       return false;
+    // the deltas are applied to the whole snapshot
+    mpi::bcast(*myComm, has_deltas);
+    if (has_deltas)
+      return read_hdf5(h5name);
 
     // load woffsets by master
     // can not read collectively since the size may differ from Nranks+1.
@@ -372,4 +390,96 @@ bool HDFWalkerInput_0_4::read_phdf5(const std::filesystem::path& h5name)
   return true;
 }
 
+bool HDFWalkerInput_0_4::apply_deltas(hdf_archive& hin,
+                                      std::vector<QMCTraits::RealType>& posin,
+                                      std::vector<QMCTraits::FullPrecRealType>& weights_in)
+{
+  if (!hin.is_group(hdf::walker_deltas))
+    return false;
+  std::vector<long> ids;
+  hin.push(hdf::main_state, false);
+  hin.read(ids, hdf::walker_ids);
+  hin.pop();
+  if (ids.size() != weights_in.size())
+    throw std::runtime_error("HDFWalkerInput_0_4::apply_deltas the walker IDs do not match the snapshot.");
+
+  hin.push(hdf::walker_deltas, false);
+  int num_deltas = 0;
+  hin.read(num_deltas, hdf::num_deltas);
+  const size_t nitems = num_ptcls_ * OHMMS_DIM;
+  for (int i = 0; i < num_deltas; ++i)
+  {
+    const std::string delta_name = "delta_" + std::to_string(i);
+    hin.push(delta_name, false);
+    std::vector<long> killed_ids, copied_ids, copied_parents, spawned_ids;
+    std::vector<QMCTraits::FullPrecRealType> copied_weights, spawned_weights;
+    if (hin.is_dataset(hdf::killed_ids))
+      hin.read(killed_ids, hdf::killed_ids);
+    if (hin.is_dataset(hdf::copied_ids))
+    {
+      hin.read(copied_ids, hdf::copied_ids);
+      hin.read(copied_parents, hdf::copied_parent_ids);
+      hin.read(copied_weights, hdf::copied_weights);
+    }
+    if (hin.is_dataset(hdf::walker_ids))
+    {
+      hin.read(spawned_ids, hdf::walker_ids);
+      hin.read(spawned_weights, hdf::walker_weights);
+    }
+
+    // copies take the positions of their parents in the previous checkpoint
+    std::unordered_map<long, size_t> index;
+    for (size_t iw = 0; iw < ids.size(); ++iw)
+      index.emplace(ids[iw], iw);
+    for (size_t ic = 0; ic < copied_ids.size(); ++ic)
+    {
+      auto parent = index.find(copied_parents[ic]);
+      if (parent == index.end())
+        throw std::runtime_error("HDFWalkerInput_0_4::apply_deltas parent of walker " + std::to_string(copied_ids[ic]) +
+                                 " not found in " + delta_name);
+      const size_t last = posin.size();
+      posin.resize(last + nitems);
+      std::copy_n(posin.begin() + parent->second * nitems, nitems, posin.begin() + last);
+      ids.push_back(copied_ids[ic]);
+      weights_in.push_back(copied_weights[ic]);
+    }
+    if (!spawned_ids.empty())
+    {
+      std::vector<QMCTraits::RealType> spawned_positions;
+      std::array<size_t, 3> dims{spawned_ids.size(), num_ptcls_, OHMMS_DIM};
+      hin.readSlabReshaped(spawned_positions, dims, hdf::walkers);
+      posin.insert(posin.end(), spawned_positions.begin(), spawned_positions.end());
+      ids.insert(ids.end(), spawned_ids.begin(), spawned_ids.end());
+      weights_in.insert(weights_in.end(), spawned_weights.begin(), spawned_weights.end());
+    }
+
+    // killed walkers are removed after the copies since a parent may be killed after branching
+    std::sort(killed_ids.begin(), killed_ids.end());
+    size_t nw = 0;
+    for (size_t iw = 0; iw < ids.size(); ++iw)
+      if (!std::binary_search(killed_ids.begin(), killed_ids.end(), ids[iw]))
+      {
+        if (nw != iw)
+        {
+          ids[nw]        = ids[iw];
+          weights_in[nw] = weights_in[iw];
+          std::copy_n(posin.begin() + iw * nitems, nitems, posin.begin() + nw * nitems);
+        }
+        ++nw;
+      }
+    ids.resize(nw);
+    weights_in.resize(nw);
+    posin.resize(nw * nitems);
+
+    size_t nw_delta = 0;
+    hin.read(nw_delta, hdf::num_walkers);
+    if (nw_delta != nw)
+      throw std::runtime_error("HDFWalkerInput_0_4::apply_deltas inconsistent number of walkers after " + delta_name);
+    hin.pop();
+  }
+  hin.pop();
+  app_log() << "  Applied " << num_deltas << " walker checkpoint deltas." << std::endl;
+  return num_deltas > 0;
+}
+
 } // namespace qmcplusplus
@@ -25,6 +25,8 @@ class Communicate;
 
 namespace qmcplusplus
 {
+class hdf_archive;
+
 struct HDFWalkerInput_0_4
 {
   struct IOInfo
@@ -87,6 +89,18 @@ struct HDFWalkerInput_0_4
   bool read_hdf5_scatter(const std::filesystem::path& h5name);
   /** read walkers using PHDF5 */
   bool read_phdf5(const std::filesystem::path& h5name);
+  /** apply the deltas appended to the full snapshot by the delta checkpoints
+   *
+   * Killed walkers are removed and spawned walkers are added by walker ID. Surviving walkers keep their
+   * positions of the snapshot and copies take the positions of their parent.
+   * @param hin file positioned at the root group
+   * @param posin walker positions updated in place
+   * @param weights_in walker weights updated in place
+   * @return true if any delta was applied
+   */
+  bool apply_deltas(hdf_archive& hin,
+                    std::vector<QMCTraits::RealType>& posin,
+                    std::vector<QMCTraits::FullPrecRealType>& weights_in);
 };
 
 } // namespace qmcplusplus
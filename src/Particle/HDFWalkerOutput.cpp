@@ -21,15 +21,34 @@
 #include "Utilities/IteratorUtility.h"
 #include "OhmmsData/FileUtility.h"
 #include "hdf/HDFVersion.h"
+#include <algorithm>
 #include <numeric>
 #include <iostream>
 #include <sstream>
 #include "Message/Communicate.h"
+#include "Message/CommOperators.h"
 #include "mpi/collectives.h"
 #include "hdf/hdf_hyperslab.h"
+#include "Platforms/Host/OutputManager.h"
 
 namespace qmcplusplus
 {
+namespace
+{
+/// gather the variable sized contributions of all the ranks to the master
+template<typename CT>
+void gather_to_master(Communicate& comm, CT& local, CT& gathered)
+{
+  std::vector<int> count{static_cast<int>(local.size())}, counts(comm.size()), displ(comm.size(), 0);
+  mpi::gather(comm, count, counts);
+  for (int i = 1; i < comm.size(); ++i)
+    displ[i] = displ[i - 1] + counts[i - 1];
+  if (!comm.rank())
+    gathered.resize(displ.back() + counts.back());
+  mpi::gatherv(comm, local, gathered, counts, displ);
+}
+} // namespace
+
 /* constructor
  * @param W walkers to operate on
  * @param aroot the root file name
@@ -49,6 +68,11 @@ namespace qmcplusplus
  *   -- NumOfConfigurations current count of the configurations
  *   -- config0000 current configuration
  *   -- config#### configuration for each block
+ * - walker_deltas, only in the delta mode
+ *   -- number_of_deltas
+ *   -- delta_# holding block, number_of_walkers, killed_walker_ids,
+ *      copied_walker_ids, copied_parent_ids and copied_walker_weights of the copies of checkpointed walkers,
+ *      walker_ids, parent_ids, walker_weights and walkers of the other spawned walkers
  * Other classes can add datasets as needed.
  * open/close functions are provided so that the hdf5 file is closed during
  * the life time of this object. This is necessary so that failures do not lead
@@ -60,13 +84,92 @@ HDFWalkerOutput::HDFWalkerOutput(size_t num_ptcls, const std::string& aroot, Com
       number_of_particles_(num_ptcls),
       myComm(c),
       currentConfigNumber(0),
-      RootName(aroot)
+      RootName(aroot),
+      async_write_(false),
+      compression_level_(0),
+      max_deltas_(0),
+      num_deltas_(-1)
 {
   block = -1;
 }
 
-/** Destructor writes the state of random numbers and close the file */
-HDFWalkerOutput::~HDFWalkerOutput() = default;
+/** Destructor makes sure the last checkpoint is complete */
+HDFWalkerOutput::~HDFWalkerOutput()
+{
+  if (pending_write_.valid())
+    pending_write_.wait();
+}
+
+void HDFWalkerOutput::setAsyncWrite(bool async)
+{
+  async_write_ = false;
+  if (!async)
+    return;
+  hbool_t is_threadsafe = false;
+  H5is_library_threadsafe(&is_threadsafe);
+#if defined(ENABLE_PHDF5)
+  const bool use_phdf5 = myComm->size() > 1;
+#else
+  const bool use_phdf5 = false;
+#endif
+  if (!is_threadsafe)
+    app_warning() << "Asynchronous walker checkpointing requires a thread-safe HDF5 library. "
+                  << "Checkpoints are written synchronously." << std::endl;
+  else if (use_phdf5)
+    app_warning() << "Asynchronous walker checkpointing is not supported with parallel HDF5. "
+                  << "Checkpoints are written synchronously." << std::endl;
+  else
+    async_write_ = true;
+}
+
+void HDFWalkerOutput::setDeltaCheckpoint(int max_deltas)
+{
+  max_deltas_ = std::max(0, max_deltas);
+#if defined(ENABLE_PHDF5)
+  if (max_deltas_ > 0 && myComm->size() > 1)
+  {
+    app_warning() << "Delta walker checkpoints are not supported with parallel HDF5. "
+                  << "Full checkpoints are written." << std::endl;
+    max_deltas_ = 0;
+  }
+#endif
+}
+
+void HDFWalkerOutput::waitForPendingWrite()
+{
+  if (!async_write_)
+    return;
+  std::exception_ptr write_error;
+  // get() rethrows any exception raised by the background write
+  if (pending_write_.valid())
+    try
+    {
+      pending_write_.get();
+    }
+    catch (...)
+    {
+      write_error = std::current_exception();
+    }
+  int failed = write_error ? 1 : 0;
+  myComm->allreduce(failed);
+  if (write_error)
+    std::rethrow_exception(write_error);
+  if (failed)
+    throw std::runtime_error("HDFWalkerOutput::waitForPendingWrite the checkpoint write failed on the master rank.");
+}
+
+bool HDFWalkerOutput::dump(const WalkerConfigurations& W, int nblock, const RefVector<RandomGenerator>& rng)
+{
+  if (!async_write_)
+  {
+    dump(W, nblock);
+    RandomNumberControl::write(rng, RootName, myComm);
+    return true;
+  }
+  // the walkers and the random states of this checkpoint are written by one background task
+  write_rng_ = RandomNumberControl::gather_rank_0(rng, myComm);
+  return dump(W, nblock);
+}
 
 /** Write the set of walker configurations to the HDF5 file.
  * @param W set of walker configurations
@@ -91,23 +194,81 @@ bool HDFWalkerOutput::dump(const WalkerConfigurations& W, int nblock)
   //  rename(prevFile.c_str(),o.str().c_str());
   //}
 
-  //try to use collective
-  hdf_archive dump_file(myComm, true);
-  dump_file.create(FileName);
-  HDFVersion cur_version;
-  dump_file.write(cur_version.version, hdf::version);
-  dump_file.push(hdf::main_state);
-  dump_file.write(nblock, "block");
+  if (max_deltas_ > 0 && num_deltas_ >= 0 && num_deltas_ < max_deltas_)
+  {
+    // the delta is appended to the file of the previous checkpoint
+    waitForPendingWrite();
+    if (dump_delta(W, FileName, nblock))
+    {
+      if (write_rng_ && !myComm->rank())
+        RandomNumberControl::write_gathered(*write_rng_, RootName);
+      write_rng_.reset();
+      currentConfigNumber++;
+      return true;
+    }
+  }
 
-  write_configuration(W, dump_file, nblock);
-  dump_file.close();
+  if (async_write_)
+  {
+    // only block if the previous checkpoint is still being written
+    waitForPendingWrite();
+    const int buffer_id = gather_configuration(W, nblock);
+    if (!myComm->rank())
+    {
+      if (buffer_id == 1)
+      {
+        std::swap(write_positions_, RemoteData[1]);
+        std::swap(write_weights_, RemoteDataW[1]);
+        std::swap(write_ids_, RemoteIDs[1]);
+      }
+      else
+      {
+        write_positions_ = RemoteData[0];
+        write_weights_   = RemoteDataW[0];
+        write_ids_       = RemoteIDs[0];
+      }
+      const auto& walker_offsets = W.getWalkerOffsets();
+      write_partition_.assign(walker_offsets.begin(), walker_offsets.end());
+      pending_write_ = std::async(std::launch::async, [this, FileName, nblock, rng = std::move(write_rng_)]() mutable {
+        hdf_archive dump_file;
+        dump_file.create(FileName);
+        HDFVersion cur_version;
+        dump_file.write(cur_version.version, hdf::version);
+        dump_file.push(hdf::main_state);
+        dump_file.write(nblock, "block");
+        write_gathered(dump_file, write_positions_, write_weights_, write_partition_, write_ids_);
+        dump_file.close();
+        if (rng)
+          RandomNumberControl::write_gathered(*rng, RootName);
+      });
+    }
+    write_rng_.reset();
+  }
+  else
+  {
+    //try to use collective
+    hdf_archive dump_file(myComm, true);
+    dump_file.create(FileName);
+    HDFVersion cur_version;
+    dump_file.write(cur_version.version, hdf::version);
+    dump_file.push(hdf::main_state);
+    dump_file.write(nblock, "block");
+
+    write_configuration(W, dump_file, nblock);
+    dump_file.close();
+  }
 
+  if (max_deltas_ > 0)
+  {
+    save_checkpoint_ids(W);
+    num_deltas_ = 0;
+  }
   currentConfigNumber++;
   prevFile = FileName;
   return true;
 }
 
-void HDFWalkerOutput::write_configuration(const WalkerConfigurations& W, hdf_archive& hout, int nblock)
+void HDFWalkerOutput::snapshot_configuration(const WalkerConfigurations& W, int nblock)
 {
   const int wb = OHMMS_DIM * number_of_particles_;
   if (nblock > block)
@@ -115,15 +276,22 @@ void HDFWalkerOutput::write_configuration(const WalkerConfigurations& W, hdf_arc
     RemoteData[0].resize(wb * W.getActiveWalkers());
     RemoteDataW[0].resize(W.getActiveWalkers());
     W.putConfigurations(RemoteData[0].data(), RemoteDataW[0].data());
+    RemoteIDs[0].clear();
+    if (max_deltas_ > 0)
+      for (int iw = 0; iw < W.getActiveWalkers(); ++iw)
+        RemoteIDs[0].push_back(W[iw]->ID);
     block = nblock;
   }
+  number_of_walkers_ = W.getWalkerOffsets()[myComm->size()];
+}
 
+void HDFWalkerOutput::write_configuration(const WalkerConfigurations& W, hdf_archive& hout, int nblock)
+{
   auto& walker_offsets = W.getWalkerOffsets();
-  number_of_walkers_ = walker_offsets[myComm->size()];
-  hout.write(number_of_walkers_, hdf::num_walkers);
-
   if (hout.is_parallel())
   {
+    snapshot_configuration(W, nblock);
+    hout.write(number_of_walkers_, hdf::num_walkers);
     { // write walker offset.
       // Though it is a small array, it needs to be written collectively in large scale runs.
       std::array<size_t, 1> gcounts{static_cast<size_t>(myComm->size()) + 1};
@@ -161,37 +329,186 @@ void HDFWalkerOutput::write_configuration(const WalkerConfigurations& W, hdf_arc
   }
   else
   { //gaterv to the master and master writes it, could use isend/irecv
-    hout.write(walker_offsets, "walker_partition");
-    if (myComm->size() > 1)
+    const int buffer_id = gather_configuration(W, nblock);
+    if (hout.is_master())
+    {
+      std::vector<int> partition(walker_offsets.begin(), walker_offsets.end());
+      write_gathered(hout, RemoteData[buffer_id], RemoteDataW[buffer_id], partition, RemoteIDs[buffer_id]);
+    }
+  }
+}
+
+int HDFWalkerOutput::gather_configuration(const WalkerConfigurations& W, int nblock)
+{
+  snapshot_configuration(W, nblock);
+  const int wb         = OHMMS_DIM * number_of_particles_;
+  auto& walker_offsets = W.getWalkerOffsets();
+  if (myComm->size() > 1)
+  {
+    std::vector<int> displ(myComm->size()), counts(myComm->size());
+    for (int i = 0; i < myComm->size(); ++i)
+    {
+      counts[i] = wb * (walker_offsets[i + 1] - walker_offsets[i]);
+      displ[i]  = wb * walker_offsets[i];
+    }
+    if (!myComm->rank())
+      RemoteData[1].resize(wb * walker_offsets[myComm->size()]);
+    mpi::gatherv(*myComm, RemoteData[0], RemoteData[1], counts, displ);
+    // update counts and displ for gathering walker weights
+    for (int i = 0; i < myComm->size(); ++i)
+    {
+      counts[i] = (walker_offsets[i + 1] - walker_offsets[i]);
+      displ[i]  = walker_offsets[i];
+    }
+    if (!myComm->rank())
+      RemoteDataW[1].resize(walker_offsets[myComm->size()]);
+    mpi::gatherv(*myComm, RemoteDataW[0], RemoteDataW[1], counts, displ);
+    if (max_deltas_ > 0)
     {
-      std::vector<int> displ(myComm->size()), counts(myComm->size());
-      for (int i = 0; i < myComm->size(); ++i)
-      {
-        counts[i] = wb * (walker_offsets[i + 1] - walker_offsets[i]);
-        displ[i]  = wb * walker_offsets[i];
-      }
-      if (!myComm->rank())
-        RemoteData[1].resize(wb * walker_offsets[myComm->size()]);
-      mpi::gatherv(*myComm, RemoteData[0], RemoteData[1], counts, displ);
-      // update counts and displ for gathering walker weights
-      for (int i = 0; i < myComm->size(); ++i)
-      {
-        counts[i] = (walker_offsets[i + 1] - walker_offsets[i]);
-        displ[i]  = walker_offsets[i];
-      }
       if (!myComm->rank())
-        RemoteDataW[1].resize(walker_offsets[myComm->size()]);
-      mpi::gatherv(*myComm, RemoteDataW[0], RemoteDataW[1], counts, displ);
+        RemoteIDs[1].resize(walker_offsets[myComm->size()]);
+      mpi::gatherv(*myComm, RemoteIDs[0], RemoteIDs[1], counts, displ);
     }
-    int buffer_id = (myComm->size() > 1) ? 1 : 0;
+  }
+  return (myComm->size() > 1) ? 1 : 0;
+}
+
+void HDFWalkerOutput::write_gathered(hdf_archive& hout,
+                                     BufferType& positions,
+                                     std::vector<QMCTraits::FullPrecRealType>& weights,
+                                     std::vector<int>& partition,
+                                     std::vector<long>& ids)
+{
+  const size_t num_walkers = partition.back();
+  hout.write(num_walkers, hdf::num_walkers);
+  hout.write(partition, "walker_partition");
+  if (!ids.empty())
+    hout.write(ids, hdf::walker_ids);
+  std::array<size_t, 3> gcounts{num_walkers, number_of_particles_, OHMMS_DIM};
+  std::array<size_t, 1> gcounts_w{num_walkers};
+  if (compression_level_ > 0)
+  {
+    // chunks of about 1MB of walker positions
+    const hsize_t walker_bytes = number_of_particles_ * OHMMS_DIM * sizeof(OHMMS_PRECISION);
+    const hsize_t chunk_rows   = std::max<hsize_t>(1, (1 << 20) / walker_bytes);
+    hout.writeSlabChunked(positions, gcounts, chunk_rows, compression_level_, hdf::walkers);
+    hout.writeSlabChunked(weights, gcounts_w, chunk_rows, compression_level_, hdf::walker_weights);
+  }
+  else
+  {
+    hout.writeSlabReshaped(positions, gcounts, hdf::walkers);
+    hout.writeSlabReshaped(weights, gcounts_w, hdf::walker_weights);
+  }
+}
+
+void HDFWalkerOutput::save_checkpoint_ids(const WalkerConfigurations& W)
+{
+  checkpoint_ids_.resize(W.getActiveWalkers());
+  for (int iw = 0; iw < W.getActiveWalkers(); ++iw)
+    checkpoint_ids_[iw] = W[iw]->ID;
+  std::sort(checkpoint_ids_.begin(), checkpoint_ids_.end());
+}
+
+bool HDFWalkerOutput::dump_delta(const WalkerConfigurations& W, const std::filesystem::path& file_name, int nblock)
+{
+  using FullPrecRealType = QMCTraits::FullPrecRealType;
+  const size_t wb        = OHMMS_DIM * number_of_particles_;
+  auto in_checkpoint     = [this](long id) {
+    return std::binary_search(checkpoint_ids_.begin(), checkpoint_ids_.end(), id);
+  };
+
+  // walkers spawned since the previous checkpoint
+  std::vector<long> ids, copied_ids, copied_parents, spawned_ids, spawned_parents;
+  std::vector<FullPrecRealType> copied_weights, spawned_weights;
+  std::vector<BufferType::value_type> spawned_positions;
+  for (int iw = 0; iw < W.getActiveWalkers(); ++iw)
+  {
+    const auto& walker = *W[iw];
+    ids.push_back(walker.ID);
+    if (in_checkpoint(walker.ID))
+      continue;
+    if (in_checkpoint(walker.ParentID))
     {
-      std::array<size_t, 3> gcounts{number_of_walkers_, number_of_particles_, OHMMS_DIM};
-      hout.writeSlabReshaped(RemoteData[buffer_id], gcounts, hdf::walkers);
+      copied_ids.push_back(walker.ID);
+      copied_parents.push_back(walker.ParentID);
+      copied_weights.push_back(walker.Weight);
     }
+    else
     {
-      std::array<size_t, 1> gcounts{number_of_walkers_};
-      hout.writeSlabReshaped(RemoteDataW[buffer_id], gcounts, hdf::walker_weights);
+      spawned_ids.push_back(walker.ID);
+      spawned_parents.push_back(walker.ParentID);
+      spawned_weights.push_back(walker.Weight);
+      const auto* positions = &walker.R[0][0];
+      spawned_positions.insert(spawned_positions.end(), positions, positions + wb);
     }
   }
+  std::sort(ids.begin(), ids.end());
+  std::vector<long> killed_ids;
+  std::set_difference(checkpoint_ids_.begin(), checkpoint_ids_.end(), ids.begin(), ids.end(),
+                      std::back_inserter(killed_ids));
+
+  // a delta holding the positions of more than half of the walkers does not pay off
+  const size_t num_walkers = W.getWalkerOffsets()[myComm->size()];
+  int num_spawned          = spawned_ids.size();
+  myComm->allreduce(num_spawned);
+  if (2 * static_cast<size_t>(num_spawned) > num_walkers)
+    return false;
+
+  std::vector<long> all_killed_ids, all_copied_ids, all_copied_parents, all_spawned_ids, all_spawned_parents;
+  std::vector<FullPrecRealType> all_copied_weights, all_spawned_weights;
+  std::vector<BufferType::value_type> all_spawned_positions;
+  gather_to_master(*myComm, killed_ids, all_killed_ids);
+  gather_to_master(*myComm, copied_ids, all_copied_ids);
+  gather_to_master(*myComm, copied_parents, all_copied_parents);
+  gather_to_master(*myComm, copied_weights, all_copied_weights);
+  gather_to_master(*myComm, spawned_ids, all_spawned_ids);
+  gather_to_master(*myComm, spawned_parents, all_spawned_parents);
+  gather_to_master(*myComm, spawned_weights, all_spawned_weights);
+  gather_to_master(*myComm, spawned_positions, all_spawned_positions);
+
+  int failed = 0;
+  if (!myComm->rank())
+    try
+    {
+      hdf_archive delta_file;
+      if (!delta_file.open(file_name))
+        throw std::runtime_error("HDFWalkerOutput::dump_delta cannot open " + file_name.string());
+      delta_file.push(hdf::walker_deltas);
+      delta_file.push("delta_" + std::to_string(num_deltas_));
+      delta_file.write(nblock, "block");
+      delta_file.write(num_walkers, hdf::num_walkers);
+      if (!all_killed_ids.empty())
+        delta_file.write(all_killed_ids, hdf::killed_ids);
+      if (!all_copied_ids.empty())
+      {
+        delta_file.write(all_copied_ids, hdf::copied_ids);
+        delta_file.write(all_copied_parents, hdf::copied_parent_ids);
+        delta_file.write(all_copied_weights, hdf::copied_weights);
+      }
+      if (!all_spawned_ids.empty())
+      {
+        delta_file.write(all_spawned_ids, hdf::walker_ids);
+        delta_file.write(all_spawned_parents, hdf::parent_ids);
+        delta_file.write(all_spawned_weights, hdf::walker_weights);
+        std::array<size_t, 3> gcounts{all_spawned_ids.size(), number_of_particles_, OHMMS_DIM};
+        delta_file.writeSlabReshaped(all_spawned_positions, gcounts, hdf::walkers);
+      }
+      delta_file.pop();
+      // the count is updated last so that an interrupted write leaves a readable file
+      int num_deltas = num_deltas_ + 1;
+      delta_file.write(num_deltas, hdf::num_deltas);
+    }
+    catch (const std::exception& e)
+    {
+      app_warning() << e.what() << " Writing a full checkpoint instead." << std::endl;
+      failed = 1;
+    }
+  myComm->allreduce(failed);
+  if (failed)
+    return false;
+
+  checkpoint_ids_ = std::move(ids);
+  num_deltas_++;
+  return true;
 }
 } // namespace qmcplusplus
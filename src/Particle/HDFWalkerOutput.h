@@ -17,12 +17,28 @@
 #define QMCPLUSPLUS_WALKER_OUTPUT_H
 
 #include "Particle/WalkerConfigurations.h"
+#include "Utilities/RandomNumberControl.h"
+#include <future>
+#include <optional>
 #include <utility>
 #include "hdf/hdf_archive.h"
 
 namespace qmcplusplus
 {
-/** Writes a set of walker configurations to an HDF5 file. */
+/** Writes a set of walker configurations to an HDF5 file.
+ *
+ * In the asynchronous mode, walkers are still gathered collectively by dump but the master
+ * hands the gathered snapshot to a background task which writes the file. A following dump
+ * only blocks if the previous write has not finished yet. The random number states of a
+ * checkpoint are written by the same task after the walkers.
+ *
+ * In the delta mode, a full snapshot also stores the walker IDs and up to a given number of deltas
+ * are appended to its file before the next full snapshot. A delta is keyed by walker ID and ParentID.
+ * It records the IDs of the walkers killed since the previous checkpoint and the walkers spawned since then.
+ * A spawned walker whose parent was in the previous checkpoint of its rank is stored as a copy of the parent,
+ * the others with their positions. The positions of surviving walkers are not rewritten, so a restart
+ * from a delta restores the population with the positions the walkers had when they entered a checkpoint.
+ */
 class HDFWalkerOutput
 {
   ///if true, keep it in memory
@@ -48,13 +64,38 @@ class HDFWalkerOutput
 public:
   ///constructor
   HDFWalkerOutput(size_t num_ptcls, const std::string& fname, Communicate* c);
-  ///destructor
+  ///destructor, waits for a pending write
   ~HDFWalkerOutput();
 
+  /** write the checkpoint file from a background thread
+   *
+   * Falls back to synchronous writes if the HDF5 library is not thread-safe
+   * or parallel HDF5 is in use because HDF5 calls would then race with the calling thread.
+   */
+  void setAsyncWrite(bool async);
+  /** use chunked walker datasets compressed with deflate at the given level, 0 means no compression
+   * Only applies when the master writes the file.
+   */
+  void setCompressionLevel(int level) { compression_level_ = level; }
+  /** append up to max_deltas deltas after each full snapshot, 0 means full snapshots only
+   * Falls back to full snapshots if parallel HDF5 is in use.
+   */
+  void setDeltaCheckpoint(int max_deltas);
+  /** block until the pending background write, if any, has finished, collective
+   *
+   * The failure of the write on the master is reduced over the ranks so that every rank throws.
+   */
+  void waitForPendingWrite();
+
   /** dump configurations
    * @param w walkers
    */
   bool dump(const WalkerConfigurations& w, int block);
+  /** dump configurations and random number generator states as one checkpoint
+   * @param w walkers
+   * @param rng random number generators, written to the RootName.random.h5 file
+   */
+  bool dump(const WalkerConfigurations& w, int block, const RefVector<RandomGenerator>& rng);
   //     bool dump(ForwardWalkingHistoryObject& FWO);
 
 private:
@@ -64,7 +105,48 @@ private:
   std::array<BufferType, 2> RemoteData;
   std::array<std::vector<QMCTraits::FullPrecRealType>, 2> RemoteDataW;
   int block;
+  ///if true, the master writes the file from a background task
+  bool async_write_;
+  ///deflate level of the walker datasets, 0 for contiguous uncompressed datasets
+  int compression_level_;
+  ///background write in flight
+  std::future<void> pending_write_;
+  ///snapshot owned by the background write
+  BufferType write_positions_;
+  std::vector<QMCTraits::FullPrecRealType> write_weights_;
+  std::vector<int> write_partition_;
+  std::vector<long> write_ids_;
+  std::optional<RandomNumberControl::GatheredStates> write_rng_;
+  ///maximal number of deltas between full snapshots, 0 for full snapshots only
+  int max_deltas_;
+  ///number of deltas appended since the last full snapshot, -1 before the first full snapshot
+  int num_deltas_;
+  ///sorted IDs of the local walkers at the last checkpoint
+  std::vector<long> checkpoint_ids_;
+  ///walker IDs gathered along RemoteData in the delta mode
+  std::array<std::vector<long>, 2> RemoteIDs;
+
+  /// copy the local walkers into RemoteData[0] and RemoteDataW[0] once per block
+  void snapshot_configuration(const WalkerConfigurations& W, int block);
   void write_configuration(const WalkerConfigurations& W, hdf_archive& hout, int block);
+  /** gather the walkers to the master
+   * @return index of RemoteData/RemoteDataW holding all the walkers on the master
+   */
+  int gather_configuration(const WalkerConfigurations& W, int block);
+  /** write the gathered walkers in the current group of a serial or master-only file
+   * @param ids walker IDs, only written if not empty
+   */
+  void write_gathered(hdf_archive& hout,
+                      BufferType& positions,
+                      std::vector<QMCTraits::FullPrecRealType>& weights,
+                      std::vector<int>& partition,
+                      std::vector<long>& ids);
+  /** append the walkers killed and spawned since the previous checkpoint to the last full snapshot, collective
+   * @return false if a full snapshot must be written instead
+   */
+  bool dump_delta(const WalkerConfigurations& W, const std::filesystem::path& file_name, int block);
+  /// keep the IDs of the local walkers of this checkpoint for the next delta
+  void save_checkpoint_ids(const WalkerConfigurations& W);
 };
 
 } // namespace qmcplusplus
@@ -17,6 +17,7 @@
 #define QMCPLUSPLUS_RANDOMSEQUENCEGENERATOR_H
 #include <algorithm>
 #include <type_traits>
+#include <utility>
 #include "OhmmsPETE/OhmmsMatrix.h"
 #include "ParticleBase/ParticleAttrib.h"
 #include "Particle/MCCoords.hpp"
@@ -29,24 +30,53 @@
   */
 namespace qmcplusplus
 {
+/// true if RG provides bulk generation of T into a buffer
+template<class RG, class T, class = void>
+struct has_bulk_generate : std::false_type
+{};
+
+template<class RG, class T>
+struct has_bulk_generate<RG, T, std::void_t<decltype(std::declval<RG&>().generate(std::declval<T*>(), size_t(0)))>>
+    : std::true_type
+{};
+
+/** fill a[0:n) with uniform random numbers [0,1), in bulk if the engine supports it
+ */
+template<class T, class RG>
+inline void generateUniformRand(T* restrict a, size_t n, RG& rng)
+{
+  if constexpr (has_bulk_generate<RG, T>::value)
+    rng.generate(a, n);
+  else
+    for (size_t i = 0; i < n; i++)
+      a[i] = rng();
+}
+
 template<class T, class RG>
 inline void assignGaussRand(T* restrict a, unsigned n, RG& rng)
 {
-  OHMMS_PRECISION_FULL slightly_less_than_one = 1.0 - std::numeric_limits<OHMMS_PRECISION_FULL>::epsilon();
-  int nm1                                     = n - 1;
-  OHMMS_PRECISION_FULL temp1, temp2;
-  for (int i = 0; i < nm1; i += 2)
-  {
-    temp1    = std::sqrt(-2.0 * std::log(1.0 - slightly_less_than_one * rng()));
-    temp2    = 2.0 * M_PI * rng();
-    a[i]     = temp1 * std::cos(temp2);
-    a[i + 1] = temp1 * std::sin(temp2);
-  }
-  if (n % 2 == 1)
+  using FullPrecType                        = OHMMS_PRECISION_FULL;
+  const FullPrecType slightly_less_than_one = 1.0 - std::numeric_limits<FullPrecType>::epsilon();
+  // uniform numbers are drawn in sequence, the Box-Muller transform of a block of them is vectorized
+  constexpr unsigned block_pairs = 64;
+  FullPrecType uniforms[2 * block_pairs];
+  FullPrecType gauss[2 * block_pairs];
+  const unsigned num_pairs = (n + 1) / 2;
+  for (unsigned first = 0; first < num_pairs; first += block_pairs)
   {
-    temp1  = std::sqrt(-2.0 * std::log(1.0 - slightly_less_than_one * rng()));
-    temp2  = 2.0 * M_PI * rng();
-    a[nm1] = temp1 * std::cos(temp2);
+    const unsigned np = std::min(block_pairs, num_pairs - first);
+    generateUniformRand(uniforms, 2 * np, rng);
+#pragma omp simd
+    for (unsigned i = 0; i < np; i++)
+    {
+      const FullPrecType temp1 = std::sqrt(-2.0 * std::log(1.0 - slightly_less_than_one * uniforms[2 * i]));
+      const FullPrecType temp2 = 2.0 * M_PI * uniforms[2 * i + 1];
+      gauss[2 * i]             = temp1 * std::cos(temp2);
+      gauss[2 * i + 1]         = temp1 * std::sin(temp2);
+    }
+    // the last pair of an odd n only fills one element
+    const unsigned count = std::min(2 * np, n - 2 * first);
+    std::copy_n(gauss, count, a + 2 * first);
   }
 }
 
@@ -63,8 +93,7 @@ inline void assignGaussRand(T* restrict a, unsigned n, RG& rng)
 template<class T, class RG>
 inline void assignUniformRand(T* restrict a, unsigned n, RG& rng)
 {
-  for (int i = 0; i < n; i++)
-    a[i] = rng();
+  generateUniformRand(a, n, rng);
 }
 
 template<typename T, unsigned D, class RG>
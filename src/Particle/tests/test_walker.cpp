@@ -19,7 +19,9 @@
 #include "Particle/HDFWalkerOutput.h"
 #include "Particle/HDFWalkerInput_0_4.h"
 #include "QMCDrivers/WalkerProperties.h"
+#include "Utilities/FairDivide.h"
 #include "type_traits/template_types.hpp"
+#include "Concurrency/OpenMP.h"
 
 #include <stdio.h>
 #include <string>
@@ -104,6 +106,181 @@ TEST_CASE("walker HDF read and write", "[particle]")
   }
 }
 
+TEST_CASE("walker HDF compressed and asynchronous write", "[particle]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  const size_t num_ptcls = 2;
+  WalkerConfigurations wc_list;
+  wc_list.createWalkers(3, num_ptcls);
+  for (int iw = 0; iw < 3; iw++)
+    for (int ip = 0; ip < num_ptcls; ip++)
+      wc_list[iw]->R[ip] = 0.25 * iw + ip;
+
+  std::vector<int> walker_offset(c->size() + 1);
+  for (int i = 0; i <= c->size(); i++)
+    walker_offset[i] = 3 * i;
+  wc_list.setWalkerOffsets(walker_offset);
+
+  std::vector<std::unique_ptr<RandomGenerator>> rngs(omp_get_max_threads());
+  for (int ip = 0; ip < rngs.size(); ip++)
+  {
+    rngs[ip] = std::make_unique<RandomGenerator>(11 + ip);
+    (*rngs[ip])();
+  }
+
+  const std::string real_name = c->getName();
+  c->setName("walker_test_async");
+  {
+    HDFWalkerOutput hout(num_ptcls, "walker_test_async", c);
+    hout.setCompressionLevel(4);
+    // falls back to synchronous writes if HDF5 is not thread-safe
+    hout.setAsyncWrite(true);
+    hout.dump(wc_list, 1);
+    // a second checkpoint waits for the first one and writes the random states in the same task
+    hout.dump(wc_list, 2, convertUPtrToRefVector(rngs));
+    hout.waitForPendingWrite();
+  }
+  c->setName(real_name);
+  c->barrier();
+
+  if (c->rank() == 0)
+  {
+    hdf_archive hin;
+    REQUIRE(hin.open("walker_test_async.random.h5", H5F_ACC_RDONLY));
+    TinyVector<size_t, 3> shape;
+    hin.push(hdf::main_state);
+    hin.read(shape, "nprocs_nthreads_statesize");
+    CHECK(shape[0] == c->size());
+    CHECK(shape[1] == rngs.size());
+    std::vector<RandomGenerator::uint_type> state, saved;
+    rngs[0]->save(saved);
+    CHECK(shape[2] == saved.size());
+    hin.push("random");
+    hin.readSlabReshaped(state, std::array<size_t, 2>{shape[0] * shape[1], shape[2]}, rngs[0]->EngineName);
+    REQUIRE(state.size() >= saved.size());
+    CHECK(std::equal(saved.begin(), saved.end(), state.begin()));
+  }
+
+  WalkerConfigurations wc_list2;
+  HDFVersion version(0, 4);
+  HDFWalkerInput_0_4 hinp(wc_list2, num_ptcls, c, version);
+  bool okay = hinp.read_hdf5("walker_test_async.config.h5");
+  REQUIRE(okay);
+
+  REQUIRE(wc_list2.getActiveWalkers() == 3);
+  for (int iw = 0; iw < 3; iw++)
+    for (int ip = 0; ip < num_ptcls; ip++)
+      for (int i = 0; i < 3; i++)
+        CHECK(wc_list2[iw]->R[ip][i] == Approx(wc_list[iw]->R[ip][i]));
+}
+
+TEST_CASE("walker HDF delta write", "[particle]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  const size_t num_ptcls = 2;
+  struct WalkerSpec
+  {
+    long id;
+    long parent_id;
+    double shift;
+  };
+  // the same walkers on every rank with IDs unique over the ranks.
+  // A walker at shift s has the positions s + ip and the weight 1 + s
+  auto make_walkers = [c, num_ptcls](WalkerConfigurations& wc_list, const std::vector<WalkerSpec>& specs) {
+    wc_list.createWalkers(specs.size(), num_ptcls);
+    for (int iw = 0; iw < specs.size(); iw++)
+    {
+      wc_list[iw]->ID       = specs[iw].id * c->size() + c->rank();
+      wc_list[iw]->ParentID = specs[iw].parent_id * c->size() + c->rank();
+      for (int ip = 0; ip < num_ptcls; ip++)
+        wc_list[iw]->R[ip] = specs[iw].shift + ip;
+      wc_list[iw]->Weight = 1.0 + specs[iw].shift;
+    }
+    std::vector<int> walker_offset(c->size() + 1);
+    for (int i = 0; i <= c->size(); i++)
+      walker_offset[i] = specs.size() * i;
+    wc_list.setWalkerOffsets(walker_offset);
+  };
+  // the restart lists the surviving walkers, then the walkers added by each delta, each group rank by rank
+  auto check_walkers = [c, num_ptcls](const std::vector<std::vector<double>>& groups) {
+    c->barrier();
+    std::vector<double> shifts;
+    for (auto& group : groups)
+      for (int rank = 0; rank < c->size(); rank++)
+        shifts.insert(shifts.end(), group.begin(), group.end());
+    std::vector<int> woffsets(c->size() + 1);
+    FairDivideLow(shifts.size(), c->size(), woffsets);
+
+    WalkerConfigurations wc_in;
+    HDFVersion version(0, 4);
+    HDFWalkerInput_0_4 hinp(wc_in, num_ptcls, c, version);
+    REQUIRE(hinp.read_hdf5("walker_test_delta.config.h5"));
+    REQUIRE(wc_in.getActiveWalkers() == woffsets[c->rank() + 1] - woffsets[c->rank()]);
+    for (int iw = 0; iw < wc_in.getActiveWalkers(); iw++)
+    {
+      const double shift = shifts[woffsets[c->rank()] + iw];
+      CHECK(wc_in[iw]->Weight == Approx(1.0 + shift));
+      for (int ip = 0; ip < num_ptcls; ip++)
+        for (int i = 0; i < 3; i++)
+          CHECK(wc_in[iw]->R[ip][i] == Approx(shift + ip));
+    }
+  };
+  auto count_deltas = [c]() {
+    c->barrier();
+    int num_deltas = 0;
+    hdf_archive hin;
+    hin.open("walker_test_delta.config.h5", H5F_ACC_RDONLY);
+    if (hin.is_group(hdf::walker_deltas))
+    {
+      hin.push(hdf::walker_deltas, false);
+      hin.read(num_deltas, hdf::num_deltas);
+    }
+    return num_deltas;
+  };
+
+  const std::string real_name = c->getName();
+  c->setName("walker_test_delta");
+  HDFWalkerOutput hout(num_ptcls, "walker_test_delta", c);
+  hout.setDeltaCheckpoint(2);
+
+  WalkerConfigurations wc_full;
+  make_walkers(wc_full, {{1, 1, 0.0}, {2, 2, 0.25}, {3, 3, 0.5}, {4, 4, 0.75}});
+  hout.dump(wc_full, 1);
+  CHECK(count_deltas() == 0);
+  check_walkers({{0.0, 0.25, 0.5, 0.75}});
+
+  // walker 2 killed, the survivors moved, walker 5 copied from walker 3 and walker 6 with an unknown parent
+  WalkerConfigurations wc_delta1;
+  make_walkers(wc_delta1, {{1, 1, 0.1}, {3, 3, 0.6}, {4, 4, 0.85}, {5, 3, 0.5}, {6, 99, 2.0}});
+  hout.dump(wc_delta1, 2);
+  CHECK(count_deltas() == 1);
+  // the survivors keep their positions of the snapshot
+  check_walkers({{0.0, 0.5, 0.75}, {0.5}, {2.0}});
+
+  // walker 3 killed after walker 7 was copied from walker 6
+  WalkerConfigurations wc_delta2;
+  make_walkers(wc_delta2, {{1, 1, 0.3}, {4, 4, 1.05}, {5, 3, 0.7}, {6, 99, 2.2}, {7, 6, 2.0}});
+  hout.dump(wc_delta2, 3);
+  CHECK(count_deltas() == 2);
+  check_walkers({{0.0, 0.75}, {0.5}, {2.0}, {2.0}});
+
+  // the number of deltas is exhausted, a full snapshot is written
+  hout.dump(wc_delta2, 4);
+  CHECK(count_deltas() == 0);
+  check_walkers({{0.3, 1.05, 0.7, 2.2, 2.0}});
+
+  // most walkers would be written with their positions, a full snapshot is written
+  WalkerConfigurations wc_new;
+  make_walkers(wc_new, {{1, 1, 0.4}, {8, 99, 3.0}, {9, 99, 3.5}});
+  hout.dump(wc_new, 5);
+  CHECK(count_deltas() == 0);
+  check_walkers({{0.4, 3.0, 3.5}});
+
+  c->setName(real_name);
+}
+
 TEST_CASE("walker buffer add, update, restore", "[particle]")
 {
   int num_particles = 4;
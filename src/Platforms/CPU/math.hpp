@@ -14,6 +14,8 @@
 #define QMCPLUSPLUS_STDLIB_PORT_H
 #include <config.h>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <type_traits>
 #include "config/stdlib/Constants.h"
 #if defined(HAVE_AMD_LIBM)
@@ -98,6 +100,23 @@ inline bool iszero(T a)
   return std::fpclassify(a) == FP_ZERO;
 }
 
+/** nan test which survives -ffast-math
+ *
+ * -ffinite-math-only allows the compiler to fold std::isnan to false, so inspect the IEEE 754 bits instead.
+ */
+template<typename T,
+  typename = typename std::enable_if<std::is_floating_point<T>::value>::type>
+inline bool isnan_bitwise(T a)
+{
+  static_assert(sizeof(T) == 4 || sizeof(T) == 8, "isnan_bitwise only supports IEEE 754 float and double");
+  using UInt = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+  constexpr UInt exponent_mask = sizeof(T) == 4 ? UInt(0x7f800000u) : UInt(0x7ff0000000000000ull);
+  constexpr UInt mantissa_mask = sizeof(T) == 4 ? UInt(0x007fffffu) : UInt(0x000fffffffffffffull);
+  UInt bits;
+  std::memcpy(&bits, &a, sizeof(T));
+  return (bits & exponent_mask) == exponent_mask && (bits & mantissa_mask) != 0;
+}
+
 }
 
 #endif
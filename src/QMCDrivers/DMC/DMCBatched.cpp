@@ -15,6 +15,7 @@
 
 #include "DMCBatched.h"
 #include "QMCDrivers/GreenFunctionModifiers/DriftModifierBase.h"
+#include "QMCDrivers/DriftOperators.h"
 #include "Concurrency/ParallelExecutor.hpp"
 #include "Concurrency/Info.hpp"
 #include "Message/UniformCommunicateError.h"
@@ -111,7 +112,7 @@ void DMCBatched::advanceWalkers(const StateForThread& sft,
   auto& pset_leader       = walker_elecs.getLeader();
   const int num_particles = pset_leader.getTotalNum();
 
-  MCCoords<CT> drifts(num_walkers), drifts_reverse(num_walkers);
+  MCCoords<CT> drifts(num_walkers);
   MCCoords<CT> walker_deltas(num_walkers * num_particles), deltas(num_walkers);
   TWFGrads<CT> grads_now(num_walkers), grads_new(num_walkers);
 
@@ -162,14 +163,12 @@ void DMCBatched::advanceWalkers(const StateForThread& sft,
         // TODO: rr needs a real name
         std::vector<RealType> rr(num_walkers, 0.0);
         assert(rr.size() == deltas.positions.size());
-        std::transform(deltas.positions.begin(), deltas.positions.end(), rr.begin(),
-                       [t = taus.tauovermass](auto& delta_r) { return t * dot(delta_r, delta_r); });
 
         twf_dispatcher.flex_evalGrad(walker_twfs, walker_elecs, iat, grads_now);
-        sft.drift_modifier.getDrifts(taus, grads_now, drifts);
-
-        scaleBySqrtTau(taus, deltas);
-        drifts += deltas;
+        // drifts holds the proposed moves, log_gf and rr are computed in the same pass
+        sft.drift_modifier.getMoves(taus, grads_now, deltas, drifts, log_gf, rr);
+        if (sft.qmcdrv_input.get_debug_checks() & DriverDebugChecks::CHECK_DRIFT)
+          checkDriftDiffusionMoves(drifts, iat);
 
 // in DMC this was done here, changed to match VMCBatched pending factoring to common source
 // if (rr > m_r2max)
@@ -186,13 +185,7 @@ void DMCBatched::advanceWalkers(const StateForThread& sft,
 
         twf_dispatcher.flex_calcRatioGrad(walker_twfs, walker_elecs, iat, ratios, grads_new);
 
-        computeLogGreensFunction(deltas, taus, log_gf);
-
-        sft.drift_modifier.getDrifts(taus, grads_new, drifts_reverse);
-
-        drifts_reverse += drifts;
-
-        computeLogGreensFunction(drifts_reverse, taus, log_gb);
+        sft.drift_modifier.getReverseLogGF(taus, grads_new, drifts, log_gb);
 
         auto checkPhaseChanged = [&sft](const TrialWaveFunction& twf, int& is_reject) {
           if (sft.branch_engine.phaseChanged(twf.getPhaseDiff()))
@@ -494,19 +487,29 @@ bool DMCBatched::run()
     endBlock();
     dmc_loop.stop();
 
-    bool stop_requested = false;
-    // Rank 0 decides whether the time limit was reached
+    bool stop_requested       = false;
+    bool target_error_reached = false;
+    // Rank 0 decides whether the time limit or the target error was reached
     if (!myComm->rank())
-      stop_requested = runtimeControl.checkStop(dmc_loop);
+    {
+      stop_requested       = runtimeControl.checkStop(dmc_loop);
+      target_error_reached = !stop_requested && checkTargetError(runtimeControl);
+    }
     myComm->bcast(stop_requested);
+    myComm->bcast(target_error_reached);
 
-    if (stop_requested)
+    if (stop_requested || target_error_reached)
     {
       if (!myComm->rank())
         app_log() << runtimeControl.generateStopMessage("DMCBatched", block);
-      run_time_manager.markStop();
+      // a converged section only ends itself, the following sections still run
+      if (stop_requested)
+        run_time_manager.markStop();
       break;
     }
+    // the last block is written by finalize
+    if (block + 1 < num_blocks)
+      recordBlock(block + 1);
   }
 
   branch_engine_->printStatus();
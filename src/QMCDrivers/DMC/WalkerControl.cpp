@@ -286,7 +286,7 @@ void WalkerControl::computeCurData(const UPtrVector<MCPWalker>& walkers, std::ve
 
   {
     ScopedTimer allreduce_timer(my_timers_[WC_allreduce]);
-    myComm->allreduce(curData);
+    myComm->allreduce_hierarchical(curData);
   }
 }
 
@@ -360,6 +360,7 @@ void WalkerControl::swapWalkersSimple(MCPopulation& pop)
   int nsend = 0;
   std::vector<job> job_list;
   std::vector<WalkerElementsRef> newW;
+  std::vector<long> newW_ids;
   std::vector<int> ncopy_newW;
 
   for (int ic = 0; ic < nswap; ic++)
@@ -407,6 +408,7 @@ void WalkerControl::swapWalkersSimple(MCPopulation& pop)
     if (minus[ic] == rank_num_)
     {
       newW.push_back(pop.spawnWalker());
+      newW_ids.push_back(newW.back().walker.ID);
 
       // recv the number of copies from the target
       myComm->comm.receive_n(&nsentcopy, 1, plus[ic]);
@@ -510,7 +512,12 @@ void WalkerControl::swapWalkersSimple(MCPopulation& pop)
     good_walkers[ncopy_pairs[iw].second]->Multiplicity = ncopy_pairs[iw].first;
 
   for (int iw = 0; iw < newW.size(); iw++)
+  {
     newW[iw].walker.Multiplicity = ncopy_newW[iw] + 1;
+    // the sender may keep copies of the walker, so the received one takes the new ID like a local copy
+    newW[iw].walker.ParentID = newW[iw].walker.ID;
+    newW[iw].walker.ID       = newW_ids[iw];
+  }
 
 #ifndef NDEBUG
   FullPrecRealType TotalMultiplicity = 0;
@@ -15,9 +15,14 @@
 
 #ifndef QMCPLUSPLUS_QMCDRIFTOPERATORS_H
 #define QMCPLUSPLUS_QMCDRIFTOPERATORS_H
+#include <sstream>
+#include <stdexcept>
+#include "CPU/math.hpp"
 #include "type_traits/ConvertToReal.h"
 #include "ParticleBase/ParticleAttribOps.h"
 #include "ParticleBase/RandomSeqGenerator.h"
+#include "QMCWaveFunctions/TWFGrads.hpp"
+#include "QMCDrivers/TauParams.hpp"
 namespace qmcplusplus
 {
 template<class T, class TG, unsigned D>
@@ -229,5 +234,144 @@ inline void assignDrift(T tau_au,
   }
 }
 
+/** Umrigar, Nightingale and Runge drift scaling factor, JCP 99, 2865 (1993) eq. (35) times tau
+ * @param tau timestep
+ * @param a scaling parameter, 1 is the usual scaled drift
+ * @param vsq squared norm of the bare drift
+ */
+template<class T>
+inline T getUNRDriftScale(T tau, T a, T vsq)
+{
+  return vsq < std::numeric_limits<T>::epsilon() ? tau : ((-1.0 + std::sqrt(1.0 + 2.0 * a * tau * vsq)) / (a * vsq));
+}
+
+/** drift-diffusion proposals of one particle for all the walkers of a crowd in a single pass
+ * @param a UNR drift scaling parameter
+ * @param taus timestep parameters of the particle group
+ * @param qf quantum forces at the current positions
+ * @param gauss unit gaussian displacements
+ * @param moves scaled drifts plus the diffusion displacements sqrt(tau)*gauss
+ * @param log_gf log of the forward Green's function
+ * @param r2 tau times the squared norm of the gaussian position displacements
+ *
+ * Same as getDrifts, scaleBySqrtTau, adding the drifts and computeLogGreensFunction in sequence.
+ */
+template<typename RT, CoordsType CT>
+inline void getDriftDiffusionMoves(RT a,
+                                   const TauParams<RT, CT>& taus,
+                                   const TWFGrads<CT>& qf,
+                                   const MCCoords<CT>& gauss,
+                                   MCCoords<CT>& moves,
+                                   std::vector<RT>& log_gf,
+                                   std::vector<RT>& r2)
+{
+  using PosType              = QMCTraits::PosType;
+  const size_t nw            = gauss.positions.size();
+  const auto* restrict grads = qf.grads_positions.data();
+  const PosType* restrict gs = gauss.positions.data();
+  PosType* restrict ms       = moves.positions.data();
+  RT* restrict lgf           = log_gf.data();
+  RT* restrict rr            = r2.data();
+#pragma omp simd
+  for (size_t iw = 0; iw < nw; ++iw)
+  {
+    PosType drift;
+    convertToReal(grads[iw], drift);
+    drift *= getUNRDriftScale(taus.tauovermass, a, dot(drift, drift));
+    const PosType delta = taus.sqrttau * gs[iw];
+    ms[iw]              = drift + delta;
+    rr[iw]              = taus.tauovermass * dot(gs[iw], gs[iw]);
+    lgf[iw]             = -taus.oneover2tau * dot(delta, delta);
+  }
+  if constexpr (CT == CoordsType::POS_SPIN)
+  {
+    using SpinType               = QMCTraits::FullPrecRealType;
+    const auto* restrict sgrads  = qf.grads_spins.data();
+    const SpinType* restrict sgs = gauss.spins.data();
+    SpinType* restrict sms       = moves.spins.data();
+#pragma omp simd
+    for (size_t iw = 0; iw < nw; ++iw)
+    {
+      SpinType drift;
+      convertToReal(sgrads[iw], drift);
+      drift *= getUNRDriftScale<SpinType>(taus.spin_tauovermass, a, drift * drift);
+      const SpinType delta = taus.spin_sqrttau * sgs[iw];
+      sms[iw]              = drift + delta;
+      lgf[iw] -= taus.spin_oneover2tau * delta * delta;
+    }
+  }
+}
+
+/** throw if a proposal made by getDriftDiffusionMoves is nan
+ * @param moves proposed displacements of particle iat for all the walkers of a crowd
+ * @param iat particle index, only used in the error message
+ *
+ * A nan drift propagates to the move, so this replaces the nan check of DriftModifierUNR::getDrift.
+ * Generally we hope this only occurs as the result of bad input.
+ */
+template<CoordsType CT>
+inline void checkDriftDiffusionMoves(const MCCoords<CT>& moves, int iat)
+{
+  auto throwNan = [iat](size_t iw, const auto& move) {
+    std::ostringstream error_message;
+    error_message << "move " << move << " of particle " << iat << " of walker " << iw
+                  << " is nan, check the drift of this walker\n";
+    throw std::runtime_error(error_message.str());
+  };
+  for (size_t iw = 0; iw < moves.positions.size(); ++iw)
+    for (int d = 0; d < moves.positions[iw].size(); ++d)
+      if (isnan_bitwise(moves.positions[iw][d]))
+        throwNan(iw, moves.positions[iw]);
+  if constexpr (CT == CoordsType::POS_SPIN)
+    for (size_t iw = 0; iw < moves.spins.size(); ++iw)
+      if (isnan_bitwise(moves.spins[iw]))
+        throwNan(iw, moves.spins[iw]);
+}
+
+/** log of the reverse Green's function of the proposals made by getDriftDiffusionMoves
+ * @param a UNR drift scaling parameter
+ * @param taus timestep parameters of the particle group
+ * @param qf quantum forces at the proposed positions
+ * @param moves proposed displacements
+ * @param log_gb log of the reverse Green's function
+ */
+template<typename RT, CoordsType CT>
+inline void getReverseLogGreensFunction(RT a,
+                                        const TauParams<RT, CT>& taus,
+                                        const TWFGrads<CT>& qf,
+                                        const MCCoords<CT>& moves,
+                                        std::vector<RT>& log_gb)
+{
+  using PosType              = QMCTraits::PosType;
+  const size_t nw            = moves.positions.size();
+  const auto* restrict grads = qf.grads_positions.data();
+  const PosType* restrict ms = moves.positions.data();
+  RT* restrict lgb           = log_gb.data();
+#pragma omp simd
+  for (size_t iw = 0; iw < nw; ++iw)
+  {
+    PosType drift;
+    convertToReal(grads[iw], drift);
+    drift *= getUNRDriftScale(taus.tauovermass, a, dot(drift, drift));
+    drift += ms[iw];
+    lgb[iw] = -taus.oneover2tau * dot(drift, drift);
+  }
+  if constexpr (CT == CoordsType::POS_SPIN)
+  {
+    using SpinType               = QMCTraits::FullPrecRealType;
+    const auto* restrict sgrads  = qf.grads_spins.data();
+    const SpinType* restrict sms = moves.spins.data();
+#pragma omp simd
+    for (size_t iw = 0; iw < nw; ++iw)
+    {
+      SpinType drift;
+      convertToReal(sgrads[iw], drift);
+      drift *= getUNRDriftScale<SpinType>(taus.spin_tauovermass, a, drift * drift);
+      drift += sms[iw];
+      lgb[iw] -= taus.spin_oneover2tau * drift * drift;
+    }
+  }
+}
+
 } // namespace qmcplusplus
 #endif
@@ -23,6 +23,7 @@ enum class DriverDebugChecks : uint_fast8_t
   CHECKGL_AFTER_LOAD  = 0x1,
   CHECKGL_AFTER_MOVES = 0x2,
   CHECKGL_AFTER_TMOVE = 0x3,
+  CHECK_DRIFT         = 0x4,
 };
 
 constexpr bool operator&(DriverDebugChecks x, DriverDebugChecks y)
@@ -49,6 +49,44 @@ public:
   template<CoordsType CT>
   void getDrifts(const TauParams<RealType, CT>& taus, const TWFGrads<CT>& qf, MCCoords<CT>& drifts) const;
 
+  /** drift-diffusion proposals and forward log Green's function of one particle for a batch of walkers
+   * @param taus timestep parameters
+   * @param qf quantum forces at the current positions
+   * @param gauss unit gaussian displacements
+   * @param moves output proposed displacements
+   * @param log_gf output log of the forward Green's function
+   * @param r2 output tau times the squared norm of the gaussian position displacements
+   */
+  virtual void getMoves(const TauParams<RealType, CoordsType::POS>& taus,
+                        const TWFGrads<CoordsType::POS>& qf,
+                        const MCCoords<CoordsType::POS>& gauss,
+                        MCCoords<CoordsType::POS>& moves,
+                        std::vector<RealType>& log_gf,
+                        std::vector<RealType>& r2) const = 0;
+
+  virtual void getMoves(const TauParams<RealType, CoordsType::POS_SPIN>& taus,
+                        const TWFGrads<CoordsType::POS_SPIN>& qf,
+                        const MCCoords<CoordsType::POS_SPIN>& gauss,
+                        MCCoords<CoordsType::POS_SPIN>& moves,
+                        std::vector<RealType>& log_gf,
+                        std::vector<RealType>& r2) const = 0;
+
+  /** log of the reverse Green's function of the displacements proposed by getMoves
+   * @param taus timestep parameters
+   * @param qf quantum forces at the proposed positions
+   * @param moves proposed displacements
+   * @param log_gb output log of the reverse Green's function
+   */
+  virtual void getReverseLogGF(const TauParams<RealType, CoordsType::POS>& taus,
+                               const TWFGrads<CoordsType::POS>& qf,
+                               const MCCoords<CoordsType::POS>& moves,
+                               std::vector<RealType>& log_gb) const = 0;
+
+  virtual void getReverseLogGF(const TauParams<RealType, CoordsType::POS_SPIN>& taus,
+                               const TWFGrads<CoordsType::POS_SPIN>& qf,
+                               const MCCoords<CoordsType::POS_SPIN>& moves,
+                               std::vector<RealType>& log_gb) const = 0;
+
   virtual bool parseXML(xmlNodePtr cur) { return true; }
 
   virtual ~DriftModifierBase() {}
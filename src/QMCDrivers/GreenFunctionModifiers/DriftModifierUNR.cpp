@@ -14,6 +14,7 @@
 #include "DriftModifierUNR.h"
 #include "OhmmsData/ParameterSet.h"
 #include "type_traits/ConvertToReal.h"
+#include "QMCDrivers/DriftOperators.h"
 
 namespace qmcplusplus
 {
@@ -100,6 +101,42 @@ void DriftModifierUNR::getDrifts(RealType tau,
   }
 }
 
+void DriftModifierUNR::getMoves(const TauParams<RealType, CoordsType::POS>& taus,
+                                const TWFGrads<CoordsType::POS>& qf,
+                                const MCCoords<CoordsType::POS>& gauss,
+                                MCCoords<CoordsType::POS>& moves,
+                                std::vector<RealType>& log_gf,
+                                std::vector<RealType>& r2) const
+{
+  getDriftDiffusionMoves(a_, taus, qf, gauss, moves, log_gf, r2);
+}
+
+void DriftModifierUNR::getMoves(const TauParams<RealType, CoordsType::POS_SPIN>& taus,
+                                const TWFGrads<CoordsType::POS_SPIN>& qf,
+                                const MCCoords<CoordsType::POS_SPIN>& gauss,
+                                MCCoords<CoordsType::POS_SPIN>& moves,
+                                std::vector<RealType>& log_gf,
+                                std::vector<RealType>& r2) const
+{
+  getDriftDiffusionMoves(a_, taus, qf, gauss, moves, log_gf, r2);
+}
+
+void DriftModifierUNR::getReverseLogGF(const TauParams<RealType, CoordsType::POS>& taus,
+                                       const TWFGrads<CoordsType::POS>& qf,
+                                       const MCCoords<CoordsType::POS>& moves,
+                                       std::vector<RealType>& log_gb) const
+{
+  getReverseLogGreensFunction(a_, taus, qf, moves, log_gb);
+}
+
+void DriftModifierUNR::getReverseLogGF(const TauParams<RealType, CoordsType::POS_SPIN>& taus,
+                                       const TWFGrads<CoordsType::POS_SPIN>& qf,
+                                       const MCCoords<CoordsType::POS_SPIN>& moves,
+                                       std::vector<RealType>& log_gb) const
+{
+  getReverseLogGreensFunction(a_, taus, qf, moves, log_gb);
+}
+
 bool DriftModifierUNR::parseXML(xmlNodePtr cur)
 {
   ParameterSet m_param;
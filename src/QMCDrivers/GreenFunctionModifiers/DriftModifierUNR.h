@@ -33,6 +33,30 @@ public:
 
   void getDrift(RealType tau, const ComplexType& qf, ParticleSet::Scalar_t& drift) const final;
 
+  void getMoves(const TauParams<RealType, CoordsType::POS>& taus,
+                const TWFGrads<CoordsType::POS>& qf,
+                const MCCoords<CoordsType::POS>& gauss,
+                MCCoords<CoordsType::POS>& moves,
+                std::vector<RealType>& log_gf,
+                std::vector<RealType>& r2) const final;
+
+  void getMoves(const TauParams<RealType, CoordsType::POS_SPIN>& taus,
+                const TWFGrads<CoordsType::POS_SPIN>& qf,
+                const MCCoords<CoordsType::POS_SPIN>& gauss,
+                MCCoords<CoordsType::POS_SPIN>& moves,
+                std::vector<RealType>& log_gf,
+                std::vector<RealType>& r2) const final;
+
+  void getReverseLogGF(const TauParams<RealType, CoordsType::POS>& taus,
+                       const TWFGrads<CoordsType::POS>& qf,
+                       const MCCoords<CoordsType::POS>& moves,
+                       std::vector<RealType>& log_gb) const final;
+
+  void getReverseLogGF(const TauParams<RealType, CoordsType::POS_SPIN>& taus,
+                       const TWFGrads<CoordsType::POS_SPIN>& qf,
+                       const MCCoords<CoordsType::POS_SPIN>& moves,
+                       std::vector<RealType>& log_gb) const final;
+
   bool parseXML(xmlNodePtr cur) final;
 
   DriftModifierUNR(RealType a = 1.0) : a_(a) {}
@@ -91,14 +91,13 @@ void MCPopulation::createWalkers(IndexType num_walkers, const WalkerConfiguratio
 
   outputManager.resume();
 
-  int num_walkers_created = 0;
   for (auto& walker_ptr : walkers_)
   {
     if (walker_ptr->ID == 0)
     {
       // And so walker ID's start at one because 0 is magic.
       // \todo This is C++ all indexes start at 0, make uninitialized ID = -1
-      walker_ptr->ID       = (num_walkers_created++) * num_ranks_ + rank_ + 1;
+      walker_ptr->ID       = (num_walkers_created_++) * num_ranks_ + rank_ + 1;
       walker_ptr->ParentID = walker_ptr->ID;
     }
   }
@@ -174,8 +173,10 @@ WalkerElementsRef MCPopulation::spawnWalker()
         hamiltonian_->makeClone(*walker_elec_particle_sets_.back(), *walker_trial_wavefunctions_.back()));
     walkers_.back()->Multiplicity = 1.0;
     walkers_.back()->Weight       = 1.0;
-    walkers_.back()->ID           = (walkers_.size() + 1) * num_ranks_ + rank_ + 1;
   }
+  // a resurrected walker must not keep the ID of the walker killed before
+  walkers_.back()->ID       = (num_walkers_created_++) * num_ranks_ + rank_ + 1;
+  walkers_.back()->ParentID = walkers_.back()->ID;
 
   outputManager.resume();
   return {*walkers_.back().get(), *walker_elec_particle_sets_.back().get(), *walker_trial_wavefunctions_.back().get()};
@@ -256,7 +257,7 @@ void MCPopulation::measureGlobalEnergyVariance(Communicate& comm,
     weight_energy_variance[2] += w * e * e;
   }
 
-  comm.allreduce(weight_energy_variance);
+  comm.allreduce_hierarchical(weight_energy_variance);
   ener     = weight_energy_variance[1] / weight_energy_variance[0];
   variance = weight_energy_variance[2] / weight_energy_variance[0] - ener * ener;
 }
@@ -55,6 +55,8 @@ private:
   IndexType max_samples_        = 0;
   IndexType target_population_  = 0;
   IndexType target_samples_     = 0;
+  /// number of walkers given an ID on this rank, IDs are never reused so that checkpoints can track walkers
+  long num_walkers_created_ = 0;
   //Properties properties_;
 
   // By making this a linked list and creating the crowds at the same time we could get first touch.
@@ -29,6 +29,10 @@ namespace qmcplusplus
  *   -- 1 = do not write anything
  *   -- 0 = dump after the completion of a qmc section
  *   -- n = dump after n blocks
+ * child node <checkpoint stride="" period="" async="no|yes" compression="0-9" delta="0|n"/>
+ *   -- async = yes writes walker checkpoints from a background thread
+ *   -- compression = deflate level of the walker datasets, 0 means uncompressed
+ *   -- delta = n appends up to n deltas of killed and spawned walkers after each full snapshot
  * - kdelay = "0|1|n" default=0
  */
 void QMCDriverInput::readXML(xmlNodePtr cur)
@@ -39,6 +43,7 @@ void QMCDriverInput::readXML(xmlNodePtr cur)
   std::string serialize_walkers;
   std::string debug_checks_str;
   std::string measure_imbalance_str;
+  std::string stat_compressor_str;
   int Period4CheckPoint{-1};
 
   ParameterSet parameter_set;
@@ -68,12 +73,17 @@ void QMCDriverInput::readXML(xmlNodePtr cur)
   parameter_set.add(tau_, "time_step");
   parameter_set.add(tau_, "tau");
   parameter_set.add(spin_mass_, "spin_mass");
+  parameter_set.add(target_error_, "target_error");
+  parameter_set.add(target_error_equilibration_, "target_error_equilibration");
+  parameter_set.add(stat_blocks_per_write_, "stat_blocks_per_write");
+  parameter_set.add(stat_compression_, "stat_compression");
+  parameter_set.add(stat_compressor_str, "stat_compressor", {"deflate", "zstd"});
   parameter_set.add(blocks_between_recompute_, "blocks_between_recompute");
   parameter_set.add(drift_modifier_, "drift_modifier");
   parameter_set.add(drift_modifier_unr_a_, "drift_UNR_a");
   parameter_set.add(max_disp_sq_, "maxDisplSq");
   parameter_set.add(debug_checks_str, "debug_checks",
-                    {"no", "all", "checkGL_after_load", "checkGL_after_moves", "checkGL_after_tmove"});
+                    {"no", "all", "checkGL_after_load", "checkGL_after_moves", "checkGL_after_tmove", "checkDrift"});
   parameter_set.add(measure_imbalance_str, "measure_imbalance", {"no", "yes"});
 
   OhmmsAttributeSet aAttrib;
@@ -110,10 +120,15 @@ void QMCDriverInput::readXML(xmlNodePtr cur)
       }
       else if (cname == "checkpoint")
       {
+        std::string check_point_async;
         OhmmsAttributeSet rAttrib;
         rAttrib.add(check_point_period_.stride, "stride");
         rAttrib.add(check_point_period_.period, "period");
+        rAttrib.add(check_point_async, "async", {"no", "yes"});
+        rAttrib.add(check_point_compression_, "compression");
+        rAttrib.add(check_point_delta_, "delta");
         rAttrib.put(tcur);
+        check_point_async_ = check_point_async == "yes";
       }
       else if (cname == "dumpconfig")
       {
@@ -154,11 +169,16 @@ void QMCDriverInput::readXML(xmlNodePtr cur)
       debug_checks_ |= DriverDebugChecks::CHECKGL_AFTER_MOVES;
     if (debug_checks_str == "all" || debug_checks_str == "checkGL_after_tmove")
       debug_checks_ |= DriverDebugChecks::CHECKGL_AFTER_TMOVE;
+    if (debug_checks_str == "all" || debug_checks_str == "checkDrift")
+      debug_checks_ |= DriverDebugChecks::CHECK_DRIFT;
   }
 
   if (measure_imbalance_str == "yes")
     measure_imbalance_ = true;
 
+  if (stat_compressor_str == "zstd")
+    stat_compressor_zstd_ = true;
+
   if (check_point_period_.period < 1)
     check_point_period_.period = max_blocks_;
 
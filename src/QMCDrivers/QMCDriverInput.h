@@ -79,6 +79,16 @@ protected:
   IndexType samples_per_thread_    = 0;
   RealType tau_                    = 0.1;
   RealType spin_mass_              = 1.0;
+  /// stop the section once the reblocked local energy error bar is below this, disabled if not positive
+  RealType target_error_ = 0.0;
+  /// equilibration blocks left out of the reblocked local energy checked against target_error
+  IndexType target_error_equilibration_ = 0;
+  /// blocks appended to stat.h5 per write
+  IndexType stat_blocks_per_write_ = 1;
+  /// lossless compression level of the stat.h5 datasets, 0 for no compression
+  int stat_compression_ = 0;
+  /// compress stat.h5 with the zstd filter plugin instead of deflate
+  bool stat_compressor_zstd_ = false;
   // call recompute at the end of each block in the full/mixed precision case.
   IndexType blocks_between_recompute_ = std::is_same<RealType, FullPrecisionRealType>::value ? 0 : 1;
   bool append_run_                    = false;
@@ -94,7 +104,13 @@ protected:
   // from putQMCInfo
   input::PeriodStride walker_dump_period_{0, 0};
   input::PeriodStride check_point_period_{0, 0};
-  bool dump_config_  = false;
+  /// write walker checkpoints from a background thread
+  bool check_point_async_ = false;
+  /// deflate level of the walker checkpoint datasets, 0 for no compression
+  int check_point_compression_ = 0;
+  /// number of delta walker checkpoints appended between full snapshots, 0 writes full snapshots only
+  int check_point_delta_ = 0;
+  bool dump_config_      = false;
   IndexType k_delay_ = 0;
   bool reset_random_ = false;
 
@@ -126,10 +142,18 @@ public:
   IndexType get_samples_per_thread() const { return samples_per_thread_; }
   RealType get_tau() const { return tau_; }
   RealType get_spin_mass() const { return spin_mass_; }
+  RealType get_target_error() const { return target_error_; }
+  IndexType get_target_error_equilibration() const { return target_error_equilibration_; }
+  IndexType get_stat_blocks_per_write() const { return stat_blocks_per_write_; }
+  int get_stat_compression() const { return stat_compression_; }
+  bool get_stat_compressor_zstd() const { return stat_compressor_zstd_; }
   IndexType get_blocks_between_recompute() const { return blocks_between_recompute_; }
   bool get_append_run() const { return append_run_; }
   input::PeriodStride get_walker_dump_period() const { return walker_dump_period_; }
   input::PeriodStride get_check_point_period() const { return check_point_period_; }
+  bool get_check_point_async() const { return check_point_async_; }
+  int get_check_point_compression() const { return check_point_compression_; }
+  int get_check_point_delta() const { return check_point_delta_; }
   IndexType get_k_delay() const { return k_delay_; }
   bool get_reset_random() const { return reset_random_; }
   bool get_dump_config() const { return dump_config_; }
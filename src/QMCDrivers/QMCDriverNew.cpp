@@ -83,6 +83,10 @@ QMCDriverNew::QMCDriverNew(const ProjectData& project_data,
                                                                       qmcdriver_input_.get_estimator_manager_input()),
                                             population_.get_golden_hamiltonian(), population.get_golden_electrons(),
                                             population.get_golden_twf());
+  estimator_manager_->setStatOutputLayout(qmcdriver_input_.get_stat_blocks_per_write(),
+                                          qmcdriver_input_.get_stat_compression(),
+                                          qmcdriver_input_.get_stat_compressor_zstd());
+  estimator_manager_->setReblockingEquilibration(qmcdriver_input_.get_target_error_equilibration());
 
   drift_modifier_.reset(
       createDriftModifier(qmcdriver_input_.get_drift_modifier(), qmcdriver_input_.get_drift_modifier_unr_a()));
@@ -96,6 +100,9 @@ QMCDriverNew::QMCDriverNew(const ProjectData& project_data,
   }
 
   wOut = std::make_unique<HDFWalkerOutput>(population.get_golden_electrons().getTotalNum(), get_root_name(), myComm);
+  wOut->setCompressionLevel(qmcdriver_input_.get_check_point_compression());
+  wOut->setAsyncWrite(qmcdriver_input_.get_check_point_async());
+  wOut->setDeltaCheckpoint(qmcdriver_input_.get_check_point_delta());
 }
 
 // The Rng pointers are transferred from global storage (RandomNumberControl::Children)
@@ -235,9 +242,12 @@ void QMCDriverNew::recordBlock(int block)
   if (qmcdriver_input_.get_dump_config() && block % qmcdriver_input_.get_check_point_period().period == 0)
   {
     ScopedTimer local_timer(timers_.checkpoint_timer);
-    wOut->dump(walker_configs_ref_, block);
+    population_.saveWalkerConfigurations(walker_configs_ref_);
+    setWalkerOffsets(walker_configs_ref_, myComm);
 #ifndef USE_FAKE_RNG
-    RandomNumberControl::write(getRngRefs(), get_root_name(), myComm);
+    wOut->dump(walker_configs_ref_, block, getRngRefs());
+#else
+    wOut->dump(walker_configs_ref_, block);
 #endif
   }
 }
@@ -250,20 +260,35 @@ bool QMCDriverNew::finalize(int block, bool dumpwalkers)
             << " walker configurations to the next QMC driver." << std::endl;
 
   const bool DumpConfig = qmcdriver_input_.get_dump_config();
+#ifndef USE_FAKE_RNG
+  if (DumpConfig && dumpwalkers)
+    wOut->dump(walker_configs_ref_, block, getRngRefs());
+  else if (DumpConfig)
+  {
+    // a checkpoint still being written would race on the random number file
+    wOut->waitForPendingWrite();
+    RandomNumberControl::write(getRngRefs(), get_root_name(), myComm);
+  }
+#else
   if (DumpConfig && dumpwalkers)
     wOut->dump(walker_configs_ref_, block);
+#endif
+  // the run ends with a complete checkpoint on disk and any write failure is reported
+  wOut->waitForPendingWrite();
 
   infoSummary.flush();
   infoLog.flush();
 
-#ifndef USE_FAKE_RNG
-  if (DumpConfig)
-    RandomNumberControl::write(getRngRefs(), get_root_name(), myComm);
-#endif
-
   return true;
 }
 
+bool QMCDriverNew::checkTargetError(RunTimeControl<>& runtime_control) const
+{
+  const auto& energy_reblocking = estimator_manager_->get_energy_reblocking();
+  return qmcdriver_input_.get_target_error() > 0 && energy_reblocking.isReliable() &&
+      runtime_control.checkTargetError(energy_reblocking.error(), qmcdriver_input_.get_target_error());
+}
+
 void QMCDriverNew::makeLocalWalkers(IndexType nwalkers, RealType reserve)
 {
   ScopedTimer local_timer(timers_.create_walkers_timer);
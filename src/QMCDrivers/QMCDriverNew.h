@@ -33,6 +33,7 @@
 #include "Pools/PooledData.h"
 #include "Utilities/TimerManager.h"
 #include "Utilities/ScopedProfiler.h"
+#include "Utilities/RunTimeManager.h"
 #include "QMCDrivers/MCPopulation.h"
 #include "QMCDrivers/QMCDriverInterface.h"
 #include "QMCDrivers/GreenFunctionModifiers/DriftModifierBase.h"
@@ -171,6 +172,11 @@ public:
    */
   bool finalize(int block, bool dumpwalkers = true);
 
+  /** check if the reblocked local energy error bar has reached the target_error input
+   *  only rank 0 has the reduced block averages so the result must be broadcast by the caller.
+   */
+  bool checkTargetError(RunTimeControl<>& runtime_control) const;
+
   ///return current step
   inline IndexType current() const { return current_step_; }
 
@@ -18,6 +18,7 @@
 #include "Utilities/RunTimeManager.h"
 #include "ParticleBase/RandomSeqGenerator.h"
 #include "Particle/MCSample.h"
+#include "QMCDrivers/DriftOperators.h"
 #include "MemoryUsage.h"
 #include "QMCWaveFunctions/TWFGrads.hpp"
 #include "TauParams.hpp"
@@ -87,13 +88,14 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
   std::vector<RealType> log_gf(num_walkers);
   std::vector<RealType> log_gb(num_walkers);
   std::vector<RealType> prob(num_walkers);
+  std::vector<RealType> rr(num_walkers);
 
   // local list to handle accept/reject
   std::vector<bool> isAccepted;
   std::vector<std::reference_wrapper<TrialWaveFunction>> twf_accept_list, twf_reject_list;
   isAccepted.reserve(num_walkers);
 
-  MCCoords<CT> drifts(num_walkers), drifts_reverse(num_walkers);
+  MCCoords<CT> drifts(num_walkers);
   MCCoords<CT> walker_deltas(num_walkers * num_particles), deltas(num_walkers);
   TWFGrads<CT> grads_now(num_walkers), grads_new(num_walkers);
 
@@ -114,16 +116,20 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
       {
         //get deltas for this particle (iat) for all walkers
         walker_deltas.getSubset(iat * num_walkers, num_walkers, deltas);
-        scaleBySqrtTau(taus, deltas);
 
         if (use_drift)
         {
           twf_dispatcher.flex_evalGrad(walker_twfs, walker_elecs, iat, grads_now);
-          sft.drift_modifier.getDrifts(taus, grads_now, drifts);
-          drifts += deltas;
+          // drifts holds the proposed moves, log_gf is computed in the same pass
+          sft.drift_modifier.getMoves(taus, grads_now, deltas, drifts, log_gf, rr);
+          if (sft.qmcdrv_input.get_debug_checks() & DriverDebugChecks::CHECK_DRIFT)
+            checkDriftDiffusionMoves(drifts, iat);
         }
         else
+        {
+          scaleBySqrtTau(taus, deltas);
           drifts = deltas;
+        }
 
         ps_dispatcher.flex_makeMove(walker_elecs, iat, drifts);
 
@@ -132,13 +138,7 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
         {
           twf_dispatcher.flex_calcRatioGrad(walker_twfs, walker_elecs, iat, ratios, grads_new);
 
-          computeLogGreensFunction(deltas, taus, log_gf);
-
-          sft.drift_modifier.getDrifts(taus, grads_new, drifts_reverse);
-
-          drifts_reverse += drifts;
-
-          computeLogGreensFunction(drifts_reverse, taus, log_gb);
+          sft.drift_modifier.getReverseLogGF(taus, grads_new, drifts, log_gb);
         }
         else
           twf_dispatcher.flex_calcRatio(walker_twfs, walker_elecs, iat, ratios);
@@ -384,19 +384,29 @@ bool VMCBatched::run()
     endBlock();
     vmc_loop.stop();
 
-    bool stop_requested = false;
-    // Rank 0 decides whether the time limit was reached
+    bool stop_requested       = false;
+    bool target_error_reached = false;
+    // Rank 0 decides whether the time limit or the target error was reached
     if (!myComm->rank())
-      stop_requested = runtimeControl.checkStop(vmc_loop);
+    {
+      stop_requested       = runtimeControl.checkStop(vmc_loop);
+      target_error_reached = !stop_requested && checkTargetError(runtimeControl);
+    }
     myComm->bcast(stop_requested);
+    myComm->bcast(target_error_reached);
 
-    if (stop_requested)
+    if (stop_requested || target_error_reached)
     {
       if (!myComm->rank())
         app_log() << runtimeControl.generateStopMessage("VMCBatched", block);
-      run_time_manager.markStop();
+      // a converged section only ends itself, the following sections still run
+      if (stop_requested)
+        run_time_manager.markStop();
       break;
     }
+    // the last block is written by finalize
+    if (block + 1 < num_blocks)
+      recordBlock(block + 1);
   }
   // This is confusing logic from VMC.cpp want this functionality write documentation of this
   // and clean it up
@@ -17,6 +17,7 @@
 
 
 #include "LinearMethod.h"
+#include <stdexcept>
 #include <vector>
 #include "QMCCostFunctionBase.h"
 #include <CPU/BLAS.hpp>
@@ -147,6 +148,16 @@ void LinearMethod::getNonLinearRange(int& first, int& last, const QMCCostFunctio
   //    app_log()<<"line params: "<<first<<" "<<last<< std::endl;
 }
 
+LinearMethod::Real LinearMethod::getNonLinearRescale(Real D) const
+{
+  Real rescale(1.0);
+  Real xi(0.5);
+  rescale = (1 - xi) * D / ((1 - xi) + xi * std::sqrt(1 + D));
+  rescale = 1.0 / (1.0 - rescale);
+  //     app_log()<<"rescale: "<<rescale<< std::endl;
+  return rescale;
+}
+
 LinearMethod::Real LinearMethod::getNonLinearRescale(std::vector<Real>& dP,
                                                      Matrix<Real>& S,
                                                      const QMCCostFunctionBase& optTarget) const
@@ -155,17 +166,196 @@ LinearMethod::Real LinearMethod::getNonLinearRescale(std::vector<Real>& dP,
   getNonLinearRange(first, last, optTarget);
   if (first == last)
     return 1.0;
-  Real rescale(1.0);
-  Real xi(0.5);
   Real D(0.0);
   for (int i = first; i < last; i++)
     for (int j = first; j < last; j++)
       D += S(i + 1, j + 1) * dP[i + 1] * dP[j + 1];
-  rescale = (1 - xi) * D / ((1 - xi) + xi * std::sqrt(1 + D));
-  rescale = 1.0 / (1.0 - rescale);
-  //     app_log()<<"rescale: "<<rescale<< std::endl;
-  return rescale;
+  return getNonLinearRescale(D);
+}
+
+LinearMethod::Real LinearMethod::getNonLinearRescale(
+    std::vector<Real>& dP,
+    const std::function<void(const std::vector<Real>& x, std::vector<Real>& sx)>& apply_overlap,
+    const QMCCostFunctionBase& optTarget) const
+{
+  int first(0), last(0);
+  getNonLinearRange(first, last, optTarget);
+  if (first == last)
+    return 1.0;
+  // only the non-linear part of the update enters
+  std::vector<Real> x(dP.size(), 0.0), sx;
+  for (int i = first; i < last; i++)
+    x[i + 1] = dP[i + 1];
+  apply_overlap(x, sx);
+  Real D(0.0);
+  for (int i = first; i < last; i++)
+    D += x[i + 1] * sx[i + 1];
+  return getNonLinearRescale(D);
 }
 
+LinearMethod::Real LinearMethod::getLowestEigenvectorDavidson(const MatrixFreeOperator& apply,
+                                                              const std::vector<Real>& a_diag,
+                                                              const std::vector<Real>& b_diag,
+                                                              std::vector<Real>& ev,
+                                                              int max_iterations,
+                                                              Real tolerance) const
+{
+  const int Nl           = ev.size();
+  const int max_subspace = std::max(1, std::min(max_iterations, Nl));
+  auto dot               = [Nl](const std::vector<Real>& x, const std::vector<Real>& y) {
+    Real res(0);
+    for (int i = 0; i < Nl; i++)
+      res += x[i] * y[i];
+    return res;
+  };
+
+  // orthonormal subspace basis and its images, the subspace matrices grow by a row and a column per iteration
+  std::vector<std::vector<Real>> basis, a_basis, b_basis;
+  Matrix<Real> a_sub(max_subspace, max_subspace), b_sub(max_subspace, max_subspace);
+  // start from the current wavefunction
+  std::vector<Real> trial(Nl, 0.0);
+  trial[0] = 1.0;
+
+  Real lowest(0);
+  std::vector<Real> ritz(Nl), a_ritz(Nl), b_ritz(Nl);
+  while (true)
+  {
+    const int m = basis.size();
+    basis.push_back(std::move(trial));
+    a_basis.emplace_back();
+    b_basis.emplace_back();
+    apply(basis[m], a_basis[m], b_basis[m]);
+    for (int i = 0; i <= m; i++)
+    {
+      a_sub(i, m) = dot(basis[i], a_basis[m]);
+      a_sub(m, i) = dot(basis[m], a_basis[i]);
+      b_sub(i, m) = dot(basis[i], b_basis[m]);
+      b_sub(m, i) = dot(basis[m], b_basis[i]);
+    }
+
+    // solve the subspace problem, LAPACK sees the transpose of row-major matrices
+    int ns(m + 1);
+    Matrix<Real> a_work(ns, ns), b_work(ns, ns), eigenT(ns, ns);
+    for (int i = 0; i < ns; i++)
+      for (int j = 0; j < ns; j++)
+      {
+        a_work(j, i) = a_sub(i, j);
+        b_work(j, i) = b_sub(i, j);
+      }
+    char jl('N');
+    char jr('V');
+    std::vector<Real> alphar(ns), alphai(ns), beta(ns);
+    int info;
+    int lwork(-1);
+    std::vector<Real> work(1);
+    Real tt(0);
+    int t(1);
+    LAPACK::ggev(&jl, &jr, &ns, a_work.data(), &ns, b_work.data(), &ns, &alphar[0], &alphai[0], &beta[0], &tt, &t,
+                 eigenT.data(), &ns, &work[0], &lwork, &info);
+    lwork = int(work[0]);
+    work.resize(lwork);
+    LAPACK::ggev(&jl, &jr, &ns, a_work.data(), &ns, b_work.data(), &ns, &alphar[0], &alphai[0], &beta[0], &tt, &t,
+                 eigenT.data(), &ns, &work[0], &lwork, &info);
+    if (info != 0)
+      throw std::runtime_error("LinearMethod::getLowestEigenvectorDavidson subspace diagonalization failed!");
+
+    /* same selection as the dense getLowestEigenvector(A, ev): among zerozero - 100 < ev < zerozero the
+     * eigenvalue closest to zerozero - 2, this rejects the spurious low roots. Until the subspace holds such
+     * an eigenvalue, e.g. in the first iteration, the lowest finite one drives the expansion.
+     * eigenvector i is the row i of eigenT
+     */
+    const Real zerozero = a_sub(0, 0) / b_sub(0, 0);
+    int lowest_index    = -1;
+    bool in_window      = false;
+    Real lowest_target  = std::numeric_limits<Real>::max();
+    for (int i = 0; i < ns; i++)
+    {
+      if (alphai[i] != 0 || beta[i] == 0)
+        continue;
+      Real evi(alphar[i] / beta[i]);
+      if (std::abs(evi) >= 1e10)
+        continue;
+      if ((evi < zerozero) && (evi > (zerozero - 1e2)))
+      {
+        const Real target = (evi - zerozero + 2.0) * (evi - zerozero + 2.0);
+        if (!in_window || target < lowest_target)
+        {
+          lowest        = evi;
+          lowest_index  = i;
+          lowest_target = target;
+          in_window     = true;
+        }
+      }
+      else if (!in_window && (lowest_index < 0 || evi < lowest))
+      {
+        lowest       = evi;
+        lowest_index = i;
+      }
+    }
+    if (lowest_index < 0)
+      throw std::runtime_error("LinearMethod::getLowestEigenvectorDavidson found no real eigenvalue!");
+
+    std::fill(ritz.begin(), ritz.end(), 0);
+    std::fill(a_ritz.begin(), a_ritz.end(), 0);
+    std::fill(b_ritz.begin(), b_ritz.end(), 0);
+    for (int k = 0; k < ns; k++)
+    {
+      const Real c = eigenT(lowest_index, k);
+      for (int i = 0; i < Nl; i++)
+      {
+        ritz[i] += c * basis[k][i];
+        a_ritz[i] += c * a_basis[k][i];
+        b_ritz[i] += c * b_basis[k][i];
+      }
+    }
+    const Real ritz_norm = std::sqrt(dot(ritz, ritz));
+
+    // residual of the normalized Ritz vector
+    std::vector<Real> residual(Nl);
+    for (int i = 0; i < Nl; i++)
+      residual[i] = (a_ritz[i] - lowest * b_ritz[i]) / ritz_norm;
+    const Real residual_norm = std::sqrt(dot(residual, residual));
+    app_log() << "  Davidson iteration " << m << "  eigenvalue " << lowest << "  residual norm " << residual_norm
+              << std::endl;
+    if (residual_norm < tolerance || ns == max_subspace)
+    {
+      if (residual_norm >= tolerance)
+        app_warning() << "Davidson did not converge in " << max_subspace << " iterations. Residual norm "
+                      << residual_norm << std::endl;
+      break;
+    }
+
+    // diagonally preconditioned correction
+    trial.resize(Nl);
+    for (int i = 0; i < Nl; i++)
+    {
+      Real denom = a_diag[i] - lowest * b_diag[i];
+      if (std::abs(denom) < 1e-8)
+        denom = denom < 0 ? -1e-8 : 1e-8;
+      trial[i] = -residual[i] / denom;
+    }
+    // orthogonalize against the basis twice for stability
+    for (int pass = 0; pass < 2; pass++)
+      for (int k = 0; k < ns; k++)
+      {
+        const Real overlap = dot(basis[k], trial);
+        for (int i = 0; i < Nl; i++)
+          trial[i] -= overlap * basis[k][i];
+      }
+    const Real trial_norm = std::sqrt(dot(trial, trial));
+    if (trial_norm < 1e-12)
+      break;
+    for (int i = 0; i < Nl; i++)
+      trial[i] /= trial_norm;
+  }
+
+  // the eigenvector is normalized so that the coefficient of the current wavefunction is 1
+  if (std::abs(ritz[0]) < 1e-8 * std::sqrt(dot(ritz, ritz)))
+    throw std::runtime_error("LinearMethod::getLowestEigenvectorDavidson lowest eigenvector has no overlap with the "
+                             "current wavefunction, cannot normalize the parameter update!");
+  for (int i = 0; i < Nl; i++)
+    ev[i] = ritz[i] / ritz[0];
+  return lowest;
+}
 
 } // namespace qmcplusplus
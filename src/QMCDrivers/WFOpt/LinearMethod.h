@@ -19,6 +19,7 @@
 #ifndef QMCPLUSPLUS_LINEARMETHOD_H
 #define QMCPLUSPLUS_LINEARMETHOD_H
 
+#include <functional>
 #include <Configuration.h>
 #include <NewTimer.h>
 #include <OhmmsPETE/OhmmsMatrix.h>
@@ -34,6 +35,8 @@ class LinearMethod
 
   // obtain the range of non-linear parameters
   void getNonLinearRange(int& first, int& last, const QMCCostFunctionBase& optTarget) const;
+  // rescale factor from the overlap norm of the non-linear part of the update
+  Real getNonLinearRescale(Real D) const;
 
 public:
   //asymmetric generalized EV
@@ -42,6 +45,33 @@ public:
   Real getLowestEigenvector(Matrix<Real>& A, std::vector<Real>& ev) const;
   // compute a rescale factor. Ye: Where is the method from?
   Real getNonLinearRescale(std::vector<Real>& dP, Matrix<Real>& S, const QMCCostFunctionBase& optTarget) const;
+
+  /// applies A and B of the generalized eigenvalue problem A x = lambda B x to x
+  using MatrixFreeOperator =
+      std::function<void(const std::vector<Real>& x, std::vector<Real>& ax, std::vector<Real>& bx)>;
+
+  /** generalized EV by the Davidson method, only the products with A and B are needed
+   * @param apply products with A and B, collective operations are allowed as long as all the ranks call it alike
+   * @param a_diag diagonal of A, used to precondition the residual
+   * @param b_diag diagonal of B
+   * @param ev eigenvector of the selected eigenvalue normalized to ev[0] = 1, its size sets the dimension
+   * @param max_iterations maximal number of Davidson iterations, i.e. maximal size of the subspace
+   * @param tolerance convergence threshold of the residual norm of the normalized eigenvector
+   * @return selected eigenvalue
+   *
+   * The eigenvalue is selected like getLowestEigenvector(A, ev) does, A(0,0) - 100 < lambda < A(0,0) closest to
+   * A(0,0) - 2, so the spurious low roots are rejected by both solvers.
+   */
+  Real getLowestEigenvectorDavidson(const MatrixFreeOperator& apply,
+                                    const std::vector<Real>& a_diag,
+                                    const std::vector<Real>& b_diag,
+                                    std::vector<Real>& ev,
+                                    int max_iterations,
+                                    Real tolerance) const;
+  // compute a rescale factor with the products of the overlap matrix
+  Real getNonLinearRescale(std::vector<Real>& dP,
+                           const std::function<void(const std::vector<Real>& x, std::vector<Real>& sx)>& apply_overlap,
+                           const QMCCostFunctionBase& optTarget) const;
 };
 } // namespace qmcplusplus
 #endif
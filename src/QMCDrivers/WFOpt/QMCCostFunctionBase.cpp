@@ -327,6 +327,7 @@ bool QMCCostFunctionBase::put(xmlNodePtr q)
   m_param.add(computeNLPPderiv, "use_nonlocalpp_deriv", {}, TagStatus::DEPRECATED);
   m_param.add(w_beta, "beta");
   m_param.add(GEVType, "GEVMethod");
+  m_param.add(records_scratch_dir_, "records_scratch");
   m_param.add(targetExcitedStr, "targetExcited");
   m_param.add(omega_shift, "omega");
   m_param.add(do_override_output, "output_vp_override", {true});
@@ -31,6 +31,7 @@
 #include "EngineHandle.h"
 
 #include <memory>
+#include <stdexcept>
 
 namespace qmcplusplus
 {
@@ -138,6 +139,28 @@ public:
 
   virtual Return_rt fillOverlapHamiltonianMatrices(Matrix<Return_rt>& Left, Matrix<Return_rt>& Right) = 0;
 
+  /** prepare the matrix-free application of the matrices of fillOverlapHamiltonianMatrices, collective
+   * @param ham_diag diagonal of Left
+   * @param ovl_diag diagonal of Right
+   */
+  virtual void prepareMatrixFree(std::vector<Return_rt>& ham_diag, std::vector<Return_rt>& ovl_diag)
+  {
+    throw std::runtime_error("The matrix-free linear method is not supported by this cost function.");
+  }
+
+  /** apply the matrices of fillOverlapHamiltonianMatrices to a vector without forming them, collective
+   * prepareMatrixFree must be called first.
+   * @param x vector of size getNumParams() + 1
+   * @param ham_x Left * x
+   * @param ovl_x Right * x
+   */
+  virtual void applyOverlapHamiltonian(const std::vector<Return_rt>& x,
+                                       std::vector<Return_rt>& ham_x,
+                                       std::vector<Return_rt>& ovl_x)
+  {
+    throw std::runtime_error("The matrix-free linear method is not supported by this cost function.");
+  }
+
 #ifdef HAVE_LMY_ENGINE
   Return_rt LMYEngineCost(const bool needDeriv, cqmc::engine::LMYEngine<Return_t>* EngineObj);
 #endif
@@ -222,6 +245,8 @@ protected:
 
   Return_rt w_beta;
   std::string GEVType;
+  ///scratch directory of the memory-mapped derivative records, the records stay in memory if empty
+  std::string records_scratch_dir_;
   Return_rt vmc_or_dmc;
   bool needGrads;
   ///whether we are targeting an excited state
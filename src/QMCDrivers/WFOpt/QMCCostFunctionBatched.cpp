@@ -23,6 +23,9 @@
 #include "Message/CommOperators.h"
 #include "QMCDrivers/Optimizers/DescentEngine.h"
 #include "Concurrency/ParallelExecutor.hpp"
+#include "Concurrency/OpenMP.h"
+#include "CPU/BLAS.hpp"
+#include "CPU/BlasThreadingEnv.h"
 //#define QMCCOSTFUNCTION_DEBUG
 
 namespace qmcplusplus
@@ -38,7 +41,8 @@ QMCCostFunctionBatched::QMCCostFunctionBatched(ParticleSet& w,
       walkers_per_crowd_(walkers_per_crowd),
       check_config_timer_(createGlobalTimer("QMCCostFunctionBatched::checkConfigurations", timer_level_medium)),
       corr_sampling_timer_(createGlobalTimer("QMCCostFunctionBatched::correlatedSampling", timer_level_medium)),
-      fill_timer_(createGlobalTimer("QMCCostFunctionBatched::fillOverlapHamiltonianMatrices", timer_level_medium))
+      fill_timer_(createGlobalTimer("QMCCostFunctionBatched::fillOverlapHamiltonianMatrices", timer_level_medium)),
+      apply_timer_(createGlobalTimer("QMCCostFunctionBatched::applyOverlapHamiltonian", timer_level_medium))
 
 {
   app_log() << " Using QMCCostFunctionBatched::QMCCostFunctionBatched" << std::endl;
@@ -147,6 +151,7 @@ void QMCCostFunctionBatched::GradCost(std::vector<Return_rt>& PGradient,
       }
     }
     myComm->allreduce(E2Dtotals_w);
+    releaseDerivRecords(0, rank_local_num_samples_);
     for (int pm = 0; pm < NumOptimizables; pm++)
       URV[pm] *= smpinv;
     for (int j = 0; j < NumOptimizables; j++)
@@ -207,6 +212,41 @@ void compute_batch_parameters(int sample_size, int batch_size, int& num_batches,
   }
 }
 
+void QMCCostFunctionBatched::resizeDerivRecords(int num_samples)
+{
+  if (deriv_records_file_)
+  {
+    // detach from the previous mapping before it is released
+    DerivRecords_.free();
+    HDerivRecords_.free();
+    deriv_records_file_.reset();
+    hderiv_records_file_.reset();
+  }
+  if (records_scratch_dir_.empty())
+  {
+    DerivRecords_.resize(num_samples, NumOptimizables);
+    HDerivRecords_.resize(num_samples, NumOptimizables);
+    return;
+  }
+
+  const size_t bytes   = static_cast<size_t>(num_samples) * NumOptimizables * sizeof(Return_rt);
+  deriv_records_file_  = std::make_unique<MappedScratchFile>(records_scratch_dir_, bytes);
+  hderiv_records_file_ = std::make_unique<MappedScratchFile>(records_scratch_dir_, bytes);
+  DerivRecords_.attachReference(static_cast<Return_rt*>(deriv_records_file_->data()), num_samples, NumOptimizables);
+  HDerivRecords_.attachReference(static_cast<Return_rt*>(hderiv_records_file_->data()), num_samples, NumOptimizables);
+  app_log() << "  Derivative records of " << num_samples << " samples are memory mapped in " << records_scratch_dir_
+            << " (" << 2 * bytes / (1 << 20) << " MB)" << std::endl;
+}
+
+void QMCCostFunctionBatched::releaseDerivRecords(int first, int num_samples) const
+{
+  if (!deriv_records_file_)
+    return;
+  const size_t row_bytes = NumOptimizables * sizeof(Return_rt);
+  deriv_records_file_->release(first * row_bytes, num_samples * row_bytes);
+  hderiv_records_file_->release(first * row_bytes, num_samples * row_bytes);
+}
+
 /** evaluate everything before optimization */
 void QMCCostFunctionBatched::checkConfigurations(EngineHandle& handle)
 {
@@ -222,19 +262,13 @@ void QMCCostFunctionBatched::checkConfigurations(EngineHandle& handle)
   {
     RecordsOnNode_.resize(rank_local_num_samples_, SUM_INDEX_SIZE);
     if (needGrads)
-    {
-      DerivRecords_.resize(rank_local_num_samples_, NumOptimizables);
-      HDerivRecords_.resize(rank_local_num_samples_, NumOptimizables);
-    }
+      resizeDerivRecords(rank_local_num_samples_);
   }
   else if (RecordsOnNode_.size1() != rank_local_num_samples_)
   {
     RecordsOnNode_.resize(rank_local_num_samples_, SUM_INDEX_SIZE);
     if (needGrads)
-    {
-      DerivRecords_.resize(rank_local_num_samples_, NumOptimizables);
-      HDerivRecords_.resize(rank_local_num_samples_, NumOptimizables);
-    }
+      resizeDerivRecords(rank_local_num_samples_);
   }
   //    synchronize the random number generator with the node
   (*MoverRng[0]) = (*RngSaved[0]);
@@ -374,6 +408,7 @@ void QMCCostFunctionBatched::checkConfigurations(EngineHandle& handle)
   ParallelExecutor<> crowd_tasks;
   crowd_tasks(opt_num_crowds, evalOptConfig, opt_eval, samples_per_crowd_offsets, walkers_per_crowd_, dLogPsi, d2LogPsi,
               RecordsOnNode_, DerivRecords_, HDerivRecords_, samples_, OptVariablesForPsi, needGrads, handle);
+  releaseDerivRecords(0, rank_local_num_samples_);
   // Sum energy values over crowds
   for (int i = 0; i < opt_eval.size(); i++)
   {
@@ -605,6 +640,8 @@ QMCCostFunctionBatched::EffectiveWeight QMCCostFunctionBatched::correlatedSampli
   crowd_tasks(opt_num_crowds, evalOptCorrelated, opt_eval, samples_per_crowd_offsets, walkers_per_crowd_, dLogPsi,
               d2LogPsi, RecordsOnNode_, DerivRecords_, HDerivRecords_, samples_, OptVariablesForPsi,
               compute_all_from_scratch, vmc_or_dmc, needGrad);
+  if (needGrad)
+    releaseDerivRecords(0, rank_local_num_samples_);
   // Sum weights over crowds
   for (int i = 0; i < opt_eval.size(); i++)
   {
@@ -679,112 +716,300 @@ QMCCostFunctionBatched::EffectiveWeight QMCCostFunctionBatched::correlatedSampli
 //   Right - overlap matrix
 //
 
-QMCCostFunctionBatched::Return_rt QMCCostFunctionBatched::fillOverlapHamiltonianMatrices(Matrix<Return_rt>& Left,
-                                                                                         Matrix<Return_rt>& Right)
+QMCCostFunctionBatched::LinearMatrixCoefficients QMCCostFunctionBatched::computeLinearMatrixCoefficients()
 {
-  ScopedTimer tmp_timer(fill_timer_);
-
-  RealType b1, b2;
+  LinearMatrixCoefficients coefs;
   if (GEVType == "H2")
   {
-    b1 = w_beta;
-    b2 = 0;
+    coefs.b1 = w_beta;
+    coefs.b2 = 0;
   }
   else
   {
-    b2 = w_beta;
-    b1 = 0;
+    coefs.b2 = w_beta;
+    coefs.b1 = 0;
   }
 
-  Right = 0.0;
-  Left  = 0.0;
-
   //     resetPsi();
   curAvg_w            = SumValue[SUM_E_WGT] / SumValue[SUM_WGT];
   Return_rt curAvg2_w = SumValue[SUM_ESQ_WGT] / SumValue[SUM_WGT];
   //    RealType H2_avg = 1.0/curAvg2_w;
-  RealType H2_avg = 1.0 / (curAvg_w * curAvg_w);
+  coefs.H2_avg = 1.0 / (curAvg_w * curAvg_w);
   //    RealType H2_avg = 1.0/std::sqrt(curAvg_w*curAvg_w*curAvg2_w);
-  RealType V_avg = curAvg2_w - curAvg_w * curAvg_w;
-  std::vector<Return_rt> D_avg(getNumParams(), 0.0);
-  Return_rt wgtinv = 1.0 / SumValue[SUM_WGT];
+  coefs.V_avg  = curAvg2_w - curAvg_w * curAvg_w;
+  coefs.wgtinv = 1.0 / SumValue[SUM_WGT];
+  coefs.D_avg.assign(getNumParams(), 0.0);
 
   for (int iw = 0; iw < rank_local_num_samples_; iw++)
   {
     const Return_rt* restrict saved = RecordsOnNode_[iw];
-    Return_rt weight                = saved[REWEIGHT] * wgtinv;
+    Return_rt weight                = saved[REWEIGHT] * coefs.wgtinv;
     const Return_rt* Dsaved         = DerivRecords_[iw];
     for (int pm = 0; pm < getNumParams(); pm++)
     {
-      D_avg[pm] += Dsaved[pm] * weight;
+      coefs.D_avg[pm] += Dsaved[pm] * weight;
     }
   }
 
-  myComm->allreduce(D_avg);
+  releaseDerivRecords(0, rank_local_num_samples_);
+  myComm->allreduce(coefs.D_avg);
+  return coefs;
+}
 
-  for (int iw = 0; iw < rank_local_num_samples_; iw++)
+int QMCCostFunctionBatched::getTileSamples() const
+{
+  return std::max(1, std::min(rank_local_num_samples_, fill_tile_elements_ / std::max(1, getNumParams())));
+}
+
+void QMCCostFunctionBatched::computeFactorTile(const LinearMatrixCoefficients& coefs,
+                                               int first,
+                                               int nb,
+                                               Matrix<Return_rt>& weighted,
+                                               Matrix<Return_rt>& ham_factors,
+                                               Matrix<Return_rt>& ovl_factors) const
+{
+  const int num_params    = getNumParams();
+  const bool has_variance = coefs.getNumFactorRows(nb) > nb;
+  const Return_rt b1      = coefs.b1;
+  const Return_rt b2      = coefs.b2;
+  const Return_rt* D_avg  = coefs.D_avg.data();
+#pragma omp for
+  for (int ib = 0; ib < nb; ib++)
   {
-    const Return_rt* restrict saved = RecordsOnNode_[iw];
-    Return_rt weight                = saved[REWEIGHT] * wgtinv;
-    Return_rt eloc_new              = saved[ENERGY_NEW];
-    const Return_rt* Dsaved         = DerivRecords_[iw];
-    const Return_rt* HDsaved        = HDerivRecords_[iw];
+    const Return_rt* restrict saved   = RecordsOnNode_[first + ib];
+    const Return_rt weight            = saved[REWEIGHT] * coefs.wgtinv;
+    const Return_rt eloc_new          = saved[ENERGY_NEW];
+    const Return_rt* restrict Dsaved  = DerivRecords_[first + ib];
+    const Return_rt* restrict HDsaved = HDerivRecords_[first + ib];
+    Return_rt* restrict wfd           = weighted[ib];
+    Return_rt* restrict ham_right     = ham_factors[ib];
+    Return_rt* restrict ovl_right     = ovl_factors[ib];
+    for (int pm = 0; pm < num_params; pm++)
+    {
+      const Return_rt dcentered = Dsaved[pm] - D_avg[pm];
+      wfd[pm]                   = dcentered * weight;
+      //                Hamiltonian and the overlap part of Variance
+      ham_right[pm] = (1 - b2) * (HDsaved[pm] + dcentered * eloc_new) + b2 * coefs.V_avg * dcentered;
+      //                Overlap
+      ovl_right[pm] = dcentered;
+    }
+    if (has_variance)
+    {
+      Return_rt* restrict wvar      = weighted[nb + ib];
+      Return_rt* restrict ham_right = ham_factors[nb + ib];
+      Return_rt* restrict ovl_right = ovl_factors[nb + ib];
+      for (int pm = 0; pm < num_params; pm++)
+      {
+        const Return_rt vfactor = HDsaved[pm] - 2.0 * (Dsaved[pm] - D_avg[pm]) * eloc_new;
+        wvar[pm]                = weight * vfactor;
+        //                Variance
+        ham_right[pm] = b2 * vfactor;
+        //                H2
+        ovl_right[pm] = b1 * coefs.H2_avg * vfactor;
+      }
+    }
+  }
+}
 
-    size_t opt_num_crowds = walkers_per_crowd_.size();
-    std::vector<int> params_per_crowd(opt_num_crowds + 1);
-    FairDivide(getNumParams(), opt_num_crowds, params_per_crowd);
+void QMCCostFunctionBatched::accumulateFirstRowColumn(const LinearMatrixCoefficients& coefs,
+                                                      int first,
+                                                      int nb,
+                                                      std::vector<Return_rt>& left_row,
+                                                      std::vector<Return_rt>& left_col,
+                                                      std::vector<Return_rt>& right_row) const
+{
+  const Return_rt b1 = coefs.b1;
+  const Return_rt b2 = coefs.b2;
+  // each thread owns a range of parameters
+#pragma omp for
+  for (int pm = 0; pm < getNumParams(); pm++)
+    for (int ib = 0; ib < nb; ib++)
+    {
+      const Return_rt* restrict saved = RecordsOnNode_[first + ib];
+      const Return_rt weight          = saved[REWEIGHT] * coefs.wgtinv;
+      const Return_rt eloc_new        = saved[ENERGY_NEW];
+      const Return_rt dcentered       = DerivRecords_[first + ib][pm] - coefs.D_avg[pm];
+      const Return_rt hd              = HDerivRecords_[first + ib][pm];
+      const Return_rt vterm = hd * (eloc_new - curAvg_w) + dcentered * eloc_new * (eloc_new - 2.0 * curAvg_w);
+      //                 H2
+      right_row[pm] += b1 * coefs.H2_avg * vterm * weight;
+      //                 Variance
+      left_row[pm] += b2 * vterm * weight;
+      left_col[pm] += b2 * vterm * weight;
+      //                 Hamiltonian
+      left_row[pm] += (1 - b2) * (hd + dcentered * eloc_new) * weight;
+      left_col[pm] += (1 - b2) * dcentered * weight * eloc_new;
+    }
+}
 
+QMCCostFunctionBatched::Return_rt QMCCostFunctionBatched::fillOverlapHamiltonianMatrices(Matrix<Return_rt>& Left,
+                                                                                         Matrix<Return_rt>& Right)
+{
+  ScopedTimer tmp_timer(fill_timer_);
 
-    auto constructMatrices = [](int crowd_id, std::vector<int>& crowd_ranges, int numParams, const Return_rt* Dsaved,
-                                const Return_rt* HDsaved, Return_rt weight, Return_rt eloc_new, RealType H2_avg,
-                                RealType V_avg, std::vector<Return_rt>& D_avg, RealType b1, RealType b2,
-                                RealType curAvg_w, Matrix<Return_rt>& Left, Matrix<Return_rt>& Right) {
-      int local_pm_start = crowd_ranges[crowd_id];
-      int local_pm_end   = crowd_ranges[crowd_id + 1];
+  Right = 0.0;
+  Left  = 0.0;
 
-      for (int pm = local_pm_start; pm < local_pm_end; pm++)
-      {
-        Return_rt wfe = (HDsaved[pm] + (Dsaved[pm] - D_avg[pm]) * eloc_new) * weight;
-        Return_rt wfd = (Dsaved[pm] - D_avg[pm]) * weight;
-        Return_rt vterm =
-            HDsaved[pm] * (eloc_new - curAvg_w) + (Dsaved[pm] - D_avg[pm]) * eloc_new * (eloc_new - 2.0 * curAvg_w);
-        //                 H2
-        Right(0, pm + 1) += b1 * H2_avg * vterm * weight;
-        Right(pm + 1, 0) += b1 * H2_avg * vterm * weight;
-        //                 Variance
-        Left(0, pm + 1) += b2 * vterm * weight;
-        Left(pm + 1, 0) += b2 * vterm * weight;
-        //                 Hamiltonian
-        Left(0, pm + 1) += (1 - b2) * wfe;
-        Left(pm + 1, 0) += (1 - b2) * wfd * eloc_new;
-        for (int pm2 = 0; pm2 < numParams; pm2++)
-        {
-          //                Hamiltonian
-          Left(pm + 1, pm2 + 1) += (1 - b2) * wfd * (HDsaved[pm2] + (Dsaved[pm2] - D_avg[pm2]) * eloc_new);
-          //                Overlap
-          RealType ovlij = wfd * (Dsaved[pm2] - D_avg[pm2]);
-          Right(pm + 1, pm2 + 1) += ovlij;
-          //                Variance
-          RealType varij = weight * (HDsaved[pm] - 2.0 * (Dsaved[pm] - D_avg[pm]) * eloc_new) *
-              (HDsaved[pm2] - 2.0 * (Dsaved[pm2] - D_avg[pm2]) * eloc_new);
-          Left(pm + 1, pm2 + 1) += b2 * (varij + V_avg * ovlij);
-          //                H2
-          Right(pm + 1, pm2 + 1) += b1 * H2_avg * varij;
-        }
-      }
-    };
+  const LinearMatrixCoefficients coefs = computeLinearMatrixCoefficients();
+
+  /* The parameter-parameter blocks are sums over samples of outer products, e.g. Right(pm+1, pm2+1) += wfd[pm]*d[pm2].
+   * Samples are processed in tiles and each tile stacks the weighted left factors (and the variance factors if needed)
+   * along the sample dimension, so that Left and Right are each updated by a single GEMM per tile.
+   */
+  const int num_params   = getNumParams();
+  const int tile_samples = getTileSamples();
+  const int tile_rows    = coefs.getNumFactorRows(tile_samples);
+  // weighted left factors, Hamiltonian right factors and overlap right factors of the tile samples
+  Matrix<Return_rt> weighted(tile_rows, num_params);
+  Matrix<Return_rt> ham_factors(tile_rows, num_params);
+  Matrix<Return_rt> ovl_factors(tile_rows, num_params);
+  std::vector<Return_rt> left_row(num_params, 0.0);
+  std::vector<Return_rt> left_col(num_params, 0.0);
+  std::vector<Return_rt> right_row(num_params, 0.0);
+
+  BlasThreadingEnv knob(omp_get_max_threads());
+  for (int first = 0; first < rank_local_num_samples_; first += tile_samples)
+  {
+    const int nb = std::min(tile_samples, rank_local_num_samples_ - first);
+#pragma omp parallel
+    {
+      computeFactorTile(coefs, first, nb, weighted, ham_factors, ovl_factors);
+      accumulateFirstRowColumn(coefs, first, nb, left_row, left_col, right_row);
+    }
 
-    ParallelExecutor<> crowd_tasks;
-    crowd_tasks(opt_num_crowds, constructMatrices, params_per_crowd, getNumParams(), Dsaved, HDsaved, weight, eloc_new,
-                H2_avg, V_avg, D_avg, b1, b2, curAvg_w, Left, Right);
+    // row-major X(pm, pm2) += sum_k weighted(k, pm) * factors(k, pm2) is the column-major factors^T * weighted
+    const int num_rows = coefs.getNumFactorRows(nb);
+    if (num_params > 0)
+    {
+      BLAS::gemm('N', 'T', num_params, num_params, num_rows, 1.0, ham_factors.data(), num_params, weighted.data(),
+                 num_params, 1.0, Left[1] + 1, num_params + 1);
+      BLAS::gemm('N', 'T', num_params, num_params, num_rows, 1.0, ovl_factors.data(), num_params, weighted.data(),
+                 num_params, 1.0, Right[1] + 1, num_params + 1);
+    }
+    releaseDerivRecords(first, nb);
+  }
+  for (int pm = 0; pm < num_params; pm++)
+  {
+    Left(0, pm + 1)  = left_row[pm];
+    Left(pm + 1, 0)  = left_col[pm];
+    Right(0, pm + 1) = right_row[pm];
+    Right(pm + 1, 0) = right_row[pm];
   }
   myComm->allreduce(Right);
   myComm->allreduce(Left);
-  Left(0, 0)  = (1 - b2) * curAvg_w + b2 * V_avg;
-  Right(0, 0) = 1.0 + b1 * H2_avg * V_avg;
+  Left(0, 0)  = (1 - coefs.b2) * curAvg_w + coefs.b2 * coefs.V_avg;
+  Right(0, 0) = 1.0 + coefs.b1 * coefs.H2_avg * coefs.V_avg;
   if (GEVType == "H2")
-    return H2_avg;
+    return coefs.H2_avg;
 
   return 1.0;
 }
+
+void QMCCostFunctionBatched::prepareMatrixFree(std::vector<Return_rt>& ham_diag, std::vector<Return_rt>& ovl_diag)
+{
+  ScopedTimer tmp_timer(fill_timer_);
+
+  matrix_free_coefs_ = computeLinearMatrixCoefficients();
+
+  const int num_params   = getNumParams();
+  const int tile_samples = getTileSamples();
+  const int tile_rows    = matrix_free_coefs_.getNumFactorRows(tile_samples);
+  Matrix<Return_rt> weighted(tile_rows, num_params);
+  Matrix<Return_rt> ham_factors(tile_rows, num_params);
+  Matrix<Return_rt> ovl_factors(tile_rows, num_params);
+  matrix_free_left_row_.assign(num_params, 0.0);
+  matrix_free_left_col_.assign(num_params, 0.0);
+  matrix_free_right_row_.assign(num_params, 0.0);
+  // diagonals of the Left and Right parameter blocks, reduced together with the first rows and columns
+  std::vector<Return_rt> reduced(5 * num_params, 0.0);
+  Return_rt* restrict left_diag  = reduced.data() + 3 * num_params;
+  Return_rt* restrict right_diag = reduced.data() + 4 * num_params;
+
+  for (int first = 0; first < rank_local_num_samples_; first += tile_samples)
+  {
+    const int nb       = std::min(tile_samples, rank_local_num_samples_ - first);
+    const int num_rows = matrix_free_coefs_.getNumFactorRows(nb);
+#pragma omp parallel
+    {
+      computeFactorTile(matrix_free_coefs_, first, nb, weighted, ham_factors, ovl_factors);
+      accumulateFirstRowColumn(matrix_free_coefs_, first, nb, matrix_free_left_row_, matrix_free_left_col_,
+                               matrix_free_right_row_);
+#pragma omp for
+      for (int pm = 0; pm < num_params; pm++)
+        for (int k = 0; k < num_rows; k++)
+        {
+          left_diag[pm] += weighted(k, pm) * ham_factors(k, pm);
+          right_diag[pm] += weighted(k, pm) * ovl_factors(k, pm);
+        }
+    }
+    releaseDerivRecords(first, nb);
+  }
+
+  std::copy(matrix_free_left_row_.begin(), matrix_free_left_row_.end(), reduced.begin());
+  std::copy(matrix_free_left_col_.begin(), matrix_free_left_col_.end(), reduced.begin() + num_params);
+  std::copy(matrix_free_right_row_.begin(), matrix_free_right_row_.end(), reduced.begin() + 2 * num_params);
+  myComm->allreduce(reduced);
+  std::copy_n(reduced.begin(), num_params, matrix_free_left_row_.begin());
+  std::copy_n(reduced.begin() + num_params, num_params, matrix_free_left_col_.begin());
+  std::copy_n(reduced.begin() + 2 * num_params, num_params, matrix_free_right_row_.begin());
+
+  ham_diag.resize(num_params + 1);
+  ovl_diag.resize(num_params + 1);
+  ham_diag[0] = (1 - matrix_free_coefs_.b2) * curAvg_w + matrix_free_coefs_.b2 * matrix_free_coefs_.V_avg;
+  ovl_diag[0] = 1.0 + matrix_free_coefs_.b1 * matrix_free_coefs_.H2_avg * matrix_free_coefs_.V_avg;
+  std::copy_n(reduced.begin() + 3 * num_params, num_params, ham_diag.begin() + 1);
+  std::copy_n(reduced.begin() + 4 * num_params, num_params, ovl_diag.begin() + 1);
+}
+
+void QMCCostFunctionBatched::applyOverlapHamiltonian(const std::vector<Return_rt>& x,
+                                                     std::vector<Return_rt>& ham_x,
+                                                     std::vector<Return_rt>& ovl_x)
+{
+  ScopedTimer tmp_timer(apply_timer_);
+
+  const int num_params = getNumParams();
+  if (matrix_free_coefs_.D_avg.size() != num_params || x.size() != num_params + 1)
+    throw std::runtime_error("QMCCostFunctionBatched::applyOverlapHamiltonian called before prepareMatrixFree.");
+
+  const int tile_samples = getTileSamples();
+  const int tile_rows    = matrix_free_coefs_.getNumFactorRows(tile_samples);
+  Matrix<Return_rt> weighted(tile_rows, num_params);
+  Matrix<Return_rt> ham_factors(tile_rows, num_params);
+  Matrix<Return_rt> ovl_factors(tile_rows, num_params);
+  std::vector<Return_rt> ham_proj(tile_rows);
+  std::vector<Return_rt> ovl_proj(tile_rows);
+  // parameter blocks of Left * x followed by Right * x, the only data reduced over the ranks
+  std::vector<Return_rt> reduced(2 * num_params, 0.0);
+
+  BlasThreadingEnv knob(omp_get_max_threads());
+  for (int first = 0; first < rank_local_num_samples_ && num_params > 0; first += tile_samples)
+  {
+    const int nb       = std::min(tile_samples, rank_local_num_samples_ - first);
+    const int num_rows = matrix_free_coefs_.getNumFactorRows(nb);
+#pragma omp parallel
+    computeFactorTile(matrix_free_coefs_, first, nb, weighted, ham_factors, ovl_factors);
+    // Block * x = weighted^T * (factors * x)
+    BLAS::gemv('T', num_params, num_rows, 1.0, ham_factors.data(), num_params, x.data() + 1, 1, 0.0, ham_proj.data(),
+               1);
+    BLAS::gemv('T', num_params, num_rows, 1.0, ovl_factors.data(), num_params, x.data() + 1, 1, 0.0, ovl_proj.data(),
+               1);
+    BLAS::gemv('N', num_params, num_rows, 1.0, weighted.data(), num_params, ham_proj.data(), 1, 1.0, reduced.data(), 1);
+    BLAS::gemv('N', num_params, num_rows, 1.0, weighted.data(), num_params, ovl_proj.data(), 1, 1.0,
+               reduced.data() + num_params, 1);
+    releaseDerivRecords(first, nb);
+  }
+  myComm->allreduce(reduced);
+
+  ham_x.resize(num_params + 1);
+  ovl_x.resize(num_params + 1);
+  ham_x[0] = ((1 - matrix_free_coefs_.b2) * curAvg_w + matrix_free_coefs_.b2 * matrix_free_coefs_.V_avg) * x[0];
+  ovl_x[0] = (1.0 + matrix_free_coefs_.b1 * matrix_free_coefs_.H2_avg * matrix_free_coefs_.V_avg) * x[0];
+  for (int pm = 0; pm < num_params; pm++)
+  {
+    ham_x[0] += matrix_free_left_row_[pm] * x[pm + 1];
+    ovl_x[0] += matrix_free_right_row_[pm] * x[pm + 1];
+    ham_x[pm + 1] = reduced[pm] + matrix_free_left_col_[pm] * x[0];
+    ovl_x[pm + 1] = reduced[num_params + pm] + matrix_free_right_row_[pm] * x[0];
+  }
+}
 } // namespace qmcplusplus
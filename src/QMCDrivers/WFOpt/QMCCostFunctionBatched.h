@@ -18,6 +18,7 @@
 #include "QMCDrivers/WFOpt/QMCCostFunctionBase.h"
 #include "QMCDrivers/CloneManager.h"
 #include "QMCWaveFunctions/OrbitalSetTraits.h"
+#include "Utilities/MappedScratchFile.h"
 
 namespace qmcplusplus
 {
@@ -62,6 +63,10 @@ public:
   void resetPsi(bool final_reset = false) override;
   void GradCost(std::vector<Return_rt>& PGradient, const std::vector<Return_rt>& PM, Return_rt FiniteDiff = 0) override;
   Return_rt fillOverlapHamiltonianMatrices(Matrix<Return_rt>& Left, Matrix<Return_rt>& Right) override;
+  void prepareMatrixFree(std::vector<Return_rt>& ham_diag, std::vector<Return_rt>& ovl_diag) override;
+  void applyOverlapHamiltonian(const std::vector<Return_rt>& x,
+                               std::vector<Return_rt>& ham_x,
+                               std::vector<Return_rt>& ovl_x) override;
 
 protected:
   /// H components used in correlated sampling. It can be KE or KE+NLPP
@@ -73,6 +78,14 @@ protected:
   */
   Matrix<Return_rt> DerivRecords_;
   Matrix<Return_rt> HDerivRecords_;
+  /// backing files of DerivRecords_ and HDerivRecords_ if records_scratch_dir_ is set
+  std::unique_ptr<MappedScratchFile> deriv_records_file_;
+  std::unique_ptr<MappedScratchFile> hderiv_records_file_;
+
+  /// size the derivative records for num_samples, in memory or in the scratch files
+  void resizeDerivRecords(int num_samples);
+  /// drop the derivative records [first, first + num_samples) from memory after a pass if they are memory mapped
+  void releaseDerivRecords(int first, int num_samples) const;
 
   EffectiveWeight correlatedSampling(bool needGrad = true) override;
 
@@ -84,9 +97,58 @@ protected:
   // Number of walkers per crowd. Size of vector is number of crowds.
   std::vector<int> walkers_per_crowd_;
 
+  /// number of sample-parameter elements per tile in fillOverlapHamiltonianMatrices
+  int fill_tile_elements_ = 1 << 20;
+
+  /// sample-independent coefficients of the linear method matrices
+  struct LinearMatrixCoefficients
+  {
+    Return_rt b1;
+    Return_rt b2;
+    Return_rt H2_avg;
+    Return_rt V_avg;
+    Return_rt wgtinv;
+    /// weighted average of the parameter derivatives over all the ranks
+    std::vector<Return_rt> D_avg;
+
+    /// the variance and H2 factors are stacked below the Hamiltonian and overlap ones
+    int getNumFactorRows(int nb) const { return b1 != 0 || b2 != 0 ? 2 * nb : nb; }
+  };
+
+  /// compute the coefficients from the current sums, collective
+  LinearMatrixCoefficients computeLinearMatrixCoefficients();
+  /// number of samples per tile
+  int getTileSamples() const;
+  /** compute the factors of the parameter blocks for the samples [first, first + nb)
+   * Block(pm, pm2) += sum_k weighted(k, pm) * factors(k, pm2) over coefs.getNumFactorRows(nb) rows.
+   * Must be called from inside an OpenMP parallel region.
+   */
+  void computeFactorTile(const LinearMatrixCoefficients& coefs,
+                        int first,
+                        int nb,
+                        Matrix<Return_rt>& weighted,
+                        Matrix<Return_rt>& ham_factors,
+                        Matrix<Return_rt>& ovl_factors) const;
+  /** accumulate the first row and column of the matrices for the samples [first, first + nb)
+   * Right is symmetric so only its first row is accumulated. Must be called from inside an OpenMP parallel region.
+   */
+  void accumulateFirstRowColumn(const LinearMatrixCoefficients& coefs,
+                                int first,
+                                int nb,
+                                std::vector<Return_rt>& left_row,
+                                std::vector<Return_rt>& left_col,
+                                std::vector<Return_rt>& right_row) const;
+
+  /// coefficients and first rows and columns saved by prepareMatrixFree
+  LinearMatrixCoefficients matrix_free_coefs_;
+  std::vector<Return_rt> matrix_free_left_row_;
+  std::vector<Return_rt> matrix_free_left_col_;
+  std::vector<Return_rt> matrix_free_right_row_;
+
   NewTimer& check_config_timer_;
   NewTimer& corr_sampling_timer_;
   NewTimer& fill_timer_;
+  NewTimer& apply_timer_;
 
 
 #ifdef HAVE_LMY_ENGINE
@@ -86,6 +86,9 @@ QMCFixedSampleLinearOptimizeBatched::QMCFixedSampleLinearOptimizeBatched(
       do_output_matrices_hdf_(false),
       output_matrices_initialized_(false),
       freeze_parameters_(false),
+      matrix_free_(false),
+      davidson_max_iterations_(50),
+      davidson_tolerance_(1e-6),
       generate_samples_timer_(createGlobalTimer("QMCLinearOptimizeBatched::GenerateSamples", timer_level_medium)),
       initialize_timer_(createGlobalTimer("QMCLinearOptimizeBatched::Initialize", timer_level_medium)),
       eigenvalue_timer_(createGlobalTimer("QMCLinearOptimizeBatched::Eigenvalue", timer_level_medium)),
@@ -109,6 +112,8 @@ QMCFixedSampleLinearOptimizeBatched::QMCFixedSampleLinearOptimizeBatched(
   m_param.add(param_tol, "alloweddifference");
   m_param.add(shift_i_input, "shift_i");
   m_param.add(shift_s_input, "shift_s");
+  m_param.add(davidson_max_iterations_, "davidson_max_its");
+  m_param.add(davidson_tolerance_, "davidson_tol");
   // options_LMY_
   m_param.add(options_LMY_.targetExcited, "options_LMY_.targetExcited");
   m_param.add(options_LMY_.block_lm, "options_LMY_.block_lm");
@@ -578,6 +583,7 @@ void QMCFixedSampleLinearOptimizeBatched::process(xmlNodePtr q)
   std::string OutputMatrices("no");
   std::string OutputMatricesHDF("no");
   std::string FreezeParameters("no");
+  std::string MatrixFree("no");
   OhmmsAttributeSet oAttrib;
   oAttrib.add(useGPU, "gpu");
   oAttrib.add(vmcMove, "move");
@@ -586,6 +592,7 @@ void QMCFixedSampleLinearOptimizeBatched::process(xmlNodePtr q)
   m_param.add(OutputMatrices, "output_matrices_csv", {"no", "yes"});
   m_param.add(OutputMatricesHDF, "output_matrices_hdf", {"no", "yes"});
   m_param.add(FreezeParameters, "freeze_parameters", {"no", "yes"});
+  m_param.add(MatrixFree, "matrix_free", {"no", "yes"});
 
   oAttrib.put(q);
   m_param.put(q);
@@ -593,6 +600,10 @@ void QMCFixedSampleLinearOptimizeBatched::process(xmlNodePtr q)
   do_output_matrices_csv_ = (OutputMatrices == "yes");
   do_output_matrices_hdf_ = (OutputMatricesHDF == "yes");
   freeze_parameters_      = (FreezeParameters == "yes");
+  matrix_free_            = (MatrixFree == "yes");
+
+  if (matrix_free_ && do_output_matrices_csv_)
+    throw UniformCommunicateError("The option 'matrix_free' cannot be used with 'output_matrices_csv'.");
 
   // Use freeze_parameters with output_matrices to generate multiple lines in the output with
   // the same parameters so statistics can be computed in post-processing.
@@ -677,6 +688,9 @@ bool QMCFixedSampleLinearOptimizeBatched::processOptXML(xmlNodePtr opt_xml,
   }
 #endif
 
+  if (matrix_free_ && options_LMY_.current_optimizer_type != OptimizerType::ONESHIFTONLY)
+    throw UniformCommunicateError("The option 'matrix_free' requires MinMethod = \"OneShiftOnly\".");
+
   // check parameter change sanity
   if (options_LMY_.max_param_change <= 0.0)
     throw std::runtime_error(
@@ -1571,6 +1585,65 @@ bool QMCFixedSampleLinearOptimizeBatched::adaptive_three_shift_run()
 }
 #endif
 
+QMCFixedSampleLinearOptimizeBatched::RealType QMCFixedSampleLinearOptimizeBatched::solveOneShiftMatrixFree(
+    std::vector<RealType>& parameterDirections)
+{
+  const int N = parameterDirections.size();
+
+  // say what we are doing
+  app_log() << std::endl
+            << "*****************************************************" << std::endl
+            << "Solving the linear method without forming the matrices" << std::endl
+            << "*****************************************************" << std::endl;
+
+  // diagonals of the Hamiltonian and overlap matrices for the preconditioner
+  std::vector<RealType> hamDiag, ovlDiag;
+  optTarget->prepareMatrixFree(hamDiag, ovlDiag);
+
+  // the first column of the overlap matrix is needed to restrict the overlap shift to the parameter block
+  std::vector<RealType> unit(N, 0.0), hamCol, ovlCol;
+  unit[0] = 1.0;
+  optTarget->applyOverlapHamiltonian(unit, hamCol, ovlCol);
+
+  // apply the identity and overlap shifts to the Hamiltonian on the fly
+  for (int i = 1; i < N; i++)
+    hamDiag[i] += bestShift_i + bestShift_s * ovlDiag[i];
+  auto apply = [&](const std::vector<RealType>& x, std::vector<RealType>& hx, std::vector<RealType>& sx) {
+    optTarget->applyOverlapHamiltonian(x, hx, sx);
+    for (int i = 1; i < N; i++)
+      hx[i] += bestShift_i * x[i] + bestShift_s * (sx[i] - ovlCol[i] * x[0]);
+  };
+
+  // compute the lowest eigenvalue and the corresponding eigenvector
+  RealType lowestEV = 0.;
+  {
+    ScopedTimer local(eigenvalue_timer_);
+    lowestEV = getLowestEigenvectorDavidson(apply, hamDiag, ovlDiag, parameterDirections, davidson_max_iterations_,
+                                            davidson_tolerance_);
+  }
+
+  // compute the scaling constant to apply to the update
+  auto apply_overlap = [&](const std::vector<RealType>& x, std::vector<RealType>& sx) {
+    std::vector<RealType> hx;
+    optTarget->applyOverlapHamiltonian(x, hx, sx);
+  };
+  objFuncWrapper_.Lambda = getNonLinearRescale(parameterDirections, apply_overlap, *optTarget);
+
+  if (do_output_matrices_hdf_)
+  {
+    hdf_archive hout;
+    std::string newh5 = get_root_name() + ".linear_matrices.h5";
+    hout.create(newh5, H5F_ACC_TRUNC);
+    hout.write(bestShift_i, "bestShift_i");
+    hout.write(bestShift_s, "bestShift_s");
+    hout.write(lowestEV, "lowest_eigenvalue");
+    hout.write(parameterDirections, "scaled_eigenvector");
+    hout.write(objFuncWrapper_.Lambda, "non_linear_rescale");
+    hout.close();
+  }
+  return lowestEV;
+}
+
 bool QMCFixedSampleLinearOptimizeBatched::one_shift_run()
 {
   // ensure the cost function is set to compute derivative vectors
@@ -1599,86 +1672,91 @@ bool QMCFixedSampleLinearOptimizeBatched::one_shift_run()
   // compute the initial cost
   const RealType initCost = optTarget->computedCost();
 
-  // say what we are doing
-  app_log() << std::endl
-            << "*****************************************" << std::endl
-            << "Building overlap and Hamiltonian matrices" << std::endl
-            << "*****************************************" << std::endl;
-
-  // allocate the matrices we will need
-  Matrix<RealType> ovlMat(N, N);
-  ovlMat = 0.0;
-  Matrix<RealType> hamMat(N, N);
-  hamMat = 0.0;
-  Matrix<RealType> invMat(N, N);
-  invMat = 0.0;
-  Matrix<RealType> prdMat(N, N);
-  prdMat = 0.0;
-
-  // build the overlap and hamiltonian matrices
-  optTarget->fillOverlapHamiltonianMatrices(hamMat, ovlMat);
-  invMat.copy(ovlMat);
-
-  if (do_output_matrices_csv_)
+  if (matrix_free_)
+    solveOneShiftMatrixFree(parameterDirections);
+  else
   {
-    output_overlap_.output(ovlMat);
-    output_hamiltonian_.output(hamMat);
-  }
+    // say what we are doing
+    app_log() << std::endl
+              << "*****************************************" << std::endl
+              << "Building overlap and Hamiltonian matrices" << std::endl
+              << "*****************************************" << std::endl;
+
+    // allocate the matrices we will need
+    Matrix<RealType> ovlMat(N, N);
+    ovlMat = 0.0;
+    Matrix<RealType> hamMat(N, N);
+    hamMat = 0.0;
+    Matrix<RealType> invMat(N, N);
+    invMat = 0.0;
+    Matrix<RealType> prdMat(N, N);
+    prdMat = 0.0;
+
+    // build the overlap and hamiltonian matrices
+    optTarget->fillOverlapHamiltonianMatrices(hamMat, ovlMat);
+    invMat.copy(ovlMat);
+
+    if (do_output_matrices_csv_)
+    {
+      output_overlap_.output(ovlMat);
+      output_hamiltonian_.output(hamMat);
+    }
 
-  hdf_archive hout;
-  if (do_output_matrices_hdf_)
-  {
-    std::string newh5 = get_root_name() + ".linear_matrices.h5";
-    hout.create(newh5, H5F_ACC_TRUNC);
-    hout.write(ovlMat, "overlap");
-    hout.write(hamMat, "Hamiltonian");
-    hout.write(bestShift_i, "bestShift_i");
-    hout.write(bestShift_s, "bestShift_s");
-  }
+    hdf_archive hout;
+    if (do_output_matrices_hdf_)
+    {
+      std::string newh5 = get_root_name() + ".linear_matrices.h5";
+      hout.create(newh5, H5F_ACC_TRUNC);
+      hout.write(ovlMat, "overlap");
+      hout.write(hamMat, "Hamiltonian");
+      hout.write(bestShift_i, "bestShift_i");
+      hout.write(bestShift_s, "bestShift_s");
+    }
 
-  // apply the identity shift
-  for (int i = 1; i < N; i++)
-  {
-    hamMat(i, i) += bestShift_i;
-    if (invMat(i, i) == 0)
-      invMat(i, i) = bestShift_i * bestShift_s;
-  }
+    // apply the identity shift
+    for (int i = 1; i < N; i++)
+    {
+      hamMat(i, i) += bestShift_i;
+      if (invMat(i, i) == 0)
+        invMat(i, i) = bestShift_i * bestShift_s;
+    }
 
-  // compute the inverse of the overlap matrix
-  {
-    ScopedTimer local(involvmat_timer_);
-    invert_matrix(invMat, false);
-  }
+    // compute the inverse of the overlap matrix
+    {
+      ScopedTimer local(involvmat_timer_);
+      invert_matrix(invMat, false);
+    }
 
-  // apply the overlap shift
-  for (int i = 1; i < N; i++)
-    for (int j = 1; j < N; j++)
-      hamMat(i, j) += bestShift_s * ovlMat(i, j);
+    // apply the overlap shift
+    for (int i = 1; i < N; i++)
+      for (int j = 1; j < N; j++)
+        hamMat(i, j) += bestShift_s * ovlMat(i, j);
 
-  // multiply the shifted hamiltonian matrix by the inverse of the overlap matrix
-  qmcplusplus::MatrixOperators::product(invMat, hamMat, prdMat);
+    // multiply the shifted hamiltonian matrix by the inverse of the overlap matrix
+    qmcplusplus::MatrixOperators::product(invMat, hamMat, prdMat);
 
-  // transpose the result (why?)
-  for (int i = 0; i < N; i++)
-    for (int j = i + 1; j < N; j++)
-      std::swap(prdMat(i, j), prdMat(j, i));
+    // transpose the result (why?)
+    for (int i = 0; i < N; i++)
+      for (int j = i + 1; j < N; j++)
+        std::swap(prdMat(i, j), prdMat(j, i));
 
-  // compute the lowest eigenvalue of the product matrix and the corresponding eigenvector
-  RealType lowestEV = 0.;
-  {
-    ScopedTimer local(eigenvalue_timer_);
-    lowestEV = getLowestEigenvector(prdMat, parameterDirections);
-  }
+    // compute the lowest eigenvalue of the product matrix and the corresponding eigenvector
+    RealType lowestEV = 0.;
+    {
+      ScopedTimer local(eigenvalue_timer_);
+      lowestEV = getLowestEigenvector(prdMat, parameterDirections);
+    }
 
-  // compute the scaling constant to apply to the update
-  objFuncWrapper_.Lambda = getNonLinearRescale(parameterDirections, ovlMat, *optTarget);
+    // compute the scaling constant to apply to the update
+    objFuncWrapper_.Lambda = getNonLinearRescale(parameterDirections, ovlMat, *optTarget);
 
-  if (do_output_matrices_hdf_)
-  {
-    hout.write(lowestEV, "lowest_eigenvalue");
-    hout.write(parameterDirections, "scaled_eigenvector");
-    hout.write(objFuncWrapper_.Lambda, "non_linear_rescale");
-    hout.close();
+    if (do_output_matrices_hdf_)
+    {
+      hout.write(lowestEV, "lowest_eigenvalue");
+      hout.write(parameterDirections, "scaled_eigenvector");
+      hout.write(objFuncWrapper_.Lambda, "non_linear_rescale");
+      hout.close();
+    }
   }
 
   // scale the update by the scaling constant
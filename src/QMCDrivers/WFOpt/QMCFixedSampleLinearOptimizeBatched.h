@@ -119,6 +119,9 @@ private:
   // perform the single-shift update, no sample regeneration
   bool one_shift_run();
 
+  // solve the single-shift update with products of the matrices, returns the lowest eigenvalue
+  RealType solveOneShiftMatrixFree(std::vector<RealType>& parameterDirections);
+
   // perform optimization using a gradient descent algorithm
   bool descent_run();
 
@@ -274,6 +277,13 @@ private:
   // Freeze variational parameters.  Do not update them during each step.
   bool freeze_parameters_;
 
+  // Solve the one shift update with the Davidson method without forming the matrices
+  bool matrix_free_;
+  // maximal number of Davidson iterations of the matrix-free solver
+  int davidson_max_iterations_;
+  // residual norm threshold of the matrix-free solver
+  RealType davidson_tolerance_;
+
   NewTimer& generate_samples_timer_;
   NewTimer& initialize_timer_;
   NewTimer& eigenvalue_timer_;
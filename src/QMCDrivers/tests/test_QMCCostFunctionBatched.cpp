@@ -11,10 +11,12 @@
 
 #include "catch.hpp"
 #include "QMCDrivers/WFOpt/QMCCostFunctionBatched.h"
+#include "QMCDrivers/WFOpt/LinearMethod.h"
 #include "FillData.h"
 // Input data and gold data for fillFromText test
 #include "diamond_fill_data.h"
 #include "Utilities/RuntimeOptions.h"
+#include <algorithm>
 
 
 namespace qmcplusplus
@@ -66,6 +68,14 @@ public:
   Matrix<QMCCostFunctionBase::Return_rt>& getDerivRecords() { return costFn.DerivRecords_; }
   Matrix<QMCCostFunctionBase::Return_rt>& getHDerivRecords() { return costFn.HDerivRecords_; }
 
+  void setGEV(const std::string& gev_type, QMCCostFunctionBase::Return_rt beta)
+  {
+    costFn.GEVType = gev_type;
+    costFn.w_beta  = beta;
+  }
+  void setFillTileElements(int elements) { costFn.fill_tile_elements_ = elements; }
+  void setRecordsScratch(const std::string& dir) { costFn.records_scratch_dir_ = dir; }
+
   void set_samples_and_param(int nsamples, int nparam)
   {
     numSamples = nsamples;
@@ -82,8 +92,7 @@ public:
     costFn.NumOptimizables = numParam;
 
     getRecordsOnNode().resize(numSamples, QMCCostFunctionBase::SUM_INDEX_SIZE);
-    getDerivRecords().resize(numSamples, numParam);
-    getHDerivRecords().resize(numSamples, numParam);
+    costFn.resizeDerivRecords(numSamples);
   }
 };
 
@@ -206,5 +215,294 @@ TEST_CASE("fillfromText", "[drivers]")
   }
 }
 
+// Compare the tiled construction against the per-sample rank-1 updates for all the generalized eigenvalue types
+TEST_CASE("fillOverlapHamiltonianMatrices tiles", "[drivers]")
+{
+  using Return_rt = qmcplusplus::QMCTraits::RealType;
+
+  std::vector<int> walkers_per_crowd{1};
+  testing::LinearMethodTestSupport lin(walkers_per_crowd, OHMMS::Controller);
+
+  const int numSamples = 7;
+  const int numParam   = 3;
+  lin.set_samples_and_param(numSamples, numParam);
+
+  auto& RecordsOnNode = lin.getRecordsOnNode();
+  auto& derivRecords  = lin.getDerivRecords();
+  auto& HDerivRecords = lin.getHDerivRecords();
+  Return_rt sum_wgt = 0, sum_e_wgt = 0, sum_esq_wgt = 0;
+  for (int iw = 0; iw < numSamples; iw++)
+  {
+    const Return_rt weight = 0.8 + 0.05 * iw;
+    const Return_rt eloc   = -1.5 + 0.1 * iw * (iw % 3);
+    RecordsOnNode(iw, QMCCostFunctionBase::REWEIGHT)   = weight;
+    RecordsOnNode(iw, QMCCostFunctionBase::ENERGY_NEW) = eloc;
+    sum_wgt += weight;
+    sum_e_wgt += weight * eloc;
+    sum_esq_wgt += weight * eloc * eloc;
+    for (int pm = 0; pm < numParam; pm++)
+    {
+      derivRecords(iw, pm)  = 0.3 * pm - 0.2 * iw + 0.01 * iw * iw;
+      HDerivRecords(iw, pm) = -0.4 + 0.15 * pm * iw - 0.03 * pm * pm;
+    }
+  }
+  std::vector<Return_rt>& SumValue           = lin.getSumValue();
+  SumValue[QMCCostFunctionBase::SUM_WGT]     = sum_wgt;
+  SumValue[QMCCostFunctionBase::SUM_E_WGT]   = sum_e_wgt;
+  SumValue[QMCCostFunctionBase::SUM_ESQ_WGT] = sum_esq_wgt;
+
+  for (const std::string gev_type : {"mixed", "H2"})
+  {
+    const Return_rt beta = 0.3;
+    lin.setGEV(gev_type, beta);
+    const Return_rt b1 = gev_type == "H2" ? beta : 0;
+    const Return_rt b2 = gev_type == "H2" ? 0 : beta;
+
+    // reference from the per-sample updates
+    const Return_rt curAvg_w  = sum_e_wgt / sum_wgt;
+    const Return_rt curAvg2_w = sum_esq_wgt / sum_wgt;
+    const Return_rt H2_avg    = 1.0 / (curAvg_w * curAvg_w);
+    const Return_rt V_avg     = curAvg2_w - curAvg_w * curAvg_w;
+    std::vector<Return_rt> D_avg(numParam, 0.0);
+    for (int iw = 0; iw < numSamples; iw++)
+      for (int pm = 0; pm < numParam; pm++)
+        D_avg[pm] += derivRecords(iw, pm) * RecordsOnNode(iw, QMCCostFunctionBase::REWEIGHT) / sum_wgt;
+
+    const int N = numParam + 1;
+    Matrix<Return_rt> ham_ref(N, N), ovlp_ref(N, N);
+    ham_ref  = 0.0;
+    ovlp_ref = 0.0;
+    for (int iw = 0; iw < numSamples; iw++)
+    {
+      const Return_rt weight   = RecordsOnNode(iw, QMCCostFunctionBase::REWEIGHT) / sum_wgt;
+      const Return_rt eloc_new = RecordsOnNode(iw, QMCCostFunctionBase::ENERGY_NEW);
+      for (int pm = 0; pm < numParam; pm++)
+      {
+        const Return_rt d     = derivRecords(iw, pm) - D_avg[pm];
+        const Return_rt hd    = HDerivRecords(iw, pm);
+        const Return_rt vterm = hd * (eloc_new - curAvg_w) + d * eloc_new * (eloc_new - 2.0 * curAvg_w);
+        ovlp_ref(0, pm + 1) += b1 * H2_avg * vterm * weight;
+        ovlp_ref(pm + 1, 0) += b1 * H2_avg * vterm * weight;
+        ham_ref(0, pm + 1) += b2 * vterm * weight + (1 - b2) * (hd + d * eloc_new) * weight;
+        ham_ref(pm + 1, 0) += b2 * vterm * weight + (1 - b2) * d * weight * eloc_new;
+        for (int pm2 = 0; pm2 < numParam; pm2++)
+        {
+          const Return_rt d2    = derivRecords(iw, pm2) - D_avg[pm2];
+          const Return_rt hd2   = HDerivRecords(iw, pm2);
+          const Return_rt ovlij = weight * d * d2;
+          const Return_rt varij = weight * (hd - 2.0 * d * eloc_new) * (hd2 - 2.0 * d2 * eloc_new);
+          ham_ref(pm + 1, pm2 + 1) += (1 - b2) * weight * d * (hd2 + d2 * eloc_new) + b2 * (varij + V_avg * ovlij);
+          ovlp_ref(pm + 1, pm2 + 1) += ovlij + b1 * H2_avg * varij;
+        }
+      }
+    }
+
+    // a single tile and tiles of two samples with a partial last tile
+    for (const int tile_elements : {1 << 20, 2 * numParam})
+    {
+      lin.setFillTileElements(tile_elements);
+      Matrix<Return_rt> ham(N, N);
+      Matrix<Return_rt> ovlp(N, N);
+      lin.costFn.fillOverlapHamiltonianMatrices(ham, ovlp);
+      for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+        {
+          if (i == 0 && j == 0)
+            continue;
+          CHECK(ham(i, j) == Approx(ham_ref(i, j)));
+          CHECK(ovlp(i, j) == Approx(ovlp_ref(i, j)));
+        }
+    }
+  }
+}
+// Matrix-free products and the Davidson solver against the dense matrices of the diamond gold data
+TEST_CASE("fillOverlapHamiltonianMatrices matrix free", "[drivers]")
+{
+  using Return_rt = qmcplusplus::QMCTraits::RealType;
+
+  FillData fd;
+  get_diamond_fill_data(fd);
+
+  std::vector<int> walkers_per_crowd{1};
+  testing::LinearMethodTestSupport lin(walkers_per_crowd, OHMMS::Controller);
+  lin.set_samples_and_param(fd.numSamples, fd.numParam);
+
+  std::vector<Return_rt>& SumValue           = lin.getSumValue();
+  SumValue[QMCCostFunctionBase::SUM_WGT]     = fd.sum_wgt;
+  SumValue[QMCCostFunctionBase::SUM_E_WGT]   = fd.sum_e_wgt;
+  SumValue[QMCCostFunctionBase::SUM_ESQ_WGT] = fd.sum_esq_wgt;
+  auto& RecordsOnNode                        = lin.getRecordsOnNode();
+  for (int iw = 0; iw < fd.numSamples; iw++)
+  {
+    RecordsOnNode(iw, QMCCostFunctionBase::REWEIGHT)   = fd.reweight[iw];
+    RecordsOnNode(iw, QMCCostFunctionBase::ENERGY_NEW) = fd.energy_new[iw];
+  }
+  lin.getDerivRecords()  = fd.derivRecords;
+  lin.getHDerivRecords() = fd.HDerivRecords;
+  // several tiles
+  lin.setFillTileElements(3 * fd.numParam);
+
+  const int N = fd.numParam + 1;
+  Matrix<Return_rt> ham(N, N);
+  Matrix<Return_rt> ovlp(N, N);
+  lin.costFn.fillOverlapHamiltonianMatrices(ham, ovlp);
+
+  std::vector<Return_rt> ham_diag, ovlp_diag;
+  lin.costFn.prepareMatrixFree(ham_diag, ovlp_diag);
+  REQUIRE(ham_diag.size() == N);
+  REQUIRE(ovlp_diag.size() == N);
+  for (int i = 0; i < N; i++)
+  {
+    CHECK(ham_diag[i] == Approx(ham(i, i)));
+    CHECK(ovlp_diag[i] == Approx(ovlp(i, i)));
+  }
+
+  std::vector<Return_rt> x(N), ham_x, ovlp_x;
+  for (int i = 0; i < N; i++)
+    x[i] = 1.0 - 0.1 * i;
+  lin.costFn.applyOverlapHamiltonian(x, ham_x, ovlp_x);
+  for (int i = 0; i < N; i++)
+  {
+    Return_rt ham_ref(0), ovlp_ref(0);
+    for (int j = 0; j < N; j++)
+    {
+      ham_ref += ham(i, j) * x[j];
+      ovlp_ref += ovlp(i, j) * x[j];
+    }
+    CHECK(ham_x[i] == Approx(ham_ref));
+    CHECK(ovlp_x[i] == Approx(ovlp_ref));
+  }
+
+  // shifted generalized eigenvalue problem of the one shift update
+  const Return_rt shift_i = 0.01;
+  for (int i = 1; i < N; i++)
+    ham(i, i) += shift_i;
+  LinearMethod::MatrixFreeOperator apply = [&](const std::vector<Return_rt>& v, std::vector<Return_rt>& hv,
+                                               std::vector<Return_rt>& sv) {
+    lin.costFn.applyOverlapHamiltonian(v, hv, sv);
+    for (int i = 1; i < N; i++)
+      hv[i] += shift_i * v[i];
+  };
+  for (int i = 1; i < N; i++)
+    ham_diag[i] += shift_i;
+
+  LinearMethod linear_method;
+  std::vector<Return_rt> ev_davidson(N);
+  const Return_rt lowest_davidson =
+      linear_method.getLowestEigenvectorDavidson(apply, ham_diag, ovlp_diag, ev_davidson, N, 1e-10);
+
+  // the dense solver overwrites the matrices, LAPACK sees the transposes of row-major matrices
+  Matrix<Return_rt> ham_t(N, N), ovlp_t(N, N);
+  for (int i = 0; i < N; i++)
+    for (int j = 0; j < N; j++)
+    {
+      ham_t(j, i)  = ham(i, j);
+      ovlp_t(j, i) = ovlp(i, j);
+    }
+  std::vector<Return_rt> ev_dense(N);
+  const Return_rt lowest_dense = linear_method.getLowestEigenvector(ham_t, ovlp_t, ev_dense);
+
+  CHECK(lowest_davidson == Approx(lowest_dense));
+  for (int i = 0; i < N; i++)
+    CHECK(ev_davidson[i] == Approx(ev_dense[i]).epsilon(1e-4));
+}
+// The selected eigenvector (0, 2, -1), eigenvalue -10 = A(0,0) - 2, has no component along the current
+// wavefunction and cannot be normalized
+TEST_CASE("getLowestEigenvectorDavidson zero overlap", "[drivers]")
+{
+  using Return_rt = qmcplusplus::QMCTraits::RealType;
+  const int N = 3;
+  const Return_rt ham[N][N]{{-8, 1, 2}, {1, -9, 2}, {2, 2, -6}};
+  LinearMethod::MatrixFreeOperator apply = [&](const std::vector<Return_rt>& v, std::vector<Return_rt>& hv,
+                                               std::vector<Return_rt>& sv) {
+    hv.assign(N, 0);
+    sv = v;
+    for (int i = 0; i < N; i++)
+      for (int j = 0; j < N; j++)
+        hv[i] += ham[i][j] * v[j];
+  };
+  std::vector<Return_rt> ham_diag{-8, -9, -6}, ovlp_diag(N, 1), ev(N);
+  LinearMethod linear_method;
+  CHECK_THROWS_AS(linear_method.getLowestEigenvectorDavidson(apply, ham_diag, ovlp_diag, ev, N, 1e-10),
+                  std::runtime_error);
+}
+
+// The root near -500 lies below the A(0,0) - 100 window, both solvers take the one closest to A(0,0) - 2
+TEST_CASE("getLowestEigenvectorDavidson spurious low root", "[drivers]")
+{
+  using Return_rt = qmcplusplus::QMCTraits::RealType;
+  const int N = 4;
+  const Return_rt ham[N][N]{{0, 0.5, 0.5, 0.1}, {0.5, 1, 0.2, 0}, {0.5, 0.2, 2, 0}, {0.1, 0, 0, -500}};
+  LinearMethod::MatrixFreeOperator apply = [&](const std::vector<Return_rt>& v, std::vector<Return_rt>& hv,
+                                               std::vector<Return_rt>& sv) {
+    hv.assign(N, 0);
+    sv = v;
+    for (int i = 0; i < N; i++)
+      for (int j = 0; j < N; j++)
+        hv[i] += ham[i][j] * v[j];
+  };
+  std::vector<Return_rt> ham_diag{0, 1, 2, -500}, ovlp_diag(N, 1), ev_davidson(N);
+  LinearMethod linear_method;
+  const Return_rt selected_davidson =
+      linear_method.getLowestEigenvectorDavidson(apply, ham_diag, ovlp_diag, ev_davidson, N, 1e-10);
+  CHECK(selected_davidson > -100);
+
+  // the overlap is the identity, ham is symmetric
+  Matrix<Return_rt> ham_dense(N, N);
+  for (int i = 0; i < N; i++)
+    for (int j = 0; j < N; j++)
+      ham_dense(i, j) = ham[i][j];
+  std::vector<Return_rt> ev_dense(N);
+  const Return_rt selected_dense = linear_method.getLowestEigenvector(ham_dense, ev_dense);
+
+  CHECK(selected_davidson == Approx(selected_dense));
+  for (int i = 0; i < N; i++)
+    CHECK(ev_davidson[i] == Approx(ev_dense[i]).epsilon(1e-6));
+}
+
+// Derivative records in memory-mapped scratch files give the same matrices
+TEST_CASE("fillOverlapHamiltonianMatrices records scratch", "[drivers]")
+{
+  using Return_rt = qmcplusplus::QMCTraits::RealType;
+
+  FillData fd;
+  get_diamond_fill_data(fd);
+  const int N = fd.numParam + 1;
+
+  std::vector<Matrix<Return_rt>> hams, ovlps;
+  for (const std::string scratch : {"", "."})
+  {
+    std::vector<int> walkers_per_crowd{1};
+    testing::LinearMethodTestSupport lin(walkers_per_crowd, OHMMS::Controller);
+    lin.setRecordsScratch(scratch);
+    lin.set_samples_and_param(fd.numSamples, fd.numParam);
+
+    std::vector<Return_rt>& SumValue           = lin.getSumValue();
+    SumValue[QMCCostFunctionBase::SUM_WGT]     = fd.sum_wgt;
+    SumValue[QMCCostFunctionBase::SUM_E_WGT]   = fd.sum_e_wgt;
+    SumValue[QMCCostFunctionBase::SUM_ESQ_WGT] = fd.sum_esq_wgt;
+    auto& RecordsOnNode                        = lin.getRecordsOnNode();
+    for (int iw = 0; iw < fd.numSamples; iw++)
+    {
+      RecordsOnNode(iw, QMCCostFunctionBase::REWEIGHT)   = fd.reweight[iw];
+      RecordsOnNode(iw, QMCCostFunctionBase::ENERGY_NEW) = fd.energy_new[iw];
+    }
+    // copy into the existing storage to keep the mapping
+    std::copy_n(fd.derivRecords.data(), fd.derivRecords.size(), lin.getDerivRecords().data());
+    std::copy_n(fd.HDerivRecords.data(), fd.HDerivRecords.size(), lin.getHDerivRecords().data());
+    lin.setFillTileElements(2 * fd.numParam);
+
+    hams.emplace_back(N, N);
+    ovlps.emplace_back(N, N);
+    lin.costFn.fillOverlapHamiltonianMatrices(hams.back(), ovlps.back());
+  }
+
+  for (int i = 0; i < N; i++)
+    for (int j = 0; j < N; j++)
+    {
+      CHECK(hams[1](i, j) == hams[0](i, j));
+      CHECK(ovlps[1](i, j) == ovlps[0](i, j));
+    }
+}
 
 } // namespace qmcplusplus
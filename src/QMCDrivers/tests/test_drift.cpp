@@ -169,4 +169,91 @@ TEST_CASE("get scaled drift complex", "[drivers][drift]")
 }
 #endif
 
+template<CoordsType CT>
+void testFusedDriftDiffusion()
+{
+  using RealType       = QMCTraits::RealType;
+  const int nw         = 5;
+  const RealType unr_a = 0.8;
+  TauParams<RealType, CT> taus(0.3, 1.0 / 0.85, 2.0);
+  DriftModifierUNR DM(unr_a);
+
+  TWFGrads<CT> grads_now(nw), grads_new(nw);
+  MCCoords<CT> gauss(nw);
+  for (int iw = 0; iw < nw; iw++)
+  {
+    // includes a vanishing gradient taking the unscaled branch
+    grads_now.grads_positions[iw] = QMCTraits::GradType(0.7 * (iw - 2), 0.3 * (iw - 2), -0.2 * (iw - 2));
+    grads_new.grads_positions[iw] = QMCTraits::GradType(0.1 * iw, -0.5, 0.4 - 0.3 * iw);
+    gauss.positions[iw]           = QMCTraits::PosType(0.2 - 0.1 * iw, 0.5 * iw, -0.8);
+    if constexpr (CT == CoordsType::POS_SPIN)
+    {
+      grads_now.grads_spins[iw] = 0.6 * iw - 1.2;
+      grads_new.grads_spins[iw] = 0.25 * iw;
+      gauss.spins[iw]           = 0.9 - 0.3 * iw;
+    }
+  }
+
+  // reference by the separate passes of the batched drivers
+  const DriftModifierBase& drift_modifier = DM;
+  MCCoords<CT> drifts(nw), drifts_reverse(nw), deltas(gauss);
+  std::vector<RealType> log_gf_ref(nw), log_gb_ref(nw);
+  drift_modifier.getDrifts(taus, grads_now, drifts);
+  for (auto& delta : deltas.positions)
+    delta *= taus.sqrttau;
+  if constexpr (CT == CoordsType::POS_SPIN)
+    for (auto& delta : deltas.spins)
+      delta *= taus.spin_sqrttau;
+  drifts += deltas;
+  drift_modifier.getDrifts(taus, grads_new, drifts_reverse);
+  drifts_reverse += drifts;
+  for (int iw = 0; iw < nw; iw++)
+  {
+    log_gf_ref[iw] = -taus.oneover2tau * dot(deltas.positions[iw], deltas.positions[iw]);
+    log_gb_ref[iw] = -taus.oneover2tau * dot(drifts_reverse.positions[iw], drifts_reverse.positions[iw]);
+    if constexpr (CT == CoordsType::POS_SPIN)
+    {
+      log_gf_ref[iw] -= taus.spin_oneover2tau * deltas.spins[iw] * deltas.spins[iw];
+      log_gb_ref[iw] -= taus.spin_oneover2tau * drifts_reverse.spins[iw] * drifts_reverse.spins[iw];
+    }
+  }
+
+  MCCoords<CT> moves(nw);
+  std::vector<RealType> log_gf(nw), log_gb(nw), r2(nw);
+  DM.getMoves(taus, grads_now, gauss, moves, log_gf, r2);
+  DM.getReverseLogGF(taus, grads_new, moves, log_gb);
+
+  for (int iw = 0; iw < nw; iw++)
+  {
+    for (int idim = 0; idim < OHMMS_DIM; idim++)
+      CHECK(moves.positions[iw][idim] == Approx(drifts.positions[iw][idim]));
+    if constexpr (CT == CoordsType::POS_SPIN)
+      CHECK(moves.spins[iw] == Approx(drifts.spins[iw]));
+    CHECK(log_gf[iw] == Approx(log_gf_ref[iw]));
+    CHECK(log_gb[iw] == Approx(log_gb_ref[iw]));
+    CHECK(r2[iw] == Approx(taus.tauovermass * dot(gauss.positions[iw], gauss.positions[iw])));
+  }
+}
+
+TEST_CASE("fused drift diffusion moves", "[drivers][drift]")
+{
+  testFusedDriftDiffusion<CoordsType::POS>();
+  testFusedDriftDiffusion<CoordsType::POS_SPIN>();
+}
+
+TEST_CASE("check drift diffusion moves", "[drivers][drift]")
+{
+  MCCoords<CoordsType::POS_SPIN> moves(2);
+  moves.positions[0] = {0.1, 0.2, 0.3};
+  moves.positions[1] = {0.1, 0.2, 0.3};
+  moves.spins[0]     = 0.1;
+  moves.spins[1]     = 0.2;
+  CHECK_NOTHROW(checkDriftDiffusionMoves(moves, 0));
+  moves.spins[1] = std::numeric_limits<QMCTraits::FullPrecRealType>::quiet_NaN();
+  CHECK_THROWS_AS(checkDriftDiffusionMoves(moves, 0), std::runtime_error);
+  moves.spins[1]        = 0.2;
+  moves.positions[0][1] = std::numeric_limits<QMCTraits::RealType>::quiet_NaN();
+  CHECK_THROWS_AS(checkDriftDiffusionMoves(moves, 0), std::runtime_error);
+}
+
 } // namespace qmcplusplus
@@ -121,6 +121,10 @@ private:
    */
   RealType calculateProjector(RealType r, const PosType& dr);
 
+  /** finalize the calculation of $\frac{V\Psi_T}{\Psi_T}$ and add its parameter derivatives to dhpsioverpsi
+   */
+  RealType calculateProjectorDerivatives(RealType r, const PosType& dr, Vector<ValueType>& dhpsioverpsi);
+
   /// Can disable grid randomization for testing
   bool do_randomize_grid_;
 
@@ -255,6 +259,26 @@ public:
                                        const Vector<ValueType>& dlogpsi,
                                        Vector<ValueType>& dhpsioverpsi);
 
+  /** @brief Evaluate the nonlocal pp contribution and its parameter derivatives via randomized quadrature grid
+   * from ion "iat" and electron "iel" for a batch of walkers. Requires the virtual particle set.
+   *
+   * @param ecp_component_list a list of ECP components
+   * @param p_list a list of electron particle set.
+   * @param psi_list a list of trial wave function object
+   * @param joblist a list of ion-electron pairs
+   * @param optvars optimizables
+   * @param dhpsioverpsi_list a list of derivatives of Vpp, the contribution of each pair is added
+   * @param pairpots a list of contribution to $\frac{V\Psi_T}{\Psi_T}$ from ion iat and electron iel.
+   */
+  static void mw_evaluateOneWithParameterDerivatives(const RefVectorWithLeader<NonLocalECPComponent>& ecp_component_list,
+                                                     const RefVectorWithLeader<ParticleSet>& p_list,
+                                                     const RefVectorWithLeader<TrialWaveFunction>& psi_list,
+                                                     const RefVector<const NLPPJob<RealType>>& joblist,
+                                                     const opt_variables_type& optvars,
+                                                     const RefVector<Vector<ValueType>>& dhpsioverpsi_list,
+                                                     std::vector<RealType>& pairpots,
+                                                     ResourceCollection& collection);
+
   /** 
    * @brief Evaluate contribution to B of election iel and ion iat.  Filippi scheme for computing fast derivatives.
    *        Sum over ions and electrons occurs at the NonLocalECPotential level.  
@@ -456,6 +456,119 @@ void NonLocalECPotential::mw_evaluateImpl(const RefVectorWithLeader<OperatorBase
   }
 }
 
+void NonLocalECPotential::mw_evaluateWithParameterDerivatives(const RefVectorWithLeader<OperatorBase>& o_list,
+                                                              const RefVectorWithLeader<ParticleSet>& p_list,
+                                                              const opt_variables_type& optvars,
+                                                              const RecordArray<ValueType>& dlogpsi,
+                                                              RecordArray<ValueType>& dhpsioverpsi) const
+{
+  auto& O_leader           = o_list.getCastedLeader<NonLocalECPotential>();
+  ParticleSet& pset_leader = p_list.getLeader();
+  const size_t nw          = o_list.size();
+
+  auto pp_component = std::find_if(O_leader.PPset.begin(), O_leader.PPset.end(), [](auto& ptr) { return bool(ptr); });
+  assert(pp_component != std::end(O_leader.PPset));
+
+  // without virtual particle sets the ratios need full moves, keep the per walker path
+  if (!(*pp_component)->getVP())
+  {
+    OperatorBase::mw_evaluateWithParameterDerivatives(o_list, p_list, optvars, dlogpsi, dhpsioverpsi);
+    return;
+  }
+
+  const int nparam = dhpsioverpsi.getNumOfParams();
+  std::vector<Vector<ValueType>> dhpsioverpsi_views;
+  dhpsioverpsi_views.reserve(nw);
+  for (size_t iw = 0; iw < nw; iw++)
+  {
+    auto& O = o_list.getCastedElement<NonLocalECPotential>(iw);
+    const ParticleSet& P(p_list[iw]);
+    dhpsioverpsi_views.emplace_back(dhpsioverpsi[iw], nparam);
+
+    for (int ipp = 0; ipp < O.PPset.size(); ipp++)
+      if (O.PPset[ipp])
+        O.PPset[ipp]->rotateQuadratureGrid(generateRandomRotationMatrix(*O.myRNG));
+
+    const auto& myTable = P.getDistTableAB(O.myTableIndex);
+    for (int ig = 0; ig < P.groups(); ++ig) //loop over species
+    {
+      auto& joblist = O.nlpp_jobs[ig];
+      joblist.clear();
+
+      for (int jel = P.first(ig); jel < P.last(ig); ++jel)
+      {
+        const auto& dist  = myTable.getDistRow(jel);
+        const auto& displ = myTable.getDisplRow(jel);
+        for (int iat = 0; iat < O.NumIons; iat++)
+          if (O.PP[iat] != nullptr && dist[iat] < O.PP[iat]->getRmax())
+            joblist.emplace_back(iat, jel, dist[iat], -displ[iat]);
+      }
+    }
+
+    O.value_ = 0.0;
+  }
+
+  RefVector<NonLocalECPotential> ecp_potential_list;
+  RefVectorWithLeader<NonLocalECPComponent> ecp_component_list(**pp_component);
+  RefVectorWithLeader<ParticleSet> pset_list(pset_leader);
+  RefVectorWithLeader<TrialWaveFunction> psi_list(O_leader.Psi);
+  RefVector<const NLPPJob<Real>> batch_list;
+  RefVector<Vector<ValueType>> dhpsioverpsi_list;
+  std::vector<Real> pairpots(nw);
+
+  ecp_potential_list.reserve(nw);
+  ecp_component_list.reserve(nw);
+  pset_list.reserve(nw);
+  psi_list.reserve(nw);
+  batch_list.reserve(nw);
+  dhpsioverpsi_list.reserve(nw);
+
+  /* as in evaluateValueAndDerivatives, prepareGroup is not needed
+   * because TWF::evaluateLog has been called and precomputed data is up-to-date
+   */
+  for (int ig = 0; ig < pset_leader.groups(); ++ig) //loop over species
+  {
+    // find the max number of jobs of all the walkers
+    size_t max_num_jobs = 0;
+    for (size_t iw = 0; iw < nw; iw++)
+    {
+      const auto& O = o_list.getCastedElement<NonLocalECPotential>(iw);
+      max_num_jobs  = std::max(max_num_jobs, O.nlpp_jobs[ig].size());
+    }
+
+    for (size_t jobid = 0; jobid < max_num_jobs; jobid++)
+    {
+      ecp_potential_list.clear();
+      ecp_component_list.clear();
+      pset_list.clear();
+      psi_list.clear();
+      batch_list.clear();
+      dhpsioverpsi_list.clear();
+      for (size_t iw = 0; iw < nw; iw++)
+      {
+        auto& O = o_list.getCastedElement<NonLocalECPotential>(iw);
+        if (jobid < O.nlpp_jobs[ig].size())
+        {
+          const auto& job = O.nlpp_jobs[ig][jobid];
+          ecp_potential_list.push_back(O);
+          ecp_component_list.push_back(*O.PP[job.ion_id]);
+          pset_list.push_back(p_list[iw]);
+          psi_list.push_back(O.Psi);
+          batch_list.push_back(job);
+          dhpsioverpsi_list.push_back(dhpsioverpsi_views[iw]);
+        }
+      }
+
+      NonLocalECPComponent::mw_evaluateOneWithParameterDerivatives(ecp_component_list, pset_list, psi_list, batch_list,
+                                                                   optvars, dhpsioverpsi_list, pairpots,
+                                                                   O_leader.mw_res_handle_.getResource().collection);
+
+      for (size_t j = 0; j < ecp_potential_list.size(); j++)
+        ecp_potential_list[j].get().value_ += pairpots[j];
+    }
+  }
+}
+
 
 void NonLocalECPotential::evalIonDerivsImpl(ParticleSet& P,
                                             ParticleSet& ions,
@@ -15,6 +15,8 @@
 #include "QMCHamiltonians/NonLocalECPotential.h"
 #include "DistanceTable.h"
 #include "CPU/BLAS.hpp"
+#include "Particle/VirtualParticleSet.h"
+#include "ResourceCollection.h"
 #include "Utilities/Timer.h"
 
 namespace qmcplusplus
@@ -107,6 +109,72 @@ NonLocalECPComponent::RealType NonLocalECPComponent::evaluateValueAndDerivatives
     }
   }
 
+  return calculateProjectorDerivatives(r, dr, dhpsioverpsi);
+}
+
+void NonLocalECPComponent::mw_evaluateOneWithParameterDerivatives(
+    const RefVectorWithLeader<NonLocalECPComponent>& ecp_component_list,
+    const RefVectorWithLeader<ParticleSet>& p_list,
+    const RefVectorWithLeader<TrialWaveFunction>& psi_list,
+    const RefVector<const NLPPJob<RealType>>& joblist,
+    const opt_variables_type& optvars,
+    const RefVector<Vector<ValueType>>& dhpsioverpsi_list,
+    std::vector<RealType>& pairpots,
+    ResourceCollection& collection)
+{
+  auto& ecp_component_leader = ecp_component_list.getLeader();
+  assert(ecp_component_leader.VP);
+  RefVectorWithLeader<VirtualParticleSet> vp_list(*ecp_component_leader.VP);
+  RefVectorWithLeader<const VirtualParticleSet> const_vp_list(*ecp_component_leader.VP);
+  RefVector<const std::vector<PosType>> deltaV_list;
+  RefVector<std::vector<ValueType>> psiratios_list;
+  RefVector<Matrix<ValueType>> dratios_list;
+  vp_list.reserve(ecp_component_list.size());
+  const_vp_list.reserve(ecp_component_list.size());
+  deltaV_list.reserve(ecp_component_list.size());
+  psiratios_list.reserve(ecp_component_list.size());
+  dratios_list.reserve(ecp_component_list.size());
+
+  for (size_t i = 0; i < ecp_component_list.size(); i++)
+  {
+    NonLocalECPComponent& component(ecp_component_list[i]);
+    const NLPPJob<RealType>& job = joblist[i];
+
+    component.buildQuadraturePointDeltaPositions(job.ion_elec_dist, job.ion_elec_displ, component.deltaV);
+    component.dratio.resize(component.nknot, optvars.num_active_vars);
+
+    vp_list.push_back(*component.VP);
+    const_vp_list.push_back(*component.VP);
+    deltaV_list.push_back(component.deltaV);
+    psiratios_list.push_back(component.psiratio);
+    dratios_list.push_back(component.dratio);
+  }
+
+  ResourceCollectionTeamLock<VirtualParticleSet> vp_res_lock(collection, vp_list);
+
+  VirtualParticleSet::mw_makeMoves(vp_list, p_list, deltaV_list, joblist, true);
+
+  TrialWaveFunction::mw_evaluateDerivRatios(psi_list, const_vp_list, optvars, psiratios_list, dratios_list);
+
+  for (size_t i = 0; i < ecp_component_list.size(); i++)
+  {
+    NonLocalECPComponent& component(ecp_component_list[i]);
+    const NLPPJob<RealType>& job = joblist[i];
+    pairpots[i] = component.calculateProjectorDerivatives(job.ion_elec_dist, job.ion_elec_displ, dhpsioverpsi_list[i]);
+  }
+}
+
+/** finalize the calculation of $\frac{V\Psi_T}{\Psi_T}$ and accumulate its parameter derivatives
+ * @param r the distance between the ion and the electron
+ * @param dr displacement from the ion to the electron
+ * @param dhpsioverpsi derivatives of Vpp, the contribution of this pair is added
+ *
+ * psiratio and dratio must hold the ratios and their parameter derivatives on the quadrature points
+ */
+NonLocalECPComponent::RealType NonLocalECPComponent::calculateProjectorDerivatives(RealType r,
+                                                                                   const PosType& dr,
+                                                                                   Vector<ValueType>& dhpsioverpsi)
+{
   for (int j = 0; j < nknot; ++j)
     psiratio[j] *= sgridweight_m[j];
 
@@ -136,6 +204,7 @@ NonLocalECPComponent::RealType NonLocalECPComponent::evaluateValueAndDerivatives
     pairpot += std::real(wvec[j]);
   }
 
+  const size_t num_vars = dratio.cols();
   BLAS::gemv('N', num_vars, nknot, 1.0, dratio.data(), num_vars, wvec.data(), 1, 1.0, dhpsioverpsi.data(), 1);
 
   return pairpot;
@@ -123,6 +123,15 @@ public:
                                        const Vector<ValueType>& dlogpsi,
                                        Vector<ValueType>& dhpsioverpsi) override;
 
+  /** batched evaluateValueAndDerivatives, the wavefunction parameter derivatives of the quadrature point ratios
+   *  are computed by TrialWaveFunction::mw_evaluateDerivRatios over the walkers sharing a job index
+   */
+  void mw_evaluateWithParameterDerivatives(const RefVectorWithLeader<OperatorBase>& o_list,
+                                           const RefVectorWithLeader<ParticleSet>& p_list,
+                                           const opt_variables_type& optvars,
+                                           const RecordArray<ValueType>& dlogpsi,
+                                           RecordArray<ValueType>& dhpsioverpsi) const override;
+
   /** Do nothing */
   bool put(xmlNodePtr cur) override { return true; }
 
@@ -17,6 +17,8 @@
  *@brief Definition of ObservableHelper class
  */
 #include "ObservableHelper.h"
+#include <functional>
+#include <numeric>
 
 namespace qmcplusplus
 {
@@ -87,15 +89,44 @@ void ObservableHelper::addProperty(std::vector<TinyVector<float, OHMMS_DIM>>& p,
   file.pop();
 }
 
+void ObservableHelper::set_output_layout(int blocks_per_write, int compression_level, bool use_zstd)
+{
+  blocks_per_write_  = std::max(blocks_per_write, 1);
+  compression_level_ = compression_level;
+  use_zstd_          = use_zstd;
+}
+
 void ObservableHelper::write(const value_type* const first_v, hdf_archive& file)
 {
   hsize_t rank = mydims.size();
-  if (rank)
+  if (!rank)
+    return;
+  if (blocks_per_write_ == 1)
   {
     file.push(group_name, true);
-    h5d_append(file.top(), "value", current, rank, mydims.data(), first_v + lower_bound);
+    h5d_append(file.top(), "value", current, rank, mydims.data(), first_v + lower_bound, 1, H5P_DEFAULT,
+               compression_level_, use_zstd_);
     file.pop();
+    return;
   }
+  const hsize_t block_size = std::accumulate(mydims.begin() + 1, mydims.end(), hsize_t(1), std::multiplies<>());
+  pending_blocks_.insert(pending_blocks_.end(), first_v + lower_bound, first_v + lower_bound + block_size);
+  if (++num_pending_ == blocks_per_write_)
+    flush(file);
+}
+
+void ObservableHelper::flush(hdf_archive& file)
+{
+  if (num_pending_ == 0)
+    return;
+  std::vector<hsize_t> dims(mydims);
+  dims[0] = num_pending_;
+  file.push(group_name, true);
+  h5d_append(file.top(), "value", current, dims.size(), dims.data(), pending_blocks_.data(), blocks_per_write_,
+             H5P_DEFAULT, compression_level_, use_zstd_);
+  file.pop();
+  pending_blocks_.clear();
+  num_pending_ = 0;
 }
 
 } // namespace qmcplusplus
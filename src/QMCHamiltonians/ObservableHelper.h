@@ -86,14 +86,36 @@ public:
   void addProperty(std::vector<float>& p, const std::string& pname, hdf_archive& file);
   void addProperty(std::vector<TinyVector<float, OHMMS_DIM>>& p, const std::string& pname, hdf_archive& file);
 
+  /** set how the block values are appended to the file
+   * @param blocks_per_write number of blocks buffered and appended by one write, also the chunk extent
+   * @param compression_level lossless compression level, 0 for none
+   * @param use_zstd compress with the zstd filter plugin if available instead of deflate
+   *
+   * Must be set before the first write.
+   */
+  void set_output_layout(int blocks_per_write, int compression_level, bool use_zstd);
+
+  /** append the block value starting at first_v + lower_bound
+   *  with more than one block per write the value is buffered until blocks_per_write blocks are pending.
+   */
   void write(const value_type* const first_v, hdf_archive& file);
 
+  /// append the pending blocks
+  void flush(hdf_archive& file);
+
   ///starting index
   hsize_t lower_bound = 0;
 
 private:
   /// "file pointer" for h5d_append
   hsize_t current = 0;
+  /// blocks appended by one write
+  hsize_t blocks_per_write_ = 1;
+  int compression_level_    = 0;
+  bool use_zstd_            = false;
+  /// blocks waiting to be appended
+  std::vector<value_type> pending_blocks_;
+  hsize_t num_pending_ = 0;
   /// Path of this observable
   hdf_path group_name;
   ///my dimensions
@@ -16,6 +16,7 @@
 #include "io/hdf/hdf_archive.h"
 
 #include <filesystem>
+#include <numeric>
 
 /*
   -- 05/07/2021 --
@@ -72,4 +73,49 @@ TEST_CASE("ObservableHelper::ObservableHelper()", "[hamiltonian]")
   REQUIRE(std::filesystem::remove(filename));
 }
 
+TEST_CASE("ObservableHelper::set_output_layout", "[hamiltonian]")
+{
+  std::filesystem::path filename("tmp_ObservableHelper3.h5");
+  const int num_blocks = 5;
+  {
+    hdf_archive hFile;
+    hFile.create(filename);
+    ObservableHelper oh{hdf_path{"u"}};
+    oh.set_dimensions({3}, 1);
+    // two blocks per write, the fifth block is written by flush
+    oh.set_output_layout(2, 4, false);
+    std::vector<value_type> data(4);
+    for (int ib = 0; ib < num_blocks; ++ib)
+    {
+      std::iota(data.begin(), data.end(), 10 * ib);
+      oh.write(data.data(), hFile);
+    }
+    oh.flush(hFile);
+    hFile.close();
+  }
+
+  hdf_archive hFile;
+  REQUIRE(hFile.open(filename));
+  std::vector<value_type> values;
+  hFile.readSlabReshaped(values, std::array<int, 2>{num_blocks, 3}, "u/value");
+  REQUIRE(values.size() == num_blocks * 3);
+  for (int ib = 0; ib < num_blocks; ++ib)
+    for (int i = 0; i < 3; ++i)
+      CHECK(values[ib * 3 + i] == Approx(10 * ib + i + 1));
+
+  hid_t dataset = H5Dopen(hFile.getFileID(), "u/value", H5P_DEFAULT);
+  REQUIRE(dataset >= 0);
+  hid_t dcpl = H5Dget_create_plist(dataset);
+  hsize_t chunk_dims[2];
+  CHECK(H5Pget_chunk(dcpl, 2, chunk_dims) == 2);
+  CHECK(chunk_dims[0] == 2);
+  CHECK(chunk_dims[1] == 3);
+  if (H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0)
+    CHECK(H5Pget_nfilters(dcpl) == 2);
+  H5Pclose(dcpl);
+  H5Dclose(dataset);
+  hFile.close();
+  REQUIRE(std::filesystem::remove(filename));
+}
+
 } // namespace qmcplusplus
@@ -23,6 +23,7 @@
 #include "QMCWaveFunctions/EinsplineSetBuilder.h"
 #include "QMCHamiltonians/HamiltonianFactory.h"
 #include "Utilities/ProjectData.h"
+#include "ResourceCollection.h"
 
 #include <stdio.h>
 #include <string>
@@ -258,6 +259,12 @@ void test_hcpBe_rotation(bool use_single_det, bool use_nlpp_batched)
 
   // batched interface
   RefVectorWithLeader<QMCHamiltonian> h_list(*h, {*h});
+  ResourceCollection ham_res("test_ham_res");
+  h->createResource(ham_res);
+  ResourceCollectionTeamLock<QMCHamiltonian> ham_lock(ham_res, h_list);
+  ResourceCollection twf_res("test_twf_res");
+  psi->createResource(twf_res);
+  ResourceCollectionTeamLock<TrialWaveFunction> twf_lock(twf_res, wf_list);
 
   RecordArray<ValueType> dlogpsi_list2(nentry, nparam);
   RecordArray<ValueType> dhpsi_over_psi_list2(nentry, nparam);
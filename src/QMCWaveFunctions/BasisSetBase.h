@@ -167,6 +167,12 @@ struct SoaBasisSetBase
                                      int jion,
                                      vghgh_type& vghgh)                            = 0;
   virtual void evaluateV(const ParticleSet& P, int iat, value_type* restrict vals) = 0;
+  /** basis function ranges [first, last) of the centers within reach of the electron in the last
+   * evaluateVGL/evaluateV/mw_evaluateVGL/mw_evaluateValue call, sorted and merged.
+   * The union over walkers for mw_ calls. The basis functions outside the ranges are zero.
+   * nullptr if the basis set does not screen its centers.
+   */
+  virtual const std::vector<std::pair<int, int>>* getActiveBasisRanges() const { return nullptr; }
   virtual bool is_S_orbital(int mo_idx, int ao_idx) { return false; }
 
   /// Determine which orbitals are S-type.  Used for cusp correction.
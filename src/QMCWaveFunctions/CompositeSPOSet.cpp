@@ -47,6 +47,8 @@ CompositeSPOSet::CompositeSPOSet(const std::string& my_name) : SPOSet(my_name)
 
 CompositeSPOSet::CompositeSPOSet(const CompositeSPOSet& other) : SPOSet(other)
 {
+  // add() accumulates the orbital count and the offsets of the cloned components
+  OrbitalSetSize = 0;
   for (auto& element : other.components)
   {
     this->add(element->makeClone());
@@ -114,6 +116,64 @@ void CompositeSPOSet::evaluateVGL(const ParticleSet& P, int iat, ValueVector& ps
   }
 }
 
+void CompositeSPOSet::mw_evaluateValue(const RefVectorWithLeader<SPOSet>& spo_list,
+                                       const RefVectorWithLeader<ParticleSet>& P_list,
+                                       int iat,
+                                       const RefVector<ValueVector>& psi_v_list) const
+{
+  assert(this == &spo_list.getLeader());
+  const size_t nw = spo_list.size();
+  for (int c = 0; c < components.size(); ++c)
+  {
+    RefVector<ValueVector> values_list;
+    values_list.reserve(nw);
+    for (int iw = 0; iw < nw; ++iw)
+      values_list.push_back(spo_list.getCastedElement<CompositeSPOSet>(iw).component_values[c]);
+    const auto component_list = extractComponentRefList(spo_list, c);
+    component_list.getLeader().mw_evaluateValue(component_list, P_list, iat, values_list);
+    for (int iw = 0; iw < nw; ++iw)
+    {
+      const ValueVector& values = values_list[iw];
+      std::copy(values.begin(), values.end(), psi_v_list[iw].get().begin() + component_offsets[c]);
+    }
+  }
+}
+
+void CompositeSPOSet::createResource(ResourceCollection& collection) const
+{
+  for (auto& component : components)
+    component->createResource(collection);
+}
+
+void CompositeSPOSet::acquireResource(ResourceCollection& collection, const RefVectorWithLeader<SPOSet>& spo_list) const
+{
+  for (int c = 0; c < components.size(); ++c)
+  {
+    const auto component_list = extractComponentRefList(spo_list, c);
+    component_list.getLeader().acquireResource(collection, component_list);
+  }
+}
+
+void CompositeSPOSet::releaseResource(ResourceCollection& collection, const RefVectorWithLeader<SPOSet>& spo_list) const
+{
+  for (int c = 0; c < components.size(); ++c)
+  {
+    const auto component_list = extractComponentRefList(spo_list, c);
+    component_list.getLeader().releaseResource(collection, component_list);
+  }
+}
+
+RefVectorWithLeader<SPOSet> CompositeSPOSet::extractComponentRefList(const RefVectorWithLeader<SPOSet>& spo_list,
+                                                                     int c)
+{
+  auto& spo_leader = spo_list.getCastedLeader<CompositeSPOSet>();
+  RefVectorWithLeader<SPOSet> component_list(*spo_leader.components[c]);
+  component_list.reserve(spo_list.size());
+  for (int iw = 0; iw < spo_list.size(); ++iw)
+    component_list.push_back(*spo_list.getCastedElement<CompositeSPOSet>(iw).components[c]);
+  return component_list;
+}
+
 void CompositeSPOSet::evaluate_notranspose(const ParticleSet& P,
                                            int first,
                                            int last,
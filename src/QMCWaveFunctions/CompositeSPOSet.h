@@ -58,6 +58,16 @@ public:
 
   void evaluateVGL(const ParticleSet& P, int iat, ValueVector& psi, GradVector& dpsi, ValueVector& d2psi) override;
 
+  /// evaluate the values of all the walkers with one batched call per component
+  void mw_evaluateValue(const RefVectorWithLeader<SPOSet>& spo_list,
+                        const RefVectorWithLeader<ParticleSet>& P_list,
+                        int iat,
+                        const RefVector<ValueVector>& psi_v_list) const override;
+
+  void createResource(ResourceCollection& collection) const override;
+  void acquireResource(ResourceCollection& collection, const RefVectorWithLeader<SPOSet>& spo_list) const override;
+  void releaseResource(ResourceCollection& collection, const RefVectorWithLeader<SPOSet>& spo_list) const override;
+
   ///unimplemented functions call this to abort
   inline void not_implemented(const std::string& method)
   {
@@ -84,6 +94,10 @@ public:
                             GradMatrix& dlogdet,
                             HessMatrix& ddlogdet,
                             GGGMatrix& dddlogdet) override;
+
+private:
+  /// the list of component c of every composite in spo_list
+  static RefVectorWithLeader<SPOSet> extractComponentRefList(const RefVectorWithLeader<SPOSet>& spo_list, int c);
 };
 
 struct CompositeSPOSetBuilder : public SPOSetBuilder
@@ -30,6 +30,20 @@ BackflowTransformation::BackflowTransformation(ParticleSet& els)
   newQP.resize(NumTargets);
   oldQP.resize(NumTargets);
   indexQP.resize(NumTargets);
+  // the temporaries are needed by particle-by-particle moves also without walker buffers
+  Bmat_temp.resize(NumTargets, NumTargets);
+  Amat_temp.resize(NumTargets, NumTargets);
+  storeQP.resize(NumTargets);
+  FirstOfP      = &(storeQP[0][0]);
+  LastOfP       = FirstOfP + OHMMS_DIM * NumTargets;
+  FirstOfA      = &(Amat(0, 0)[0]);
+  LastOfA       = FirstOfA + OHMMS_DIM * OHMMS_DIM * NumTargets * NumTargets;
+  FirstOfB      = &(Bmat_full(0, 0)[0]);
+  LastOfB       = FirstOfB + OHMMS_DIM * NumTargets * NumTargets;
+  FirstOfA_temp = &(Amat_temp(0, 0)[0]);
+  LastOfA_temp  = FirstOfA_temp + OHMMS_DIM * OHMMS_DIM * NumTargets * NumTargets;
+  FirstOfB_temp = &(Bmat_temp(0, 0)[0]);
+  LastOfB_temp  = FirstOfB_temp + OHMMS_DIM * NumTargets * NumTargets;
   HESS_ID.diagonal(1.0);
   DummyHess    = 0.0;
   numVarBefore = 0;
@@ -66,9 +80,14 @@ void BackflowTransformation::acceptMove(const ParticleSet& P, int iat)
 {
   // update QP table
   // may be faster if I do this one qp at a time, for now do full update
+  acceptMoveNoQPUpdate(iat);
+  QP.update(0);
+}
+
+void BackflowTransformation::acceptMoveNoQPUpdate(int iat)
+{
   for (int i = 0; i < NumTargets; i++)
     QP.R[i] = newQP[i];
-  QP.update(0);
   indexQP.clear();
   switch (UpdateMode)
   {
@@ -133,23 +152,7 @@ void BackflowTransformation::resetParameters(const opt_variables_type& active)
 
 void BackflowTransformation::registerData(ParticleSet& P, WFBufferType& buf)
 {
-  if (storeQP.size() == 0)
-  {
-    Bmat_temp.resize(NumTargets, NumTargets);
-    Amat_temp.resize(NumTargets, NumTargets);
-    storeQP.resize(NumTargets);
-  }
   evaluate(P);
-  FirstOfP      = &(storeQP[0][0]);
-  LastOfP       = FirstOfP + OHMMS_DIM * NumTargets;
-  FirstOfA      = &(Amat(0, 0)[0]);
-  LastOfA       = FirstOfA + OHMMS_DIM * OHMMS_DIM * NumTargets * NumTargets;
-  FirstOfB      = &(Bmat_full(0, 0)[0]);
-  LastOfB       = FirstOfB + OHMMS_DIM * NumTargets * NumTargets;
-  FirstOfA_temp = &(Amat_temp(0, 0)[0]);
-  LastOfA_temp  = FirstOfA_temp + OHMMS_DIM * OHMMS_DIM * NumTargets * NumTargets;
-  FirstOfB_temp = &(Bmat_temp(0, 0)[0]);
-  LastOfB_temp  = FirstOfB_temp + OHMMS_DIM * NumTargets * NumTargets;
   for (int i = 0; i < NumTargets; i++)
     storeQP[i] = QP.R[i];
   buf.add(FirstOfP, LastOfP);
@@ -310,6 +313,12 @@ void BackflowTransformation::evaluateBmatOnly(const ParticleSet& P, int iat)
 /** calculate quasi-particle coordinates, Bmat and Amat
    */
 void BackflowTransformation::evaluate(const ParticleSet& P)
+{
+  evaluateNoQPUpdate(P);
+  QP.update(0); // update distance tables
+}
+
+void BackflowTransformation::evaluateNoQPUpdate(const ParticleSet& P)
 {
   Bmat      = 0.0;
   Amat      = 0.0;
@@ -344,7 +353,6 @@ void BackflowTransformation::evaluate(const ParticleSet& P)
           }
           //
     */
-  QP.update(0); // update distance tables
 }
 
 /** calculate quasi-particle coordinates and store in Pnew
@@ -620,4 +628,71 @@ void BackflowTransformation::testPbyP(ParticleSet& P)
     app_log() << i << "\n" << qp_0[i] - QP.R[i] << "\n" << qp_0[i] << "\n" << QP.R[i] << std::endl << std::endl;
   APP_ABORT("Finished BackflowTransformation::testPbyP() \n.");
 }
+RefVectorWithLeader<ParticleSet> BackflowTransformation::extractQPRefList(
+    const RefVectorWithLeader<BackflowTransformation>& bf_list)
+{
+  RefVectorWithLeader<ParticleSet> qp_list(bf_list.getLeader().QP);
+  qp_list.reserve(bf_list.size());
+  for (BackflowTransformation& bf : bf_list)
+    qp_list.push_back(bf.QP);
+  return qp_list;
+}
+
+void BackflowTransformation::mw_evaluatePbyP(const RefVectorWithLeader<BackflowTransformation>& bf_list,
+                                             const RefVectorWithLeader<ParticleSet>& p_list,
+                                             int iat)
+{
+  for (int iw = 0; iw < bf_list.size(); iw++)
+    bf_list[iw].evaluatePbyP(p_list[iw], iat);
+}
+
+void BackflowTransformation::mw_evaluatePbyPWithGrad(const RefVectorWithLeader<BackflowTransformation>& bf_list,
+                                                     const RefVectorWithLeader<ParticleSet>& p_list,
+                                                     int iat)
+{
+  for (int iw = 0; iw < bf_list.size(); iw++)
+    bf_list[iw].evaluatePbyPWithGrad(p_list[iw], iat);
+}
+
+void BackflowTransformation::mw_evaluate(const RefVectorWithLeader<BackflowTransformation>& bf_list,
+                                         const RefVectorWithLeader<ParticleSet>& p_list)
+{
+  for (int iw = 0; iw < bf_list.size(); iw++)
+    bf_list[iw].evaluateNoQPUpdate(p_list[iw]);
+  ParticleSet::mw_update(extractQPRefList(bf_list));
+}
+
+void BackflowTransformation::mw_accept_rejectMove(const RefVectorWithLeader<BackflowTransformation>& bf_list,
+                                                  const RefVectorWithLeader<ParticleSet>& p_list,
+                                                  int iat,
+                                                  const std::vector<bool>& isAccepted)
+{
+  auto& bf_leader = bf_list.getLeader();
+  RefVectorWithLeader<ParticleSet> qp_accepted_list(bf_leader.QP);
+  for (int iw = 0; iw < bf_list.size(); iw++)
+    if (isAccepted[iw])
+    {
+      bf_list[iw].acceptMoveNoQPUpdate(iat);
+      qp_accepted_list.push_back(bf_list[iw].QP);
+    }
+    else
+      bf_list[iw].restore(iat);
+  if (qp_accepted_list.size() > 0)
+    ParticleSet::mw_update(qp_accepted_list);
+}
+
+void BackflowTransformation::createResource(ResourceCollection& collection) const { QP.createResource(collection); }
+
+void BackflowTransformation::acquireResource(ResourceCollection& collection,
+                                             const RefVectorWithLeader<BackflowTransformation>& bf_list)
+{
+  ParticleSet::acquireResource(collection, extractQPRefList(bf_list));
+}
+
+void BackflowTransformation::releaseResource(ResourceCollection& collection,
+                                             const RefVectorWithLeader<BackflowTransformation>& bf_list)
+{
+  ParticleSet::releaseResource(collection, extractQPRefList(bf_list));
+}
+
 } // namespace qmcplusplus
@@ -208,6 +208,48 @@ public:
   void testDeriv(const ParticleSet& P);
 
   void testPbyP(ParticleSet& P);
+
+  /* The multi walker functions loop over the walkers with the single walker code to evaluate newQP, Amat and
+   * dAmat, only the quasi-particle distance table updates are batched.
+   */
+  /// multi walker version of evaluatePbyP
+  static void mw_evaluatePbyP(const RefVectorWithLeader<BackflowTransformation>& bf_list,
+                              const RefVectorWithLeader<ParticleSet>& p_list,
+                              int iat);
+
+  /// multi walker version of evaluatePbyPWithGrad
+  static void mw_evaluatePbyPWithGrad(const RefVectorWithLeader<BackflowTransformation>& bf_list,
+                                      const RefVectorWithLeader<ParticleSet>& p_list,
+                                      int iat);
+
+  /** multi walker version of evaluate
+   * Quasi-particle distance tables of all the walkers are updated in a batch.
+   */
+  static void mw_evaluate(const RefVectorWithLeader<BackflowTransformation>& bf_list,
+                          const RefVectorWithLeader<ParticleSet>& p_list);
+
+  /** accept or reject the pbyp moves of multiple walkers
+   * Quasi-particle distance tables of the accepted walkers are updated in a batch.
+   */
+  static void mw_accept_rejectMove(const RefVectorWithLeader<BackflowTransformation>& bf_list,
+                                   const RefVectorWithLeader<ParticleSet>& p_list,
+                                   int iat,
+                                   const std::vector<bool>& isAccepted);
+
+  /// resources of the quasi-particle set
+  void createResource(ResourceCollection& collection) const;
+  static void acquireResource(ResourceCollection& collection,
+                              const RefVectorWithLeader<BackflowTransformation>& bf_list);
+  static void releaseResource(ResourceCollection& collection,
+                              const RefVectorWithLeader<BackflowTransformation>& bf_list);
+
+private:
+  /// evaluate without updating the distance tables of QP
+  void evaluateNoQPUpdate(const ParticleSet& P);
+  /// acceptMove without updating the distance tables of QP
+  void acceptMoveNoQPUpdate(int iat);
+  /// collect the quasi-particle sets
+  static RefVectorWithLeader<ParticleSet> extractQPRefList(const RefVectorWithLeader<BackflowTransformation>& bf_list);
 };
 
 } // namespace qmcplusplus
@@ -0,0 +1,102 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "CIScreening.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include "Platforms/Host/OutputManager.h"
+
+namespace qmcplusplus
+{
+CIScreening::CIScreening(size_t num_terms, RealType tolerance, size_t samples_per_update, size_t sample_interval)
+    : tolerance_(tolerance),
+      samples_per_update_(samples_per_update),
+      sample_interval_(sample_interval),
+      sum_contribution_(num_terms, 0)
+{
+  if (num_terms == 0)
+    throw std::runtime_error("CIScreening requires at least one CI term!");
+  if (tolerance < 0)
+    throw std::runtime_error("CIScreening tolerance must not be negative!");
+  if (samples_per_update == 0 || sample_interval == 0)
+    throw std::runtime_error("CIScreening samples_per_update and sample_interval must be positive!");
+}
+
+std::shared_ptr<const std::vector<size_t>> CIScreening::getKeptTerms() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return kept_terms_;
+}
+
+size_t CIScreening::getNumKeptTerms() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return kept_terms_ ? kept_terms_->size() : sum_contribution_.size();
+}
+
+CIScreening::RealType CIScreening::getEstimatedError() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return estimated_error_;
+}
+
+CIScreening::RealType CIScreening::getMeasuredError() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return measured_error_;
+}
+
+void CIScreening::update()
+{
+  const size_t nterms = sum_contribution_.size();
+  const RealType norm = RealType(1) / num_samples_;
+
+  std::vector<size_t> order(nterms);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [this](size_t a, size_t b) { return sum_contribution_[a] > sum_contribution_[b]; });
+
+  // drop the smallest terms as long as their summed contribution stays within the tolerance
+  size_t nkept   = nterms;
+  RealType error = 0;
+  while (nkept > 1)
+  {
+    const RealType next_error = error + sum_contribution_[order[nkept - 1]] * norm;
+    if (next_error > tolerance_)
+      break;
+    error = next_error;
+    nkept--;
+  }
+
+  measured_error_  = sum_psi_error_ * norm;
+  estimated_error_ = error;
+  if (nkept == nterms)
+    kept_terms_.reset();
+  else
+  {
+    auto kept = std::make_shared<std::vector<size_t>>(order.begin(), order.begin() + nkept);
+    std::sort(kept->begin(), kept->end());
+    kept_terms_ = std::move(kept);
+  }
+  generation_++;
+
+  app_log() << "  CI screening after " << num_samples_ << " samples: measured relative error " << measured_error_
+            << ", keeping " << nkept << " of " << nterms << " terms with estimated relative error " << estimated_error_
+            << std::endl;
+
+  std::fill(sum_contribution_.begin(), sum_contribution_.end(), RealType(0));
+  sum_psi_error_ = 0;
+  num_samples_   = 0;
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_CISCREENING_H
+#define QMCPLUSPLUS_CISCREENING_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <Configuration.h>
+
+namespace qmcplusplus
+{
+/** Runtime screening of the CI terms of a multi Slater determinant expansion
+ *
+ * The relative contribution |c_i D_i| / |Psi| of every term is accumulated over the sampled walker configurations.
+ * Once enough samples are collected, the terms are sorted by their mean contribution and the tail whose
+ * summed contribution stays below the tolerance is dropped. The summed contribution of the dropped terms bounds
+ * the mean relative error of |Psi| and is reported as the estimated bias. Dropped terms keep being sampled so
+ * each update revalidates the truncation: the error of the kept expansion against the full one is measured and
+ * terms whose contribution has grown are included again.
+ *
+ * One object is shared by all the clones of a wavefunction. Accumulation and updates are thread safe.
+ * Clones pick up a new list of kept terms via getGeneration/getKeptTerms.
+ */
+class CIScreening
+{
+public:
+  using RealType = QMCTraits::RealType;
+
+  /** constructor
+   * @param num_terms number of CI terms in the full expansion
+   * @param tolerance target relative error of |Psi|
+   * @param samples_per_update number of samples accumulated between updates of the kept terms
+   * @param sample_interval a walker is sampled every sample_interval full evaluations
+   */
+  CIScreening(size_t num_terms, RealType tolerance, size_t samples_per_update, size_t sample_interval);
+
+  RealType getTolerance() const { return tolerance_; }
+  size_t getSampleInterval() const { return sample_interval_; }
+  size_t getNumTerms() const { return sum_contribution_.size(); }
+
+  /// incremented at every update of the kept terms
+  size_t getGeneration() const { return generation_; }
+  /// the kept terms in ascending order, nullptr if all the terms are kept
+  std::shared_ptr<const std::vector<size_t>> getKeptTerms() const;
+  /// number of kept terms
+  size_t getNumKeptTerms() const;
+  /// summed mean contribution of the dropped terms at the last update
+  RealType getEstimatedError() const;
+  /// mean relative error of |Psi| from the kept terms measured over the samples of the last update
+  RealType getMeasuredError() const;
+
+  /** accumulate one sample
+   * @param contribution contribution(i) returns the relative contribution |c_i D_i| / |Psi| of term i
+   * @param psi_error relative error |Psi - Psi_kept| / |Psi| of the kept terms of the sampling walker
+   */
+  template<typename F>
+  void accumulate(F&& contribution, RealType psi_error)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < sum_contribution_.size(); i++)
+      sum_contribution_[i] += contribution(i);
+    sum_psi_error_ += psi_error;
+    if (++num_samples_ >= samples_per_update_)
+      update();
+  }
+
+private:
+  /// update the kept terms from the accumulated samples, the lock must be held
+  void update();
+
+  /// target relative error of |Psi|
+  const RealType tolerance_;
+  /// number of samples between updates
+  const size_t samples_per_update_;
+  /// sampling interval of each walker
+  const size_t sample_interval_;
+
+  mutable std::mutex mutex_;
+  /// accumulated relative contributions of all the terms
+  std::vector<RealType> sum_contribution_;
+  /// accumulated relative error of the kept terms
+  RealType sum_psi_error_ = 0;
+  /// number of accumulated samples
+  size_t num_samples_ = 0;
+
+  std::atomic<size_t> generation_{0};
+  std::shared_ptr<const std::vector<size_t>> kept_terms_;
+  RealType estimated_error_ = 0;
+  RealType measured_error_  = 0;
+};
+
+} // namespace qmcplusplus
+#endif
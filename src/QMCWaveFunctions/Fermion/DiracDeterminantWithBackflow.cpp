@@ -21,6 +21,7 @@
 #include "OhmmsPETE/Tensor.h"
 #include "CPU/SIMD/simd.hpp"
 #include "type_traits/ConvertToReal.h"
+#include <algorithm>
 
 namespace qmcplusplus
 {
@@ -66,6 +67,14 @@ void DiracDeterminantWithBackflow::resize(int nel, int morb)
   psiMinv_temp.resize(NumPtcls, norb);
   psiV.resize(norb);
   psiM_temp.resize(NumPtcls, norb);
+  dpsiM_temp.resize(NumPtcls, norb);
+  grad_grad_psiM_temp.resize(NumPtcls, norb);
+  dpsiV.resize(norb);
+  d2psiV.resize(norb);
+  grad_gradV.resize(norb);
+  Fmatdiag_temp.resize(norb);
+  myG_temp.resize(NumParticles);
+  myL_temp.resize(NumParticles);
   // For forces
   /*  not used
   grad_source_psiM.resize(nel,norb);
@@ -103,14 +112,6 @@ void DiracDeterminantWithBackflow::registerData(ParticleSet& P, WFBufferType& bu
     int norb     = NumOrbitals;
     NP           = P.getTotalNum();
     NumParticles = P.getTotalNum();
-    dpsiM_temp.resize(NumPtcls, norb);
-    grad_grad_psiM_temp.resize(NumPtcls, norb);
-    dpsiV.resize(norb);
-    d2psiV.resize(norb);
-    grad_gradV.resize(norb);
-    Fmatdiag_temp.resize(norb);
-    myG_temp.resize(NP);
-    myL_temp.resize(NP);
     resize(NumPtcls, NumOrbitals);
     FirstAddressOfG   = &myG[0][0];
     LastAddressOfG    = FirstAddressOfG + NP * DIM;
@@ -189,9 +190,7 @@ void DiracDeterminantWithBackflow::copyFromBuffer(ParticleSet& P, WFBufferType&
  */
 DiracDeterminantWithBackflow::PsiValueType DiracDeterminantWithBackflow::ratio(ParticleSet& P, int iat)
 {
-  // FIX FIX FIX : code Woodbury formula
-  psiM_temp = psiM;
-  // either code Woodbury or do multiple single particle updates
+  psiM_temp                         = psiM;
   UpdateMode                        = ORB_PBYP_RATIO;
   std::vector<int>::iterator it     = BFTrans_.indexQP.begin();
   std::vector<int>::iterator it_end = BFTrans_.indexQP.end();
@@ -211,14 +210,58 @@ DiracDeterminantWithBackflow::PsiValueType DiracDeterminantWithBackflow::ratio(P
     BFTrans_.QP.rejectMove(*it);
     it++;
   }
-  // FIX FIX FIX : code Woodbury formula
-  psiMinv_temp = psiM_temp;
-  // FIX FIX FIX : code Woodbury formula
+  return ratioWithMovedQP();
+}
+
+DiracDeterminantWithBackflow::PsiValueType DiracDeterminantWithBackflow::ratioWithMovedQP()
+{
   InverseTimer.start();
-  LogValueType NewLog;
-  InvertWithLog(psiMinv_temp.data(), NumPtcls, NumOrbitals, WorkSpace.data(), Pivot.data(), NewLog);
+  const LogValueType LogRatio = updateInverseWithMovedQP();
   InverseTimer.stop();
-  return curRatio = LogToValue<PsiValueType>::convert(NewLog - log_value_);
+  return curRatio = LogToValue<PsiValueType>::convert(LogRatio);
+}
+
+DiracDeterminantWithBackflow::LogValueType DiracDeterminantWithBackflow::updateInverseWithMovedQP()
+{
+  movedQP.clear();
+  for (int iat : BFTrans_.indexQP)
+    if (iat >= FirstIndex && iat < LastIndex)
+      movedQP.push_back(iat - FirstIndex);
+  const int k = movedQP.size();
+  const int n = NumPtcls;
+  if (k == 0)
+  {
+    psiMinv_temp = psiMinv;
+    return LogValueType();
+  }
+
+  Vmat.resize(n, k);
+  Wmat.resize(n, k);
+  Rinv.resize(k, k);
+  Tmat.resize(k, n);
+  // V = psiM_temp[:,J]
+  for (int o = 0; o < n; o++)
+    for (int b = 0; b < k; b++)
+      Vmat(o, b) = psiM_temp(o, movedQP[b]);
+  // W = Minv V, row-major products are computed as transposed column-major ones
+  BLAS::gemm('N', 'N', k, n, n, ValueType(1), Vmat.data(), k, psiMinv.data(), n, ValueType(0), Wmat.data(), k);
+  // R = W[J,:], its determinant is the ratio
+  for (int a = 0; a < k; a++)
+    for (int b = 0; b < k; b++)
+      Rinv(a, b) = Wmat(movedQP[a], b);
+  LogValueType LogRatio;
+  InvertWithLog(Rinv.data(), k, k, WorkSpace.data(), Pivot.data(), LogRatio);
+  // Minv U = W - E[:,J]
+  for (int b = 0; b < k; b++)
+    Wmat(movedQP[b], b) -= ValueType(1);
+  // T = R^{-1} Minv[J,:]
+  for (int a = 0; a < k; a++)
+    std::copy_n(psiMinv[movedQP[a]], n, psiMinv_temp[a]);
+  BLAS::gemm('N', 'N', n, k, k, ValueType(1), psiMinv_temp.data(), n, Rinv.data(), k, ValueType(0), Tmat.data(), n);
+  // Minv' = Minv - (Minv U) T
+  psiMinv_temp = psiMinv;
+  BLAS::gemm('N', 'N', n, n, k, ValueType(-1), Tmat.data(), n, Wmat.data(), k, ValueType(1), psiMinv_temp.data(), n);
+  return LogRatio;
 }
 
 void DiracDeterminantWithBackflow::evaluateRatiosAlltoOne(ParticleSet& P, std::vector<ValueType>& ratios)
@@ -260,7 +303,6 @@ DiracDeterminantWithBackflow::PsiValueType DiracDeterminantWithBackflow::ratioGr
                                                                                    int iat,
                                                                                    GradType& grad_iat)
 {
-  // FIX FIX FIX : code Woodbury formula
   psiM_temp                         = psiM;
   dpsiM_temp                        = dpsiM;
   UpdateMode                        = ORB_PBYP_PARTIAL;
@@ -285,12 +327,14 @@ DiracDeterminantWithBackflow::PsiValueType DiracDeterminantWithBackflow::ratioGr
     BFTrans_.QP.rejectMove(*it);
     it++;
   }
-  // FIX FIX FIX : code Woodbury formula
-  psiMinv_temp = psiM_temp;
-  // FIX FIX FIX : code Woodbury formula
+  return ratioGradWithMovedQP(iat, grad_iat);
+}
+
+DiracDeterminantWithBackflow::PsiValueType DiracDeterminantWithBackflow::ratioGradWithMovedQP(int iat,
+                                                                                              GradType& grad_iat)
+{
   InverseTimer.start();
-  LogValueType NewLog;
-  InvertWithLog(psiMinv_temp.data(), NumPtcls, NumOrbitals, WorkSpace.data(), Pivot.data(), NewLog);
+  const LogValueType LogRatio = updateInverseWithMovedQP();
   InverseTimer.stop();
   // update Fmatdiag_temp
   for (int j = 0; j < NumPtcls; j++)
@@ -298,7 +342,122 @@ DiracDeterminantWithBackflow::PsiValueType DiracDeterminantWithBackflow::ratioGr
     Fmatdiag_temp[j] = simd::dot(psiMinv_temp[j], dpsiM_temp[j], NumOrbitals);
     grad_iat += dot(BFTrans_.Amat_temp(iat, FirstIndex + j), Fmatdiag_temp[j]);
   }
-  return curRatio = LogToValue<PsiValueType>::convert(NewLog - log_value_);
+  return curRatio = LogToValue<PsiValueType>::convert(LogRatio);
+}
+
+void DiracDeterminantWithBackflow::mw_evaluateMovedQP(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                                      bool with_grad)
+{
+  auto& det_leader = wfc_list.getCastedLeader<DiracDeterminantWithBackflow>();
+  const int first  = det_leader.FirstIndex;
+  const int last   = det_leader.LastIndex;
+  // (quasi-particle, walker) pairs sorted by quasi-particle
+  std::vector<std::pair<int, int>> moved;
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+  {
+    auto& det     = wfc_list.getCastedElement<DiracDeterminantWithBackflow>(iw);
+    det.psiM_temp = det.psiM;
+    if (with_grad)
+      det.dpsiM_temp = det.dpsiM;
+    det.UpdateMode = with_grad ? ORB_PBYP_PARTIAL : ORB_PBYP_RATIO;
+    for (int qp : det.BFTrans_.indexQP)
+      if (qp >= first && qp < last)
+        moved.emplace_back(qp, iw);
+  }
+  std::sort(moved.begin(), moved.end());
+
+  RefVectorWithLeader<SPOSet> phi_list(*det_leader.Phi);
+  RefVectorWithLeader<ParticleSet> qp_list(det_leader.BFTrans_.QP);
+  RefVector<ValueVector> psi_v_list, d2psi_v_list;
+  RefVector<GradVector> dpsi_v_list;
+  std::vector<ParticleSet::SingleParticlePos> displs;
+  for (auto group = moved.begin(); group != moved.end();)
+  {
+    const int qp   = group->first;
+    auto group_end = std::find_if(group, moved.end(), [qp](const std::pair<int, int>& m) { return m.first != qp; });
+    phi_list.clear();
+    qp_list.clear();
+    psi_v_list.clear();
+    dpsi_v_list.clear();
+    d2psi_v_list.clear();
+    displs.clear();
+    for (auto it = group; it != group_end; ++it)
+    {
+      auto& det = wfc_list.getCastedElement<DiracDeterminantWithBackflow>(it->second);
+      phi_list.push_back(*det.Phi);
+      qp_list.push_back(det.BFTrans_.QP);
+      psi_v_list.push_back(det.psiV);
+      dpsi_v_list.push_back(det.dpsiV);
+      d2psi_v_list.push_back(det.d2psiV);
+      displs.push_back(det.BFTrans_.newQP[qp] - det.BFTrans_.QP.R[qp]);
+    }
+    ParticleSet::mw_makeMove(qp_list, qp, displs);
+    if (with_grad)
+      det_leader.Phi->mw_evaluateVGL(phi_list, qp_list, qp, psi_v_list, dpsi_v_list, d2psi_v_list);
+    else
+      det_leader.Phi->mw_evaluateValue(phi_list, qp_list, qp, psi_v_list);
+
+    const int jat = qp - first;
+    for (auto it = group; it != group_end; ++it)
+    {
+      auto& det = wfc_list.getCastedElement<DiracDeterminantWithBackflow>(it->second);
+      for (int orb = 0; orb < det.psiV.size(); orb++)
+        det.psiM_temp(orb, jat) = det.psiV[orb];
+      if (with_grad)
+      {
+        std::copy(det.dpsiV.begin(), det.dpsiV.end(), det.dpsiM_temp.begin(jat));
+        std::copy(det.grad_gradV.begin(), det.grad_gradV.end(), det.grad_grad_psiM_temp.begin(jat));
+      }
+      det.BFTrans_.QP.rejectMove(qp);
+    }
+    group = group_end;
+  }
+}
+
+void DiracDeterminantWithBackflow::mw_calcRatio(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                                const RefVectorWithLeader<ParticleSet>& p_list,
+                                                int iat,
+                                                std::vector<PsiValueType>& ratios) const
+{
+  mw_evaluateMovedQP(wfc_list, false);
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+    ratios[iw] = wfc_list.getCastedElement<DiracDeterminantWithBackflow>(iw).ratioWithMovedQP();
+}
+
+void DiracDeterminantWithBackflow::mw_ratioGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                                const RefVectorWithLeader<ParticleSet>& p_list,
+                                                int iat,
+                                                std::vector<PsiValueType>& ratios,
+                                                std::vector<GradType>& grad_new) const
+{
+  mw_evaluateMovedQP(wfc_list, true);
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+    ratios[iw] = wfc_list.getCastedElement<DiracDeterminantWithBackflow>(iw).ratioGradWithMovedQP(iat, grad_new[iw]);
+}
+
+void DiracDeterminantWithBackflow::createResource(ResourceCollection& collection) const
+{
+  Phi->createResource(collection);
+}
+
+void DiracDeterminantWithBackflow::acquireResource(ResourceCollection& collection,
+                                                   const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const
+{
+  auto& wfc_leader = wfc_list.getCastedLeader<DiracDeterminantWithBackflow>();
+  RefVectorWithLeader<SPOSet> phi_list(*wfc_leader.Phi);
+  for (WaveFunctionComponent& wfc : wfc_list)
+    phi_list.push_back(*static_cast<DiracDeterminantWithBackflow&>(wfc).Phi);
+  wfc_leader.Phi->acquireResource(collection, phi_list);
+}
+
+void DiracDeterminantWithBackflow::releaseResource(ResourceCollection& collection,
+                                                   const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const
+{
+  auto& wfc_leader = wfc_list.getCastedLeader<DiracDeterminantWithBackflow>();
+  RefVectorWithLeader<SPOSet> phi_list(*wfc_leader.Phi);
+  for (WaveFunctionComponent& wfc : wfc_list)
+    phi_list.push_back(*static_cast<DiracDeterminantWithBackflow&>(wfc).Phi);
+  wfc_leader.Phi->releaseResource(collection, phi_list);
 }
 
 void DiracDeterminantWithBackflow::testL(ParticleSet& P)
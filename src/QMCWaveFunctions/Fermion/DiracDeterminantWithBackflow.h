@@ -93,6 +93,27 @@ public:
   void evaluateRatiosAlltoOne(ParticleSet& P, std::vector<ValueType>& ratios) override;
 
   PsiValueType ratioGrad(ParticleSet& P, int iat, GradType& grad_iat) override;
+
+  /** the orbitals of the moved quasi-particles are evaluated with one batched SPO call per quasi-particle
+   *  moved in any walker. The inverse update and the ratio are computed per walker.
+   */
+  void mw_calcRatio(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios) const override;
+
+  void mw_ratioGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios,
+                    std::vector<GradType>& grad_new) const override;
+
+  void createResource(ResourceCollection& collection) const override;
+  void acquireResource(ResourceCollection& collection,
+                       const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const override;
+  void releaseResource(ResourceCollection& collection,
+                       const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const override;
+
   GradType evalGrad(ParticleSet& P, int iat) override;
   GradType evalGradSource(ParticleSet& P, ParticleSet& source, int iat) override;
 
@@ -140,6 +161,28 @@ private:
   ///reset the size: with the number of particles and number of orbtials
   void resize(int nel, int morb);
 
+  /** compute psiMinv_temp from psiMinv after the columns of the moved quasi-particles changed in psiM_temp
+   *
+   * A move changes k quasi-particles of this determinant, k columns of psiM. The Woodbury formula
+   * Minv' = Minv - (Minv U) R^{-1} Minv[J,:], with R = Minv[J,:] psiM_temp[:,J], costs O(N^2 k) instead of
+   * the O(N^3) inversion of psiM_temp.
+   * @return the log of the determinant ratio, log det(R)
+   */
+  LogValueType updateInverseWithMovedQP();
+
+  /// ratio after the columns of the moved quasi-particles are set in psiM_temp
+  PsiValueType ratioWithMovedQP();
+
+  /// ratio and gradient after the columns of the moved quasi-particles are set in psiM_temp and dpsiM_temp
+  PsiValueType ratioGradWithMovedQP(int iat, GradType& grad_iat);
+
+  /** set the columns of the quasi-particles moved in each walker of a batch
+   *
+   * The walkers moving the same quasi-particle are evaluated together by the batched SPO APIs.
+   * @param with_grad also set the gradients in dpsiM_temp
+   */
+  static void mw_evaluateMovedQP(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list, bool with_grad);
+
   inline ValueType rcdot(TinyVector<RealType, OHMMS_DIM>& lhs, TinyVector<ValueType, OHMMS_DIM>& rhs)
   {
     ValueType ret(0);
@@ -199,6 +242,11 @@ private:
   Vector<IndexType> Pivot;
 
   ValueMatrix psiMinv_temp;
+
+  /// columns of the moved quasi-particles of this determinant in a pbyp move
+  std::vector<int> movedQP;
+  /// new columns, Minv times new columns, R^{-1} and R^{-1} Minv[J,:] of the Woodbury update
+  ValueMatrix Vmat, Wmat, Rinv, Tmat;
   ValueType* FirstAddressOfGGG;
   ValueType* LastAddressOfGGG;
   ValueType* FirstAddressOfFm;
@@ -0,0 +1,255 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_EXCITATIONTRIE_H
+#define QMCPLUSPLUS_EXCITATIONTRIE_H
+
+#include <cmath>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+#include "type_traits/complex_help.hpp"
+#include "Numerics/DeterminantOperators.h"
+
+namespace qmcplusplus
+{
+/** Excitation tree of the unique determinants of a multi determinant expansion
+ *
+ * A node adds one (occupied position, unoccupied orbital) pair to the excitation of its parent.
+ * Its minor is the table matrix restricted to the rows and columns of all the pairs on the path from the root.
+ * The determinant of a minor is obtained from the parent one by bordering,
+ *   det(child) = det(parent) * (a - v M^{-1} u),
+ * where u, v and a are the new column, row and diagonal element. This costs O(n^2) instead of a O(n^3)
+ * factorization and the minors shared by determinants with a common excitation prefix are computed once.
+ * Nodes are stored in depth-first order so only the inverses along the current path are kept.
+ * When the bordering loses precision the minor and its subtree are computed by LU factorization.
+ */
+template<typename T>
+class ExcitationTrie
+{
+public:
+  /** scratch of evaluate, sized by the maximal depth of the tree
+   *
+   * The tree is shared by all the copies of a determinant, each caller keeps its own workspace.
+   */
+  struct Workspace
+  {
+    /// inverses of the minors along the path, inverse at depth d is stored in inv[d * nmax * nmax]
+    std::vector<T> inv;
+    /// determinants of the minors along the path
+    std::vector<T> det;
+    /// bordering vectors and the factorization buffer
+    std::vector<T> w, z, lu;
+    /// if the inverse of the minor at each depth is available for bordering
+    std::vector<char> bordered;
+    /// rows, columns of the current minor and the pivots of its factorization
+    std::vector<int> rows, cols, pivot;
+  };
+
+  /** build the tree
+   * @param data excitation data in the layout of MultiDiracDeterminant::detData
+   * @param ndets_per_excitation_level number of unique determinants at each excitation level
+   * @param min_ext_level only determinants with at least this excitation level are added
+   * @param det_ids if not nullptr, the id of each determinant in data. Otherwise its position in data.
+   */
+  void build(const int* data,
+             const std::vector<int>& ndets_per_excitation_level,
+             int min_ext_level,
+             const int* det_ids = nullptr)
+  {
+    depth_.clear();
+    row_.clear();
+    col_.clear();
+    det_id_.clear();
+    has_children_.clear();
+    max_depth_ = 0;
+    first_det_ = 0;
+
+    // build with linked children and flatten in depth-first order afterwards
+    struct BuildNode
+    {
+      int det_id = -1;
+      std::map<std::pair<int, int>, int> children;
+    };
+    std::vector<BuildNode> nodes(1);
+
+    const int* it = data;
+    size_t det_id = 0;
+    for (int ext_level = 0; ext_level < ndets_per_excitation_level.size(); ext_level++)
+    {
+      if (ext_level < min_ext_level)
+        first_det_ += ndets_per_excitation_level[ext_level];
+      for (int i = 0; i < ndets_per_excitation_level[ext_level]; i++, det_id++)
+      {
+        const int n = *it;
+        if (ext_level >= min_ext_level)
+        {
+          int node = 0;
+          for (int k = 0; k < n; k++)
+          {
+            const auto key = std::make_pair(it[1 + k], it[1 + n + k]);
+            auto found     = nodes[node].children.find(key);
+            if (found == nodes[node].children.end())
+            {
+              nodes.emplace_back();
+              found = nodes[node].children.emplace(key, nodes.size() - 1).first;
+            }
+            node = found->second;
+          }
+          nodes[node].det_id = det_ids ? det_ids[det_id] : det_id;
+          max_depth_         = std::max(max_depth_, n);
+        }
+        it += 3 * n + 1;
+      }
+    }
+
+    // depth-first flattening, the root is not stored
+    std::vector<std::pair<int, int>> stack;
+    for (auto child = nodes[0].children.rbegin(); child != nodes[0].children.rend(); ++child)
+      stack.emplace_back(child->second, 1);
+    // keys of the flattened nodes are kept along with the linked ones
+    std::vector<std::pair<int, int>> keys(nodes.size());
+    for (auto& node : nodes)
+      for (auto& [key, child] : node.children)
+        keys[child] = key;
+    while (!stack.empty())
+    {
+      const auto [node, depth] = stack.back();
+      stack.pop_back();
+      depth_.push_back(depth);
+      row_.push_back(keys[node].first);
+      col_.push_back(keys[node].second);
+      det_id_.push_back(nodes[node].det_id);
+      has_children_.push_back(!nodes[node].children.empty());
+      for (auto child = nodes[node].children.rbegin(); child != nodes[node].children.rend(); ++child)
+        stack.emplace_back(child->second, depth + 1);
+    }
+  }
+
+  /// the position in data of the first determinant in the tree. All the determinants after it are in the tree.
+  size_t getFirstDet() const { return first_det_; }
+  size_t getNumNodes() const { return depth_.size(); }
+
+  /** compute the determinants of the minors of all the determinants in the tree
+   * @param table_matrix the table matrix of the dot products between two determinants
+   * @param dets dets[det_id] is written for every determinant in the tree
+   * @param ws scratch, only resized on the first call
+   */
+  template<typename MAT>
+  void evaluate(const MAT& table_matrix, T* dets, Workspace& ws) const
+  {
+    if (depth_.empty())
+      return;
+
+    using RealType         = RealAlias<T>;
+    const RealType rel_tol = std::sqrt(std::numeric_limits<RealType>::epsilon());
+    const int nmax         = max_depth_;
+    // path state, inverse of the minor at depth d is stored in inv[d * nmax * nmax] with leading dimension d
+    ws.inv.resize((nmax + 1) * nmax * nmax);
+    ws.det.resize(nmax + 1);
+    ws.w.resize(nmax);
+    ws.z.resize(nmax);
+    ws.lu.resize(nmax * nmax);
+    ws.bordered.resize(nmax + 1);
+    ws.rows.resize(nmax);
+    ws.cols.resize(nmax);
+    ws.pivot.resize(nmax);
+    auto& [inv, det, w, z, lu, bordered, rows, cols, pivot] = ws;
+    det[0]      = T(1);
+    bordered[0] = true;
+
+    for (size_t i = 0; i < depth_.size(); i++)
+    {
+      const int d     = depth_[i];
+      const int p     = d - 1;
+      rows[p]         = row_[i];
+      cols[p]         = col_[i];
+      const T a       = table_matrix(rows[p], cols[p]);
+      bool stable     = false;
+      const T* minv_p = inv.data() + p * nmax * nmax;
+
+      if (bordered[p])
+      {
+        // w = M^{-1} u, s = a - v w
+        T s              = a;
+        RealType s_scale = std::abs(a);
+        for (int r = 0; r < p; r++)
+        {
+          T wr(0);
+          for (int c = 0; c < p; c++)
+            wr += minv_p[r * p + c] * table_matrix(rows[c], cols[p]);
+          w[r]            = wr;
+          const T product = table_matrix(rows[p], cols[r]) * wr;
+          s -= product;
+          s_scale += std::abs(product);
+        }
+        stable = std::abs(s) > rel_tol * s_scale;
+        if (stable)
+        {
+          det[d] = det[p] * s;
+          if (has_children_[i])
+          {
+            // z = v M^{-1}
+            for (int c = 0; c < p; c++)
+            {
+              T zc(0);
+              for (int r = 0; r < p; r++)
+                zc += table_matrix(rows[p], cols[r]) * minv_p[r * p + c];
+              z[c] = zc;
+            }
+            const T sinv = T(1) / s;
+            T* minv      = inv.data() + d * nmax * nmax;
+            for (int r = 0; r < p; r++)
+            {
+              for (int c = 0; c < p; c++)
+                minv[r * d + c] = minv_p[r * p + c] + w[r] * z[c] * sinv;
+              minv[r * d + p] = -w[r] * sinv;
+            }
+            for (int c = 0; c < p; c++)
+              minv[p * d + c] = -z[c] * sinv;
+            minv[p * d + p] = sinv;
+          }
+        }
+      }
+
+      if (!stable)
+      {
+        for (int r = 0; r < d; r++)
+          for (int c = 0; c < d; c++)
+            lu[r * d + c] = table_matrix(rows[r], cols[c]);
+        det[d] = Determinant(lu.data(), d, d, pivot.data());
+      }
+      bordered[d] = stable;
+
+      if (det_id_[i] >= 0)
+        dets[det_id_[i]] = det[d];
+    }
+  }
+
+private:
+  /// depth of each node, equal to the excitation level of its minor
+  std::vector<int> depth_;
+  /// occupied position and unoccupied orbital added by each node
+  std::vector<int> row_, col_;
+  /// the unique determinant ending at each node, -1 if none
+  std::vector<int> det_id_;
+  /// if the inverse of the minor of each node is needed by its children
+  std::vector<char> has_children_;
+  /// maximal depth of the tree
+  int max_depth_ = 0;
+  /// the id of the first determinant in the tree
+  size_t first_det_ = 0;
+};
+
+} // namespace qmcplusplus
+#endif
@@ -18,6 +18,7 @@
  * @brief Implement build functions: Function bodies are too big to be in a header file
  */
 #include "QMCWaveFunctions/Fermion/MultiDiracDeterminant.h"
+#include "QMCWaveFunctions/Fermion/SmallMatrixDetCalculator.h"
 #include "Numerics/MatrixOperators.h"
 #include "OMPTarget/ompBLAS.hpp"
 #include "OMPTarget/ompReductionComplex.hpp"
@@ -54,20 +55,27 @@ void MultiDiracDeterminant::buildTableMatrix_calculateRatios_impl(
 
   {
     ScopedTimer local(table2ratios_timer);
-    const int* it2       = data.data();
-    const size_t nitems  = sign.size();
-    const size_t nb_cols = table_matrix.cols();
+    const int* it2              = data.data();
+    const size_t nitems         = sign.size();
+    const size_t nb_cols        = table_matrix.cols();
+    const auto& excitation_trie = getActiveExcitationTrie();
+    const size_t first_trie_det = excitation_trie.getFirstDet();
+    const int* det_ids          = getActiveDetIds();
     // explore Inclusive Scan for OpenMP
-    for (size_t count = 0; count < nitems; ++count)
+    for (size_t count = 0; count < first_trie_det; ++count)
     {
-      const size_t n = *it2;
-      if (count != ref)
-        ratios[count] = sign[count] * det0 *
-            (n > MaxSmallDet ? det_calculator_.evaluate(table_matrix, it2 + 1, n)
-                             : calcSmallDeterminant(n, table_matrix.data(), it2 + 1, nb_cols));
+      const size_t n      = *it2;
+      const size_t det_id = det_ids ? det_ids[count] : count;
+      if (det_id != ref)
+        ratios[det_id] = sign[count] * det0 * calcSmallDeterminant(n, table_matrix.data(), it2 + 1, nb_cols);
       it2 += 3 * n + 1;
     }
 
+    // higher excitations share their minors along the excitation tree
+    excitation_trie.evaluate(table_matrix, ratios, trie_workspace_);
+    for (size_t count = first_trie_det; count < nitems; ++count)
+      ratios[det_ids ? det_ids[count] : count] *= sign[count] * det0;
+
     ratios[ref] = det0;
   }
 }
@@ -143,7 +151,9 @@ void MultiDiracDeterminant::mw_buildTableMatrix_calculateRatios_impl(
   }
   {
     ScopedTimer local(table2ratios_timer);
-    const int max_ext_level = ndets_per_excitation_level_->size() - 1;
+    const auto& ndets_per_excitation_level = getActiveNdetsPerExcitationLevel();
+    const int max_ext_level                = ndets_per_excitation_level.size() - 1;
+    const int* det_ids                     = getActiveDetIds();
 
     // Compute workload changes drastically as the excitation level increases.
     // this may need different parallelization strategy.
@@ -151,44 +161,44 @@ void MultiDiracDeterminant::mw_buildTableMatrix_calculateRatios_impl(
     size_t data_offset = 1;
 
     auto update_offsets = [&](size_t ext_level) {
-      det_offset += (*ndets_per_excitation_level_)[ext_level];
-      data_offset += (*ndets_per_excitation_level_)[ext_level] * (3 * ext_level + 1);
+      det_offset += ndets_per_excitation_level[ext_level];
+      data_offset += ndets_per_excitation_level[ext_level] * (3 * ext_level + 1);
     };
 
     mw_updateRatios_det0(det0_list, ratios_deviceptr_list);
 
     if (max_ext_level >= 1)
     {
-      mw_updateRatios<1>(det_offset, data_offset, data, sign, table_matrix_deviceptr_list, nb_cols_table_matrix,
-                         ratios_deviceptr_list);
+      mw_updateRatios<1>(det_offset, data_offset, data, sign, det_ids, table_matrix_deviceptr_list,
+                         nb_cols_table_matrix, ratios_deviceptr_list);
       update_offsets(1);
     }
 
     if (max_ext_level >= 2)
     {
-      mw_updateRatios<2>(det_offset, data_offset, data, sign, table_matrix_deviceptr_list, nb_cols_table_matrix,
-                         ratios_deviceptr_list);
+      mw_updateRatios<2>(det_offset, data_offset, data, sign, det_ids, table_matrix_deviceptr_list,
+                         nb_cols_table_matrix, ratios_deviceptr_list);
       update_offsets(2);
     }
 
     if (max_ext_level >= 3)
     {
-      mw_updateRatios<3>(det_offset, data_offset, data, sign, table_matrix_deviceptr_list, nb_cols_table_matrix,
-                         ratios_deviceptr_list);
+      mw_updateRatios<3>(det_offset, data_offset, data, sign, det_ids, table_matrix_deviceptr_list,
+                         nb_cols_table_matrix, ratios_deviceptr_list);
       update_offsets(3);
     }
 
     if (max_ext_level >= 4)
     {
-      mw_updateRatios<4>(det_offset, data_offset, data, sign, table_matrix_deviceptr_list, nb_cols_table_matrix,
-                         ratios_deviceptr_list);
+      mw_updateRatios<4>(det_offset, data_offset, data, sign, det_ids, table_matrix_deviceptr_list,
+                         nb_cols_table_matrix, ratios_deviceptr_list);
       update_offsets(4);
     }
 
     if (max_ext_level >= 5)
     {
-      mw_updateRatios<5>(det_offset, data_offset, data, sign, table_matrix_deviceptr_list, nb_cols_table_matrix,
-                         ratios_deviceptr_list);
+      mw_updateRatios<5>(det_offset, data_offset, data, sign, det_ids, table_matrix_deviceptr_list,
+                         nb_cols_table_matrix, ratios_deviceptr_list);
       update_offsets(5);
     }
 
@@ -196,12 +206,7 @@ void MultiDiracDeterminant::mw_buildTableMatrix_calculateRatios_impl(
     {
       for (size_t iw = 0; iw < nw; iw++)
         table_matrix_list[iw].get().updateFrom();
-      for (size_t ext_level = 6; ext_level <= max_ext_level; ext_level++)
-      {
-        mw_updateRatios_generic(ext_level, det_offset, data_offset, det_calculator_, data, sign, table_matrix_list,
-                                ratios_list);
-        update_offsets(ext_level);
-      }
+      mw_updateRatios_generic(mw_res, sign, table_matrix_list, ratios_list);
       // FIXME need to transfer the part of det ratios ext_level >= 6 to the device.
     }
   }
@@ -470,9 +475,9 @@ void MultiDiracDeterminant::mw_evaluateDetsForPtclMove(const RefVectorWithLeader
 
     auto& det0_list = mw_res.cone_vec;
     det_leader.mw_buildTableMatrix_calculateRatios(det_leader.mw_res_handle_, det_leader.ReferenceDeterminant,
-                                                   det0_list, psiMinv_temp_list, TpsiM_list, *det_leader.detData,
-                                                   *det_leader.uniquePairs, *det_leader.DetSigns, table_matrix_list,
-                                                   new_ratios_to_ref_list);
+                                                   det0_list, psiMinv_temp_list, TpsiM_list, det_leader.getActiveData(),
+                                                   det_leader.getActivePairs(), det_leader.getActiveSigns(),
+                                                   table_matrix_list, new_ratios_to_ref_list);
 
     // restore the modified column of TpsiM.
     PRAGMA_OFFLOAD("omp target teams distribute parallel for collapse(2) is_device_ptr(TpsiM_list_devptr) \
@@ -521,13 +526,96 @@ void MultiDiracDeterminant::evaluateDetsForPtclMove(const ParticleSet& P, int ia
     for (size_t i = 0; i < NumOrbitals; i++)
       TpsiM(i, WorkingIndex) = psiV[i];
   }
-  buildTableMatrix_calculateRatios(ReferenceDeterminant, psiMinv_temp, TpsiM, *detData, *uniquePairs, *DetSigns,
-                                   table_matrix, new_ratios_to_ref_);
+  buildTableMatrix_calculateRatios(ReferenceDeterminant, psiMinv_temp, TpsiM, getActiveData(), getActivePairs(),
+                                   getActiveSigns(), table_matrix, new_ratios_to_ref_);
   // check comment above
   for (size_t i = 0; i < NumOrbitals; i++)
     TpsiM(i, WorkingIndex) = psiM(WorkingIndex, i);
 }
 
+void MultiDiracDeterminant::mw_evaluateDetsForVirtualMoves(
+    const RefVectorWithLeader<MultiDiracDeterminant>& det_list,
+    const RefVectorWithLeader<const VirtualParticleSet>& vp_list)
+{
+  MultiDiracDeterminant& det_leader = det_list.getLeader();
+  ScopedTimer local_timer(det_leader.evaluateDetsForPtclMove_timer);
+
+  // every virtual move of every walker is an entry of the batch
+  RefVector<OffloadMatrix<ValueType>> psiMinv_temp_list, TpsiM_list, table_matrix_list;
+  RefVector<OffloadVector<ValueType>> new_ratios_to_ref_list;
+
+  for (size_t iw = 0; iw < det_list.size(); iw++)
+  {
+    MultiDiracDeterminant& det   = det_list[iw];
+    const VirtualParticleSet& VP = vp_list[iw];
+    const size_t nknots          = VP.getTotalNum();
+    const int WorkingIndex       = VP.refPtcl - det.FirstIndex;
+    assert(WorkingIndex >= 0 && WorkingIndex < det.LastIndex - det.FirstIndex);
+
+    det.UpdateMode = ORB_PBYP_RATIO;
+    if (det.vp_psiMinv_.size() < nknots)
+    {
+      det.vp_psiMinv_.resize(nknots);
+      det.vp_TpsiM_.resize(nknots);
+      det.vp_table_matrix_.resize(nknots);
+      det.vp_ratios_to_ref_.resize(nknots);
+    }
+    det.vp_cur_ratios_.resize(nknots);
+
+    const auto& occup = (*det.ciConfigList)[ReferenceDeterminant].occup;
+    for (size_t k = 0; k < nknots; k++)
+    {
+      {
+        ScopedTimer orb_timer(det.evalOrbValue_timer);
+        Vector<ValueType> psiV_host_view(det.psiV.data(), det.psiV.size());
+        det.Phi->evaluateValue(VP, k, psiV_host_view);
+      }
+
+      auto& psiMinv_temp = det.vp_psiMinv_[k];
+      auto& TpsiM        = det.vp_TpsiM_[k];
+      {
+        ScopedTimer inverse(det.updateInverse_timer);
+        psiMinv_temp.resize(det.psiMinv.rows(), det.psiMinv.cols());
+        psiMinv_temp = det.psiMinv;
+        for (size_t i = 0; i < det.NumPtcls; i++)
+          det.psiV_temp[i] = det.psiV[occup[i]];
+        auto ratio_old_ref_det = DetRatioByColumn(psiMinv_temp, det.psiV_temp, WorkingIndex);
+        det.vp_cur_ratios_[k]  = ratio_old_ref_det;
+        InverseUpdateByColumn(psiMinv_temp, det.psiV_temp, det.workV1, det.workV2, WorkingIndex, ratio_old_ref_det);
+        TpsiM.resize(det.TpsiM.rows(), det.TpsiM.cols());
+        TpsiM = det.TpsiM;
+        for (size_t i = 0; i < det.NumOrbitals; i++)
+          TpsiM(i, WorkingIndex) = det.psiV[i];
+      }
+      det.vp_table_matrix_[k].resize(det.table_matrix.rows(), det.table_matrix.cols());
+      det.vp_ratios_to_ref_[k].resize(det.getNumDets());
+      {
+        ScopedTimer local_timer(det.transferH2D_timer);
+        psiMinv_temp.updateTo();
+        TpsiM.updateTo();
+      }
+
+      psiMinv_temp_list.push_back(psiMinv_temp);
+      TpsiM_list.push_back(TpsiM);
+      table_matrix_list.push_back(det.vp_table_matrix_[k]);
+      new_ratios_to_ref_list.push_back(det.vp_ratios_to_ref_[k]);
+    }
+  }
+
+  const size_t nentries = new_ratios_to_ref_list.size();
+  if (nentries == 0)
+    return;
+
+  auto& mw_res    = det_leader.mw_res_handle_.getResource();
+  auto& det0_list = mw_res.vp_det0_list;
+  det0_list.resize(nentries);
+  std::fill_n(det0_list.data(), nentries, ValueType(1));
+  det_leader.mw_buildTableMatrix_calculateRatios(det_leader.mw_res_handle_, ReferenceDeterminant, det0_list,
+                                                 psiMinv_temp_list, TpsiM_list, det_leader.getActiveData(),
+                                                 det_leader.getActivePairs(), det_leader.getActiveSigns(),
+                                                 table_matrix_list, new_ratios_to_ref_list);
+}
+
 void MultiDiracDeterminant::evaluateDetsAndGradsForPtclMove(const ParticleSet& P, int iat)
 {
   ScopedTimer local_timer(evaluateDetsAndGradsForPtclMove_timer);
@@ -562,8 +650,8 @@ void MultiDiracDeterminant::evaluateDetsAndGradsForPtclMove(const ParticleSet& P
     for (size_t i = 0; i < NumOrbitals; i++)
       TpsiM(i, WorkingIndex) = psiV[i];
   }
-  buildTableMatrix_calculateRatios(ReferenceDeterminant, psiMinv_temp, TpsiM, *detData, *uniquePairs, *DetSigns,
-                                   table_matrix, new_ratios_to_ref_);
+  buildTableMatrix_calculateRatios(ReferenceDeterminant, psiMinv_temp, TpsiM, getActiveData(), getActivePairs(),
+                                   getActiveSigns(), table_matrix, new_ratios_to_ref_);
   for (size_t idim = 0; idim < OHMMS_DIM; idim++)
   {
     {
@@ -577,8 +665,9 @@ void MultiDiracDeterminant::evaluateDetsAndGradsForPtclMove(const ParticleSet& P
       for (size_t i = 0; i < NumOrbitals; i++)
         TpsiM(i, WorkingIndex) = dpsiV[i][idim];
     }
-    buildTableMatrix_calculateGradRatios(ReferenceDeterminant, dpsiMinv, TpsiM, *detData, *uniquePairs, *DetSigns,
-                                         ratioGradRef[idim] / curRatio, table_matrix, idim, WorkingIndex, new_grads);
+    buildTableMatrix_calculateGradRatios(ReferenceDeterminant, dpsiMinv, TpsiM, getActiveData(), getActivePairs(),
+                                         getActiveSigns(), ratioGradRef[idim] / curRatio, table_matrix, idim,
+                                         WorkingIndex, new_grads);
   }
   // check comment above
   for (int i = 0; i < NumOrbitals; i++)
@@ -622,8 +711,8 @@ void MultiDiracDeterminant::evaluateDetsAndGradsForPtclMoveWithSpin(const Partic
     for (size_t i = 0; i < NumOrbitals; i++)
       TpsiM(i, WorkingIndex) = psiV[i];
   }
-  buildTableMatrix_calculateRatios(ReferenceDeterminant, psiMinv_temp, TpsiM, *detData, *uniquePairs, *DetSigns,
-                                   table_matrix, new_ratios_to_ref_);
+  buildTableMatrix_calculateRatios(ReferenceDeterminant, psiMinv_temp, TpsiM, getActiveData(), getActivePairs(),
+                                   getActiveSigns(), table_matrix, new_ratios_to_ref_);
   for (size_t idim = 0; idim < OHMMS_DIM; idim++)
   {
     {
@@ -637,8 +726,9 @@ void MultiDiracDeterminant::evaluateDetsAndGradsForPtclMoveWithSpin(const Partic
       for (size_t i = 0; i < NumOrbitals; i++)
         TpsiM(i, WorkingIndex) = dpsiV[i][idim];
     }
-    buildTableMatrix_calculateGradRatios(ReferenceDeterminant, dpsiMinv, TpsiM, *detData, *uniquePairs, *DetSigns,
-                                         ratioGradRef[idim] / curRatio, table_matrix, idim, WorkingIndex, new_grads);
+    buildTableMatrix_calculateGradRatios(ReferenceDeterminant, dpsiMinv, TpsiM, getActiveData(), getActivePairs(),
+                                         getActiveSigns(), ratioGradRef[idim] / curRatio, table_matrix, idim,
+                                         WorkingIndex, new_grads);
   }
 
   //Now compute the spin gradient, same procedure as normal gradient components above
@@ -652,8 +742,9 @@ void MultiDiracDeterminant::evaluateDetsAndGradsForPtclMoveWithSpin(const Partic
     for (size_t i = 0; i < NumOrbitals; i++)
       TpsiM(i, WorkingIndex) = dspin_psiV[i];
   }
-  buildTableMatrix_calculateRatiosValueMatrixOneParticle(ReferenceDeterminant, dpsiMinv, TpsiM, *detData, *uniquePairs,
-                                                         *DetSigns, table_matrix, WorkingIndex, new_spingrads);
+  buildTableMatrix_calculateRatiosValueMatrixOneParticle(ReferenceDeterminant, dpsiMinv, TpsiM, getActiveData(),
+                                                         getActivePairs(), getActiveSigns(), table_matrix, WorkingIndex,
+                                                         new_spingrads);
 
   // check comment above
   for (int i = 0; i < NumOrbitals; i++)
@@ -824,9 +915,9 @@ void MultiDiracDeterminant::mw_evaluateDetsAndGradsForPtclMove(
 
     auto& det0_list = mw_res.cone_vec;
     det_leader.mw_buildTableMatrix_calculateRatios(det_leader.mw_res_handle_, det_leader.ReferenceDeterminant,
-                                                   det0_list, psiMinv_temp_list, TpsiM_list, *det_leader.detData,
-                                                   *det_leader.uniquePairs, *det_leader.DetSigns, table_matrix_list,
-                                                   new_ratios_to_ref_list);
+                                                   det0_list, psiMinv_temp_list, TpsiM_list, det_leader.getActiveData(),
+                                                   det_leader.getActivePairs(), det_leader.getActiveSigns(),
+                                                   table_matrix_list, new_ratios_to_ref_list);
 
     for (size_t idim = 0; idim < OHMMS_DIM; idim++)
     {
@@ -863,9 +954,9 @@ void MultiDiracDeterminant::mw_evaluateDetsAndGradsForPtclMove(
 
       det_leader.mw_buildTableMatrix_calculateGradRatios(det_leader.mw_res_handle_, det_leader.ReferenceDeterminant,
                                                          WorkingIndex, idim, det_leader.getNumDets(), det0_grad_list,
-                                                         dpsiMinv_list, TpsiM_list, *det_leader.detData,
-                                                         *det_leader.uniquePairs, *det_leader.DetSigns, WorkSpace_list,
-                                                         table_matrix_list, mw_grads);
+                                                         dpsiMinv_list, TpsiM_list, det_leader.getActiveData(),
+                                                         det_leader.getActivePairs(), det_leader.getActiveSigns(),
+                                                         WorkSpace_list, table_matrix_list, mw_grads);
     }
 
     // restore the modified column of TpsiM.
@@ -903,8 +994,8 @@ void MultiDiracDeterminant::evaluateGrads(ParticleSet& P, int iat)
     InverseUpdateByColumn(dpsiMinv, psiV_temp, workV1, workV2, WorkingIndex, ratioG);
     for (size_t i = 0; i < NumOrbitals; i++)
       TpsiM(i, WorkingIndex) = dpsiM(WorkingIndex, i)[idim];
-    buildTableMatrix_calculateGradRatios(ReferenceDeterminant, dpsiMinv, TpsiM, *detData, *uniquePairs, *DetSigns,
-                                         ratioG, table_matrix, idim, WorkingIndex, grads);
+    buildTableMatrix_calculateGradRatios(ReferenceDeterminant, dpsiMinv, TpsiM, getActiveData(), getActivePairs(),
+                                         getActiveSigns(), ratioG, table_matrix, idim, WorkingIndex, grads);
   }
   // check comment above
   for (size_t i = 0; i < NumOrbitals; i++)
@@ -933,8 +1024,8 @@ void MultiDiracDeterminant::evaluateGradsWithSpin(ParticleSet& P, int iat)
     InverseUpdateByColumn(dpsiMinv, psiV_temp, workV1, workV2, WorkingIndex, ratioG);
     for (size_t i = 0; i < NumOrbitals; i++)
       TpsiM(i, WorkingIndex) = dpsiM(WorkingIndex, i)[idim];
-    buildTableMatrix_calculateGradRatios(ReferenceDeterminant, dpsiMinv, TpsiM, *detData, *uniquePairs, *DetSigns,
-                                         ratioG, table_matrix, idim, WorkingIndex, grads);
+    buildTableMatrix_calculateGradRatios(ReferenceDeterminant, dpsiMinv, TpsiM, getActiveData(), getActivePairs(),
+                                         getActiveSigns(), ratioG, table_matrix, idim, WorkingIndex, grads);
   }
 
   //Now compute the spin gradient, same procedure as normal gradient components above
@@ -951,8 +1042,9 @@ void MultiDiracDeterminant::evaluateGradsWithSpin(ParticleSet& P, int iat)
   InverseUpdateByColumn(dpsiMinv, psiV_temp, workV1, workV2, WorkingIndex, ratioSG);
   for (size_t i = 0; i < NumOrbitals; i++)
     TpsiM(i, WorkingIndex) = dspin_psiM(WorkingIndex, i);
-  buildTableMatrix_calculateRatiosValueMatrixOneParticle(ReferenceDeterminant, dpsiMinv, TpsiM, *detData, *uniquePairs,
-                                                         *DetSigns, table_matrix, WorkingIndex, spingrads);
+  buildTableMatrix_calculateRatiosValueMatrixOneParticle(ReferenceDeterminant, dpsiMinv, TpsiM, getActiveData(),
+                                                         getActivePairs(), getActiveSigns(), table_matrix, WorkingIndex,
+                                                         spingrads);
 
   // check comment above
   for (size_t i = 0; i < NumOrbitals; i++)
@@ -1076,9 +1168,9 @@ void MultiDiracDeterminant::mw_evaluateGrads(const RefVectorWithLeader<MultiDira
 
       det_leader.mw_buildTableMatrix_calculateGradRatios(det_leader.mw_res_handle_, det_leader.ReferenceDeterminant,
                                                          WorkingIndex, idim, det_leader.getNumDets(), ratioG_list,
-                                                         dpsiMinv_list, TpsiM_list, *det_leader.detData,
-                                                         *det_leader.uniquePairs, *det_leader.DetSigns, WorkSpace_list,
-                                                         table_matrix_list, mw_grads);
+                                                         dpsiMinv_list, TpsiM_list, det_leader.getActiveData(),
+                                                         det_leader.getActivePairs(), det_leader.getActiveSigns(),
+                                                         WorkSpace_list, table_matrix_list, mw_grads);
     }
 
     // restore the modified column of TpsiM.
@@ -1090,24 +1182,23 @@ void MultiDiracDeterminant::mw_evaluateGrads(const RefVectorWithLeader<MultiDira
   }
 }
 
-void MultiDiracDeterminant::mw_updateRatios_generic(int ext_level,
-                                                    const size_t det_offset,
-                                                    const size_t data_offset,
-                                                    SmallMatrixDetCalculator<ValueType>& det_calculator,
-                                                    const OffloadVector<int>& data,
+void MultiDiracDeterminant::mw_updateRatios_generic(MultiDiracDetMultiWalkerResource& mw_res,
                                                     const OffloadVector<RealType>& sign,
                                                     const RefVector<OffloadMatrix<ValueType>>& table_matrix_list,
                                                     const RefVector<OffloadVector<ValueType>>& ratios_list) const
 {
-  const size_t nw = ratios_list.size();
-  const int* it2  = data.data() + data_offset;
+  const size_t nw             = ratios_list.size();
+  const size_t nitems         = sign.size();
+  const auto& excitation_trie = getActiveExcitationTrie();
+  const size_t first_trie_det = excitation_trie.getFirstDet();
+  const int* det_ids          = getActiveDetIds();
   for (size_t iw = 0; iw < nw; iw++)
-    for (size_t count = 0; count < (*ndets_per_excitation_level_)[ext_level]; ++count)
-    {
-      size_t det_id                 = det_offset + count;
-      ratios_list[iw].get()[det_id] = sign[det_id] * ratios_list[iw].get()[0] *
-          det_calculator.evaluate(table_matrix_list[iw].get(), it2 + 1 + count * (3 * ext_level + 1), ext_level);
-    }
+  {
+    auto& ratios = ratios_list[iw].get();
+    excitation_trie.evaluate(table_matrix_list[iw].get(), ratios.data(), mw_res.trie_workspace);
+    for (size_t count = first_trie_det; count < nitems; count++)
+      ratios[det_ids ? det_ids[count] : count] *= sign[count] * ratios[0];
+  }
 }
 
 void MultiDiracDeterminant::mw_updateRatios_det0(const OffloadVector<ValueType>& det0_list,
@@ -1129,13 +1220,14 @@ void MultiDiracDeterminant::mw_updateRatios(const size_t det_offset,
                                             const size_t data_offset,
                                             const OffloadVector<int>& data,
                                             const OffloadVector<RealType>& sign,
+                                            const int* det_ids,
                                             const OffloadVector<ValueType*>& table_matrix_deviceptr_list,
                                             const size_t num_table_matrix_cols,
                                             const OffloadVector<ValueType*>& ratios_deviceptr_list) const
 {
   const size_t nw        = ratios_deviceptr_list.size();
   const size_t size_sign = sign.size();
-  const size_t ndet_ext  = (*ndets_per_excitation_level_)[EXT_LEVEL];
+  const size_t ndet_ext  = getActiveNdetsPerExcitationLevel()[EXT_LEVEL];
 
   ScopedTimer local_timer(updateRatios_timer);
 
@@ -1148,8 +1240,8 @@ void MultiDiracDeterminant::mw_updateRatios(const size_t det_offset,
   for (size_t iw = 0; iw < nw; iw++)
     for (size_t count = 0; count < ndet_ext; ++count)
     {
-      size_t det_id               = det_offset + count;
-      ratios_list_ptr[iw][det_id] = sign_ptr[det_id] * ratios_list_ptr[iw][0] *
+      const size_t det_id         = det_ids ? det_ids[det_offset + count] : det_offset + count;
+      ratios_list_ptr[iw][det_id] = sign_ptr[det_offset + count] * ratios_list_ptr[iw][0] *
           CustomizedMatrixDet<EXT_LEVEL>::evaluate(table_matrix_list_ptr[iw],
                                                    (data_ptr + data_offset) + 1 + count * (3 * EXT_LEVEL + 1),
                                                    num_table_matrix_cols);
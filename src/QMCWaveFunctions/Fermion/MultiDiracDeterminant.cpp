@@ -114,6 +114,8 @@ void MultiDiracDeterminant::createDetData(const int ref_det_id,
   for (size_t i = 0; i < data_local.size(); i++)
     data[i] = data_local[i];
 
+  excitation_trie_->build(data.data(), ndets_per_excitation_level, MaxSmallDet + 1);
+
   assert(det_idx_order.size() == nci);
 
   // make reverse mapping (old to new) and reorder confgList by exc. lvl.
@@ -158,6 +160,72 @@ void MultiDiracDeterminant::createDetData(const int ref_det_id,
   resize();
 }
 
+std::shared_ptr<const MultiDiracDeterminant::DetSubset> MultiDiracDeterminant::buildDetSubset(
+    const std::vector<bool>& active) const
+{
+  const auto& data                       = *detData;
+  const auto& sign                       = *DetSigns;
+  const auto& ndets_per_excitation_level = *ndets_per_excitation_level_;
+  assert(active.size() == getNumDets());
+
+  auto subset = std::make_shared<DetSubset>();
+  subset->ndets_per_excitation_level.resize(ndets_per_excitation_level.size(), 0);
+  std::vector<int> data_local, det_ids_local;
+  std::vector<RealType> sign_local;
+  // unique pairs of the subset, pair_used is indexed by the occupied position and the unoccupied orbital
+  std::vector<int> first_local, second_local;
+  std::vector<char> pair_used(NumPtcls * NumOrbitals, 0);
+
+  const int* it = data.data();
+  int det_id    = 0;
+  for (int ext_level = 0; ext_level < ndets_per_excitation_level.size(); ext_level++)
+    for (int i = 0; i < ndets_per_excitation_level[ext_level]; i++, det_id++)
+    {
+      const int n = *it;
+      if (det_id == ReferenceDeterminant || active[det_id])
+      {
+        det_ids_local.push_back(det_id);
+        sign_local.push_back(sign[det_id]);
+        data_local.insert(data_local.end(), it, it + 3 * n + 1);
+        subset->ndets_per_excitation_level[ext_level]++;
+        for (int k1 = 0; k1 < n; k1++)
+          for (int k2 = 0; k2 < n; k2++)
+          {
+            const int I = it[1 + k1];
+            const int J = it[1 + n + k2];
+            if (!pair_used[I * NumOrbitals + J])
+            {
+              pair_used[I * NumOrbitals + J] = 1;
+              first_local.push_back(I);
+              second_local.push_back(J);
+            }
+          }
+      }
+      it += 3 * n + 1;
+    }
+
+  subset->data.resize(data_local.size());
+  std::copy(data_local.begin(), data_local.end(), subset->data.begin());
+  subset->sign.resize(sign_local.size());
+  std::copy(sign_local.begin(), sign_local.end(), subset->sign.begin());
+  subset->det_ids.resize(det_ids_local.size());
+  std::copy(det_ids_local.begin(), det_ids_local.end(), subset->det_ids.begin());
+  subset->pairs.resize(first_local.size());
+  std::copy(first_local.begin(), first_local.end(), subset->pairs.data(0));
+  std::copy(second_local.begin(), second_local.end(), subset->pairs.data(1));
+  subset->excitation_trie.build(subset->data.data(), subset->ndets_per_excitation_level, MaxSmallDet + 1,
+                                subset->det_ids.data());
+
+  {
+    ScopedTimer local_timer(transferH2D_timer);
+    subset->data.updateTo();
+    subset->sign.updateTo();
+    subset->det_ids.updateTo();
+    subset->pairs.updateTo();
+  }
+  return subset;
+}
+
 void MultiDiracDeterminant::evaluateForWalkerMove(const ParticleSet& P, bool fromScratch)
 {
   ScopedTimer local_timer(evalWalker_timer);
@@ -199,8 +267,8 @@ void MultiDiracDeterminant::evaluateForWalkerMove(const ParticleSet& P, bool fro
   }
 
   const RealType detsign = (*DetSigns)[ReferenceDeterminant];
-  buildTableMatrix_calculateRatios(ReferenceDeterminant, psiMinv, TpsiM, *detData, *uniquePairs, *DetSigns,
-                                   table_matrix, ratios_to_ref_);
+  buildTableMatrix_calculateRatios(ReferenceDeterminant, psiMinv, TpsiM, getActiveData(), getActivePairs(),
+                                   getActiveSigns(), table_matrix, ratios_to_ref_);
   ///Pinning ratios_to_ref_ to the device.
 
 
@@ -225,8 +293,8 @@ void MultiDiracDeterminant::evaluateForWalkerMove(const ParticleSet& P, bool fro
       InverseUpdateByColumn(dpsiMinv, psiV_temp, workV1, workV2, iat, gradRatio[idim]);
       for (size_t i = 0; i < NumOrbitals; i++)
         TpsiM(i, iat) = dpsiM(iat, i)[idim];
-      buildTableMatrix_calculateGradRatios(ReferenceDeterminant, dpsiMinv, TpsiM, *detData, *uniquePairs, *DetSigns,
-                                           gradRatio[idim], table_matrix, idim, iat, grads);
+      buildTableMatrix_calculateGradRatios(ReferenceDeterminant, dpsiMinv, TpsiM, getActiveData(), getActivePairs(),
+                                           getActiveSigns(), gradRatio[idim], table_matrix, idim, iat, grads);
     }
     dpsiMinv = psiMinv;
     it       = confgList[ReferenceDeterminant].occup.begin();
@@ -235,8 +303,9 @@ void MultiDiracDeterminant::evaluateForWalkerMove(const ParticleSet& P, bool fro
     InverseUpdateByColumn(dpsiMinv, psiV_temp, workV1, workV2, iat, ratioLapl);
     for (size_t i = 0; i < NumOrbitals; i++)
       TpsiM(i, iat) = d2psiM(iat, i);
-    buildTableMatrix_calculateRatiosValueMatrixOneParticle(ReferenceDeterminant, dpsiMinv, TpsiM, *detData,
-                                                           *uniquePairs, *DetSigns, table_matrix, iat, lapls);
+    buildTableMatrix_calculateRatiosValueMatrixOneParticle(ReferenceDeterminant, dpsiMinv, TpsiM, getActiveData(),
+                                                           getActivePairs(), getActiveSigns(), table_matrix, iat,
+                                                           lapls);
     // restore matrix
     for (size_t i = 0; i < NumOrbitals; i++)
       TpsiM(i, iat) = psiM(iat, i);
@@ -292,8 +361,8 @@ void MultiDiracDeterminant::evaluateForWalkerMoveWithSpin(const ParticleSet& P,
     log_value_ref_det_ = logValueRef;
   } ///Stop inverse_timerScop
   const RealType detsign = (*DetSigns)[ReferenceDeterminant];
-  buildTableMatrix_calculateRatios(ReferenceDeterminant, psiMinv, TpsiM, *detData, *uniquePairs, *DetSigns,
-                                   table_matrix, ratios_to_ref_);
+  buildTableMatrix_calculateRatios(ReferenceDeterminant, psiMinv, TpsiM, getActiveData(), getActivePairs(),
+                                   getActiveSigns(), table_matrix, ratios_to_ref_);
 
   for (size_t iat = 0; iat < NumPtcls; iat++)
   {
@@ -319,8 +388,8 @@ void MultiDiracDeterminant::evaluateForWalkerMoveWithSpin(const ParticleSet& P,
       InverseUpdateByColumn(dpsiMinv, psiV_temp, workV1, workV2, iat, gradRatio[idim]);
       for (size_t i = 0; i < NumOrbitals; i++)
         TpsiM(i, iat) = dpsiM(iat, i)[idim];
-      buildTableMatrix_calculateGradRatios(ReferenceDeterminant, dpsiMinv, TpsiM, *detData, *uniquePairs, *DetSigns,
-                                           gradRatio[idim], table_matrix, idim, iat, grads);
+      buildTableMatrix_calculateGradRatios(ReferenceDeterminant, dpsiMinv, TpsiM, getActiveData(), getActivePairs(),
+                                           getActiveSigns(), gradRatio[idim], table_matrix, idim, iat, grads);
     }
     dpsiMinv = psiMinv;
     it       = confgList[ReferenceDeterminant].occup.begin();
@@ -329,8 +398,9 @@ void MultiDiracDeterminant::evaluateForWalkerMoveWithSpin(const ParticleSet& P,
     InverseUpdateByColumn(dpsiMinv, psiV_temp, workV1, workV2, iat, ratioLapl);
     for (size_t i = 0; i < NumOrbitals; i++)
       TpsiM(i, iat) = d2psiM(iat, i);
-    buildTableMatrix_calculateRatiosValueMatrixOneParticle(ReferenceDeterminant, dpsiMinv, TpsiM, *detData,
-                                                           *uniquePairs, *DetSigns, table_matrix, iat, lapls);
+    buildTableMatrix_calculateRatiosValueMatrixOneParticle(ReferenceDeterminant, dpsiMinv, TpsiM, getActiveData(),
+                                                           getActivePairs(), getActiveSigns(), table_matrix, iat,
+                                                           lapls);
 
     //Adding the spin gradient
     dpsiMinv = psiMinv;
@@ -340,8 +410,9 @@ void MultiDiracDeterminant::evaluateForWalkerMoveWithSpin(const ParticleSet& P,
     InverseUpdateByColumn(dpsiMinv, psiV_temp, workV1, workV2, iat, spingradRatio);
     for (size_t i = 0; i < NumOrbitals; i++)
       TpsiM(i, iat) = dspin_psiM(iat, i);
-    buildTableMatrix_calculateRatiosValueMatrixOneParticle(ReferenceDeterminant, dpsiMinv, TpsiM, *detData,
-                                                           *uniquePairs, *DetSigns, table_matrix, iat, spingrads);
+    buildTableMatrix_calculateRatiosValueMatrixOneParticle(ReferenceDeterminant, dpsiMinv, TpsiM, getActiveData(),
+                                                           getActivePairs(), getActiveSigns(), table_matrix, iat,
+                                                           spingrads);
 
     // restore matrix
     for (size_t i = 0; i < NumOrbitals; i++)
@@ -564,7 +635,8 @@ MultiDiracDeterminant::MultiDiracDeterminant(const MultiDiracDeterminant& s)
       detData(s.detData),
       uniquePairs(s.uniquePairs),
       DetSigns(s.DetSigns),
-      ndets_per_excitation_level_(s.ndets_per_excitation_level_)
+      ndets_per_excitation_level_(s.ndets_per_excitation_level_),
+      excitation_trie_(s.excitation_trie_)
 {
   resize();
 }
@@ -612,6 +684,7 @@ MultiDiracDeterminant::MultiDiracDeterminant(std::unique_ptr<SPOSet>&& spos, boo
   uniquePairs                 = std::make_shared<VectorSoaContainer<int, 2, OffloadPinnedAllocator<int>>>();
   DetSigns                    = std::make_shared<OffloadVector<RealType>>();
   ndets_per_excitation_level_ = std::make_shared<std::vector<int>>();
+  excitation_trie_            = std::make_shared<ExcitationTrie<ValueType>>();
 }
 
 ///default destructor
@@ -753,7 +826,10 @@ void MultiDiracDeterminant::resize()
   lapls.resize(NumDets, nel);
   new_lapls.resize(NumDets, nel);
   table_matrix.resize(NumOrbitals, NumOrbitals);
-  det_calculator_.resize(nel);
+  // the unique determinants outside the active subset are not written on the device, start them from zero
+  WorkSpace.updateTo();
+  ratios_to_ref_.updateTo();
+  new_ratios_to_ref_.updateTo();
 
   if (is_spinor_)
   {
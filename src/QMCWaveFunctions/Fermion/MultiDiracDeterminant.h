@@ -22,7 +22,7 @@
 #include "QMCWaveFunctions/WaveFunctionComponent.h"
 #include "QMCWaveFunctions/SPOSet.h"
 #include "QMCWaveFunctions/Fermion/ci_configuration2.h"
-#include "QMCWaveFunctions/Fermion/SmallMatrixDetCalculator.h"
+#include "QMCWaveFunctions/Fermion/ExcitationTrie.h"
 #include "Message/Communicate.h"
 #include "Numerics/DeterminantOperators.h"
 #include "ResourceCollection.h"
@@ -113,7 +113,11 @@ public:
     OffloadVector<ValueType> inv_curRatio_list;
 
     OffloadVector<ValueType> det0_grad_list;
+    OffloadVector<ValueType> vp_det0_list;
     OffloadVector<GradType> ratioGradRef_list;
+
+    /// scratch of the excitation tree used by mw_updateRatios_generic
+    ExcitationTrie<ValueType>::Workspace trie_workspace;
   };
 
   //lookup table mapping the unique determinants to their element position in C2_node vector
@@ -273,6 +277,34 @@ public:
                      const std::vector<size_t>& C2nodes_unsorted,
                      std::vector<size_t>& C2nodes_sorted);
 
+  /** excitation data of a subset of the unique determinants
+   * The layout is the one of detData, DetSigns and ndets_per_excitation_level_ restricted to the determinants of
+   * the subset. The reference determinant is always the first one.
+   */
+  struct DetSubset
+  {
+    OffloadVector<int> data;
+    VectorSoaContainer<int, 2, OffloadPinnedAllocator<int>> pairs;
+    OffloadVector<RealType> sign;
+    std::vector<int> ndets_per_excitation_level;
+    /// excitation tree of the subset, determinants are identified by their id in the full set
+    ExcitationTrie<ValueType> excitation_trie;
+    /// id in the full set of each determinant of the subset
+    OffloadVector<int> det_ids;
+  };
+
+  /** build the excitation data of the unique determinants selected by active
+   * @param active active[i] is true if the unique determinant i is evaluated. The reference one is always evaluated.
+   */
+  std::shared_ptr<const DetSubset> buildDetSubset(const std::vector<bool>& active) const;
+
+  /** restrict the evaluation to a subset of the unique determinants, nullptr to evaluate all of them
+   * Ratios, gradients and laplacians of the other unique determinants are left unchanged.
+   */
+  void setActiveDets(std::shared_ptr<const DetSubset> subset) { active_dets_ = std::move(subset); }
+  /// number of the unique determinants evaluated
+  size_t getNumActiveDets() const { return active_dets_ ? active_dets_->det_ids.size() : getNumDets(); }
+
   /** evaluate the value of all the unique determinants with one electron moved. Used by the table method
    *@param P particle set which provides the positions
    *@param iat the index of the moved electron
@@ -284,6 +316,14 @@ public:
                                          const RefVectorWithLeader<ParticleSet>& P_list,
                                          int iat);
 
+  /** multi walker version of evaluateDetsForPtclMove over all the virtual moves of each walker
+   * The reference particle of every virtual particle set must belong to this group.
+   * The table matrices and ratios of all the virtual moves of all the walkers are computed in one batch.
+   * Results of the k-th virtual move of a walker are given by getVPRatiosToRefDet(k) and getVPRefDetRatio(k).
+   */
+  void static mw_evaluateDetsForVirtualMoves(const RefVectorWithLeader<MultiDiracDeterminant>& det_list,
+                                             const RefVectorWithLeader<const VirtualParticleSet>& vp_list);
+
   /// evaluate the value and gradients of all the unique determinants with one electron moved. Used by the table method
   void evaluateDetsAndGradsForPtclMove(const ParticleSet& P, int iat);
   /// multi walker version of mw_evaluateDetsAndGradsForPtclMove
@@ -325,9 +365,29 @@ public:
   const Matrix<ValueType>& getNewSpinGrads() const { return new_spingrads; }
 
   PsiValueType getRefDetRatio() const { return static_cast<PsiValueType>(curRatio); }
+  const OffloadVector<ValueType>& getVPRatiosToRefDet(int k) const { return vp_ratios_to_ref_[k]; }
+  PsiValueType getVPRefDetRatio(int k) const { return static_cast<PsiValueType>(vp_cur_ratios_[k]); }
   LogValueType getLogValueRefDet() const { return log_value_ref_det_; }
 
 private:
+  /// excitation data of the unique determinants evaluated
+  const OffloadVector<int>& getActiveData() const { return active_dets_ ? active_dets_->data : *detData; }
+  const VectorSoaContainer<int, 2, OffloadPinnedAllocator<int>>& getActivePairs() const
+  {
+    return active_dets_ ? active_dets_->pairs : *uniquePairs;
+  }
+  const OffloadVector<RealType>& getActiveSigns() const { return active_dets_ ? active_dets_->sign : *DetSigns; }
+  const std::vector<int>& getActiveNdetsPerExcitationLevel() const
+  {
+    return active_dets_ ? active_dets_->ndets_per_excitation_level : *ndets_per_excitation_level_;
+  }
+  const ExcitationTrie<ValueType>& getActiveExcitationTrie() const
+  {
+    return active_dets_ ? active_dets_->excitation_trie : *excitation_trie_;
+  }
+  /// ids of the unique determinants evaluated, nullptr if all of them
+  const int* getActiveDetIds() const { return active_dets_ ? active_dets_->det_ids.data() : nullptr; }
+
   void mw_InverseUpdateByColumn(MultiDiracDetMultiWalkerResource& mw_res,
                                 const int working_index,
                                 const OffloadVector<ValueType>& curRatio_list,
@@ -335,20 +395,15 @@ private:
                                 const OffloadVector<ValueType*>& psiMinv_deviceptr_list,
                                 const size_t psiMinv_rows) const;
 
-  /** update ratios with respect to the reference deteriminant for a given excitation level
-   * @param ext_level excitation level
-   * @param det_offset offset of the determinant id
-   * @param data_offset offset of the "data" structure
+  /** update ratios with respect to the reference deteriminant for all the excitation levels above MaxSmallDet
+   * @param mw_res multi walker resource holding the excitation tree scratch
    * @param sign of determinants
    * @param table_matrix_list list of table_matrix
+   * @param ratios_list list of ratios
    *
-   * this is a general implementation. Support abitrary excitation level
+   * this is a general implementation using the excitation tree. Support abitrary excitation level
    */
-  void mw_updateRatios_generic(const int ext_level,
-                               const size_t det_offset,
-                               const size_t data_offset,
-                               SmallMatrixDetCalculator<ValueType>& det_calculator,
-                               const OffloadVector<int>& data,
+  void mw_updateRatios_generic(MultiDiracDetMultiWalkerResource& mw_res,
                                const OffloadVector<RealType>& sign,
                                const RefVector<OffloadMatrix<ValueType>>& table_matrix_list,
                                const RefVector<OffloadVector<ValueType>>& ratios_list) const;
@@ -363,6 +418,7 @@ private:
    * @param det_offset offset of the determinant id
    * @param data_offset offset of the "data" structure
    * @param sign of determinants
+   * @param det_ids ids of the determinants in data, nullptr if data holds all of them
    * @param table_matrix_list list of table_matrix
    *
    * this is intended to be customized based on EXT_LEVEL
@@ -372,6 +428,7 @@ private:
                        const size_t data_offset,
                        const OffloadVector<int>& data,
                        const OffloadVector<RealType>& sign,
+                       const int* det_ids,
                        const OffloadVector<ValueType*>& table_matrix_deviceptr_list,
                        const size_t num_table_matrix_cols,
                        const OffloadVector<ValueType*>& ratios_deviceptr_list) const;
@@ -559,6 +616,8 @@ private:
   OffloadMatrix<ValueType> table_matrix;
 
   OffloadVector<ValueType> WorkSpace;
+  /// scratch of the excitation tree in the single walker APIs
+  ExcitationTrie<ValueType>::Workspace trie_workspace_;
   Vector<IndexType> Pivot;
 
   ValueType* FirstAddressOfGrads;
@@ -574,6 +633,13 @@ private:
   ValueType curRatio;
   /// log value of the reference determinant
   LogValueType log_value_ref_det_;
+  /// inverse and transposed orbital matrices of the reference determinant after each virtual move
+  std::vector<OffloadMatrix<ValueType>> vp_psiMinv_, vp_TpsiM_;
+  /// table matrices and determinant ratios with respect to the reference determinant of each virtual move
+  std::vector<OffloadMatrix<ValueType>> vp_table_matrix_;
+  std::vector<OffloadVector<ValueType>> vp_ratios_to_ref_;
+  /// new value of the reference determinant over the old value of each virtual move
+  std::vector<ValueType> vp_cur_ratios_;
   /// store determinant grads (old and new)
   Matrix<GradType> grads, new_grads;
   /// store determinant lapls (old and new)
@@ -597,7 +663,10 @@ private:
    *  {1, n_singles, n_doubles, n_triples, ...}
    */
   std::shared_ptr<std::vector<int>> ndets_per_excitation_level_;
-  SmallMatrixDetCalculator<ValueType> det_calculator_;
+  /// excitation tree of the unique determinants with excitation levels above MaxSmallDet
+  std::shared_ptr<ExcitationTrie<ValueType>> excitation_trie_;
+  /// subset of the unique determinants evaluated, nullptr if all of them
+  std::shared_ptr<const DetSubset> active_dets_;
 
   /// for matrices with leading dimensions <= MaxSmallDet, compute determinant with direct expansion.
   static constexpr size_t MaxSmallDet = 5;
@@ -81,6 +81,20 @@ void MultiSlaterDetTableMethod::initialize(std::unique_ptr<std::vector<std::vect
   CI_Optimizable = CI_optimizable;
 }
 
+void MultiSlaterDetTableMethod::setCIScreening(std::shared_ptr<CIScreening> ci_screening)
+{
+  if (ci_screening && ci_screening->getNumTerms() != C->size())
+    throw std::runtime_error("MultiSlaterDetTableMethod::setCIScreening the number of terms doesn't match!");
+  ci_screening_             = std::move(ci_screening);
+  ci_screening_det_subsets_ = ci_screening_ ? std::make_shared<CIScreeningDetSubsets>() : nullptr;
+  kept_terms_               = nullptr;
+  kept_terms_generation_    = 0;
+  screening_counter_        = 0;
+  ci_screening_dets_.clear();
+  for (auto& det : Dets)
+    det->setActiveDets(nullptr);
+}
+
 MultiSlaterDetTableMethod::~MultiSlaterDetTableMethod() = default;
 
 std::unique_ptr<WaveFunctionComponent> MultiSlaterDetTableMethod::makeClone(ParticleSet& tqp) const
@@ -98,6 +112,9 @@ std::unique_ptr<WaveFunctionComponent> MultiSlaterDetTableMethod::makeClone(Part
 
   clone->csf_data_ = csf_data_;
 
+  clone->ci_screening_             = ci_screening_;
+  clone->ci_screening_det_subsets_ = ci_screening_det_subsets_;
+
   return clone;
 }
 
@@ -117,6 +134,9 @@ WaveFunctionComponent::LogValueType MultiSlaterDetTableMethod::evaluate_vgl_impl
   g_tmp                 = czero;
   l_tmp                 = czero;
 
+  if (ci_screening_ && sample_ci_screening_)
+    sampleCIScreening();
+
   for (size_t ig = 0; ig < Dets.size(); ig++)
     precomputeC_otherDs(P, ig);
 
@@ -145,6 +165,8 @@ WaveFunctionComponent::LogValueType MultiSlaterDetTableMethod::evaluateLog(const
                                                                            ParticleSet::ParticleLaplacian& L)
 {
   ScopedTimer local_timer(EvaluateTimer);
+  if (ci_screening_)
+    prepareCIScreening();
   for (size_t id = 0; id < Dets.size(); id++)
   {
     if (P.isSpinor())
@@ -328,11 +350,9 @@ WaveFunctionComponent::PsiValueType MultiSlaterDetTableMethod::evalGrad_impl_no_
   const auto& detValues0         = (newpos) ? Dets[det_id]->getNewRatiosToRefDet() : Dets[det_id]->getRatiosToRefDet();
   const size_t* restrict det0    = (*C2node)[det_id].data();
   const ValueType* restrict cptr = C->data();
-  const size_t nc                = C->size();
   const size_t noffset           = Dets[det_id]->getFirstIndex();
   PsiValueType psi(0);
-  for (size_t i = 0; i < nc; ++i)
-  {
+  forEachCITerm([&](size_t i) {
     const size_t d0 = det0[i];
     ValueType t     = cptr[i];
     for (size_t id = 0; id < Dets.size(); id++)
@@ -340,7 +360,7 @@ WaveFunctionComponent::PsiValueType MultiSlaterDetTableMethod::evalGrad_impl_no_
         t *= Dets[id]->getRatiosToRefDet()[(*C2node)[id][i]];
     psi += t * detValues0[d0];
     g_at += t * grads(d0, iat - noffset);
-  }
+  });
   g_at *= PsiValueType(1.0) / psi;
   return psi;
 }
@@ -363,11 +383,9 @@ WaveFunctionComponent::PsiValueType MultiSlaterDetTableMethod::evalGradWithSpin_
   const auto& spingrads          = (newpos) ? Dets[det_id]->getNewSpinGrads() : Dets[det_id]->getSpinGrads();
   const size_t* restrict det0    = (*C2node)[det_id].data();
   const ValueType* restrict cptr = C->data();
-  const size_t nc                = C->size();
   const size_t noffset           = Dets[det_id]->getFirstIndex();
   PsiValueType psi(0);
-  for (size_t i = 0; i < nc; ++i)
-  {
+  forEachCITerm([&](size_t i) {
     const size_t d0 = det0[i];
     ValueType t     = cptr[i];
     for (size_t id = 0; id < Dets.size(); id++)
@@ -376,7 +394,7 @@ WaveFunctionComponent::PsiValueType MultiSlaterDetTableMethod::evalGradWithSpin_
     psi += t * detValues0[d0];
     g_at += t * grads(d0, iat - noffset);
     sg_at += t * spingrads(d0, iat - noffset);
-  }
+  });
   g_at *= PsiValueType(1.0) / psi;
   sg_at *= PsiValueType(1.0) / psi;
   return psi;
@@ -507,8 +525,13 @@ void MultiSlaterDetTableMethod::mw_ratioGrad(const RefVectorWithLeader<WaveFunct
 
 WaveFunctionComponent::PsiValueType MultiSlaterDetTableMethod::computeRatio_NewMultiDet_to_NewRefDet(int det_id) const
 {
-  const auto& detValues0 = Dets[det_id]->getNewRatiosToRefDet();
+  return computeRatio_NewMultiDet_to_NewRefDet(det_id, Dets[det_id]->getNewRatiosToRefDet());
+}
 
+WaveFunctionComponent::PsiValueType MultiSlaterDetTableMethod::computeRatio_NewMultiDet_to_NewRefDet(
+    int det_id,
+    const OffloadVector<ValueType>& detValues0) const
+{
   PsiValueType psi = 0;
   if (use_pre_computing_)
   {
@@ -523,17 +546,15 @@ WaveFunctionComponent::PsiValueType MultiSlaterDetTableMethod::computeRatio_NewM
   {
     const size_t* restrict det0    = (*C2node)[det_id].data();
     const ValueType* restrict cptr = C->data();
-    const size_t nc                = C->size();
 
-    for (size_t i = 0; i < nc; ++i)
-    {
+    forEachCITerm([&](size_t i) {
       ValueType t = cptr[i];
       for (size_t id = 0; id < Dets.size(); id++)
         if (id != det_id)
           t *= Dets[id]->getRatiosToRefDet()[(*C2node)[id][i]];
       t *= detValues0[det0[i]];
       psi += t;
-    }
+    });
   }
   return psi;
 }
@@ -636,6 +657,52 @@ void MultiSlaterDetTableMethod::evaluateRatios(const VirtualParticleSet& VP, std
   }
 }
 
+void MultiSlaterDetTableMethod::mw_evaluateDetsForVirtualMoves(
+    const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+    const RefVectorWithLeader<const VirtualParticleSet>& vp_list)
+{
+  auto& wfc_leader = wfc_list.getCastedLeader<MultiSlaterDetTableMethod>();
+  for (int det_id = 0; det_id < wfc_leader.Dets.size(); det_id++)
+  {
+    RefVectorWithLeader<MultiDiracDeterminant> det_list(*wfc_leader.Dets[det_id]);
+    RefVectorWithLeader<const VirtualParticleSet> det_vp_list(vp_list.getLeader());
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+    {
+      auto& wfc = wfc_list.getCastedElement<MultiSlaterDetTableMethod>(iw);
+      if (wfc.getDetID(vp_list[iw].refPtcl) == det_id)
+      {
+        det_list.push_back(*wfc.Dets[det_id]);
+        det_vp_list.push_back(vp_list[iw]);
+      }
+    }
+    if (det_list.size() > 0)
+      MultiDiracDeterminant::mw_evaluateDetsForVirtualMoves(det_list, det_vp_list);
+  }
+}
+
+void MultiSlaterDetTableMethod::mw_evaluateRatios(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                                  const RefVectorWithLeader<const VirtualParticleSet>& vp_list,
+                                                  std::vector<std::vector<ValueType>>& ratios) const
+{
+  auto& wfc_leader = wfc_list.getCastedLeader<MultiSlaterDetTableMethod>();
+  ScopedTimer local_timer(wfc_leader.RatioTimer);
+
+  mw_evaluateDetsForVirtualMoves(wfc_list, vp_list);
+
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+  {
+    auto& wfc                    = wfc_list.getCastedElement<MultiSlaterDetTableMethod>(iw);
+    const VirtualParticleSet& VP = vp_list[iw];
+    const int det_id             = wfc.getDetID(VP.refPtcl);
+    const auto& det              = *wfc.Dets[det_id];
+    for (size_t iat = 0; iat < VP.getTotalNum(); ++iat)
+    {
+      PsiValueType psiNew = wfc.computeRatio_NewMultiDet_to_NewRefDet(det_id, det.getVPRatiosToRefDet(iat));
+      ratios[iw][iat]     = det.getVPRefDetRatio(iat) * psiNew / wfc.psi_ratio_to_ref_det_;
+    }
+  }
+}
+
 void MultiSlaterDetTableMethod::acceptMove(ParticleSet& P, int iat, bool safe_to_delay)
 {
   // this should depend on the type of update, ratio / ratioGrad
@@ -693,6 +760,8 @@ WaveFunctionComponent::LogValueType MultiSlaterDetTableMethod::updateBuffer(Part
 {
   ScopedTimer local_timer(UpdateTimer);
 
+  if (ci_screening_)
+    prepareCIScreening();
   for (size_t id = 0; id < Dets.size(); id++)
     Dets[id]->updateBuffer(P, buf, fromscratch);
 
@@ -994,13 +1063,19 @@ void MultiSlaterDetTableMethod::evaluateDerivativesMSD(const PsiValueType& multi
                                                        Vector<ValueType>& dlogpsi,
                                                        int det_id) const
 {
-  const bool newpos = det_id < 0 ? false : true;
   // when not using a new position, the result doesn't get affected by det_id, thus choose 0.
   if (det_id < 0)
-    det_id = 0;
+    evaluateDerivativesMSD(multi_det_to_ref, Dets[0]->getRatiosToRefDet(), 0, dlogpsi);
+  else
+    evaluateDerivativesMSD(multi_det_to_ref, Dets[det_id]->getNewRatiosToRefDet(), det_id, dlogpsi);
+}
 
-  ValueType psiinv       = static_cast<ValueType>(PsiValueType(1.0) / multi_det_to_ref);
-  const auto& detValues0 = newpos ? Dets[det_id]->getNewRatiosToRefDet() : Dets[det_id]->getRatiosToRefDet();
+void MultiSlaterDetTableMethod::evaluateDerivativesMSD(const PsiValueType& multi_det_to_ref,
+                                                       const OffloadVector<ValueType>& detValues0,
+                                                       int det_id,
+                                                       Vector<ValueType>& dlogpsi) const
+{
+  ValueType psiinv = static_cast<ValueType>(PsiValueType(1.0) / multi_det_to_ref);
 
   if (csf_data_) // CSF
   {
@@ -1043,18 +1118,8 @@ void MultiSlaterDetTableMethod::evaluateDerivRatios(const VirtualParticleSet& VP
                                                     std::vector<ValueType>& ratios,
                                                     Matrix<ValueType>& dratios)
 {
-  const int det_id = getDetID(VP.refPtcl);
-
-  bool recalculate(false);
-  if (CI_Optimizable)
-    for (int k = 0; k < myVars->size(); ++k)
-    {
-      int kk = myVars->where(k);
-      if (kk < 0)
-        continue;
-      if (optvars.recompute(kk))
-        recalculate = true;
-    }
+  const int det_id       = getDetID(VP.refPtcl);
+  const bool recalculate = recomputeCIDerivatives(optvars);
 
   // calculate derivatives based on the reference electron position
   Vector<ValueType> dlogpsi_ref, dlogpsi_vp;
@@ -1089,6 +1154,70 @@ void MultiSlaterDetTableMethod::evaluateDerivRatios(const VirtualParticleSet& VP
   }
 }
 
+void MultiSlaterDetTableMethod::mw_evaluateDerivRatios(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                                       const RefVectorWithLeader<const VirtualParticleSet>& vp_list,
+                                                       const opt_variables_type& optvars,
+                                                       std::vector<std::vector<ValueType>>& ratios,
+                                                       const RefVector<Matrix<ValueType>>& dratios_list) const
+{
+  mw_evaluateDetsForVirtualMoves(wfc_list, vp_list);
+
+  Vector<ValueType> dlogpsi_ref, dlogpsi_vp;
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+  {
+    auto& wfc                    = wfc_list.getCastedElement<MultiSlaterDetTableMethod>(iw);
+    const VirtualParticleSet& VP = vp_list[iw];
+    const int det_id             = wfc.getDetID(VP.refPtcl);
+    const auto& det              = *wfc.Dets[det_id];
+    const bool recalculate       = wfc.recomputeCIDerivatives(optvars);
+    Matrix<ValueType>& dratios   = dratios_list[iw];
+
+    // calculate derivatives based on the reference electron position
+    if (recalculate)
+      wfc.evaluateDerivativesMSD(wfc.psi_ratio_to_ref_det_, dlogpsi_ref);
+
+    for (size_t iat = 0; iat < VP.getTotalNum(); ++iat)
+    {
+      const OffloadVector<ValueType>& detValues0 = det.getVPRatiosToRefDet(iat);
+
+      // calculate VP ratios
+      PsiValueType psiNew = wfc.computeRatio_NewMultiDet_to_NewRefDet(det_id, detValues0);
+      ratios[iw][iat]     = det.getVPRefDetRatio(iat) * psiNew / wfc.psi_ratio_to_ref_det_;
+
+      // calculate VP ratios derivatives
+      if (recalculate)
+      {
+        wfc.evaluateDerivativesMSD(psiNew, detValues0, det_id, dlogpsi_vp);
+
+        const size_t nparams = csf_data_ ? csf_data_->coeffs.size() - 1 : C->size() - 1;
+        assert(dlogpsi_vp.size() == nparams);
+
+        for (int i = 0; i < nparams; i++)
+        {
+          int kk = myVars->where(i);
+          if (kk < 0)
+            continue;
+          dratios[iat][kk] = dlogpsi_vp[i] - dlogpsi_ref[i];
+        }
+      }
+    }
+  }
+}
+
+bool MultiSlaterDetTableMethod::recomputeCIDerivatives(const opt_variables_type& optvars) const
+{
+  if (CI_Optimizable)
+    for (int k = 0; k < myVars->size(); ++k)
+    {
+      int kk = myVars->where(k);
+      if (kk < 0)
+        continue;
+      if (optvars.recompute(kk))
+        return true;
+    }
+  return false;
+}
+
 void MultiSlaterDetTableMethod::evaluateMultiDiracDeterminantDerivativesWF(ParticleSet& P,
                                                                            const opt_variables_type& optvars,
                                                                            Vector<ValueType>& dlogpsi)
@@ -1172,19 +1301,85 @@ void MultiSlaterDetTableMethod::precomputeC_otherDs(const ParticleSet& P, int ig
   ScopedTimer local_timer(PrepareGroupTimer);
   C_otherDs[ig].resize(Dets[ig]->getNumDets());
   std::fill(C_otherDs[ig].begin(), C_otherDs[ig].end(), ValueType(0));
-  for (size_t i = 0; i < C->size(); i++)
-  {
+  forEachCITerm([&](size_t i) {
     // enforce full precision reduction on C_otherDs due to numerical sensitivity
     PsiValueType product = (*C)[i];
     for (size_t id = 0; id < Dets.size(); id++)
       if (id != ig)
         product *= Dets[id]->getRatiosToRefDet()[(*C2node)[id][i]];
     C_otherDs[ig][(*C2node)[ig][i]] += product;
-  }
+  });
   //put C_otherDs in device
   C_otherDs[ig].updateTo();
 }
 
+void MultiSlaterDetTableMethod::prepareCIScreening()
+{
+  // a new list of kept terms takes effect here, before all the ratios of its unique determinants are recomputed
+  if (kept_terms_generation_ != ci_screening_->getGeneration())
+  {
+    kept_terms_generation_ = ci_screening_->getGeneration();
+    kept_terms_            = ci_screening_->getKeptTerms();
+    ci_screening_dets_     = getCIScreeningDetSubsets();
+  }
+
+  // a sampled configuration evaluates all the unique determinants to validate the truncation
+  sample_ci_screening_ = ++screening_counter_ >= ci_screening_->getSampleInterval();
+  if (sample_ci_screening_)
+    screening_counter_ = 0;
+  for (size_t id = 0; id < Dets.size(); id++)
+    Dets[id]->setActiveDets(sample_ci_screening_ || ci_screening_dets_.empty() ? nullptr : ci_screening_dets_[id]);
+}
+
+std::vector<std::shared_ptr<const MultiDiracDeterminant::DetSubset>> MultiSlaterDetTableMethod::
+    getCIScreeningDetSubsets() const
+{
+  if (!kept_terms_)
+    return {};
+
+  std::lock_guard<std::mutex> lock(ci_screening_det_subsets_->mutex);
+  auto& shared_subsets = *ci_screening_det_subsets_;
+  if (shared_subsets.kept_terms != kept_terms_)
+  {
+    shared_subsets.subsets.clear();
+    for (size_t id = 0; id < Dets.size(); id++)
+    {
+      std::vector<bool> active(Dets[id]->getNumDets(), false);
+      for (size_t i : *kept_terms_)
+        active[(*C2node)[id][i]] = true;
+      shared_subsets.subsets.push_back(Dets[id]->buildDetSubset(active));
+    }
+    shared_subsets.kept_terms = kept_terms_;
+  }
+  return shared_subsets.subsets;
+}
+
+void MultiSlaterDetTableMethod::sampleCIScreening()
+{
+  // all the terms are evaluated, the dropped ones included, to validate the truncation
+  ci_term_values_.resize(C->size());
+  PsiValueType psi_all(0), psi_kept(0);
+  for (size_t i = 0; i < C->size(); i++)
+  {
+    PsiValueType t = (*C)[i];
+    for (size_t id = 0; id < Dets.size(); id++)
+      t *= Dets[id]->getRatiosToRefDet()[(*C2node)[id][i]];
+    ci_term_values_[i] = t;
+    psi_all += t;
+  }
+  forEachCITerm([&](size_t i) { psi_kept += ci_term_values_[i]; });
+
+  const RealType psi_inv = RealType(1) / std::abs(psi_all);
+  ci_screening_->accumulate([&](size_t i) { return std::abs(ci_term_values_[i]) * psi_inv; },
+                            std::abs(psi_all - psi_kept) * psi_inv);
+
+  // particle moves only need the unique determinants of the kept terms
+  sample_ci_screening_ = false;
+  if (!ci_screening_dets_.empty())
+    for (size_t id = 0; id < Dets.size(); id++)
+      Dets[id]->setActiveDets(ci_screening_dets_[id]);
+}
+
 void MultiSlaterDetTableMethod::createResource(ResourceCollection& collection) const
 {
   collection.addResource(std::make_unique<MultiSlaterDetTableMethodMultiWalkerResource>());
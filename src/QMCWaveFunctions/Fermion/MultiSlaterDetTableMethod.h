@@ -18,6 +18,7 @@
 #include <Configuration.h>
 #include "QMCWaveFunctions/WaveFunctionComponent.h"
 #include "QMCWaveFunctions/Fermion/MultiDiracDeterminant.h"
+#include "QMCWaveFunctions/Fermion/CIScreening.h"
 #include "Utilities/TimerManager.h"
 #include "Platforms/PinnedAllocator.h"
 #include "OMPTarget/OffloadAlignedAllocators.hpp"
@@ -152,6 +153,10 @@ public:
 
   void evaluateRatios(const VirtualParticleSet& VP, std::vector<ValueType>& ratios) override;
 
+  void mw_evaluateRatios(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                         const RefVectorWithLeader<const VirtualParticleSet>& vp_list,
+                         std::vector<std::vector<ValueType>>& ratios) const override;
+
   void evaluateRatiosAlltoOne(ParticleSet& P, std::vector<ValueType>& ratios) override
   {
     // the base class routine may probably work, just never tested.
@@ -191,6 +196,12 @@ public:
                            std::vector<ValueType>& ratios,
                            Matrix<ValueType>& dratios) override;
 
+  void mw_evaluateDerivRatios(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                              const RefVectorWithLeader<const VirtualParticleSet>& vp_list,
+                              const opt_variables_type& optvars,
+                              std::vector<std::vector<ValueType>>& ratios,
+                              const RefVector<Matrix<ValueType>>& dratios_list) const override;
+
   /** initialize a few objects and states by the builder
    * YL: it should be part of the constructor. It cannot be added to the constructor
    * because the constructor is used by makeClone. The right way of fix needs:
@@ -204,6 +215,20 @@ public:
                   bool optimizable,
                   bool CI_optimizable);
 
+  /** enable runtime screening of the CI terms. The screening object is shared with the clones.
+   * Not compatible with optimization.
+   */
+  void setCIScreening(std::shared_ptr<CIScreening> ci_screening);
+  const std::shared_ptr<CIScreening>& getCIScreening() const { return ci_screening_; }
+  /// number of the unique determinants evaluated at particle moves, summed over the groups
+  size_t getNumActiveDets() const
+  {
+    size_t num_dets = 0;
+    for (auto& det : Dets)
+      num_dets += det->getNumActiveDets();
+    return num_dets;
+  }
+
 private:
   //get Det ID. It should be consistent with particle group id within the particle set.
   inline int getDetID(const int iat) const
@@ -242,6 +267,38 @@ private:
 
   // compute the new multi determinant to reference determinant ratio based on temporarycoordinates.
   PsiValueType computeRatio_NewMultiDet_to_NewRefDet(int det_id) const;
+  /// the same as above with the new ratios to the reference determinant of the det_id group given
+  PsiValueType computeRatio_NewMultiDet_to_NewRefDet(int det_id, const OffloadVector<ValueType>& detValues0) const;
+
+  /** evaluate the unique determinants of all the virtual moves of multiple walkers
+   * walkers are batched by the group of their reference particle
+   */
+  static void mw_evaluateDetsForVirtualMoves(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                             const RefVectorWithLeader<const VirtualParticleSet>& vp_list);
+
+  /// true if any CI coefficient needs derivatives with respect to optvars
+  bool recomputeCIDerivatives(const opt_variables_type& optvars) const;
+
+  /// loop over the CI terms, only the kept ones when screening
+  template<typename F>
+  inline void forEachCITerm(F&& f) const
+  {
+    if (kept_terms_)
+      for (size_t i : *kept_terms_)
+        f(i);
+    else
+      for (size_t i = 0; i < C->size(); i++)
+        f(i);
+  }
+
+  /** pick up the latest kept terms of the CI screening before a full evaluation of the unique determinants
+   * The unique determinants are restricted to the ones of the kept terms unless the configuration is sampled.
+   */
+  void prepareCIScreening();
+  /// the unique determinants of the kept terms of the CI screening, built once per generation for all the clones
+  std::vector<std::shared_ptr<const MultiDiracDeterminant::DetSubset>> getCIScreeningDetSubsets() const;
+  /// accumulate the contributions of the CI terms at the current configuration
+  void sampleCIScreening();
 
   /** precompute C_otherDs for a given particle group
    * @param P a particle set
@@ -264,6 +321,11 @@ private:
    * @param det_id provide this argument to affect determinant group id for virtual moves
    */
   void evaluateDerivativesMSD(const PsiValueType& multi_det_to_ref, Vector<ValueType>& dlogpsi, int det_id = -1) const;
+  /// the same as above with the new ratios to the reference determinant of the det_id group given
+  void evaluateDerivativesMSD(const PsiValueType& multi_det_to_ref,
+                              const OffloadVector<ValueType>& detValues0,
+                              int det_id,
+                              Vector<ValueType>& dlogpsi) const;
 
   /// determinant collection
   std::vector<std::unique_ptr<MultiDiracDeterminant>> Dets;
@@ -282,6 +344,31 @@ private:
   /// CSF data set. If nullptr, not using CSF
   std::shared_ptr<CSFData> csf_data_;
 
+  /// runtime CI screening shared with the clones. If nullptr, not screening
+  std::shared_ptr<CIScreening> ci_screening_;
+  /// the CI terms in use, nullptr if all of them
+  std::shared_ptr<const std::vector<size_t>> kept_terms_;
+  /// generation of kept_terms_
+  size_t kept_terms_generation_ = 0;
+  /// number of full evaluations since this walker was last sampled for screening
+  size_t screening_counter_ = 0;
+  /// if true, all the unique determinants are evaluated and the current configuration is sampled
+  bool sample_ci_screening_ = false;
+  /// value of each CI term at the sampled configuration
+  std::vector<PsiValueType> ci_term_values_;
+  /// unique determinants of the kept terms of each group, empty if all of them
+  std::vector<std::shared_ptr<const MultiDiracDeterminant::DetSubset>> ci_screening_dets_;
+
+  /// the unique determinants of the kept terms shared with the clones
+  struct CIScreeningDetSubsets
+  {
+    std::mutex mutex;
+    /// the kept terms the subsets are built for
+    std::shared_ptr<const std::vector<size_t>> kept_terms;
+    std::vector<std::shared_ptr<const MultiDiracDeterminant::DetSubset>> subsets;
+  };
+  std::shared_ptr<CIScreeningDetSubsets> ci_screening_det_subsets_;
+
   ///the last particle of each group
   std::vector<int> Last;
   ///use pre-compute (fast) algorithm
@@ -606,10 +606,38 @@ std::unique_ptr<MultiSlaterDetTableMethod> SlaterDetBuilder::createMSDFast(
     Optimizable = true;
   }
 
+  RealType screening_tolerance = 0.0;
+  int screening_samples        = 1000;
+  int screening_interval       = 10;
+  OhmmsAttributeSet screeningAttrib;
+  screeningAttrib.add(screening_tolerance, "screening_tolerance");
+  screeningAttrib.add(screening_samples, "screening_samples");
+  screeningAttrib.add(screening_interval, "screening_interval");
+  screeningAttrib.put(cur);
+
+  const size_t nterms = C.size();
+
   auto msd_fast = std::make_unique<MultiSlaterDetTableMethod>(targetPtcl, std::move(dets), use_precompute);
   msd_fast->initialize(std::move(C2nodes_sorted_ptr), std::move(C_ptr), std::move(myVars_ptr), std::move(csf_data_ptr),
                        Optimizable, CI_Optimizable);
 
+  if (screening_tolerance > 0)
+  {
+    if (Optimizable)
+      app_warning() << "Runtime CI screening is disabled because the multideterminant wavefunction is optimizable."
+                    << std::endl;
+    else
+    {
+      if (screening_samples <= 0 || screening_interval <= 0)
+        myComm->barrier_and_abort("screening_samples and screening_interval must be positive!");
+      app_summary() << "    Runtime CI screening with target relative error " << screening_tolerance << std::endl;
+      app_summary() << "      updated every " << screening_samples << " samples taken every " << screening_interval
+                    << " full evaluations of each walker" << std::endl;
+      msd_fast->setCIScreening(
+          std::make_shared<CIScreening>(nterms, screening_tolerance, screening_samples, screening_interval));
+    }
+  }
+
   return msd_fast;
 }
 
@@ -97,6 +97,135 @@ std::unique_ptr<WaveFunctionComponent> SlaterDetWithBackflow::makeClone(Particle
   return myclone;
 }
 
+RefVectorWithLeader<BackflowTransformation> SlaterDetWithBackflow::extractBFRefList(
+    const RefVectorWithLeader<WaveFunctionComponent>& wfc_list)
+{
+  RefVectorWithLeader<BackflowTransformation> bf_list(*wfc_list.getCastedLeader<SlaterDetWithBackflow>().BFTrans);
+  bf_list.reserve(wfc_list.size());
+  for (WaveFunctionComponent& wfc : wfc_list)
+    bf_list.push_back(*static_cast<SlaterDetWithBackflow&>(wfc).BFTrans);
+  return bf_list;
+}
+
+RefVectorWithLeader<WaveFunctionComponent> SlaterDetWithBackflow::extractDetRefList(
+    const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+    int det_id)
+{
+  RefVectorWithLeader<WaveFunctionComponent> det_list(*wfc_list.getCastedLeader<SlaterDetWithBackflow>().Dets[det_id]);
+  det_list.reserve(wfc_list.size());
+  for (WaveFunctionComponent& wfc : wfc_list)
+    det_list.push_back(*static_cast<SlaterDetWithBackflow&>(wfc).Dets[det_id]);
+  return det_list;
+}
+
+void SlaterDetWithBackflow::mw_evaluateLogImpl(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                               const RefVectorWithLeader<ParticleSet>& p_list,
+                                               const RefVector<ParticleSet::ParticleGradient>& G_list,
+                                               const RefVector<ParticleSet::ParticleLaplacian>& L_list) const
+{
+  BackflowTransformation::mw_evaluate(extractBFRefList(wfc_list), p_list);
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+  {
+    auto& det_bf = wfc_list.getCastedElement<SlaterDetWithBackflow>(iw);
+    det_bf.log_value_ = 0.0;
+    for (int i = 0; i < Dets.size(); ++i)
+      det_bf.log_value_ += det_bf.Dets[i]->evaluateLog(p_list[iw], G_list[iw], L_list[iw]);
+  }
+}
+
+void SlaterDetWithBackflow::mw_evaluateLog(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                           const RefVectorWithLeader<ParticleSet>& p_list,
+                                           const RefVector<ParticleSet::ParticleGradient>& G_list,
+                                           const RefVector<ParticleSet::ParticleLaplacian>& L_list) const
+{
+  mw_evaluateLogImpl(wfc_list, p_list, G_list, L_list);
+}
+
+void SlaterDetWithBackflow::mw_evaluateGL(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                          const RefVectorWithLeader<ParticleSet>& p_list,
+                                          const RefVector<ParticleSet::ParticleGradient>& G_list,
+                                          const RefVector<ParticleSet::ParticleLaplacian>& L_list,
+                                          bool fromscratch) const
+{
+  // evaluateGL is always from scratch with backflow
+  mw_evaluateLogImpl(wfc_list, p_list, G_list, L_list);
+}
+
+void SlaterDetWithBackflow::mw_calcRatio(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                         const RefVectorWithLeader<ParticleSet>& p_list,
+                                         int iat,
+                                         std::vector<PsiValueType>& ratios) const
+{
+  BackflowTransformation::mw_evaluatePbyP(extractBFRefList(wfc_list), p_list, iat);
+  std::fill(ratios.begin(), ratios.end(), PsiValueType(1));
+  std::vector<PsiValueType> det_ratios(wfc_list.size());
+  for (int i = 0; i < Dets.size(); ++i)
+  {
+    Dets[i]->mw_calcRatio(extractDetRefList(wfc_list, i), p_list, iat, det_ratios);
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+      ratios[iw] *= det_ratios[iw];
+  }
+}
+
+void SlaterDetWithBackflow::mw_ratioGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                         const RefVectorWithLeader<ParticleSet>& p_list,
+                                         int iat,
+                                         std::vector<PsiValueType>& ratios,
+                                         std::vector<GradType>& grad_new) const
+{
+  BackflowTransformation::mw_evaluatePbyPWithGrad(extractBFRefList(wfc_list), p_list, iat);
+  std::fill(ratios.begin(), ratios.end(), PsiValueType(1));
+  std::vector<PsiValueType> det_ratios(wfc_list.size());
+  // every determinant contributes to the gradient of a moved particle via the quasi-particles
+  for (int i = 0; i < Dets.size(); ++i)
+  {
+    Dets[i]->mw_ratioGrad(extractDetRefList(wfc_list, i), p_list, iat, det_ratios, grad_new);
+    for (int iw = 0; iw < wfc_list.size(); iw++)
+      ratios[iw] *= det_ratios[iw];
+  }
+}
+
+void SlaterDetWithBackflow::mw_accept_rejectMove(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                                 const RefVectorWithLeader<ParticleSet>& p_list,
+                                                 int iat,
+                                                 const std::vector<bool>& isAccepted,
+                                                 bool safe_to_delay) const
+{
+  BackflowTransformation::mw_accept_rejectMove(extractBFRefList(wfc_list), p_list, iat, isAccepted);
+  for (int i = 0; i < Dets.size(); ++i)
+    Dets[i]->mw_accept_rejectMove(extractDetRefList(wfc_list, i), p_list, iat, isAccepted, safe_to_delay);
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+  {
+    auto& bf_det      = wfc_list.getCastedElement<SlaterDetWithBackflow>(iw);
+    bf_det.log_value_ = 0.0;
+    for (int i = 0; i < Dets.size(); ++i)
+      bf_det.log_value_ += bf_det.Dets[i]->get_log_value();
+  }
+}
+
+void SlaterDetWithBackflow::createResource(ResourceCollection& collection) const
+{
+  BFTrans->createResource(collection);
+  for (int i = 0; i < Dets.size(); ++i)
+    Dets[i]->createResource(collection);
+}
+
+void SlaterDetWithBackflow::acquireResource(ResourceCollection& collection,
+                                            const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const
+{
+  BackflowTransformation::acquireResource(collection, extractBFRefList(wfc_list));
+  for (int i = 0; i < Dets.size(); ++i)
+    Dets[i]->acquireResource(collection, extractDetRefList(wfc_list, i));
+}
+
+void SlaterDetWithBackflow::releaseResource(ResourceCollection& collection,
+                                            const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const
+{
+  BackflowTransformation::releaseResource(collection, extractBFRefList(wfc_list));
+  for (int i = 0; i < Dets.size(); ++i)
+    Dets[i]->releaseResource(collection, extractDetRefList(wfc_list, i));
+}
+
 void SlaterDetWithBackflow::testDerivGL(ParticleSet& P)
 {
   // testing derivatives of G and L
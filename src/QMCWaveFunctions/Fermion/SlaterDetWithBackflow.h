@@ -99,8 +99,12 @@ public:
   inline void acceptMove(ParticleSet& P, int iat, bool safe_to_delay = false) override
   {
     BFTrans->acceptMove(P, iat);
+    log_value_ = 0.0;
     for (int i = 0; i < Dets.size(); i++)
+    {
       Dets[i]->acceptMove(P, iat);
+      log_value_ += Dets[i]->get_log_value();
+    }
   }
 
   inline void restore(int iat) override
@@ -121,6 +125,45 @@ public:
     return ratio;
   }
 
+  /* The multi walker functions below batch the quasi-particle distance table updates and, in mw_calcRatio and
+   * mw_ratioGrad, the orbital evaluation of the moved quasi-particles grouped by quasi-particle. The backflow
+   * transformation (newQP, Amat, dAmat), the low rank inverse update of each determinant and mw_evaluateLog still
+   * run the single walker code per walker.
+   */
+  void mw_evaluateLog(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                      const RefVectorWithLeader<ParticleSet>& p_list,
+                      const RefVector<ParticleSet::ParticleGradient>& G_list,
+                      const RefVector<ParticleSet::ParticleLaplacian>& L_list) const override;
+
+  void mw_evaluateGL(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                     const RefVectorWithLeader<ParticleSet>& p_list,
+                     const RefVector<ParticleSet::ParticleGradient>& G_list,
+                     const RefVector<ParticleSet::ParticleLaplacian>& L_list,
+                     bool fromscratch) const override;
+
+  void mw_calcRatio(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios) const override;
+
+  void mw_ratioGrad(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                    const RefVectorWithLeader<ParticleSet>& p_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios,
+                    std::vector<GradType>& grad_new) const override;
+
+  void mw_accept_rejectMove(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                            const RefVectorWithLeader<ParticleSet>& p_list,
+                            int iat,
+                            const std::vector<bool>& isAccepted,
+                            bool safe_to_delay = false) const override;
+
+  void createResource(ResourceCollection& collection) const override;
+  void acquireResource(ResourceCollection& collection,
+                       const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const override;
+  void releaseResource(ResourceCollection& collection,
+                       const RefVectorWithLeader<WaveFunctionComponent>& wfc_list) const override;
+
   std::unique_ptr<WaveFunctionComponent> makeClone(ParticleSet& tqp) const override;
 
   SPOSetPtr getPhi(int i = 0) const { return Dets[i]->getPhi(); }
@@ -135,6 +178,18 @@ public:
   void testDerivGL(ParticleSet& P);
 
 private:
+  /// evaluate the log of multiple walkers after their backflow transformations are evaluated in a batch
+  void mw_evaluateLogImpl(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                          const RefVectorWithLeader<ParticleSet>& p_list,
+                          const RefVector<ParticleSet::ParticleGradient>& G_list,
+                          const RefVector<ParticleSet::ParticleLaplacian>& L_list) const;
+
+  static RefVectorWithLeader<BackflowTransformation> extractBFRefList(
+      const RefVectorWithLeader<WaveFunctionComponent>& wfc_list);
+  static RefVectorWithLeader<WaveFunctionComponent> extractDetRefList(
+      const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+      int det_id);
+
   ///container for the DiracDeterminants
   const std::vector<std::unique_ptr<Determinant_t>> Dets;
   /// backflow transformation
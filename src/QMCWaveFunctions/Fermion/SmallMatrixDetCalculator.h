@@ -20,27 +20,17 @@
 #ifndef QMCPLUSPLUS_MULTIDIRACDETERMINANTCALCULATOR_H
 #define QMCPLUSPLUS_MULTIDIRACDETERMINANTCALCULATOR_H
 
-#include "OhmmsPETE/OhmmsMatrix.h"
-#include "Numerics/DeterminantOperators.h"
+#include <cstddef>
+#include <stdexcept>
 
 namespace qmcplusplus
 {
-/** Function class calculates multi determinant ratio from matrix elements
- *  needs to be the size of your result matrix or larger
- *  includes manual expansions for smaller evaluations
+/** Function class with manual expansions of the determinants of small matrices
+ *  larger excitations are evaluated by ExcitationTrie
  */
 template<typename T>
 struct SmallMatrixDetCalculator
 {
-  std::vector<T> M;
-  std::vector<int> Pivot;
-
-  void resize(int n)
-  {
-    M.resize(n * n);
-    Pivot.resize(n);
-  }
-
   static T evaluate(T a11, T a12, T a21, T a22) { return a11 * a22 - a21 * a12; }
 
   static T evaluate(T a11, T a12, T a13, T a21, T a22, T a23, T a31, T a32, T a33)
@@ -124,27 +114,6 @@ struct SmallMatrixDetCalculator
              a32 * (a13 * (a24 * a45 - a44 * a25) - a23 * (a14 * a45 - a44 * a15) + a43 * (a14 * a25 - a24 * a15)) -
              a42 * (a13 * (a24 * a35 - a34 * a25) - a23 * (a14 * a35 - a34 * a15) + a33 * (a14 * a25 - a24 * a15))));
   }
-
-  /** default implementation of MultiDiracDeterminant::CustomizedMatrixDet
-   *  If you don't have a perfect square below 25 of dots this is what you hit
-   *  dots must be a 2n by 2n Matrix
-   *  iter must be size n^2
-   *  this object must have been resized to n
-   */
-  template<typename DT>
-  using OffloadMatrix = Matrix<DT, OffloadPinnedAllocator<DT>>;
-  template<typename ITER>
-  inline T evaluate(const OffloadMatrix<T>& dots, ITER it, int n)
-  {
-    typename std::vector<T>::iterator d = M.begin();
-    for (int i = 0; i < n; i++)
-      for (int j = 0; j < n; j++)
-      {
-        //performance through proper iterator indistiquishable from data pointer
-        *(d++) = dots(*(it + i), *(it + n + j));
-      }
-    return Determinant(M.data(), n, n, Pivot.data());
-  }
 };
 
 template<unsigned NEXCITED>
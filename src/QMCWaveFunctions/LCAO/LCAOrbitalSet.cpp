@@ -126,6 +126,61 @@ void LCAOrbitalSet::releaseResource(ResourceCollection& collection, const RefVec
 
 std::unique_ptr<SPOSet> LCAOrbitalSet::makeClone() const { return std::make_unique<LCAOrbitalSet>(*this); }
 
+/** Find a better place for other user classes, Matrix should be padded as well */
+template<typename T, unsigned D>
+inline void Product_ABt(const VectorSoaContainer<T, D>& A, const Matrix<T>& B, VectorSoaContainer<T, D>& C)
+{
+  constexpr char transa = 't';
+  constexpr char transb = 'n';
+  constexpr T zone(1);
+  constexpr T zero(0);
+  BLAS::gemm(transa, transb, B.rows(), D, B.cols(), zone, B.data(), B.cols(), A.data(), A.capacity(), zero, C.data(),
+             C.capacity());
+}
+
+/** out(n, orb) = sum_b basis(n, b) * C(orb, b) restricted to the basis ranges [first, last)
+ * @param norb number of orbitals, the rows of C
+ * @param n number of rows of basis and out
+ */
+template<typename T>
+inline void gemmBasisRanges(const std::vector<std::pair<int, int>>& ranges,
+                            size_t norb,
+                            size_t n,
+                            const T* C,
+                            size_t ldc,
+                            const T* basis,
+                            size_t ldbasis,
+                            T* out,
+                            size_t ldout)
+{
+  if (ranges.empty())
+  {
+    for (size_t i = 0; i < n; i++)
+      std::fill_n(out + i * ldout, norb, T(0));
+    return;
+  }
+  T beta(0);
+  for (const auto& [first, last] : ranges)
+  {
+    BLAS::gemm('T', 'N', norb, n, last - first, T(1), C + first, ldc, basis + first, ldbasis, beta, out, ldout);
+    beta = T(1);
+  }
+}
+
+/** Product_ABt skipping the columns of A outside the active basis ranges, see SoaBasisSetBase::getActiveBasisRanges
+ */
+template<typename T, unsigned D>
+inline void Product_ABt(const VectorSoaContainer<T, D>& A,
+                        const Matrix<T>& B,
+                        VectorSoaContainer<T, D>& C,
+                        const std::vector<std::pair<int, int>>* ranges)
+{
+  if (ranges)
+    gemmBasisRanges(*ranges, B.rows(), D, B.data(), B.cols(), A.data(), A.capacity(), C.data(), C.capacity());
+  else
+    Product_ABt(A, B, C);
+}
+
 void LCAOrbitalSet::evaluateValue(const ParticleSet& P, int iat, ValueVector& psi)
 {
   if (Identity)
@@ -138,21 +193,14 @@ void LCAOrbitalSet::evaluateValue(const ParticleSet& P, int iat, ValueVector& ps
     myBasisSet->evaluateV(P, iat, vTemp.data());
     assert(psi.size() <= OrbitalSetSize);
     ValueMatrix C_partial_view(C->data(), psi.size(), BasisSetSize);
-    MatrixOperators::product(C_partial_view, vTemp, psi);
+    if (auto ranges = myBasisSet->getActiveBasisRanges(); ranges)
+      gemmBasisRanges(*ranges, psi.size(), 1, C->data(), BasisSetSize, vTemp.data(), BasisSetSize, psi.data(),
+                      psi.size());
+    else
+      MatrixOperators::product(C_partial_view, vTemp, psi);
   }
 }
 
-/** Find a better place for other user classes, Matrix should be padded as well */
-template<typename T, unsigned D>
-inline void Product_ABt(const VectorSoaContainer<T, D>& A, const Matrix<T>& B, VectorSoaContainer<T, D>& C)
-{
-  constexpr char transa = 't';
-  constexpr char transb = 'n';
-  constexpr T zone(1);
-  constexpr T zero(0);
-  BLAS::gemm(transa, transb, B.rows(), D, B.cols(), zone, B.data(), B.cols(), A.data(), A.capacity(), zero, C.data(),
-             C.capacity());
-}
 
 inline void LCAOrbitalSet::evaluate_vgl_impl(const vgl_type& temp,
                                              ValueVector& psi,
@@ -387,7 +435,7 @@ void LCAOrbitalSet::evaluateVGL(const ParticleSet& P, int iat, ValueVector& psi,
     {
       ScopedTimer local(mo_timer_);
       ValueMatrix C_partial_view(C->data(), psi.size(), BasisSetSize);
-      Product_ABt(Temp, C_partial_view, Tempv);
+      Product_ABt(Temp, C_partial_view, Tempv, myBasisSet->getActiveBasisRanges());
     }
     evaluate_vgl_impl(Tempv, psi, dpsi, d2psi);
   }
@@ -456,12 +504,16 @@ void LCAOrbitalSet::mw_evaluateVGLImplGEMM(const RefVectorWithLeader<SPOSet>& sp
       ValueMatrix C_partial_view(C->data(), requested_orb_size, BasisSetSize);
       // TODO: make class for general blas interface in Platforms
       // have instance of that class as member of LCAOrbitalSet, call gemm through that
-      BLAS::gemm('T', 'N',
-                 requested_orb_size,        // MOs
-                 spo_list.size() * DIM_VGL, // walkers * DIM_VGL
-                 BasisSetSize,              // AOs
-                 1, C_partial_view.data(), BasisSetSize, basis_mw.data(), BasisSetSize, 0, phi_vgl_v.data(),
-                 requested_orb_size);
+      if (auto ranges = myBasisSet->getActiveBasisRanges(); ranges)
+        gemmBasisRanges(*ranges, requested_orb_size, spo_list.size() * DIM_VGL, C_partial_view.data(), BasisSetSize,
+                        basis_mw.data(), BasisSetSize, phi_vgl_v.data(), requested_orb_size);
+      else
+        BLAS::gemm('T', 'N',
+                   requested_orb_size,        // MOs
+                   spo_list.size() * DIM_VGL, // walkers * DIM_VGL
+                   BasisSetSize,              // AOs
+                   1, C_partial_view.data(), BasisSetSize, basis_mw.data(), BasisSetSize, 0, phi_vgl_v.data(),
+                   requested_orb_size);
     }
   }
 }
@@ -506,12 +558,16 @@ void LCAOrbitalSet::mw_evaluateValueImplGEMM(const RefVectorWithLeader<SPOSet>&
     const size_t requested_orb_size = phi_v.size(1);
     assert(requested_orb_size <= OrbitalSetSize);
     ValueMatrix C_partial_view(C->data(), requested_orb_size, BasisSetSize);
-    BLAS::gemm('T', 'N',
-               requested_orb_size, // MOs
-               spo_list.size(),    // walkers
-               BasisSetSize,       // AOs
-               1, C_partial_view.data(), BasisSetSize, basis_v_mw.data(), BasisSetSize, 0, phi_v.data(),
-               requested_orb_size);
+    if (auto ranges = myBasisSet->getActiveBasisRanges(); ranges)
+      gemmBasisRanges(*ranges, requested_orb_size, spo_list.size(), C_partial_view.data(), BasisSetSize,
+                      basis_v_mw.data(), BasisSetSize, phi_v.data(), requested_orb_size);
+    else
+      BLAS::gemm('T', 'N',
+                 requested_orb_size, // MOs
+                 spo_list.size(),    // walkers
+                 BasisSetSize,       // AOs
+                 1, C_partial_view.data(), BasisSetSize, basis_v_mw.data(), BasisSetSize, 0, phi_v.data(),
+                 requested_orb_size);
   }
 }
 
@@ -524,11 +580,9 @@ void LCAOrbitalSet::mw_evaluateDetRatios(const RefVectorWithLeader<SPOSet>& spo_
   const size_t nw = spo_list.size();
   for (size_t iw = 0; iw < nw; iw++)
   {
-    for (size_t iat = 0; iat < vp_list[iw].getTotalNum(); iat++)
-    {
-      spo_list[iw].evaluateValue(vp_list[iw], iat, psi_list[iw]);
-      ratios_list[iw][iat] = simd::dot(psi_list[iw].get().data(), invRow_ptr_list[iw], psi_list[iw].get().size());
-    }
+    // contract C with the inverse row once per walker instead of a GEMV per virtual move
+    const ValueVector inv_row(const_cast<ValueType*>(invRow_ptr_list[iw]), psi_list[iw].get().size());
+    spo_list[iw].evaluateDetRatios(vp_list[iw], psi_list[iw], inv_row, ratios_list[iw]);
   }
 }
 
@@ -553,7 +607,14 @@ void LCAOrbitalSet::evaluateDetRatios(const VirtualParticleSet& VP,
       ScopedTimer local(basis_timer_);
       myBasisSet->evaluateV(VP, j, vTemp.data());
     }
-    ratios[j] = simd::dot(vTemp.data(), invTemp.data(), BasisSetSize);
+    if (auto ranges = myBasisSet->getActiveBasisRanges(); ranges)
+    {
+      ratios[j] = 0;
+      for (const auto& [first, last] : *ranges)
+        ratios[j] += simd::dot(vTemp.data() + first, invTemp.data() + first, last - first);
+    }
+    else
+      ratios[j] = simd::dot(vTemp.data(), invTemp.data(), BasisSetSize);
   }
 }
 
@@ -765,7 +826,7 @@ void LCAOrbitalSet::evaluate_notranspose(const ParticleSet& P,
     for (size_t i = 0, iat = first; iat < last; i++, iat++)
     {
       myBasisSet->evaluateVGL(P, iat, Temp);
-      Product_ABt(Temp, C_partial_view, Tempv);
+      Product_ABt(Temp, C_partial_view, Tempv, myBasisSet->getActiveBasisRanges());
       evaluate_vgl_impl(Tempv, i, logdet, dlogdet, d2logdet);
     }
   }
@@ -248,6 +248,18 @@ protected:
   ///Nbasis x [1(value)+3(gradient)+6(hessian)+10(grad_hessian)]
   vghgh_type Tempghv;
 
+  /// packed walker GEMM implementation of VGL, shared by all the mw_ VGL APIs
+  virtual void mw_evaluateVGLImplGEMM(const RefVectorWithLeader<SPOSet>& spo_list,
+                                      const RefVectorWithLeader<ParticleSet>& P_list,
+                                      int iat,
+                                      OffloadMWVGLArray& phi_vgl_v) const;
+
+  /// packed walker GEMM implementation
+  virtual void mw_evaluateValueImplGEMM(const RefVectorWithLeader<SPOSet>& spo_list,
+                                        const RefVectorWithLeader<ParticleSet>& P_list,
+                                        int iat,
+                                        OffloadMWVArray& phi_v) const;
+
 private:
   ///helper functions to handle Identity
   void evaluate_vgl_impl(const vgl_type& temp, ValueVector& psi, GradVector& dpsi, ValueVector& d2psi) const;
@@ -299,17 +311,6 @@ private:
   ///Unpacks data in vgl object and calculates/places ionic gradient of a single row (phi_j(r)) into dlogdet.
   void evaluate_ionderiv_v_row_impl(const vgl_type& temp, GradVector& dlogdet) const;
 
-  void mw_evaluateVGLImplGEMM(const RefVectorWithLeader<SPOSet>& spo_list,
-                              const RefVectorWithLeader<ParticleSet>& P_list,
-                              int iat,
-                              OffloadMWVGLArray& phi_vgl_v) const;
-
-  /// packed walker GEMM implementation
-  void mw_evaluateValueImplGEMM(const RefVectorWithLeader<SPOSet>& spo_list,
-                                const RefVectorWithLeader<ParticleSet>& P_list,
-                                int iat,
-                                OffloadMWVArray& phi_v) const;
-
   struct LCAOMultiWalkerMem;
   ResourceHandle<LCAOMultiWalkerMem> mw_mem_handle_;
   /// timer for basis set
@@ -49,6 +49,33 @@ void LCAOrbitalSetWithCorrection::evaluateVGL(const ParticleSet& P,
   cusp.add_vector_vgl(P, iat, psi, dpsi, d2psi);
 }
 
+void LCAOrbitalSetWithCorrection::evaluateDetRatios(const VirtualParticleSet& VP,
+                                                    ValueVector& psi,
+                                                    const ValueVector& psiinv,
+                                                    std::vector<ValueType>& ratios)
+{
+  LCAOrbitalSet::evaluateDetRatios(VP, psi, psiinv, ratios);
+  cusp.addDetRatios(VP, psiinv, ratios);
+}
+
+void LCAOrbitalSetWithCorrection::mw_evaluateVGLImplGEMM(const RefVectorWithLeader<SPOSet>& spo_list,
+                                                         const RefVectorWithLeader<ParticleSet>& P_list,
+                                                         int iat,
+                                                         OffloadMWVGLArray& phi_vgl_v) const
+{
+  LCAOrbitalSet::mw_evaluateVGLImplGEMM(spo_list, P_list, iat, phi_vgl_v);
+  spo_list.getCastedLeader<LCAOrbitalSetWithCorrection>().cusp.mw_addVGL(P_list, iat, phi_vgl_v);
+}
+
+void LCAOrbitalSetWithCorrection::mw_evaluateValueImplGEMM(const RefVectorWithLeader<SPOSet>& spo_list,
+                                                           const RefVectorWithLeader<ParticleSet>& P_list,
+                                                           int iat,
+                                                           OffloadMWVArray& phi_v) const
+{
+  LCAOrbitalSet::mw_evaluateValueImplGEMM(spo_list, P_list, iat, phi_v);
+  spo_list.getCastedLeader<LCAOrbitalSetWithCorrection>().cusp.mw_addV(P_list, iat, phi_v);
+}
+
 void LCAOrbitalSetWithCorrection::evaluateVGH(const ParticleSet& P,
                                               int iat,
                                               ValueVector& psi,
@@ -68,6 +68,26 @@ struct MultiFunctorAdapter
       d2u[i] = Rnl[i]->d2Y;
     }
   }
+  /** evaluate at many radii, the point index is innermost in the outputs [Rnl.size()][ld] */
+  inline void evaluate(const RealType* restrict r,
+                       size_t npts,
+                       RealType* restrict u,
+                       RealType* restrict du,
+                       RealType* restrict d2u,
+                       size_t ld)
+  {
+    for (size_t ip = 0; ip < npts; ++ip)
+    {
+      const RealType rinv = RealType(1) / r[ip];
+      for (size_t i = 0, n = Rnl.size(); i < n; ++i)
+      {
+        Rnl[i]->evaluateAll(r[ip], rinv);
+        u[i * ld + ip]   = Rnl[i]->Y;
+        du[i * ld + ip]  = Rnl[i]->dY;
+        d2u[i * ld + ip] = Rnl[i]->d2Y;
+      }
+    }
+  }
   inline void evaluate(RealType r,
                        RealType* restrict u,
                        RealType* restrict du,
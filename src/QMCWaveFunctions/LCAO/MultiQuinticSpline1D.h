@@ -180,6 +180,151 @@ public:
     }
   }
 
+  /** evaluate the values of all the splines at many radii, the point index is innermost in the output
+   * @param r radii of the points
+   * @param npts number of points
+   * @param u values [num_splines][ld]
+   * @param ld leading dimension of the output, ld >= npts
+   */
+  inline void evaluate(const T* restrict r, size_t npts, T* restrict u, size_t ld) const
+  {
+    constexpr size_t chunk_size = 64;
+    const size_t ncols          = coeffs->cols();
+    const T* restrict coefs     = coeffs->data();
+    size_t offsets[chunk_size];
+    T cLs[chunk_size];
+
+    for (size_t first = 0; first < npts; first += chunk_size)
+    {
+      const size_t n = std::min(chunk_size, npts - first);
+      for (size_t ip = 0; ip < n; ++ip)
+        if (r[first + ip] < myGrid.lower_bound)
+        {
+          offsets[ip] = 0;
+          cLs[ip]     = 0;
+        }
+        else
+        {
+          int loc;
+          cLs[ip]     = myGrid.getCLForQuintic(r[first + ip], loc);
+          offsets[ip] = loc * 6 * ncols;
+        }
+
+      for (size_t i = 0; i < num_splines_; ++i)
+      {
+        T* restrict u_i = u + i * ld + first;
+#pragma omp simd
+        for (size_t ip = 0; ip < n; ++ip)
+        {
+          const T* restrict coef = coefs + offsets[ip] + i;
+          const T a              = coef[0];
+          const T b              = coef[ncols];
+          const T c              = coef[2 * ncols];
+          const T d              = coef[3 * ncols];
+          const T e              = coef[4 * ncols];
+          const T f              = coef[5 * ncols];
+          const T cL             = cLs[ip];
+          u_i[ip]                = a + cL * (b + cL * (c + cL * (d + cL * (e + cL * f))));
+        }
+      }
+
+      for (size_t ip = 0; ip < n; ++ip)
+        if (r[first + ip] < myGrid.lower_bound)
+        {
+          const T dr          = r[first + ip] - myGrid.lower_bound;
+          const T* restrict a = (*coeffs)[0];
+          for (size_t i = 0; i < num_splines_; ++i)
+            u[i * ld + first + ip] = a[i] + first_deriv[i] * dr;
+        }
+    }
+  }
+
+  /** evaluate all the splines at many radii, the point index is innermost in the outputs
+   * @param r radii of the points
+   * @param npts number of points
+   * @param u values [num_splines][ld]
+   * @param du first derivatives [num_splines][ld]
+   * @param d2u second derivatives [num_splines][ld]
+   * @param ld leading dimension of the outputs, ld >= npts
+   *
+   * The grid is located once per point and the splines are looped outside the points
+   * so that the polynomial evaluation runs over the points at full SIMD width.
+   */
+  inline void evaluate(const T* restrict r,
+                       size_t npts,
+                       T* restrict u,
+                       T* restrict du,
+                       T* restrict d2u,
+                       size_t ld) const
+  {
+    constexpr size_t chunk_size = 64;
+    constexpr T ctwo(2);
+    constexpr T cthree(3);
+    constexpr T cfour(4);
+    constexpr T cfive(5);
+    constexpr T csix(6);
+    constexpr T c12(12);
+    constexpr T c20(20);
+
+    const size_t ncols      = coeffs->cols();
+    const T* restrict coefs = coeffs->data();
+    size_t offsets[chunk_size];
+    T cLs[chunk_size];
+
+    for (size_t first = 0; first < npts; first += chunk_size)
+    {
+      const size_t n = std::min(chunk_size, npts - first);
+      // points below the grid are fixed up after the polynomial evaluation
+      for (size_t ip = 0; ip < n; ++ip)
+        if (r[first + ip] < myGrid.lower_bound)
+        {
+          offsets[ip] = 0;
+          cLs[ip]     = 0;
+        }
+        else
+        {
+          int loc;
+          cLs[ip]     = myGrid.getCLForQuintic(r[first + ip], loc);
+          offsets[ip] = loc * 6 * ncols;
+        }
+
+      for (size_t i = 0; i < num_splines_; ++i)
+      {
+        T* restrict u_i   = u + i * ld + first;
+        T* restrict du_i  = du + i * ld + first;
+        T* restrict d2u_i = d2u + i * ld + first;
+#pragma omp simd
+        for (size_t ip = 0; ip < n; ++ip)
+        {
+          const T* restrict coef = coefs + offsets[ip] + i;
+          const T a              = coef[0];
+          const T b              = coef[ncols];
+          const T c              = coef[2 * ncols];
+          const T d              = coef[3 * ncols];
+          const T e              = coef[4 * ncols];
+          const T f              = coef[5 * ncols];
+          const T cL             = cLs[ip];
+          u_i[ip]                = a + cL * (b + cL * (c + cL * (d + cL * (e + cL * f))));
+          du_i[ip]               = b + cL * (ctwo * c + cL * (cthree * d + cL * (cfour * e + cL * f * cfive)));
+          d2u_i[ip]              = ctwo * c + cL * (csix * d + cL * (c12 * e + cL * f * c20));
+        }
+      }
+
+      for (size_t ip = 0; ip < n; ++ip)
+        if (r[first + ip] < myGrid.lower_bound)
+        {
+          const T dr          = r[first + ip] - myGrid.lower_bound;
+          const T* restrict a = (*coeffs)[0];
+          for (size_t i = 0; i < num_splines_; ++i)
+          {
+            u[i * ld + first + ip]   = a[i] + first_deriv[i] * dr;
+            du[i * ld + first + ip]  = first_deriv[i];
+            d2u[i * ld + first + ip] = 0.0;
+          }
+        }
+    }
+  }
+
   /** compute upto 3rd derivatives */
   inline void evaluate(T r, T* restrict u, T* restrict du, T* restrict d2u, T* restrict d3u) const
   {
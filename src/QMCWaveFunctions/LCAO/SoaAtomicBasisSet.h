@@ -56,6 +56,16 @@ struct SoaAtomicBasisSet
   std::vector<QuantumNumberType> RnlID;
   ///temporary storage
   VectorSoaContainer<RealType, 4> tempS;
+  ///x, y, z and r of the points gathered by mw_evaluateVGL
+  VectorSoaContainer<RealType, 4> mw_points_;
+  ///walker index of each point
+  std::vector<int> mw_point_walkers_;
+  ///phase of each point
+  std::vector<ValueType> mw_point_phases_;
+  ///radial functions [3][nl][point] and solid harmonics [VGL][lm][point] of the points
+  aligned_vector<RealType> mw_rnl_, mw_ylm_;
+  ///VGL contributions of one basis function at the points
+  VectorSoaContainer<ValueType, 5> mw_contrib_;
 
   ///the constructor
   explicit SoaAtomicBasisSet(int lmax, bool addsignforM = false) : Ylm(lmax, addsignforM) {}
@@ -242,6 +252,160 @@ struct SoaAtomicBasisSet
     }
   }
 
+  /** evaluate VGL at a batch of electron positions, e.g. the same electron of all the walkers in a crowd
+   * @param lattice lattice
+   * @param walkers walker index of each position, selects the row of vgl_v
+   * @param displs displacements from this center
+   * @param Tvs translation vectors of the minimum image displacements
+   * @param offset basis offset of this center
+   * @param vgl_v [VGL][walker][basis] output, the blocks of the given walkers are overwritten
+   *
+   * All the walkers x periodic images within Rmax are gathered as points. The radial functions
+   * are evaluated for all the points at once and the basis functions are assembled with the point index innermost.
+   */
+  template<typename LAT, typename PosType, typename MWVGL>
+  inline void mw_evaluateVGL(const LAT& lattice,
+                             const std::vector<int>& walkers,
+                             const std::vector<PosType>& displs,
+                             const std::vector<PosType>& Tvs,
+                             const size_t offset,
+                             MWVGL& vgl_v)
+  {
+    using T = RealType;
+    constexpr T ctwo(2);
+
+    for (const int iw : walkers)
+      for (int idim = 0; idim < OHMMS_DIM + 2; idim++)
+        std::fill_n(vgl_v.data_at(idim, iw, offset), BasisSetSize, ValueType(0));
+
+    const size_t num_images = (PBCImages[0] + 1) * (PBCImages[1] + 1) * (PBCImages[2] + 1);
+    mw_points_.resize(walkers.size() * num_images);
+    mw_point_walkers_.resize(walkers.size() * num_images);
+    mw_point_phases_.resize(walkers.size() * num_images);
+
+    // gather the points within Rmax, SIGN Change!! as in evaluateVGL
+    size_t npts = 0;
+    for (size_t k = 0; k < walkers.size(); k++)
+    {
+      const PosType& dr = displs[k];
+#if not defined(QMC_COMPLEX)
+      const ValueType correctphase = 1;
+#else
+      const PosType& Tv = Tvs[k];
+      RealType phasearg = SuperTwist[0] * Tv[0] + SuperTwist[1] * Tv[1] + SuperTwist[2] * Tv[2];
+      RealType s, c;
+      qmcplusplus::sincos(-phasearg, &s, &c);
+      const ValueType correctphase(c, s);
+#endif
+      int iter = -1;
+      for (int i = 0; i <= PBCImages[0]; i++)
+      {
+        const int TransX = ((i % 2) * 2 - 1) * ((i + 1) / 2);
+        for (int j = 0; j <= PBCImages[1]; j++)
+        {
+          const int TransY = ((j % 2) * 2 - 1) * ((j + 1) / 2);
+          for (int l = 0; l <= PBCImages[2]; l++)
+          {
+            const int TransZ = ((l % 2) * 2 - 1) * ((l + 1) / 2);
+            PosType dr_new;
+            dr_new[0] = dr[0] + (TransX * lattice.R(0, 0) + TransY * lattice.R(1, 0) + TransZ * lattice.R(2, 0));
+            dr_new[1] = dr[1] + (TransX * lattice.R(0, 1) + TransY * lattice.R(1, 1) + TransZ * lattice.R(2, 1));
+            dr_new[2] = dr[2] + (TransX * lattice.R(0, 2) + TransY * lattice.R(1, 2) + TransZ * lattice.R(2, 2));
+            const T r_new = std::sqrt(dot(dr_new, dr_new));
+            iter++;
+            if (r_new >= Rmax)
+              continue;
+            mw_points_.data(0)[npts] = -dr_new[0];
+            mw_points_.data(1)[npts] = -dr_new[1];
+            mw_points_.data(2)[npts] = -dr_new[2];
+            mw_points_.data(3)[npts] = r_new;
+            mw_point_walkers_[npts]  = walkers[k];
+            mw_point_phases_[npts]   = periodic_image_phase_factors[iter] * correctphase;
+            npts++;
+          }
+        }
+      }
+    }
+    if (npts == 0)
+      return;
+
+    const size_t ld   = mw_points_.capacity();
+    const size_t nrnl = RnlID.size();
+    const size_t nylm = Ylm.size();
+    mw_rnl_.resize(3 * nrnl * ld);
+    mw_ylm_.resize((OHMMS_DIM + 2) * nylm * ld);
+    mw_contrib_.resize(npts);
+
+    T* restrict phi   = mw_rnl_.data();
+    T* restrict dphi  = phi + nrnl * ld;
+    T* restrict d2phi = dphi + nrnl * ld;
+    MultiRnl.evaluate(mw_points_.data(3), npts, phi, dphi, d2phi, ld);
+
+    for (size_t ip = 0; ip < npts; ip++)
+    {
+      Ylm.evaluateVGL(mw_points_.data(0)[ip], mw_points_.data(1)[ip], mw_points_.data(2)[ip]);
+      for (int idim = 0; idim < OHMMS_DIM + 2; idim++)
+      {
+        const T* restrict ylm = Ylm[idim];
+        T* restrict ylm_p     = mw_ylm_.data() + idim * nylm * ld + ip;
+        for (size_t lm = 0; lm < nylm; lm++)
+          ylm_p[lm * ld] = ylm[lm];
+      }
+    }
+
+    const T* restrict x             = mw_points_.data(0);
+    const T* restrict y             = mw_points_.data(1);
+    const T* restrict z             = mw_points_.data(2);
+    const T* restrict r             = mw_points_.data(3);
+    const ValueType* restrict phase = mw_point_phases_.data();
+    ValueType* restrict c_v         = mw_contrib_.data(0);
+    ValueType* restrict c_x         = mw_contrib_.data(1);
+    ValueType* restrict c_y         = mw_contrib_.data(2);
+    ValueType* restrict c_z         = mw_contrib_.data(3);
+    ValueType* restrict c_l         = mw_contrib_.data(4);
+    for (size_t ib = 0; ib < BasisSetSize; ++ib)
+    {
+      const T* restrict vr_p   = phi + NL[ib] * ld;
+      const T* restrict dvr_p  = dphi + NL[ib] * ld;
+      const T* restrict d2vr_p = d2phi + NL[ib] * ld;
+      const T* restrict ylm_v  = mw_ylm_.data() + LM[ib] * ld;
+      const T* restrict ylm_x  = ylm_v + nylm * ld;
+      const T* restrict ylm_y  = ylm_x + nylm * ld;
+      const T* restrict ylm_z  = ylm_y + nylm * ld;
+      const T* restrict ylm_l  = ylm_z + nylm * ld;
+#pragma omp simd
+      for (size_t ip = 0; ip < npts; ip++)
+      {
+        const T drnloverr = dvr_p[ip] / r[ip];
+        const T ang       = ylm_v[ip];
+        const T gr_x      = drnloverr * x[ip];
+        const T gr_y      = drnloverr * y[ip];
+        const T gr_z      = drnloverr * z[ip];
+        const T ang_x     = ylm_x[ip];
+        const T ang_y     = ylm_y[ip];
+        const T ang_z     = ylm_z[ip];
+        const T vr        = vr_p[ip];
+
+        c_v[ip] = ang * vr * phase[ip];
+        c_x[ip] = (ang * gr_x + vr * ang_x) * phase[ip];
+        c_y[ip] = (ang * gr_y + vr * ang_y) * phase[ip];
+        c_z[ip] = (ang * gr_z + vr * ang_z) * phase[ip];
+        c_l[ip] = (ang * (ctwo * drnloverr + d2vr_p[ip]) + ctwo * (gr_x * ang_x + gr_y * ang_y + gr_z * ang_z) +
+                   vr * ylm_l[ip]) *
+            phase[ip];
+      }
+      for (size_t ip = 0; ip < npts; ip++)
+      {
+        const int iw = mw_point_walkers_[ip];
+        *vgl_v.data_at(0, iw, offset + ib) += c_v[ip];
+        *vgl_v.data_at(1, iw, offset + ib) += c_x[ip];
+        *vgl_v.data_at(2, iw, offset + ib) += c_y[ip];
+        *vgl_v.data_at(3, iw, offset + ib) += c_z[ip];
+        *vgl_v.data_at(4, iw, offset + ib) += c_l[ip];
+      }
+    }
+  }
+
   template<typename LAT, typename T, typename PosType, typename VGH>
   inline void evaluateVGH(const LAT& lattice, const T r, const PosType& dr, const size_t offset, VGH& vgh)
   {
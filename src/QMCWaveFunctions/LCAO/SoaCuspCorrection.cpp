@@ -14,6 +14,7 @@
  */
 #include "SoaCuspCorrection.h"
 #include "SoaCuspCorrectionBasisSet.h"
+#include "CPU/SIMD/simd.hpp"
 
 namespace qmcplusplus
 {
@@ -151,6 +152,95 @@ void SoaCuspCorrection::evaluateV(const ParticleSet& P, int iat, ValueVector& ps
   }
 }
 
+size_t SoaCuspCorrection::gatherPoints(const RefVectorWithLeader<ParticleSet>& P_list, int iat, int c, size_t nradial)
+{
+  const RealType r_max = LOBasisSet[c]->getRmax();
+  mw_rows_.clear();
+  mw_dists_.clear();
+  mw_displs_.clear();
+  for (int iw = 0; iw < P_list.size(); iw++)
+  {
+    const ParticleSet& P = P_list[iw];
+    const auto& d_table  = P.getDistTableAB(myTableIndex);
+    const auto& dist     = (P.getActivePtcl() == iat) ? d_table.getTempDists() : d_table.getDistRow(iat);
+    if (dist[c] >= r_max)
+      continue;
+    const auto& displ = (P.getActivePtcl() == iat) ? d_table.getTempDispls() : d_table.getDisplRow(iat);
+    mw_rows_.push_back(iw);
+    mw_dists_.push_back(dist[c]);
+    mw_displs_.push_back(displ[c]);
+  }
+  const size_t ld = getAlignedSize<RealType>(mw_rows_.size());
+  mw_radial_.resize(nradial * LOBasisSet[c]->getNumOrbs() * ld);
+  return ld;
+}
+
+void SoaCuspCorrection::mw_addVGL(const RefVectorWithLeader<ParticleSet>& P_list, int iat, OffloadMWVGLArray& vgl_v)
+{
+  assert(vgl_v.size(1) == P_list.size());
+  assert(MaxOrbSize >= vgl_v.size(2));
+  const size_t norb = vgl_v.size(2);
+  for (int c = 0; c < NumCenters; c++)
+    if (LOBasisSet[c])
+    {
+      const size_t ld = gatherPoints(P_list, iat, c, 3);
+      if (!mw_rows_.empty())
+        LOBasisSet[c]->mw_evaluate_vgl(mw_rows_.size(), mw_dists_.data(), mw_displs_.data(), mw_rows_.data(), norb,
+                                       vgl_v.data(), norb, vgl_v.size(1) * norb, mw_radial_.data(), ld);
+    }
+}
+
+void SoaCuspCorrection::mw_addV(const RefVectorWithLeader<ParticleSet>& P_list, int iat, OffloadMWVArray& v)
+{
+  assert(v.size(0) == P_list.size());
+  assert(MaxOrbSize >= v.size(1));
+  const size_t norb = v.size(1);
+  for (int c = 0; c < NumCenters; c++)
+    if (LOBasisSet[c])
+    {
+      const size_t ld = gatherPoints(P_list, iat, c, 1);
+      if (!mw_rows_.empty())
+        LOBasisSet[c]->mw_evaluate(mw_rows_.size(), mw_dists_.data(), mw_rows_.data(), norb, v.data(), norb,
+                                   mw_radial_.data(), ld);
+    }
+}
+
+void SoaCuspCorrection::addDetRatios(const VirtualParticleSet& VP,
+                                     const ValueVector& psiinv,
+                                     std::vector<ValueType>& ratios)
+{
+  assert(MaxOrbSize >= psiinv.size());
+  const size_t norb   = psiinv.size();
+  const size_t npts   = VP.getTotalNum();
+  const auto& d_table = VP.getDistTableAB(myTableIndex);
+  mw_vp_values_.resize(npts, norb);
+  mw_vp_values_ = 0.0;
+
+  // all the virtual moves within the cutoff of a center are evaluated in one batch
+  for (int c = 0; c < NumCenters; c++)
+    if (LOBasisSet[c])
+    {
+      const RealType r_max = LOBasisSet[c]->getRmax();
+      mw_rows_.clear();
+      mw_dists_.clear();
+      for (int j = 0; j < npts; j++)
+        if (const RealType r = d_table.getDistRow(j)[c]; r < r_max)
+        {
+          mw_rows_.push_back(j);
+          mw_dists_.push_back(r);
+        }
+      if (mw_rows_.empty())
+        continue;
+      const size_t ld = getAlignedSize<RealType>(mw_rows_.size());
+      mw_radial_.resize(LOBasisSet[c]->getNumOrbs() * ld);
+      LOBasisSet[c]->mw_evaluate(mw_rows_.size(), mw_dists_.data(), mw_rows_.data(), norb, mw_vp_values_.data(), norb,
+                                 mw_radial_.data(), ld);
+    }
+
+  for (int j = 0; j < npts; j++)
+    ratios[j] += simd::dot(mw_vp_values_[j], psiinv.data(), norb);
+}
+
 void SoaCuspCorrection::add(int icenter, std::unique_ptr<COT> aos)
 {
   assert(MaxOrbSize == aos->getNumOrbs() && "All the centers should support the same number of orbitals!");
@@ -41,6 +41,9 @@ class SoaCuspCorrection
   using ValueVector = SPOSet::ValueVector;
   using PosType     = ParticleSet::PosType;
 
+  using OffloadMWVGLArray = Array<ValueType, 3, OffloadPinnedAllocator<ValueType>>; // [VGL, walker, Orbs]
+  using OffloadMWVArray   = Array<ValueType, 2, OffloadPinnedAllocator<ValueType>>; // [walker, Orbs]
+
   ///number of centers, e.g., ions
   size_t NumCenters;
   ///number of quantum particles
@@ -64,6 +67,20 @@ class SoaCuspCorrection
 
   Matrix<RealType> myVGL;
 
+  ///rows, distances and displacements of the points of a center gathered by the batched evaluation
+  std::vector<int> mw_rows_;
+  aligned_vector<RealType> mw_dists_;
+  std::vector<PosType> mw_displs_;
+  ///radial functions of the gathered points [3][orbital][point]
+  aligned_vector<RealType> mw_radial_;
+  ///cusp correction values of the virtual moves [point][orbital]
+  Matrix<ValueType> mw_vp_values_;
+
+  /** gather the points of electron iat of all the walkers within the cutoff of center c
+   * @return the leading dimension of the radial scratch
+   */
+  size_t gatherPoints(const RefVectorWithLeader<ParticleSet>& P_list, int iat, int c, size_t nradial);
+
 public:
   /** constructor
    * @param ions ionic system
@@ -115,6 +132,25 @@ public:
   {
     evaluate_vgl(P, iat, vals, dpsi, d2psi);
   }
+
+  /** add the VGL of electron iat of all the walkers, one batch of points per center
+   * @param P_list quantum particlesets of the walkers
+   * @param iat active particle
+   * @param vgl_v [VGL][walker][orbital], the number of orbitals may be smaller than MaxOrbSize
+   */
+  void mw_addVGL(const RefVectorWithLeader<ParticleSet>& P_list, int iat, OffloadMWVGLArray& vgl_v);
+
+  /** add the values of electron iat of all the walkers
+   * @param v [walker][orbital]
+   */
+  void mw_addV(const RefVectorWithLeader<ParticleSet>& P_list, int iat, OffloadMWVArray& v);
+
+  /** add the determinant ratio contributions of all the virtual moves
+   * @param VP virtual particleset
+   * @param psiinv row of the inverse matrix
+   * @param ratios ratios to which dot(correction, psiinv) is added
+   */
+  void addDetRatios(const VirtualParticleSet& VP, const ValueVector& psiinv, std::vector<ValueType>& ratios);
 };
 } // namespace qmcplusplus
 #endif
@@ -44,6 +44,8 @@ public:
 
   auto getNumOrbs() const { return AOs.getNumSplines(); }
 
+  auto getRmax() const { return r_max_; }
+
   /** copy constructor */
   CuspCorrectionAtomicBasis(const CuspCorrectionAtomicBasis& a) = default;
 
@@ -104,6 +106,77 @@ public:
       d2u[j] += d2phi[i] + 2 * dphi[i] / r;
     }
   }
+
+  /** add the values at a batch of points within r_max, e.g. the same electron of all the walkers
+   * @param npts number of points
+   * @param r distances of the points
+   * @param rows output row of each point
+   * @param norb number of orbitals to add
+   * @param out output, out[row * row_stride + orbital]
+   * @param radial scratch of getNumOrbs() * ld
+   * @param ld leading dimension of the scratch, ld >= npts
+   */
+  template<typename VT>
+  inline void mw_evaluate(size_t npts,
+                          const T* restrict r,
+                          const int* restrict rows,
+                          size_t norb,
+                          VT* restrict out,
+                          size_t row_stride,
+                          T* restrict radial,
+                          size_t ld) const
+  {
+    AOs.evaluate(r, npts, radial, ld);
+    for (size_t i = 0; i < norb; ++i)
+    {
+      const T* restrict phi = radial + i * ld;
+      for (size_t ip = 0; ip < npts; ++ip)
+        out[rows[ip] * row_stride + i] += phi[ip];
+    }
+  }
+
+  /** add VGL at a batch of points within r_max, e.g. the same electron of all the walkers
+   * @param npts number of points
+   * @param r distances of the points
+   * @param dr displacements of the points
+   * @param rows output row of each point
+   * @param norb number of orbitals to add
+   * @param out output, out[component * comp_stride + row * row_stride + orbital]
+   * @param radial scratch of 3 * getNumOrbs() * ld
+   * @param ld leading dimension of the scratch, ld >= npts
+   */
+  template<typename VT>
+  inline void mw_evaluate_vgl(size_t npts,
+                              const T* restrict r,
+                              const PosType* restrict dr,
+                              const int* restrict rows,
+                              size_t norb,
+                              VT* restrict out,
+                              size_t row_stride,
+                              size_t comp_stride,
+                              T* restrict radial,
+                              size_t ld) const
+  {
+    const size_t nr = AOs.getNumSplines();
+    AOs.evaluate(r, npts, radial, radial + nr * ld, radial + 2 * nr * ld, ld);
+    for (size_t i = 0; i < norb; ++i)
+    {
+      const T* restrict phi   = radial + i * ld;
+      const T* restrict dphi  = radial + (nr + i) * ld;
+      const T* restrict d2phi = radial + (2 * nr + i) * ld;
+      for (size_t ip = 0; ip < npts; ++ip)
+      {
+        // Displacements have opposite sign (relative to AOS)
+        const T dphi_r = dphi[ip] / r[ip];
+        VT* restrict u = out + rows[ip] * row_stride + i;
+        u[0] += phi[ip];
+        u[comp_stride] -= dphi_r * dr[ip][0];
+        u[2 * comp_stride] -= dphi_r * dr[ip][1];
+        u[3 * comp_stride] -= dphi_r * dr[ip][2];
+        u[4 * comp_stride] += d2phi[ip] + 2 * dphi_r;
+      }
+    }
+  }
 };
 } // namespace qmcplusplus
 #endif
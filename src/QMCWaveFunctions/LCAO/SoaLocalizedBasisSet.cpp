@@ -11,6 +11,7 @@
 
 
 #include <memory>
+#include <numeric>
 #include "SoaLocalizedBasisSet.h"
 #include "Particle/DistanceTable.h"
 #include "SoaAtomicBasisSet.h"
@@ -25,13 +26,15 @@ template<class COT, typename ORBT>
 SoaLocalizedBasisSet<COT, ORBT>::SoaLocalizedBasisSet(ParticleSet& ions, ParticleSet& els)
     : ions_(ions),
       myTableIndex(els.addTable(ions, DTModes::NEED_FULL_TABLE_ANYTIME | DTModes::NEED_VP_FULL_TABLE_ON_HOST)),
-      SuperTwist(0.0)
+      SuperTwist(0.0),
+      center_screening_(true)
 {
   NumCenters = ions.getTotalNum();
   NumTargets = els.getTotalNum();
   LOBasisSet.resize(ions.getSpeciesSet().getTotalNum());
   BasisOffset.resize(NumCenters + 1);
   BasisSetSize = 0;
+  center_active_.resize(NumCenters);
 }
 
 template<class COT, typename ORBT>
@@ -42,7 +45,10 @@ SoaLocalizedBasisSet<COT, ORBT>::SoaLocalizedBasisSet(const SoaLocalizedBasisSet
       ions_(a.ions_),
       myTableIndex(a.myTableIndex),
       SuperTwist(a.SuperTwist),
-      BasisOffset(a.BasisOffset)
+      BasisOffset(a.BasisOffset),
+      center_screening_(a.center_screening_),
+      center_active_(a.center_active_),
+      centers_by_offset_(a.centers_by_offset_)
 {
   LOBasisSet.reserve(a.LOBasisSet.size());
   for (auto& elem : a.LOBasisSet)
@@ -57,7 +63,8 @@ void SoaLocalizedBasisSet<COT, ORBT>::setPBCParams(const TinyVector<int, 3>& PBC
   for (int i = 0; i < LOBasisSet.size(); ++i)
     LOBasisSet[i]->setPBCParams(PBCImages, Sup_Twist, phase_factor);
 
-  SuperTwist = Sup_Twist;
+  SuperTwist        = Sup_Twist;
+  center_screening_ = PBCImages[0] == 0 && PBCImages[1] == 0 && PBCImages[2] == 0;
 }
 
 template<class COT, typename ORBT>
@@ -92,6 +99,38 @@ void SoaLocalizedBasisSet<COT, ORBT>::setBasisSetSize(int nbs)
 
     BasisSetSize = basis_offset_input_order[NumCenters];
   }
+
+  centers_by_offset_.resize(NumCenters);
+  std::iota(centers_by_offset_.begin(), centers_by_offset_.end(), 0);
+  std::sort(centers_by_offset_.begin(), centers_by_offset_.end(),
+            [this](int a, int b) { return BasisOffset[a] < BasisOffset[b]; });
+}
+
+template<class COT, typename ORBT>
+inline bool SoaLocalizedBasisSet<COT, ORBT>::screenCenter(int c, RealType r)
+{
+  if (center_screening_ && r >= LOBasisSet[ions_.GroupID[c]]->Rmax)
+    return false;
+  center_active_[c] = true;
+  return true;
+}
+
+template<class COT, typename ORBT>
+void SoaLocalizedBasisSet<COT, ORBT>::updateActiveBasisRanges()
+{
+  const auto& IonID(ions_.GroupID);
+  active_basis_ranges_.clear();
+  for (const int c : centers_by_offset_)
+  {
+    if (!center_active_[c])
+      continue;
+    const int first = BasisOffset[c];
+    const int last  = first + LOBasisSet[IonID[c]]->getBasisSetSize();
+    if (!active_basis_ranges_.empty() && active_basis_ranges_.back().second == first)
+      active_basis_ranges_.back().second = last;
+    else
+      active_basis_ranges_.emplace_back(first, last);
+  }
 }
 
 template<class COT, typename ORBT>
@@ -121,6 +160,15 @@ void SoaLocalizedBasisSet<COT, ORBT>::queryOrbitalsForSType(const std::vector<bo
 
 template<class COT, typename ORBT>
 void SoaLocalizedBasisSet<COT, ORBT>::evaluateVGL(const ParticleSet& P, int iat, vgl_type& vgl)
+{
+  std::fill(center_active_.begin(), center_active_.end(), false);
+  evaluateVGLImpl(P, iat, vgl);
+  if (center_screening_)
+    updateActiveBasisRanges();
+}
+
+template<class COT, typename ORBT>
+void SoaLocalizedBasisSet<COT, ORBT>::evaluateVGLImpl(const ParticleSet& P, int iat, vgl_type& vgl)
 {
   const auto& IonID(ions_.GroupID);
   const auto& coordR  = P.activeR(iat);
@@ -131,6 +179,12 @@ void SoaLocalizedBasisSet<COT, ORBT>::evaluateVGL(const ParticleSet& P, int iat,
   PosType Tv;
   for (int c = 0; c < NumCenters; c++)
   {
+    if (!screenCenter(c, dist[c]))
+    {
+      for (int idim = 0; idim < OHMMS_DIM + 2; idim++)
+        std::fill_n(vgl.data(idim) + BasisOffset[c], LOBasisSet[IonID[c]]->getBasisSetSize(), ORBT(0));
+      continue;
+    }
     Tv[0] = (ions_.R[c][0] - coordR[0]) - displ[c][0];
     Tv[1] = (ions_.R[c][1] - coordR[1]) - displ[c][1];
     Tv[2] = (ions_.R[c][2] - coordR[2]) - displ[c][2];
@@ -143,29 +197,38 @@ void SoaLocalizedBasisSet<COT, ORBT>::mw_evaluateVGL(const RefVectorWithLeader<P
                                                      int iat,
                                                      OffloadMWVGLArray& vgl_v)
 {
-  for (size_t iw = 0; iw < P_list.size(); iw++)
+  assert(BasisSetSize == vgl_v.size(2));
+  const auto& IonID(ions_.GroupID);
+  const auto& lattice = P_list.getLeader().getLattice();
+  std::fill(center_active_.begin(), center_active_.end(), false);
+  // all the walkers of a center are evaluated in one batch
+  for (int c = 0; c < NumCenters; c++)
   {
-    const auto& IonID(ions_.GroupID);
-    const auto& coordR  = P_list[iw].activeR(iat);
-    const auto& d_table = P_list[iw].getDistTableAB(myTableIndex);
-    const auto& dist    = (P_list[iw].getActivePtcl() == iat) ? d_table.getTempDists() : d_table.getDistRow(iat);
-    const auto& displ   = (P_list[iw].getActivePtcl() == iat) ? d_table.getTempDispls() : d_table.getDisplRow(iat);
-
-    PosType Tv;
-
-    // number of walkers * BasisSetSize
-    auto stride = vgl_v.size(1) * BasisSetSize;
-    assert(BasisSetSize == vgl_v.size(2));
-    vgl_type vgl_iw(vgl_v.data_at(0, iw, 0), BasisSetSize, stride);
-
-    for (int c = 0; c < NumCenters; c++)
+    mw_walkers_.clear();
+    mw_displs_.clear();
+    mw_Tvs_.clear();
+    for (size_t iw = 0; iw < P_list.size(); iw++)
     {
-      Tv[0] = (ions_.R[c][0] - coordR[0]) - displ[c][0];
-      Tv[1] = (ions_.R[c][1] - coordR[1]) - displ[c][1];
-      Tv[2] = (ions_.R[c][2] - coordR[2]) - displ[c][2];
-      LOBasisSet[IonID[c]]->evaluateVGL(P_list[iw].getLattice(), dist[c], displ[c], BasisOffset[c], vgl_iw, Tv);
+      const ParticleSet& P = P_list[iw];
+      const auto& d_table  = P.getDistTableAB(myTableIndex);
+      const auto& dist     = (P.getActivePtcl() == iat) ? d_table.getTempDists() : d_table.getDistRow(iat);
+      const auto& displ    = (P.getActivePtcl() == iat) ? d_table.getTempDispls() : d_table.getDisplRow(iat);
+      if (!screenCenter(c, dist[c]))
+      {
+        for (int idim = 0; idim < OHMMS_DIM + 2; idim++)
+          std::fill_n(vgl_v.data_at(idim, iw, BasisOffset[c]), LOBasisSet[IonID[c]]->getBasisSetSize(), ORBT(0));
+        continue;
+      }
+      const auto& coordR = P.activeR(iat);
+      mw_walkers_.push_back(iw);
+      mw_displs_.push_back(displ[c]);
+      mw_Tvs_.push_back((ions_.R[c] - coordR) - displ[c]);
     }
+    if (!mw_walkers_.empty())
+      LOBasisSet[IonID[c]]->mw_evaluateVGL(lattice, mw_walkers_, mw_displs_, mw_Tvs_, BasisOffset[c], vgl_v);
   }
+  if (center_screening_)
+    updateActiveBasisRanges();
 }
 
 
@@ -199,6 +262,15 @@ void SoaLocalizedBasisSet<COT, ORBT>::evaluateVGHGH(const ParticleSet& P, int ia
 
 template<class COT, typename ORBT>
 void SoaLocalizedBasisSet<COT, ORBT>::evaluateV(const ParticleSet& P, int iat, ORBT* restrict vals)
+{
+  std::fill(center_active_.begin(), center_active_.end(), false);
+  evaluateVImpl(P, iat, vals);
+  if (center_screening_)
+    updateActiveBasisRanges();
+}
+
+template<class COT, typename ORBT>
+void SoaLocalizedBasisSet<COT, ORBT>::evaluateVImpl(const ParticleSet& P, int iat, ORBT* restrict vals)
 {
   const auto& IonID(ions_.GroupID);
   const auto& coordR  = P.activeR(iat);
@@ -209,6 +281,11 @@ void SoaLocalizedBasisSet<COT, ORBT>::evaluateV(const ParticleSet& P, int iat, O
   PosType Tv;
   for (int c = 0; c < NumCenters; c++)
   {
+    if (!screenCenter(c, dist[c]))
+    {
+      std::fill_n(vals + BasisOffset[c], LOBasisSet[IonID[c]]->getBasisSetSize(), ORBT(0));
+      continue;
+    }
     Tv[0] = (ions_.R[c][0] - coordR[0]) - displ[c][0];
     Tv[1] = (ions_.R[c][1] - coordR[1]) - displ[c][1];
     Tv[2] = (ions_.R[c][2] - coordR[2]) - displ[c][2];
@@ -221,8 +298,11 @@ void SoaLocalizedBasisSet<COT, ORBT>::mw_evaluateValue(const RefVectorWithLeader
                                                        int iat,
                                                        OffloadMWVArray& v)
 {
+  std::fill(center_active_.begin(), center_active_.end(), false);
   for (size_t iw = 0; iw < P_list.size(); iw++)
-    evaluateV(P_list[iw], iat, v.data_at(iw, 0));
+    evaluateVImpl(P_list[iw], iat, v.data_at(iw, 0));
+  if (center_screening_)
+    updateActiveBasisRanges();
 }
 
 template<class COT, typename ORBT>
@@ -165,6 +165,37 @@ public:
    * @param aos a set of Centered Atomic Orbitals
    */
   void add(int icenter, std::unique_ptr<COT> aos);
+
+  const std::vector<std::pair<int, int>>* getActiveBasisRanges() const override
+  {
+    return center_screening_ ? &active_basis_ranges_ : nullptr;
+  }
+
+private:
+  /** skip the centers beyond their cutoff radius Rmax in evaluateVGL/evaluateV and their mw_ versions
+   *
+   * The atomic basis sets vanish beyond Rmax, so screening is exact as long as no periodic images are summed.
+   */
+  bool center_screening_;
+  /// centers within their cutoff radius in the current evaluation
+  std::vector<bool> center_active_;
+  /// basis function ranges of the active centers, see getActiveBasisRanges
+  std::vector<std::pair<int, int>> active_basis_ranges_;
+  /// center indices in the order of their basis offsets
+  std::vector<int> centers_by_offset_;
+  /// walkers, displacements and translation vectors of a center gathered by mw_evaluateVGL
+  std::vector<int> mw_walkers_;
+  std::vector<PosType> mw_displs_;
+  std::vector<PosType> mw_Tvs_;
+
+  /// return true if center c contributes at distance r and mark it active
+  inline bool screenCenter(int c, RealType r);
+  /// rebuild active_basis_ranges_ from center_active_
+  void updateActiveBasisRanges();
+  /// evaluateVGL without resetting the active centers
+  void evaluateVGLImpl(const ParticleSet& P, int iat, vgl_type& vgl);
+  /// evaluateV without resetting the active centers
+  void evaluateVImpl(const ParticleSet& P, int iat, ORBT* restrict vals);
 };
 } // namespace qmcplusplus
 #endif
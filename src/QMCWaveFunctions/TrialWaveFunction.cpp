@@ -1058,6 +1058,38 @@ void TrialWaveFunction::evaluateDerivRatios(const VirtualParticleSet& VP,
   }
 }
 
+void TrialWaveFunction::mw_evaluateDerivRatios(const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                                               const RefVectorWithLeader<const VirtualParticleSet>& vp_list,
+                                               const opt_variables_type& optvars,
+                                               const RefVector<std::vector<ValueType>>& ratios_list,
+                                               const RefVector<Matrix<ValueType>>& dratio_list)
+{
+  auto& wf_leader               = wf_list.getLeader();
+  auto& wavefunction_components = wf_leader.Z;
+  std::vector<std::vector<ValueType>> t(ratios_list.size());
+  for (int iw = 0; iw < wf_list.size(); iw++)
+  {
+    std::vector<ValueType>& ratios = ratios_list[iw];
+    assert(vp_list[iw].getTotalNum() == ratios.size());
+    std::fill(ratios.begin(), ratios.end(), 1.0);
+    std::fill(dratio_list[iw].get().begin(), dratio_list[iw].get().end(), 0.0);
+    t[iw].resize(ratios.size());
+  }
+
+  for (int i = 0; i < wavefunction_components.size(); i++)
+  {
+    ScopedTimer z_timer(wf_leader.WFC_timers_[DERIVS_TIMER + TIMER_SKIP * i]);
+    const auto wfc_list(extractWFCRefList(wf_list, i));
+    wavefunction_components[i]->mw_evaluateDerivRatios(wfc_list, vp_list, optvars, t, dratio_list);
+    for (int iw = 0; iw < wf_list.size(); iw++)
+    {
+      std::vector<ValueType>& ratios = ratios_list[iw];
+      for (int j = 0; j < ratios.size(); ++j)
+        ratios[j] *= t[iw][j];
+    }
+  }
+}
+
 bool TrialWaveFunction::put(xmlNodePtr cur) { return true; }
 
 std::unique_ptr<TrialWaveFunction> TrialWaveFunction::makeClone(ParticleSet& tqp) const
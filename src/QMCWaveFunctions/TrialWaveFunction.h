@@ -309,6 +309,12 @@ public:
                            const opt_variables_type& optvars,
                            std::vector<ValueType>& ratios,
                            Matrix<ValueType>& dratio);
+  /// batched version of evaluateDerivRatios
+  static void mw_evaluateDerivRatios(const RefVectorWithLeader<TrialWaveFunction>& wf_list,
+                                     const RefVectorWithLeader<const VirtualParticleSet>& vp_list,
+                                     const opt_variables_type& optvars,
+                                     const RefVector<std::vector<ValueType>>& ratios_list,
+                                     const RefVector<Matrix<ValueType>>& dratio_list);
 
   void printGL(ParticleSet::ParticleGradient& G, ParticleSet::ParticleLaplacian& L, std::string tag = "GL");
 
@@ -256,6 +256,17 @@ void WaveFunctionComponent::evaluateDerivRatios(const VirtualParticleSet& VP,
   evaluateRatios(VP, ratios);
 }
 
+void WaveFunctionComponent::mw_evaluateDerivRatios(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                                   const RefVectorWithLeader<const VirtualParticleSet>& vp_list,
+                                                   const opt_variables_type& optvars,
+                                                   std::vector<std::vector<ValueType>>& ratios,
+                                                   const RefVector<Matrix<ValueType>>& dratios_list) const
+{
+  assert(this == &wfc_list.getLeader());
+  for (int iw = 0; iw < wfc_list.size(); iw++)
+    wfc_list[iw].evaluateDerivRatios(vp_list[iw], optvars, ratios[iw], dratios_list[iw]);
+}
+
 void WaveFunctionComponent::registerTWFFastDerivWrapper(const ParticleSet& P, TWFFastDerivWrapper& twf) const
 {
   std::ostringstream o;
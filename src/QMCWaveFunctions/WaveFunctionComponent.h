@@ -527,6 +527,18 @@ public:
                                    std::vector<ValueType>& ratios,
                                    Matrix<ValueType>& dratios);
 
+  /** evaluate ratios and their parameter derivatives to evaluate the non-local PP multiple walkers
+   * @param wfc_list the list of WaveFunctionComponent references of the same component in a walker batch
+   * @param vp_list the list of VirtualParticleSet references in a walker batch
+   * @param ratios of all the virtual moves of all the walkers
+   * @param dratios_list Nq x Num_param matrices of all the walkers
+   */
+  virtual void mw_evaluateDerivRatios(const RefVectorWithLeader<WaveFunctionComponent>& wfc_list,
+                                      const RefVectorWithLeader<const VirtualParticleSet>& vp_list,
+                                      const opt_variables_type& optvars,
+                                      std::vector<std::vector<ValueType>>& ratios,
+                                      const RefVector<Matrix<ValueType>>& dratios_list) const;
+
 private:
   /** compute the current gradients and spin gradients for the iat-th particle of multiple walkers
    * @param wfc_list the list of WaveFunctionComponent pointers of the same component in a walker batch
@@ -16,6 +16,7 @@
 #include "Particle/tests/MinimalParticlePool.h"
 #include "QMCWaveFunctions/tests/MinimalWaveFunctionPool.h"
 #include "Utilities/ProjectData.h"
+#include "Utilities/ResourceCollection.h"
 
 namespace qmcplusplus
 {
@@ -49,5 +50,22 @@ TEST_CASE("CompositeSPO::diamond_1x1x1", "[wavefunction")
   SPOSet::GradMatrix dpsiM(pset.R.size(), comp_sposet.getOrbitalSetSize());
   SPOSet::ValueMatrix d2psiM(pset.R.size(), comp_sposet.getOrbitalSetSize());
   comp_sposet.evaluate_notranspose(pset, 0, pset.R.size(), psiM, dpsiM, d2psiM);
+
+  auto clone = comp_sposet.makeClone();
+  CHECK(clone->size() == 8);
+
+  // the batched values of every walker match the single walker values
+  SPOSet::ValueVector psi(comp_sposet.size());
+  comp_sposet.evaluateValue(pset, 1, psi);
+  ResourceCollection spo_res("test_spo_res");
+  comp_sposet.createResource(spo_res);
+  RefVectorWithLeader<SPOSet> spo_list(comp_sposet, {comp_sposet, *clone});
+  RefVectorWithLeader<ParticleSet> p_list(pset, {pset, pset});
+  ResourceCollectionTeamLock<SPOSet> mw_spo_lock(spo_res, spo_list);
+  std::vector<SPOSet::ValueVector> mw_psi(2, SPOSet::ValueVector(comp_sposet.size()));
+  comp_sposet.mw_evaluateValue(spo_list, p_list, 1, makeRefVector<SPOSet::ValueVector>(mw_psi));
+  for (int iw = 0; iw < 2; ++iw)
+    for (int j = 0; j < comp_sposet.size(); ++j)
+      CHECK(mw_psi[iw][j] == ValueApprox(psi[j]));
 }
 } // namespace qmcplusplus
@@ -18,6 +18,7 @@
 #include "ParticleIO/XMLParticleIO.h"
 #include "Numerics/GaussianBasisSet.h"
 #include "QMCWaveFunctions/LCAO/LCAOrbitalBuilder.h"
+#include "QMCWaveFunctions/LCAO/LCAOrbitalSet.h"
 #include "QMCWaveFunctions/SPOSetBuilderFactory.h"
 #include <ResourceCollection.h>
 
@@ -1038,4 +1039,273 @@ TEST_CASE("ReadMolecularOrbital GTO HCN", "[wavefunction]") { test_HCN(false); }
 
 TEST_CASE("ReadMolecularOrbital Numerical HCN", "[wavefunction]") { test_HCN(true); }
 
+TEST_CASE("LCAO center screening He3", "[wavefunction]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  const SimulationCell simulation_cell;
+  auto elec_ptr = std::make_unique<ParticleSet>(simulation_cell);
+  auto& elec(*elec_ptr);
+  elec.setName("e");
+  elec.create({1, 1});
+  elec.R[0] = {0.0001, 0.0, 0.0};
+  elec.R[1] = {40.0, 1.0, 0.0};
+
+  SpeciesSet& tspecies       = elec.getSpeciesSet();
+  int upIdx                  = tspecies.addSpecies("u");
+  int downIdx                = tspecies.addSpecies("d");
+  int massIdx                = tspecies.addAttribute("mass");
+  tspecies(massIdx, upIdx)   = 1.0;
+  tspecies(massIdx, downIdx) = 1.0;
+
+  // three He atoms far beyond the cutoff radius of each other's basis functions
+  auto ions_ptr = std::make_unique<ParticleSet>(simulation_cell);
+  auto& ions(*ions_ptr);
+  ions.setName("ion0");
+  ions.create({3});
+  ions.R[0] = {0.0, 0.0, 0.0};
+  ions.R[1] = {40.0, 0.0, 0.0};
+  ions.R[2] = {80.0, 0.0, 0.0};
+  ions.getSpeciesSet().addSpecies("He");
+  ions.update();
+
+  elec.addTable(ions);
+  elec.update();
+
+  const char* wf_xml = R"(<determinantset type="MolecularOrbital" name="LCAOBSet" source="ion0" transform="yes"
+                 cuspCorrection="no">
+  <basisset name="LCAOBSet">
+    <atomicBasisSet name="Gaussian" angular="cartesian" type="Gaussian" elementType="He" normalized="no">
+      <grid type="log" ri="1.e-6" rf="1.e2" npts="1001"/>
+      <basisGroup rid="He00" n="0" l="0" type="Gaussian">
+        <radfunc exponent="6.362421400000e+00" contraction="1.543289672950e-01"/>
+        <radfunc exponent="1.158923000000e+00" contraction="5.353281422820e-01"/>
+        <radfunc exponent="3.136498000000e-01" contraction="4.446345421850e-01"/>
+      </basisGroup>
+    </atomicBasisSet>
+  </basisset>
+  <sposet name="spo" size="3">
+    <coefficient size="3" id="C">
+      1.0  0.5  0.25
+      0.3 -1.0  0.7
+      0.2  0.4 -0.6
+    </coefficient>
+  </sposet>
+</determinantset>
+)";
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString(wf_xml));
+
+  WaveFunctionComponentBuilder::PSetMap particle_set_map;
+  particle_set_map.emplace(elec_ptr->getName(), std::move(elec_ptr));
+  particle_set_map.emplace(ions_ptr->getName(), std::move(ions_ptr));
+
+  SPOSetBuilderFactory bf(c, elec, particle_set_map);
+  const auto bb_ptr = bf.createSPOSetBuilder(doc.getRoot());
+  auto sposet       = bb_ptr->createSPOSet(xmlNextElementSibling(xmlFirstElementChild(doc.getRoot())));
+  auto& lcao        = dynamic_cast<LCAOrbitalSet&>(*sposet);
+  REQUIRE(lcao.getBasisSetSize() == 3);
+
+  using Ranges = std::vector<std::pair<int, int>>;
+  const double C[3][3] = {{1.0, 0.5, 0.25}, {0.3, -1.0, 0.7}, {0.2, 0.4, -0.6}};
+  // single He atom values, see test_He
+  const double v0 = 0.9996037001, gx0 = -0.0006678035459, l0 = -20.03410564; // at 0.0001 bohr
+  const double v1 = 0.2315567641, gx1 = -0.3805431885, l1 = -0.2618497452;   // at 1 bohr
+
+  const size_t n_mo = 3;
+  SPOSet::ValueVector psi(n_mo), psi_v(n_mo);
+  SPOSet::GradVector dpsi(n_mo);
+  SPOSet::ValueVector d2psi(n_mo);
+
+  // only the first center is within reach of electron 0
+  sposet->evaluateVGL(elec, 0, psi, dpsi, d2psi);
+  REQUIRE(lcao.myBasisSet->getActiveBasisRanges() != nullptr);
+  CHECK(*lcao.myBasisSet->getActiveBasisRanges() == Ranges{{0, 1}});
+  sposet->evaluateValue(elec, 0, psi_v);
+  CHECK(*lcao.myBasisSet->getActiveBasisRanges() == Ranges{{0, 1}});
+  for (size_t iorb = 0; iorb < n_mo; iorb++)
+  {
+    CHECK(std::real(psi[iorb]) == Approx(C[iorb][0] * v0));
+    CHECK(std::real(psi_v[iorb]) == Approx(C[iorb][0] * v0));
+    CHECK(std::real(dpsi[iorb][0]) == Approx(C[iorb][0] * gx0));
+    CHECK(std::real(d2psi[iorb]) == Approx(C[iorb][0] * l0));
+  }
+
+  // electron 1 sits 1 bohr from the second center along y
+  sposet->evaluateVGL(elec, 1, psi, dpsi, d2psi);
+  CHECK(*lcao.myBasisSet->getActiveBasisRanges() == Ranges{{1, 2}});
+  for (size_t iorb = 0; iorb < n_mo; iorb++)
+  {
+    CHECK(std::real(psi[iorb]) == Approx(C[iorb][1] * v1));
+    CHECK(std::real(dpsi[iorb][1]) == Approx(C[iorb][1] * gx1));
+    CHECK(std::real(d2psi[iorb]) == Approx(C[iorb][1] * l1));
+  }
+
+  // the batched evaluation runs over the union of the active centers of all the walkers
+  ParticleSet elec_2(elec);
+  elec_2.R[0] = {81.0, 0.0, 0.0};
+  elec_2.update();
+
+  std::unique_ptr<SPOSet> sposet_2(sposet->makeClone());
+  RefVectorWithLeader<SPOSet> spo_list(*sposet, {*sposet, *sposet_2});
+  RefVectorWithLeader<ParticleSet> P_list(elec, {elec, elec_2});
+
+  SPOSet::ValueVector psi_1(n_mo), psi_2(n_mo), psi_v_1(n_mo), psi_v_2(n_mo);
+  SPOSet::GradVector dpsi_1(n_mo), dpsi_2(n_mo);
+  SPOSet::ValueVector d2psi_1(n_mo), d2psi_2(n_mo);
+  RefVector<SPOSet::ValueVector> psi_list{psi_1, psi_2};
+  RefVector<SPOSet::GradVector> dpsi_list{dpsi_1, dpsi_2};
+  RefVector<SPOSet::ValueVector> d2psi_list{d2psi_1, d2psi_2};
+  RefVector<SPOSet::ValueVector> psi_v_list{psi_v_1, psi_v_2};
+
+  ResourceCollection pset_res("test_pset_res");
+  ResourceCollection spo_res("test_spo_res");
+  elec.createResource(pset_res);
+  sposet->createResource(spo_res);
+  ResourceCollectionTeamLock<ParticleSet> mw_pset_lock(pset_res, P_list);
+  ResourceCollectionTeamLock<SPOSet> mw_sposet_lock(spo_res, spo_list);
+
+  sposet->mw_evaluateVGL(spo_list, P_list, 0, psi_list, dpsi_list, d2psi_list);
+  CHECK(*lcao.myBasisSet->getActiveBasisRanges() == Ranges{{0, 1}, {2, 3}});
+  sposet->mw_evaluateValue(spo_list, P_list, 0, psi_v_list);
+  CHECK(*lcao.myBasisSet->getActiveBasisRanges() == Ranges{{0, 1}, {2, 3}});
+  for (size_t iorb = 0; iorb < n_mo; iorb++)
+  {
+    CHECK(std::real(psi_1[iorb]) == Approx(C[iorb][0] * v0));
+    CHECK(std::real(psi_v_1[iorb]) == Approx(C[iorb][0] * v0));
+    CHECK(std::real(dpsi_1[iorb][0]) == Approx(C[iorb][0] * gx0));
+    CHECK(std::real(d2psi_1[iorb]) == Approx(C[iorb][0] * l0));
+    CHECK(std::real(psi_2[iorb]) == Approx(C[iorb][2] * v1));
+    CHECK(std::real(psi_v_2[iorb]) == Approx(C[iorb][2] * v1));
+    CHECK(std::real(dpsi_2[iorb][0]) == Approx(C[iorb][2] * gx1));
+    CHECK(std::real(d2psi_2[iorb]) == Approx(C[iorb][2] * l1));
+  }
+}
+
+
+#if !defined(QMC_COMPLEX)
+void test_He2_pbc_mw(bool transform)
+{
+  Communicate* c = OHMMS::Controller;
+
+  ParticleSet::ParticleLayout lattice;
+  lattice.R = {4.0, 0.0, 0.0, 0.0, 4.0, 0.0, 0.0, 0.0, 4.0};
+  lattice.BoxBConds = true; // periodic
+  lattice.reset();
+  const SimulationCell simulation_cell(lattice);
+
+  auto elec_ptr = std::make_unique<ParticleSet>(simulation_cell);
+  auto& elec(*elec_ptr);
+  elec.setName("e");
+  elec.create({1, 1});
+  elec.R[0] = {0.3, -0.2, 1.1};
+  elec.R[1] = {3.1, 0.9, 2.2};
+
+  SpeciesSet& tspecies       = elec.getSpeciesSet();
+  int upIdx                  = tspecies.addSpecies("u");
+  int downIdx                = tspecies.addSpecies("d");
+  int massIdx                = tspecies.addAttribute("mass");
+  tspecies(massIdx, upIdx)   = 1.0;
+  tspecies(massIdx, downIdx) = 1.0;
+
+  auto ions_ptr = std::make_unique<ParticleSet>(simulation_cell);
+  auto& ions(*ions_ptr);
+  ions.setName("ion0");
+  ions.create({2});
+  ions.R[0] = {0.0, 0.0, 0.0};
+  ions.R[1] = {2.0, 1.5, 1.0};
+  ions.getSpeciesSet().addSpecies("He");
+  ions.update();
+
+  elec.addTable(ions);
+  elec.update();
+
+  const std::string wf_xml = std::string(R"(<determinantset type="MolecularOrbital" name="LCAOBSet" source="ion0"
+                 PBCimages="2 2 2" cuspCorrection="no" transform=")") +
+      (transform ? "yes" : "no") + R"(">
+  <basisset name="LCAOBSet" keyword="GTO">
+    <atomicBasisSet name="Gaussian" angular="cartesian" type="Gaussian" elementType="He" normalized="no">
+      <grid type="log" ri="1.e-6" rf="1.e2" npts="1001"/>
+      <basisGroup rid="He00" n="0" l="0" type="Gaussian">
+        <radfunc exponent="6.362421400000e+00" contraction="1.543289672950e-01"/>
+        <radfunc exponent="1.158923000000e+00" contraction="5.353281422820e-01"/>
+        <radfunc exponent="3.136498000000e-01" contraction="4.446345421850e-01"/>
+      </basisGroup>
+      <basisGroup rid="He10" n="1" l="1" type="Gaussian">
+        <radfunc exponent="8.000000000000e-01" contraction="1.000000000000e+00"/>
+      </basisGroup>
+    </atomicBasisSet>
+  </basisset>
+  <sposet name="spo" size="2">
+    <coefficient size="8" id="C">
+      1.0  0.2 -0.3  0.1  0.5  0.0  0.4 -0.2
+      0.3 -0.5  0.7  0.2 -1.0  0.6  0.1  0.3
+    </coefficient>
+  </sposet>
+</determinantset>
+)";
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString(wf_xml));
+
+  WaveFunctionComponentBuilder::PSetMap particle_set_map;
+  particle_set_map.emplace(elec_ptr->getName(), std::move(elec_ptr));
+  particle_set_map.emplace(ions_ptr->getName(), std::move(ions_ptr));
+
+  SPOSetBuilderFactory bf(c, elec, particle_set_map);
+  const auto bb_ptr = bf.createSPOSetBuilder(doc.getRoot());
+  auto sposet       = bb_ptr->createSPOSet(xmlNextElementSibling(xmlFirstElementChild(doc.getRoot())));
+  auto& lcao        = dynamic_cast<LCAOrbitalSet&>(*sposet);
+  REQUIRE(lcao.getBasisSetSize() == 8);
+  // no screening when periodic images are summed
+  CHECK(lcao.myBasisSet->getActiveBasisRanges() == nullptr);
+
+  ParticleSet elec_2(elec);
+  elec_2.R[0] = {1.7, 2.5, -0.4};
+  elec_2.update();
+
+  const size_t n_mo = 2;
+  SPOSet::ValueVector psi_ref_1(n_mo), psi_ref_2(n_mo);
+  SPOSet::GradVector dpsi_ref_1(n_mo), dpsi_ref_2(n_mo);
+  SPOSet::ValueVector d2psi_ref_1(n_mo), d2psi_ref_2(n_mo);
+  sposet->evaluateVGL(elec, 0, psi_ref_1, dpsi_ref_1, d2psi_ref_1);
+  sposet->evaluateVGL(elec_2, 0, psi_ref_2, dpsi_ref_2, d2psi_ref_2);
+
+  std::unique_ptr<SPOSet> sposet_2(sposet->makeClone());
+  RefVectorWithLeader<SPOSet> spo_list(*sposet, {*sposet, *sposet_2});
+  RefVectorWithLeader<ParticleSet> P_list(elec, {elec, elec_2});
+
+  SPOSet::ValueVector psi_1(n_mo), psi_2(n_mo);
+  SPOSet::GradVector dpsi_1(n_mo), dpsi_2(n_mo);
+  SPOSet::ValueVector d2psi_1(n_mo), d2psi_2(n_mo);
+  RefVector<SPOSet::ValueVector> psi_list{psi_1, psi_2};
+  RefVector<SPOSet::GradVector> dpsi_list{dpsi_1, dpsi_2};
+  RefVector<SPOSet::ValueVector> d2psi_list{d2psi_1, d2psi_2};
+
+  ResourceCollection pset_res("test_pset_res");
+  ResourceCollection spo_res("test_spo_res");
+  elec.createResource(pset_res);
+  sposet->createResource(spo_res);
+  ResourceCollectionTeamLock<ParticleSet> mw_pset_lock(pset_res, P_list);
+  ResourceCollectionTeamLock<SPOSet> mw_sposet_lock(spo_res, spo_list);
+
+  // all the walkers x images of a center are evaluated in one batch
+  sposet->mw_evaluateVGL(spo_list, P_list, 0, psi_list, dpsi_list, d2psi_list);
+  for (size_t iorb = 0; iorb < n_mo; iorb++)
+  {
+    CHECK(psi_1[iorb] == Approx(psi_ref_1[iorb]));
+    CHECK(psi_2[iorb] == Approx(psi_ref_2[iorb]));
+    CHECK(d2psi_1[iorb] == Approx(d2psi_ref_1[iorb]));
+    CHECK(d2psi_2[iorb] == Approx(d2psi_ref_2[iorb]));
+    for (int idim = 0; idim < OHMMS_DIM; idim++)
+    {
+      CHECK(dpsi_1[iorb][idim] == Approx(dpsi_ref_1[iorb][idim]));
+      CHECK(dpsi_2[iorb][idim] == Approx(dpsi_ref_2[iorb][idim]));
+    }
+  }
+}
+
+TEST_CASE("mw_evaluateVGL GTO He2 periodic images", "[wavefunction]") { test_He2_pbc_mw(false); }
+TEST_CASE("mw_evaluateVGL Numerical He2 periodic images", "[wavefunction]") { test_He2_pbc_mw(true); }
+#endif
+
 } // namespace qmcplusplus
@@ -0,0 +1,183 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "OhmmsData/Libxml2Doc.h"
+#include "Particle/ParticleSet.h"
+#include "Particle/ParticleSetPool.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
+#include "QMCWaveFunctions/WaveFunctionFactory.h"
+#include "QMCWaveFunctions/Fermion/SlaterDetWithBackflow.h"
+#include "TWFGrads.hpp"
+#include "Utilities/RuntimeOptions.h"
+#include <ResourceCollection.h>
+
+namespace qmcplusplus
+{
+using RealType     = QMCTraits::RealType;
+using PosType      = QMCTraits::PosType;
+using GradType     = QMCTraits::GradType;
+using PsiValueType = QMCTraits::QTFull::ValueType;
+
+TEST_CASE("SlaterDetWithBackflow HEG", "[wavefunction][fermion]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  const char* cell_xml = R"(<simulationcell>
+  <parameter name="lattice" units="bohr">
+    4.0 0.0 0.0
+    0.0 4.0 0.0
+    0.0 0.0 4.0
+  </parameter>
+  <parameter name="bconds"> p p p </parameter>
+  <parameter name="LR_dim_cutoff"> 6 </parameter>
+</simulationcell>
+)";
+
+  const char* pset_xml = R"(<particleset name="e" random="no">
+  <group name="u" size="3" mass="1.0">
+    <parameter name="charge"> -1 </parameter>
+    <attrib name="position" datatype="posArray" condition="0">
+      0.1 0.3 0.5
+      1.7 2.2 0.9
+      3.1 0.4 2.6
+    </attrib>
+  </group>
+  <group name="d" size="3" mass="1.0">
+    <parameter name="charge"> -1 </parameter>
+    <attrib name="position" datatype="posArray" condition="0">
+      2.4 3.3 1.2
+      0.6 1.5 3.4
+      1.9 0.2 2.0
+    </attrib>
+  </group>
+</particleset>
+)";
+
+  const char* wf_xml = R"(<wavefunction name="psi0" target="e">
+  <sposet_builder type="heg">
+    <sposet type="heg" name="spo_ud" size="3"/>
+  </sposet_builder>
+  <determinantset>
+    <slaterdeterminant>
+      <determinant id="updet" group="u" sposet="spo_ud" size="3"/>
+      <determinant id="downdet" group="d" sposet="spo_ud" size="3"/>
+    </slaterdeterminant>
+    <backflow>
+      <transformation name="eeB" type="e-e" function="Bspline">
+        <correlation cusp="0.0" speciesA="u" speciesB="u" size="5" type="shortrange" init="no">
+          <coefficients id="eeuu" type="Array"> 0.1062989927 0.06173674368 0.08246051331 0.01993157184 0.02842145713</coefficients>
+        </correlation>
+        <correlation cusp="0.0" speciesA="u" speciesB="d" size="5" type="shortrange" init="no">
+          <coefficients id="eeud" type="Array"> 0.5824836964 0.272210709 0.1644887754 0.07508022611 0.03887818308</coefficients>
+        </correlation>
+      </transformation>
+    </backflow>
+  </determinantset>
+</wavefunction>
+)";
+
+  Libxml2Document doc;
+  ParticleSetPool ptcl(c);
+  REQUIRE(doc.parseFromString(cell_xml));
+  ptcl.readSimulationCellXML(doc.getRoot());
+  REQUIRE(doc.parseFromString(pset_xml));
+  ptcl.put(doc.getRoot());
+  ParticleSet& elec(*ptcl.getParticleSet("e"));
+  ParticleSet elec_clone(elec);
+
+  REQUIRE(doc.parseFromString(wf_xml));
+  WaveFunctionFactory wf_factory(elec, ptcl.getPool(), c);
+  RuntimeOptions runtime_options;
+  auto twf_ptr = wf_factory.buildTWF(doc.getRoot(), runtime_options);
+  auto& twf(*twf_ptr);
+  REQUIRE(dynamic_cast<SlaterDetWithBackflow*>(twf.getOrbitals()[0].get()) != nullptr);
+  auto twf_clone = twf.makeClone(elec_clone);
+
+  elec.update();
+  twf.evaluateLog(elec);
+  const RealType logpsi_old = twf.getLogPsi();
+
+  // a single particle move changes every quasi-particle within the backflow cutoff.
+  // The low rank update of the inverse must reproduce a full evaluation at the new configuration
+  const int iel = 1;
+  const PosType delta(0.3, -0.2, 0.25);
+  GradType grad_new;
+  elec.makeMove(iel, delta);
+  const PsiValueType ratio      = twf.calcRatio(elec, iel);
+  const PsiValueType ratio_grad = twf.calcRatioGrad(elec, iel, grad_new);
+  CHECK(ratio_grad == ValueApprox(ratio));
+  twf.acceptMove(elec, iel);
+  elec.acceptMove(iel);
+  twf.completeUpdates();
+  const RealType logpsi_new = twf.getLogPsi();
+  CHECK(logpsi_new == Approx(logpsi_old + std::log(std::abs(ratio))));
+
+  elec.update();
+  twf.evaluateLog(elec);
+  CHECK(twf.getLogPsi() == Approx(logpsi_new));
+  GradType grad_check = twf.evalGrad(elec, iel);
+  for (int idim = 0; idim < OHMMS_DIM; idim++)
+    CHECK(grad_new[idim] == ValueApprox(grad_check[idim]));
+
+  // batched APIs against the single walker ones, the clone stays at the original configuration
+  ResourceCollection pset_res("test_pset_res");
+  ResourceCollection twf_res("test_twf_res");
+  elec.createResource(pset_res);
+  twf.createResource(twf_res);
+
+  RefVectorWithLeader<ParticleSet> p_ref_list(elec, {elec, elec_clone});
+  RefVectorWithLeader<TrialWaveFunction> wf_ref_list(twf, {twf, *twf_clone});
+  ResourceCollectionTeamLock<ParticleSet> mw_pset_lock(pset_res, p_ref_list);
+  ResourceCollectionTeamLock<TrialWaveFunction> mw_twf_lock(twf_res, wf_ref_list);
+
+  ParticleSet::mw_update(p_ref_list);
+  TrialWaveFunction::mw_evaluateLog(wf_ref_list, p_ref_list);
+  CHECK(wf_ref_list[0].getLogPsi() == Approx(logpsi_new));
+  CHECK(wf_ref_list[1].getLogPsi() == Approx(logpsi_old));
+
+  std::vector<PosType> displs{delta, delta};
+  ParticleSet::mw_makeMove(p_ref_list, iel, displs);
+  std::vector<PsiValueType> ratios(2);
+  TWFGrads<CoordsType::POS> grads(2);
+  TrialWaveFunction::mw_calcRatio(wf_ref_list, p_ref_list, iel, ratios);
+  CHECK(ratios[1] == ValueApprox(ratio));
+  // walker 0 is at a different configuration, check it against the single walker APIs
+  const PsiValueType ratio_walker0 = ratios[0];
+  CHECK(twf.calcRatio(elec, iel) == ValueApprox(ratio_walker0));
+
+  TrialWaveFunction::mw_calcRatioGrad(wf_ref_list, p_ref_list, iel, ratios, grads);
+  CHECK(ratios[0] == ValueApprox(ratio_walker0));
+  CHECK(ratios[1] == ValueApprox(ratio));
+  GradType grad_walker0;
+  CHECK(twf.calcRatioGrad(elec, iel, grad_walker0) == ValueApprox(ratio_walker0));
+  for (int idim = 0; idim < OHMMS_DIM; idim++)
+  {
+    CHECK(grads.grads_positions[0][idim] == ValueApprox(grad_walker0[idim]));
+    CHECK(grads.grads_positions[1][idim] == ValueApprox(grad_new[idim]));
+  }
+
+  std::vector<bool> isAccepted{false, true};
+  TrialWaveFunction::mw_accept_rejectMove(wf_ref_list, p_ref_list, iel, isAccepted);
+  ParticleSet::mw_accept_rejectMove(p_ref_list, iel, isAccepted);
+  TrialWaveFunction::mw_completeUpdates(wf_ref_list);
+  CHECK(wf_ref_list[0].getLogPsi() == Approx(logpsi_new));
+  CHECK(wf_ref_list[1].getLogPsi() == Approx(logpsi_new));
+
+  // both walkers are now at the same configuration
+  ParticleSet::mw_update(p_ref_list);
+  TrialWaveFunction::mw_evaluateLog(wf_ref_list, p_ref_list);
+  CHECK(wf_ref_list[0].getLogPsi() == Approx(logpsi_new));
+  CHECK(wf_ref_list[1].getLogPsi() == Approx(logpsi_new));
+}
+} // namespace qmcplusplus
@@ -14,6 +14,7 @@
 
 #include "OhmmsPETE/OhmmsMatrix.h"
 #include "QMCWaveFunctions/Fermion/MultiDiracDeterminant.h"
+#include "QMCWaveFunctions/Fermion/SmallMatrixDetCalculator.h"
 
 //#include <stdio.h>
 #include <string>
@@ -29,14 +30,12 @@ class TestSmallMatrixDetCalculator
   template<typename DT>
   using OffloadMatrix = Matrix<DT, OffloadPinnedAllocator<DT>>;
 
-  SmallMatrixDetCalculator<double> MDDC;
   OffloadMatrix<double> dots;
   std::vector<int> it_things;
 
 public:
   void build_interal_data(int dim_size)
   {
-    MDDC.resize(dim_size);
     dots.resize(dim_size, dim_size);
     it_things.resize(2 * dim_size);
 
@@ -59,12 +58,6 @@ public:
       it_things[i] = it_things[i + dim_size] = i;
   }
 
-  T generic_evaluate(int dim_size)
-  {
-    build_interal_data(dim_size);
-    return MDDC.evaluate(dots, it_things.data(), dim_size);
-  }
-
   template<unsigned EXT_LEVEL>
   T customized_evaluate()
   {
@@ -78,21 +71,65 @@ public:
 TEST_CASE("SmallMatrixDetCalculator::evaluate-Small", "[wavefunction][fermion][multidet]")
 {
   TestSmallMatrixDetCalculator<double> double_test;
-  CHECK(double_test.generic_evaluate(1) == Approx(0.0));
-  CHECK(double_test.generic_evaluate(2) == Approx(0.5));
-  CHECK(double_test.generic_evaluate(3) == Approx(-0.7407407407));
-  CHECK(double_test.generic_evaluate(4) == Approx(-0.87890625));
-  CHECK(double_test.generic_evaluate(5) == Approx(-0.96768));
-
   CHECK(double_test.customized_evaluate<1>() == Approx(0.0));
   CHECK(double_test.customized_evaluate<2>() == Approx(0.5));
   CHECK(double_test.customized_evaluate<3>() == Approx(-0.7407407407));
   CHECK(double_test.customized_evaluate<4>() == Approx(-0.87890625));
   CHECK(double_test.customized_evaluate<5>() == Approx(-0.96768));
+}
+
+TEST_CASE("ExcitationTrie::evaluate", "[wavefunction][fermion][multidet]")
+{
+  using OffloadMatrix = Matrix<double, OffloadPinnedAllocator<double>>;
+
+  // excitations {pos..., uno...} of a reference, levels 6, 6, 6, 7, 7 and 8 sharing prefixes
+  const std::vector<std::vector<int>> excitations{{0, 1, 2, 3, 4, 5, 10, 11, 12, 13, 14, 15},
+                                                  {0, 1, 2, 3, 4, 6, 10, 11, 12, 13, 14, 16},
+                                                  {0, 1, 2, 3, 5, 6, 10, 11, 12, 13, 15, 16},
+                                                  {0, 1, 2, 3, 4, 5, 6, 10, 11, 12, 13, 14, 15, 16},
+                                                  {0, 1, 2, 3, 4, 5, 7, 10, 11, 12, 13, 14, 15, 17},
+                                                  {0, 1, 2, 3, 4, 5, 6, 7, 10, 11, 12, 13, 14, 15, 16, 17}};
+  std::vector<int> data{0};
+  for (auto& ex : excitations)
+  {
+    const int n = ex.size() / 2;
+    data.push_back(n);
+    data.insert(data.end(), ex.begin(), ex.end());
+    data.insert(data.end(), n, 0);
+  }
+  const std::vector<int> ndets_per_excitation_level{1, 0, 0, 0, 0, 0, 3, 2, 1};
+
+  ExcitationTrie<double> trie;
+  trie.build(data.data(), ndets_per_excitation_level, 6);
+  CHECK(trie.getFirstDet() == 1);
+  // 4 shared by all, then 2, 3, 2 and 1 at depths 5 to 8
+  CHECK(trie.getNumNodes() == 12);
+
+  OffloadMatrix table_matrix(18, 18);
+  for (int i = 0; i < 18; i++)
+    for (int j = 0; j < 18; j++)
+      table_matrix(i, j) = std::sin(1.3 * i + 0.7 * j * j) + (i + 10 == j ? 2.0 : 0.0);
+
+  ExcitationTrie<double>::Workspace ws;
+  auto check_dets = [&]() {
+    std::vector<double> dets(excitations.size() + 1, 0.0);
+    trie.evaluate(table_matrix, dets.data(), ws);
+    for (int id = 0; id < excitations.size(); id++)
+    {
+      const int n = excitations[id].size() / 2;
+      std::vector<double> minor(n * n);
+      std::vector<int> pivot(n);
+      for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+          minor[i * n + j] = table_matrix(excitations[id][i], excitations[id][n + j]);
+      CHECK(dets[id + 1] == Approx(Determinant(minor.data(), n, n, pivot.data())));
+    }
+  };
 
-  CHECK(double_test.generic_evaluate(1<<3) == Approx(-1.1086723208));
-  CHECK(double_test.generic_evaluate(1<<7) == Approx(-1.3432116824));
-  CHECK(double_test.generic_evaluate(1<<12) == Approx(-1.3586431786));
+  check_dets();
+  // singular leading minors fall back to factorizations
+  table_matrix(0, 10) = 0.0;
+  check_dets();
 }
 
 } // namespace qmcplusplus
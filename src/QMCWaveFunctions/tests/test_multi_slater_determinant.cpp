@@ -19,6 +19,7 @@
 #include "WaveFunctionFactory.h"
 #include "LCAO/LCAOrbitalSet.h"
 #include "TWFGrads.hpp"
+#include "Fermion/MultiSlaterDetTableMethod.h"
 #include "Utilities/RuntimeOptions.h"
 #include <ResourceCollection.h>
 
@@ -296,6 +297,38 @@ void test_LiH_msd(const std::string& spo_xml_string,
     CHECK(wf_ref_list[0].getLogPsi() == Approx(-7.803347327300152));
     CHECK(wf_ref_list[1].getLogPsi() == Approx(-7.321765331299484));
 
+    // batched virtual moves, reference particles in the same group and in different groups
+    for (const int ref_ptcl_1 : {1, 2})
+    {
+      VirtualParticleSet vp_0(elec_, 2), vp_1(elec_clone, 2);
+      vp_0.makeMoves(elec_, 1, {PosType(0.3, 0.2, 0.5) - elec_.R[1], PosType(0.2, 0.5, 0.3) - elec_.R[1]});
+      vp_1.makeMoves(elec_clone, ref_ptcl_1,
+                     {PosType(0.1, -0.2, 0.4) - elec_clone.R[ref_ptcl_1],
+                      PosType(-0.3, 0.1, 0.2) - elec_clone.R[ref_ptcl_1]});
+      RefVectorWithLeader<const VirtualParticleSet> vp_list(vp_0, {vp_0, vp_1});
+
+      std::vector<std::vector<ValueType>> vp_ratios(2, std::vector<ValueType>(2));
+      std::vector<Matrix<ValueType>> vp_dratios(2, Matrix<ValueType>(2, nparam));
+      TrialWaveFunction::mw_evaluateRatios(wf_ref_list, vp_list, {vp_ratios[0], vp_ratios[1]});
+      auto mw_ratios = vp_ratios;
+      TrialWaveFunction::mw_evaluateDerivRatios(wf_ref_list, vp_list, active, {vp_ratios[0], vp_ratios[1]},
+                                                {vp_dratios[0], vp_dratios[1]});
+
+      for (int iw = 0; iw < 2; iw++)
+      {
+        std::vector<ValueType> ratios_ref(2);
+        Matrix<ValueType> dratios_ref(2, nparam);
+        wf_ref_list[iw].evaluateDerivRatios(vp_list[iw], active, ratios_ref, dratios_ref);
+        for (int k = 0; k < 2; k++)
+        {
+          CHECK(mw_ratios[iw][k] == ValueApprox(ratios_ref[k]));
+          CHECK(vp_ratios[iw][k] == ValueApprox(ratios_ref[k]));
+          for (int ip = 0; ip < nparam; ip++)
+            CHECK(vp_dratios[iw][k][ip] == ValueApprox(dratios_ref[k][ip]));
+        }
+      }
+    }
+
     // move the next electron
     TrialWaveFunction::mw_prepareGroup(wf_ref_list, p_ref_list, 1);
     const int moved_elec_id_next = 2;
@@ -386,6 +419,156 @@ TEST_CASE("LiH multi Slater dets precomputed_table_method", "[wavefunction]")
   test_LiH_msd(spo_xml_string1_new, "spo-up", 85, 105, true, true);
 }
 
+TEST_CASE("CIScreening", "[wavefunction]")
+{
+  CIScreening screening(4, 0.1, 2, 1);
+  CHECK(screening.getNumKeptTerms() == 4);
+  CHECK(screening.getKeptTerms() == nullptr);
+
+  const std::vector<RealType> contributions{0.9, 0.05, 0.03, 0.5};
+  screening.accumulate([&](size_t i) { return contributions[i]; }, 0.0);
+  CHECK(screening.getGeneration() == 0);
+  screening.accumulate([&](size_t i) { return contributions[i]; }, 0.02);
+  CHECK(screening.getGeneration() == 1);
+
+  // the two smallest terms sum up to 0.08, adding the next one exceeds 0.1
+  auto kept = screening.getKeptTerms();
+  REQUIRE(kept != nullptr);
+  CHECK(*kept == std::vector<size_t>{0, 3});
+  CHECK(screening.getEstimatedError() == Approx(0.08));
+  CHECK(screening.getMeasuredError() == Approx(0.01));
+
+  // dropped terms growing above the tolerance are included again
+  const std::vector<RealType> grown{0.9, 0.2, 0.03, 0.5};
+  screening.accumulate([&](size_t i) { return grown[i]; }, 0.2);
+  screening.accumulate([&](size_t i) { return grown[i]; }, 0.2);
+  CHECK(screening.getGeneration() == 2);
+  CHECK(*screening.getKeptTerms() == std::vector<size_t>{0, 1, 3});
+  CHECK(screening.getEstimatedError() == Approx(0.03));
+  CHECK(screening.getMeasuredError() == Approx(0.2));
+
+  CHECK_THROWS_AS(CIScreening(4, 0.1, 0, 1), std::runtime_error);
+}
+
+TEST_CASE("LiH multi Slater dets runtime CI screening", "[wavefunction]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  ParticleSetPool ptcl = ParticleSetPool(c);
+  auto ions_uptr       = std::make_unique<ParticleSet>(ptcl.getSimulationCell());
+  auto elec_uptr       = std::make_unique<ParticleSet>(ptcl.getSimulationCell());
+  ParticleSet& ions_(*ions_uptr);
+  ParticleSet& elec_(*elec_uptr);
+
+  ions_.setName("ion0");
+  ptcl.addParticleSet(std::move(ions_uptr));
+  ions_.create({1, 1});
+  ions_.R[0]           = {0.0, 0.0, 0.0};
+  ions_.R[1]           = {0.0, 0.0, 3.0139239693};
+  SpeciesSet& ispecies = ions_.getSpeciesSet();
+  ispecies.addSpecies("Li");
+  ispecies.addSpecies("H");
+
+  elec_.setName("elec");
+  ptcl.addParticleSet(std::move(elec_uptr));
+  elec_.create({2, 2});
+  elec_.R[0] = {0.5, 0.5, 0.5};
+  elec_.R[1] = {0.1, 0.1, 1.1};
+  elec_.R[2] = {-0.5, -0.5, -0.5};
+  elec_.R[3] = {-0.1, -0.1, 1.5};
+
+  SpeciesSet& tspecies       = elec_.getSpeciesSet();
+  int upIdx                  = tspecies.addSpecies("u");
+  int downIdx                = tspecies.addSpecies("d");
+  int massIdx                = tspecies.addAttribute("mass");
+  tspecies(massIdx, upIdx)   = 1.0;
+  tspecies(massIdx, downIdx) = 1.0;
+  elec_.resetGroups();
+
+  const char* wf_xml_string = R"(<wavefunction name="psi0" target="e">
+    <sposet_collection type="MolecularOrbital" name="LCAOBSet" source="ion0" cuspCorrection="no" href="LiH.orbs.h5">
+      <basisset name="LCAOBSet" key="GTO" transform="yes">
+        <grid type="log" ri="1.e-6" rf="1.e2" npts="1001"/>
+      </basisset>
+      <sposet basisset="LCAOBSet" name="spo-up" size="85">
+        <occupation mode="ground"/>
+        <coefficient size="85" spindataset="0"/>
+      </sposet>
+      <sposet basisset="LCAOBSet" name="spo-dn" size="85">
+        <occupation mode="ground"/>
+        <coefficient size="85" spindataset="0"/>
+      </sposet>
+    </sposet_collection>
+    <determinantset>
+      <multideterminant optimize="no" spo_up="spo-up" spo_dn="spo-dn" algorithm="precomputed_table_method"
+                        screening_tolerance="1e-3" screening_samples="1" screening_interval="2">
+        <detlist size="1487" type="DETS" cutoff="1e-20" href="LiH.orbs.h5"/>
+      </multideterminant>
+    </determinantset>
+</wavefunction>
+)";
+
+  Libxml2Document doc;
+  REQUIRE(doc.parseFromString(wf_xml_string));
+  WaveFunctionFactory wf_factory(elec_, ptcl.getPool(), c);
+  RuntimeOptions runtime_options;
+  auto twf_ptr = wf_factory.buildTWF(doc.getRoot(), runtime_options);
+  auto& twf(*twf_ptr);
+  auto& msd = dynamic_cast<MultiSlaterDetTableMethod&>(*twf.getOrbitals()[0]);
+  REQUIRE(msd.getCIScreening() != nullptr);
+  const CIScreening& screening(*msd.getCIScreening());
+
+  ions_.update();
+  elec_.update();
+  twf.setMassTerm(elec_);
+
+  // every second evaluation is sampled. The first sample uses all the terms and triggers the first truncation
+  const size_t num_dets = msd.getNumActiveDets();
+  twf.evaluateLog(elec_);
+  CHECK(screening.getGeneration() == 0);
+  PosType delta(0.1, 0.05, -0.1);
+  elec_.makeMove(1, delta);
+  const auto ratio_all = twf.calcRatio(elec_, 1);
+  elec_.rejectMove(1);
+  twf.evaluateLog(elec_);
+  CHECK(std::complex<double>(twf.getLogPsi(), twf.getPhase()) ==
+        LogComplexApprox(std::complex<double>(-7.646027846242066, 3.141592653589793)));
+  CHECK(screening.getGeneration() == 1);
+  CHECK(screening.getMeasuredError() == Approx(0.0));
+  const size_t nkept = screening.getNumKeptTerms();
+  CHECK(nkept < 1487);
+  const RealType estimated_error = screening.getEstimatedError();
+  CHECK(estimated_error <= 1e-3);
+  CHECK(msd.getNumActiveDets() == num_dets);
+
+  // the next evaluation only computes the unique determinants of the kept terms
+  twf.evaluateLog(elec_);
+  CHECK(msd.getNumActiveDets() < num_dets);
+  const double logpsi_kept = twf.getLogPsi();
+  CHECK(std::abs(logpsi_kept + 7.646027846242066) < 2 * estimated_error);
+
+  // so do particle moves
+  elec_.makeMove(1, delta);
+  const auto ratio_kept = twf.calcRatio(elec_, 1);
+  elec_.rejectMove(1);
+  CHECK(std::abs(ratio_kept / ratio_all - 1.0) < 4 * estimated_error);
+
+  // the sampled evaluation uses all the unique determinants with the kept terms.
+  // At the same configuration the error is bounded by the estimate
+  twf.evaluateLog(elec_);
+  CHECK(screening.getGeneration() == 2);
+  CHECK(screening.getNumKeptTerms() == nkept);
+  CHECK(screening.getMeasuredError() > 0.0);
+  CHECK(screening.getMeasuredError() <= estimated_error * (1 + 1e-6));
+  CHECK(twf.getLogPsi() == Approx(logpsi_kept));
+  CHECK(msd.getNumActiveDets() < num_dets);
+
+  // the ratio of the kept terms doesn't depend on the unique determinants left out
+  elec_.makeMove(1, delta);
+  CHECK(ValueApprox(twf.calcRatio(elec_, 1)) == ratio_kept);
+  elec_.rejectMove(1);
+}
+
 #ifdef QMC_COMPLEX
 void test_Bi_msd(const std::string& spo_xml_string,
                  const std::string& check_sponame,
@@ -24,6 +24,8 @@
 #include "QMCWaveFunctions/LCAO/CuspCorrection.h"
 
 #include "QMCWaveFunctions/SPOSetBuilderFactory.h"
+#include "CPU/SIMD/simd.hpp"
+#include <ResourceCollection.h>
 
 namespace qmcplusplus
 {
@@ -404,6 +406,87 @@ TEST_CASE("HCN MO with cusp", "[wavefunction]")
   CHECK(all_grad[0][1][1] == Approx(0.0000000000));
   CHECK(all_grad[0][1][2] == Approx(0.0000000000));
   CHECK(all_lap[0][1] == Approx(19.8720529007));
+
+  // batched APIs against the single walker ones, both walkers within the cusp correction radius of N
+  ParticleSet elec_2(elec);
+  elec_2.R[0][0] = -1.1;
+  elec_2.R[0][1] = 0.01;
+  elec_2.update();
+  elec_2.makeMove(0, newpos);
+
+  const size_t norb = sposet->getOrbitalSetSize();
+  SPOSet::ValueVector psi_ref_1(norb), psi_ref_2(norb), d2psi_ref_1(norb), d2psi_ref_2(norb);
+  SPOSet::GradVector dpsi_ref_1(norb), dpsi_ref_2(norb);
+  sposet->evaluateVGL(elec, 0, psi_ref_1, dpsi_ref_1, d2psi_ref_1);
+  sposet->evaluateVGL(elec_2, 0, psi_ref_2, dpsi_ref_2, d2psi_ref_2);
+
+  RefVectorWithLeader<SPOSet> spo_list(*sposet, {*sposet, *sposet_clone});
+  RefVectorWithLeader<ParticleSet> P_list(elec, {elec, elec_2});
+  ResourceCollection pset_res("test_pset_res");
+  ResourceCollection spo_res("test_spo_res");
+  elec.createResource(pset_res);
+  sposet->createResource(spo_res);
+  ResourceCollectionTeamLock<ParticleSet> mw_pset_lock(pset_res, P_list);
+  ResourceCollectionTeamLock<SPOSet> mw_sposet_lock(spo_res, spo_list);
+
+  SPOSet::ValueVector psi_1(norb), psi_2(norb), d2psi_1(norb), d2psi_2(norb), psi_v_1(norb), psi_v_2(norb);
+  SPOSet::GradVector dpsi_1(norb), dpsi_2(norb);
+  RefVector<SPOSet::ValueVector> psi_list{psi_1, psi_2};
+  RefVector<SPOSet::GradVector> dpsi_list{dpsi_1, dpsi_2};
+  RefVector<SPOSet::ValueVector> d2psi_list{d2psi_1, d2psi_2};
+  RefVector<SPOSet::ValueVector> psi_v_list{psi_v_1, psi_v_2};
+  sposet->mw_evaluateVGL(spo_list, P_list, 0, psi_list, dpsi_list, d2psi_list);
+  sposet->mw_evaluateValue(spo_list, P_list, 0, psi_v_list);
+  for (size_t iorb = 0; iorb < norb; iorb++)
+  {
+    CHECK(psi_1[iorb] == Approx(psi_ref_1[iorb]));
+    CHECK(psi_2[iorb] == Approx(psi_ref_2[iorb]));
+    CHECK(psi_v_1[iorb] == Approx(psi_ref_1[iorb]));
+    CHECK(psi_v_2[iorb] == Approx(psi_ref_2[iorb]));
+    CHECK(d2psi_1[iorb] == Approx(d2psi_ref_1[iorb]));
+    CHECK(d2psi_2[iorb] == Approx(d2psi_ref_2[iorb]));
+    for (int idim = 0; idim < OHMMS_DIM; idim++)
+    {
+      CHECK(dpsi_1[iorb][idim] == Approx(dpsi_ref_1[iorb][idim]));
+      CHECK(dpsi_2[iorb][idim] == Approx(dpsi_ref_2[iorb][idim]));
+    }
+  }
+
+  SPOSet::ValueVector inv_row(norb);
+  for (size_t iorb = 0; iorb < norb; iorb++)
+    inv_row[iorb] = 0.1 * (iorb + 1);
+  std::vector<const SPOSet::ValueType*> inv_row_ptr_list{inv_row.data(), inv_row.data()};
+  SPOSet::OffloadMWVGLArray phi_vgl_v;
+  phi_vgl_v.resize(QMCTraits::DIM_VGL, 2, norb);
+  std::vector<SPOSet::ValueType> ratios(2);
+  std::vector<SPOSet::GradType> grads(2);
+  sposet->mw_evaluateVGLandDetRatioGrads(spo_list, P_list, 0, inv_row_ptr_list, phi_vgl_v, ratios, grads);
+  const SPOSet::ValueType ratio_ref_2 = simd::dot(psi_ref_2.data(), inv_row.data(), norb);
+  CHECK(ratios[0] == Approx(simd::dot(psi_ref_1.data(), inv_row.data(), norb)));
+  CHECK(ratios[1] == Approx(ratio_ref_2));
+  SPOSet::ValueType dphi_x = 0;
+  for (size_t iorb = 0; iorb < norb; iorb++)
+    dphi_x += dpsi_ref_2[iorb][0] * inv_row[iorb];
+  CHECK(grads[1][0] == Approx(dphi_x / ratio_ref_2));
+
+  // virtual moves into the cusp correction radius of N
+  using PosType = ParticleSet::SingleParticlePos;
+  VirtualParticleSet vp(elec, 2), vp_2(elec_2, 2);
+  vp.makeMoves(elec, 1, {PosType(-1.08, 0.0, 0.0) - elec.R[1], PosType(0.5, 0.2, 0.1) - elec.R[1]});
+  vp_2.makeMoves(elec_2, 1, {PosType(-1.1, 0.02, 0.0) - elec_2.R[1], PosType(-1.09, 0.0, 0.01) - elec_2.R[1]});
+  std::vector<SPOSet::ValueType> vp_ratios_ref(2), vp_ratios_ref_2(2);
+  sposet->SPOSet::evaluateDetRatios(vp, psi_1, inv_row, vp_ratios_ref);
+  sposet->SPOSet::evaluateDetRatios(vp_2, psi_2, inv_row, vp_ratios_ref_2);
+
+  std::vector<std::vector<SPOSet::ValueType>> vp_ratios_list{std::vector<SPOSet::ValueType>(2),
+                                                             std::vector<SPOSet::ValueType>(2)};
+  RefVectorWithLeader<const VirtualParticleSet> vp_list(vp, {vp, vp_2});
+  sposet->mw_evaluateDetRatios(spo_list, vp_list, psi_list, inv_row_ptr_list, vp_ratios_list);
+  for (int j = 0; j < 2; j++)
+  {
+    CHECK(vp_ratios_list[0][j] == Approx(vp_ratios_ref[j]));
+    CHECK(vp_ratios_list[1][j] == Approx(vp_ratios_ref_2[j]));
+  }
 }
 
 // Test case with multiple atoms of the same type
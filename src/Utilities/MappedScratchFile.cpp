@@ -0,0 +1,73 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "MappedScratchFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace qmcplusplus
+{
+MappedScratchFile::MappedScratchFile(const std::string& directory, size_t bytes) : data_(nullptr), bytes_(bytes)
+{
+  std::string name = directory + "/qmcpack_scratch_XXXXXX";
+  std::vector<char> name_buf(name.begin(), name.end());
+  name_buf.push_back('\0');
+  const int fd = mkstemp(name_buf.data());
+  if (fd < 0)
+    throw std::runtime_error("MappedScratchFile cannot create a file in " + directory + ": " + std::strerror(errno));
+  // the mapping keeps the storage alive, the name is not needed any more
+  unlink(name_buf.data());
+
+  if (bytes_ > 0)
+  {
+    if (ftruncate(fd, bytes_) != 0)
+    {
+      const std::string reason(std::strerror(errno));
+      close(fd);
+      throw std::runtime_error("MappedScratchFile cannot reserve " + std::to_string(bytes_) + " bytes in " + directory +
+                               ": " + reason);
+    }
+    data_ = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data_ == MAP_FAILED)
+    {
+      const std::string reason(std::strerror(errno));
+      close(fd);
+      throw std::runtime_error("MappedScratchFile cannot map " + std::to_string(bytes_) + " bytes: " + reason);
+    }
+  }
+  close(fd);
+}
+
+MappedScratchFile::~MappedScratchFile()
+{
+  if (data_ != nullptr)
+    munmap(data_, bytes_);
+}
+
+void MappedScratchFile::release(size_t offset, size_t bytes) const
+{
+  const size_t page  = sysconf(_SC_PAGESIZE);
+  const size_t first = (offset + page - 1) / page * page;
+  const size_t last  = std::min(offset + bytes, bytes_) / page * page;
+  if (data_ == nullptr || last <= first)
+    return;
+  // shared file mappings keep the content in the page cache and the file, dirty pages are written back by the kernel
+  madvise(static_cast<char*>(data_) + first, last - first, MADV_DONTNEED);
+}
+
+} // namespace qmcplusplus
@@ -0,0 +1,57 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_MAPPED_SCRATCH_FILE_H
+#define QMCPLUSPLUS_MAPPED_SCRATCH_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace qmcplusplus
+{
+/** Anonymous file in a scratch directory mapped into memory
+ *
+ *  Large arrays that are produced once and swept over in passes can live in it instead of in the heap.
+ *  The file is unlinked right after creation so it never outlives the process.
+ *  Its pages are loaded by the kernel when touched and can be evicted under memory pressure.
+ *  release() drops a range from the resident set of the process once a pass over it is done.
+ */
+class MappedScratchFile
+{
+public:
+  /** create and map a file
+   * @param directory scratch directory, preferably node local
+   * @param bytes size of the mapping
+   */
+  MappedScratchFile(const std::string& directory, size_t bytes);
+  ~MappedScratchFile();
+
+  MappedScratchFile(const MappedScratchFile&)            = delete;
+  MappedScratchFile& operator=(const MappedScratchFile&) = delete;
+
+  void* data() const { return data_; }
+  size_t size() const { return bytes_; }
+
+  /** drop the pages fully inside [offset, offset + bytes) from the resident set
+   * The content is kept in the file and the pages are read back when touched again.
+   */
+  void release(size_t offset, size_t bytes) const;
+
+private:
+  /// mapped address
+  void* data_;
+  /// size of the mapping
+  size_t bytes_;
+};
+
+} // namespace qmcplusplus
+#endif
@@ -0,0 +1,193 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file
+ *  Counter-based Philox4x32-10 engine with the interface of StdRandom
+ *
+ *  J. K. Salmon, M. A. Moraes, R. O. Dror and D. E. Shaw, "Parallel random numbers: as easy as 1, 2, 3", SC11.
+ *  The n-th block of four 32-bit outputs is a pure function of the key and the counter n,
+ *  so the state is a handful of integers and blocks are generated independently in bulk.
+ */
+#ifndef QMCPLUSPLUS_PHILOXRANDOM_H
+#define QMCPLUSPLUS_PHILOXRANDOM_H
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace qmcplusplus
+{
+/** Philox4x32 bijection with 10 rounds
+ * @param ctr 128-bit counter
+ * @param key 64-bit key
+ * @return four 32-bit random integers
+ */
+inline std::array<uint32_t, 4> philox4x32_10(std::array<uint32_t, 4> ctr, std::array<uint32_t, 2> key)
+{
+  constexpr uint64_t M0 = 0xD2511F53;
+  constexpr uint64_t M1 = 0xCD9E8D57;
+  constexpr uint32_t W0 = 0x9E3779B9;
+  constexpr uint32_t W1 = 0xBB67AE85;
+  for (int round = 0; round < 10; round++)
+  {
+    const uint64_t prod0 = M0 * ctr[0];
+    const uint64_t prod1 = M1 * ctr[2];
+    ctr = {static_cast<uint32_t>(prod1 >> 32) ^ ctr[1] ^ key[0], static_cast<uint32_t>(prod1),
+           static_cast<uint32_t>(prod0 >> 32) ^ ctr[3] ^ key[1], static_cast<uint32_t>(prod0)};
+    key[0] += W0;
+    key[1] += W1;
+  }
+  return ctr;
+}
+
+template<typename T>
+class PhiloxRandom
+{
+public:
+  using result_type = T;
+  using uint_type   = uint32_t;
+  static_assert(std::is_floating_point<T>::value);
+
+  PhiloxRandom(uint_type iseed = 911, uint_type stream = 0) : key_{iseed, stream} { reset(); }
+
+  void init(int iseed_in) { seed(static_cast<uint_type>(iseed_in)); }
+
+  void seed(uint_type aseed)
+  {
+    key_[0] = aseed;
+    reset();
+  }
+
+  /** select an independent stream of the same seed and restart it
+   * Streams can be assigned deterministically, e.g. by walker or crowd index.
+   */
+  void setStream(uint_type stream)
+  {
+    key_[1] = stream;
+    reset();
+  }
+
+  /// return a random number [0,1)
+  result_type operator()()
+  {
+    if (index_ == block_size)
+    {
+      block_ = philox4x32_10(counterWords(counter_), key_);
+      ++counter_;
+      index_ = 0;
+    }
+    return toUniform(block_[index_++]);
+  }
+
+  /** fill [first, first + n) with random numbers [0,1)
+   *  Produces the same sequence as n calls to operator() but the blocks are generated in a vectorizable loop.
+   */
+  void generate(result_type* first, size_t n)
+  {
+    size_t i = 0;
+    for (; i < n && index_ < block_size; i++)
+      first[i] = toUniform(block_[index_++]);
+    const size_t num_blocks = (n - i) / block_size;
+    const uint64_t counter  = counter_;
+    const auto key          = key_;
+    result_type* out        = first + i;
+#pragma omp simd
+    for (size_t ib = 0; ib < num_blocks; ib++)
+    {
+      const auto block = philox4x32_10(counterWords(counter + ib), key);
+      for (int j = 0; j < block_size; j++)
+        out[ib * block_size + j] = toUniform(block[j]);
+    }
+    counter_ += num_blocks;
+    for (i += num_blocks * block_size; i < n; i++)
+      first[i] = (*this)();
+  }
+
+  void write(std::ostream& rout) const
+  {
+    std::vector<uint_type> state;
+    save(state);
+    for (auto s : state)
+      rout << s << " ";
+  }
+
+  void read(std::istream& rin)
+  {
+    std::vector<uint_type> state(state_size());
+    for (auto& s : state)
+      rin >> s;
+    load(state);
+  }
+
+  /// key, counter, position in the current block
+  size_t state_size() const { return 5; }
+
+  void load(const std::vector<uint_type>& newstate)
+  {
+    key_     = {newstate[0], newstate[1]};
+    counter_ = static_cast<uint64_t>(newstate[2]) | (static_cast<uint64_t>(newstate[3]) << 32);
+    index_   = newstate[4];
+    // the current block is regenerated from the counter of the next one
+    if (index_ < block_size)
+      block_ = philox4x32_10(counterWords(counter_ - 1), key_);
+  }
+
+  void save(std::vector<uint_type>& curstate) const
+  {
+    curstate = {key_[0], key_[1], static_cast<uint_type>(counter_), static_cast<uint_type>(counter_ >> 32),
+                static_cast<uint_type>(index_)};
+  }
+
+public:
+  // Non const allows use of default copy constructor
+  std::string ClassName{"PhiloxRand"};
+  std::string EngineName{"philox4x32_10"};
+
+private:
+  static constexpr int block_size = 4;
+
+  void reset()
+  {
+    counter_ = 0;
+    index_   = block_size;
+  }
+
+  static std::array<uint32_t, 4> counterWords(uint64_t counter)
+  {
+    return {static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), 0, 0};
+  }
+
+  /// same mapping from 32-bit integers to [0,1) as uniform_real_distribution_as_boost over std::mt19937
+  static result_type toUniform(uint32_t x)
+  {
+    if constexpr (std::is_same<result_type, float>::value)
+      return static_cast<float>(x >> 8) * (1.0f / 16777216.0f); // keep 24 bits so 1 is never reached
+    else
+      return static_cast<result_type>(x) / (static_cast<result_type>(UINT32_MAX) + 1);
+  }
+
+  /// seed and stream
+  std::array<uint32_t, 2> key_;
+  /// counter of the next block
+  uint64_t counter_;
+  /// current block and the position of the next unused number in it
+  std::array<uint32_t, 4> block_;
+  int index_;
+};
+
+} // namespace qmcplusplus
+
+#endif
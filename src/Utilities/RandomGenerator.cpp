@@ -30,8 +30,19 @@ typename RNG::result_type RNGThreadSafe<RNG>::operator()()
   return result;
 }
 
+template<class RNG>
+void RNGThreadSafe<RNG>::generate(result_type* first, size_t n)
+{
+#pragma omp critical
+  {
+    for (size_t i = 0; i < n; i++)
+      first[i] = RNG::operator()();
+  }
+}
+
 template class RNGThreadSafe<FakeRandom>;
-template class RNGThreadSafe<RandomGenerator>;
+template class RNGThreadSafe<StdRandom<double>>;
+template class RNGThreadSafe<PhiloxRandom<double>>;
 
 RNGThreadSafe<FakeRandom> fake_random_global;
 RNGThreadSafe<RandomGenerator> random_global;
@@ -19,6 +19,7 @@
  *
  * Selected among
  * - std::mt19937
+ * - Philox4x32-10 if QMC_RNG_PHILOX is set at configure time
  * qmcplusplus::Random() returns a random number [0,1)
  * For OpenMP is enabled, it is important to use thread-safe boost::random. Each
  * thread uses its own random number generator with a distinct seed. This prevents
@@ -33,6 +34,7 @@
 // The definition of the fake RNG should always be available for unit testing
 #include "FakeRandom.h"
 #include "StdRandom.h"
+#include "PhiloxRandom.h"
 
 uint32_t make_seed(int i, int n);
 
@@ -47,16 +49,26 @@ public:
   /** return a random number [0,1)
    */
   result_type operator()();
+
+  /** fill [first, first + n) with random numbers [0,1) under a single lock
+   */
+  void generate(result_type* first, size_t n);
 };
 
 extern template class RNGThreadSafe<FakeRandom>;
 extern template class RNGThreadSafe<StdRandom<double>>;
+extern template class RNGThreadSafe<PhiloxRandom<double>>;
 
 #if defined(USE_FAKE_RNG)
 // fake RNG redirection
 using RandomGenerator = FakeRandom;
 extern RNGThreadSafe<RandomGenerator> fake_random_global;
 #define Random fake_random_global
+#elif defined(QMC_RNG_PHILOX)
+// counter-based RNG redirection
+using RandomGenerator = PhiloxRandom<OHMMS_PRECISION_FULL>;
+extern RNGThreadSafe<RandomGenerator> random_global;
+#define Random random_global
 #else
 // real RNG redirection
 using RandomGenerator = StdRandom<OHMMS_PRECISION_FULL>;
@@ -92,7 +92,13 @@ void RandomNumberControl::make_children()
   std::vector<uint_type> myprimes;
   PrimeNumbers.get(baseoffset, nthreads, myprimes);
   for (int ip = 0; ip < nthreads; ip++)
+  {
     Children[ip]->init(myprimes[ip]);
+#if defined(QMC_RNG_PHILOX) && !defined(USE_FAKE_RNG)
+    // each crowd draws from its own stream, the walkers of a crowd share the crowd generator
+    Children[ip]->setStream(nthreads * rank + ip);
+#endif
+  }
 }
 
 xmlNodePtr RandomNumberControl::initialize(xmlXPathContextPtr acontext)
@@ -403,15 +409,21 @@ void RandomNumberControl::read_rank_0(hdf_archive& hin, Communicate* comm)
 
 //scatter write
 void RandomNumberControl::write_rank_0(const RefVector<RandomGenerator>& rng, hdf_archive& hout, Communicate* comm)
+{
+  const GatheredStates states = gather_rank_0(rng, comm);
+  if (comm->rank() == 0)
+    write_gathered(states, hout);
+}
+
+RandomNumberControl::GatheredStates RandomNumberControl::gather_rank_0(const RefVector<RandomGenerator>& rng,
+                                                                       Communicate* comm)
 {
   // cast integer to size_t
   const size_t nthreads  = static_cast<size_t>(omp_get_max_threads());
   const size_t comm_size = static_cast<size_t>(comm->size());
-  const size_t comm_rank = static_cast<size_t>(comm->rank());
 
-  std::vector<uint_type> vt, vt_tot, mt, mt_tot;
-  std::array<size_t, 2> shape{comm_size * nthreads, Random.state_size()};     //dimensions of children dataset
-  TinyVector<size_t, 3> shape_hdf5(comm_size, nthreads, Random.state_size()); //configuration at write time
+  GatheredStates states{{comm_size, nthreads, Random.state_size()}, {}, {}};
+  std::vector<uint_type> vt, mt;
   vt.reserve(nthreads * Random.state_size()); //buffer for children[ip] (Random object of seeds for each thread)
   mt.reserve(Random.state_size()); //buffer for single Random object of seeds, one per proc regardless of thread num
 
@@ -425,30 +437,42 @@ void RandomNumberControl::write_rank_0(const RefVector<RandomGenerator>& rng, hd
 
   if (comm->size() > 1)
   {
-    vt_tot.resize(vt.size() * comm->size());
-    mt_tot.resize(mt.size() * comm->size());
-    mpi::gather(*comm, vt, vt_tot); //gather into one big buffer for master write
-    mpi::gather(*comm, mt, mt_tot);
+    states.children.resize(vt.size() * comm->size());
+    states.master.resize(mt.size() * comm->size());
+    mpi::gather(*comm, vt, states.children); //gather into one big buffer for master write
+    mpi::gather(*comm, mt, states.master);
   }
   else
   {
-    vt_tot = vt;
-    mt_tot = mt;
+    states.children = std::move(vt);
+    states.master   = std::move(mt);
   }
+  return states;
+}
 
-  if (comm->rank() == 0)
-  {
-    hout.push(hdf::main_state);
-    hout.write(shape_hdf5, "nprocs_nthreads_statesize"); //configuration at write time to file
+void RandomNumberControl::write_gathered(const GatheredStates& states, const std::string& fname)
+{
+  hdf_archive hout;
+  hout.create(fname + ".random.h5");
+  write_gathered(states, hout);
+}
 
-    hout.push("random"); //group for children[ip]
-    hout.writeSlabReshaped(vt_tot, shape, Random.EngineName);
-    hout.pop();
+void RandomNumberControl::write_gathered(const GatheredStates& states, hdf_archive& hout)
+{
+  const auto [comm_size, nthreads, state_size] = states.shape;
+  std::array<size_t, 2> shape{comm_size * nthreads, state_size};    //dimensions of children dataset
+  TinyVector<size_t, 3> shape_hdf5(comm_size, nthreads, state_size); //configuration at write time
 
-    shape[0] = comm->size();    //reset dims for single thread use
-    hout.push("random_master"); //group for random_th object
-    hout.writeSlabReshaped(mt_tot, shape, Random.EngineName);
-    hout.close();
-  }
+  hout.push(hdf::main_state);
+  hout.write(shape_hdf5, "nprocs_nthreads_statesize"); //configuration at write time to file
+
+  hout.push("random"); //group for children[ip]
+  hout.writeSlabReshaped(states.children, shape, Random.EngineName);
+  hout.pop();
+
+  shape[0] = comm_size;       //reset dims for single thread use
+  hout.push("random_master"); //group for random_th object
+  hout.writeSlabReshaped(states.master, shape, Random.EngineName);
+  hout.close();
 }
 } // namespace qmcplusplus
@@ -94,7 +94,33 @@ public:
    */
   static void write_rank_0(const RefVector<RandomGenerator>& rng, hdf_archive& hout, Communicate* comm);
 
+  /// random states of all the ranks gathered on rank 0
+  struct GatheredStates
+  {
+    /// number of ranks, number of threads and state size at gather time
+    std::array<size_t, 3> shape;
+    /// states of the per thread generators, only filled on rank 0
+    std::vector<uint_type> children;
+    /// states of the per rank generator, only filled on rank 0
+    std::vector<uint_type> master;
+  };
+  /** rank 0 gathers the random states from all the other ranks, collective
+   * @param rng random number generators
+   * @param comm communicator
+   */
+  static GatheredStates gather_rank_0(const RefVector<RandomGenerator>& rng, Communicate* comm);
+  /** write random states gathered by gather_rank_0 to a hdf file, called only on rank 0
+   *
+   * No communication is involved, so a background thread may call it.
+   * @param states gathered states
+   * @param fname file name
+   */
+  static void write_gathered(const GatheredStates& states, const std::string& fname);
+
 private:
+  /// write gathered random states to an open hdf file and close it
+  static void write_gathered(const GatheredStates& states, hdf_archive& hout);
+
   bool NeverBeenInitialized;
   xmlNodePtr myCur;
   static uint_type Offset;
@@ -129,6 +129,17 @@ bool RunTimeControl<CLOCK>::checkStop(LoopTimer<CLOCK>& loop_timer)
   return need_to_stop;
 }
 
+template<class CLOCK>
+bool RunTimeControl<CLOCK>::checkTargetError(double error, double target_error)
+{
+  if (target_error <= 0.0 || error > target_error)
+    return false;
+  m_error        = error;
+  m_target_error = target_error;
+  stop_status_   = StopStatus::TARGET_ERROR;
+  return true;
+}
+
 template<class CLOCK>
 std::string RunTimeControl<CLOCK>::generateStopMessage(const std::string& driverName, int block) const
 {
@@ -147,6 +158,9 @@ std::string RunTimeControl<CLOCK>::generateStopMessage(const std::string& driver
   else if (stop_status_ == StopStatus::STOP_FILE)
     log << "Stop requested from the control file \"" + stop_filename_ + "\", stopping after block " << block
         << std::endl;
+  else if (stop_status_ == StopStatus::TARGET_ERROR)
+    log << "Target error reached. Stopping after block " << block << std::endl
+        << "  Error = " << m_error << ", target error = " << m_target_error << std::endl;
   else
     throw std::runtime_error("Unidentified stop status!");
 
@@ -75,6 +75,8 @@ class RunTimeControl
   double m_loop_time;
   double m_elapsed;
   double m_remaining;
+  double m_error;
+  double m_target_error;
   RunTimeManager<CLOCK>& runtimeManager;
   /// the prefix of the stop file (stop_file_prefix + ".STOP")
   const std::string stop_filename_;
@@ -85,6 +87,7 @@ class RunTimeControl
     MAX_SECONDS_PASSED, // all already passed max_seconds
     NOT_ENOUGH_TIME,    // not enough time for next iteration
     STOP_FILE,          // reqsuted stop from a file
+    TARGET_ERROR,       // the requested error bar has been reached
   } stop_status_;
 
   bool enough_time_for_next_iteration(LoopTimer<CLOCK>& loop_timer);
@@ -104,6 +107,13 @@ public:
    */
   bool checkStop(LoopTimer<CLOCK>& loop_timer);
 
+  /** check if the error bar has reached the target error.
+   * unlike checkStop only the current driver section needs to stop.
+   * @param error current error bar of the driver section
+   * @param target_error requested error bar, the check is disabled if not positive
+   */
+  bool checkTargetError(double error, double target_error);
+
   /// generate stop message explaining why
   std::string generateStopMessage(const std::string& driverName, int block) const;
 
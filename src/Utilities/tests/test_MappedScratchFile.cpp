@@ -0,0 +1,39 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Utilities/MappedScratchFile.h"
+
+#include <stdexcept>
+
+namespace qmcplusplus
+{
+TEST_CASE("MappedScratchFile", "[utilities]")
+{
+  const size_t n = 3 * 4096 / sizeof(double) + 7;
+  MappedScratchFile scratch(".", n * sizeof(double));
+  CHECK(scratch.size() == n * sizeof(double));
+
+  auto* values = static_cast<double*>(scratch.data());
+  for (size_t i = 0; i < n; i++)
+    values[i] = 0.5 * i;
+
+  // released pages are read back from the file
+  scratch.release(0, scratch.size());
+  scratch.release(100, 5000);
+  for (size_t i = 0; i < n; i++)
+    CHECK(values[i] == 0.5 * i);
+
+  CHECK_THROWS_AS(MappedScratchFile("/nonexistent_qmcpack_scratch_dir", 8), std::runtime_error);
+}
+
+} // namespace qmcplusplus
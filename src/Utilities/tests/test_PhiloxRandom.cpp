@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2023 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "Utilities/PhiloxRandom.h"
+
+#include <sstream>
+#include <vector>
+
+namespace qmcplusplus
+{
+TEST_CASE("Philox4x32-10 known answers", "[utilities]")
+{
+  // known answer tests of the Random123 library
+  auto zeros = philox4x32_10({0, 0, 0, 0}, {0, 0});
+  CHECK(zeros == std::array<uint32_t, 4>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+  auto ones = philox4x32_10({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff});
+  CHECK(ones == std::array<uint32_t, 4>{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+  auto pi = philox4x32_10({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0});
+  CHECK(pi == std::array<uint32_t, 4>{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+}
+
+TEST_CASE("PhiloxRandom bulk generate", "[utilities]")
+{
+  PhiloxRandom<double> rng(13), rng_bulk(13);
+  std::vector<double> bulk(23);
+  // misaligned with the blocks of four
+  rng_bulk.generate(bulk.data(), 3);
+  rng_bulk.generate(bulk.data() + 3, 20);
+  for (auto val : bulk)
+  {
+    CHECK(val == rng());
+    CHECK(val >= 0.0);
+    CHECK(val < 1.0);
+  }
+}
+
+TEST_CASE("PhiloxRandom streams", "[utilities]")
+{
+  // as RandomNumberControl::make_children assigns them, one stream per crowd
+  constexpr int num_streams = 4;
+  constexpr int n           = 64;
+  std::vector<std::vector<double>> sequences(num_streams, std::vector<double>(n));
+  for (int is = 0; is < num_streams; is++)
+  {
+    PhiloxRandom<double> rng(13);
+    rng.setStream(is);
+    rng.generate(sequences[is].data(), n);
+  }
+
+  for (int is = 0; is < num_streams; is++)
+    for (int js = is + 1; js < num_streams; js++)
+    {
+      int num_equal = 0;
+      for (int i = 0; i < n; i++)
+        if (sequences[is][i] == sequences[js][i])
+          num_equal++;
+      CHECK(num_equal == 0);
+    }
+
+  // a stream is reproducible and setStream restarts it
+  PhiloxRandom<double> rng(13);
+  rng.setStream(2);
+  for (int i = 0; i < n; i++)
+    CHECK(rng() == sequences[2][i]);
+  rng.setStream(1);
+  CHECK(rng() == sequences[1][0]);
+}
+
+TEST_CASE("PhiloxRandom save and load", "[utilities]")
+{
+  using DoubleRNG = PhiloxRandom<double>;
+  DoubleRNG rng;
+  rng.init(111);
+  for (int i = 0; i < 7; i++)
+    rng();
+
+  std::vector<DoubleRNG::uint_type> state;
+  rng.save(state);
+  CHECK(state.size() == rng.state_size());
+
+  DoubleRNG rng2;
+  rng2.init(110);
+  rng2.load(state);
+  for (int i = 0; i < 6; i++)
+    CHECK(rng2() == rng());
+
+  std::stringstream stream;
+  rng.write(stream);
+  DoubleRNG rng3;
+  rng3.read(stream);
+  CHECK(rng3() == rng());
+}
+
+} // namespace qmcplusplus
@@ -87,5 +87,18 @@ TEST_CASE("test_loop_control", "[utilities]")
   REQUIRE(msg.size() > 0);
 }
 
+TEST_CASE("test_loop_control_target_error", "[utilities]")
+{
+  RunTimeManager<FakeChronoClock> rm;
+  RunTimeControl<FakeChronoClock> rc(rm, 100, "dummy", false);
+  // disabled
+  CHECK(!rc.checkTargetError(0.01, 0.0));
+  CHECK(!rc.checkTargetError(0.01, 0.005));
+  CHECK(rc.checkTargetError(0.004, 0.005));
+
+  std::string msg = rc.generateStopMessage("QMC", 40);
+  CHECK(msg.find("Target error reached") != std::string::npos);
+}
+
 
 } // namespace qmcplusplus
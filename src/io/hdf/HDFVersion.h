@@ -27,9 +27,10 @@ namespace hdf
 const char config_ext[] = ".config.h5";
 
 //1st level
-const char version[]      = "version";
-const char main_state[]   = "state_0";
-const char config_group[] = "config_collection";
+const char version[]       = "version";
+const char main_state[]    = "state_0";
+const char config_group[]  = "config_collection";
+const char walker_deltas[] = "walker_deltas";
 
 //2nd level for main_state
 const char random[]         = "random_state";
@@ -39,11 +40,22 @@ const char walker_weights[] = "walker_weights";
 const char energy_history[] = "energy_history";
 const char norm_history[]   = "norm_history";
 const char qmc_status[]     = "qmc_status";
+const char walker_ids[]     = "walker_ids";
 
 //2nd level for config_group
 const char num_blocks[]     = "NumOfConfigurations";
 const char append_walkers[] = "config_";
 
+//2nd level for walker_deltas
+const char num_deltas[] = "number_of_deltas";
+
+//3rd level for walker_deltas/delta_#
+const char killed_ids[]        = "killed_walker_ids";
+const char copied_ids[]        = "copied_walker_ids";
+const char copied_parent_ids[] = "copied_parent_ids";
+const char copied_weights[]    = "copied_walker_weights";
+const char parent_ids[]        = "parent_ids";
+
 //unused
 const char coord[] = "coord";
 } // namespace hdf
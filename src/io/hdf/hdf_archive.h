@@ -281,6 +281,34 @@ public:
     write(pxy, aname);
   }
 
+  /** write the container data with a specific shape as a chunked dataset and check status
+   * @param data container, linear storage required.
+   * @param shape shape on the hdf file
+   * @param chunk_rows extent of a chunk along the leading dimension
+   * @param deflate_level deflate compression level [1,9], 0 for no compression
+   * @param aname dataset name in the file
+   * Only serial or master-only i/o is supported. runtime error is issued on I/O error
+   */
+  template<typename T, typename IT, std::size_t RANK>
+  void writeSlabChunked(T& data,
+                        const std::array<IT, RANK>& shape,
+                        hsize_t chunk_rows,
+                        int deflate_level,
+                        const std::string& aname)
+  {
+    static_assert(std::is_arithmetic<typename T::value_type>::value, "writeSlabChunked only supports real scalars");
+    if (Mode[NOIO])
+      return;
+    if (Mode[IS_PARALLEL])
+      throw std::runtime_error("hdf_archive::writeSlabChunked does not support parallel I/O " + aname);
+    std::array<hsize_t, RANK> dims;
+    for (int dim = 0; dim < RANK; dim++)
+      dims[dim] = static_cast<hsize_t>(shape[dim]);
+    hid_t p = group_id.empty() ? file_id : group_id.top();
+    if (!h5d_write_chunked(p, aname, RANK, dims.data(), chunk_rows, deflate_level, data.data(), xfer_plist))
+      throw std::runtime_error("HDF5 write failure in hdf_archive::writeSlabChunked " + aname);
+  }
+
   /** read the data from the group aname and return status
    * use read() for inbuilt error checking
    * @return true if successful
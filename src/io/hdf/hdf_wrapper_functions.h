@@ -21,6 +21,7 @@
  * @brief free template functions wrapping HDF5 calls.
  */
 
+#include <algorithm>
 #include <vector>
 #include "hdf_datatype.h"
 #include "hdf_dataspace.h"
@@ -395,6 +396,82 @@ inline bool h5d_write(hid_t grp,
   return ret != -1;
 }
 
+/// id of the registered zstd filter plugin
+constexpr H5Z_filter_t H5Z_FILTER_ZSTD_PLUGIN = 32015;
+
+/** add byte shuffling and lossless compression to a dataset creation property list
+ * @param level compression level, 0 disables compression
+ * @param use_zstd compress with the zstd filter plugin if it is available instead of deflate
+ *
+ * Nothing is added if no suitable filter is available.
+ */
+inline void h5p_set_compression(hid_t dcpl, int level, bool use_zstd = false)
+{
+  if (level <= 0)
+    return;
+  if (use_zstd && H5Zfilter_avail(H5Z_FILTER_ZSTD_PLUGIN) > 0)
+  {
+    const unsigned zstd_level = level;
+    H5Pset_shuffle(dcpl);
+    H5Pset_filter(dcpl, H5Z_FILTER_ZSTD_PLUGIN, H5Z_FLAG_OPTIONAL, 1, &zstd_level);
+  }
+  else if (H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0)
+  {
+    H5Pset_shuffle(dcpl);
+    H5Pset_deflate(dcpl, std::min(level, 9));
+  }
+}
+
+/** create a chunked dataset and write the whole buffer to it
+ * @param chunk_rows extent of a chunk along the leading dimension, the other dimensions are taken whole
+ * @param deflate_level deflate compression level [1,9] preceded by byte shuffling, 0 disables compression
+ *
+ * An existing dataset of the same name is replaced. Compression is skipped if the deflate filter is not available.
+ */
+template<typename T>
+inline bool h5d_write_chunked(hid_t grp,
+                              const std::string& aname,
+                              hsize_t ndims,
+                              const hsize_t* dims,
+                              hsize_t chunk_rows,
+                              int deflate_level,
+                              const T* first,
+                              hid_t xfer_plist)
+{
+  if (grp < 0)
+    return true;
+  hid_t h5d_type_id = get_h5_datatype(*first);
+  if (H5Lexists(grp, aname.c_str(), H5P_DEFAULT) > 0)
+    H5Ldelete(grp, aname.c_str(), H5P_DEFAULT);
+
+  // chunk extents must be positive even for empty dimensions
+  std::vector<hsize_t> chunk_dims(ndims);
+  chunk_dims[0] = std::max<hsize_t>(1, std::min(chunk_rows, dims[0]));
+  for (int d = 1; d < ndims; ++d)
+    chunk_dims[d] = std::max<hsize_t>(1, dims[d]);
+
+  hid_t p = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(p, ndims, chunk_dims.data());
+  h5p_set_compression(p, deflate_level);
+  hid_t dataspace = H5Screate_simple(ndims, dims, NULL);
+  hid_t dataset   = H5Dcreate(grp, aname.c_str(), h5d_type_id, dataspace, H5P_DEFAULT, p, H5P_DEFAULT);
+  herr_t ret      = -1;
+  if (dataset >= 0)
+  {
+    ret = H5Dwrite(dataset, h5d_type_id, H5S_ALL, H5S_ALL, xfer_plist, first);
+    H5Dclose(dataset);
+  }
+  H5Sclose(dataspace);
+  H5Pclose(p);
+  return ret >= 0;
+}
+
+/** append dims[0] rows to an extendable dataset, the dataset is created on the first call
+ * @param current number of rows in the dataset, updated
+ * @param chunk_size rows per chunk of a new dataset
+ * @param compression_level lossless compression level of a new dataset, see h5p_set_compression
+ * @param use_zstd prefer the zstd filter plugin for compression
+ */
 template<typename T>
 inline bool h5d_append(hid_t grp,
                        const std::string& aname,
@@ -402,8 +479,10 @@ inline bool h5d_append(hid_t grp,
                        hsize_t ndims,
                        const hsize_t* const dims,
                        const T* const first,
-                       hsize_t chunk_size = 1,
-                       hid_t xfer_plist   = H5P_DEFAULT)
+                       hsize_t chunk_size    = 1,
+                       hid_t xfer_plist      = H5P_DEFAULT,
+                       int compression_level = 0,
+                       bool use_zstd         = false)
 {
   //app_log()<<omp_get_thread_num()<<"  h5d_append  group = "<<grp<<"  name = "<<aname.c_str()<< std::endl;
   if (grp < 0)
@@ -434,6 +513,7 @@ inline bool h5d_append(hid_t grp,
     hid_t sl = H5Pset_layout(p, H5D_CHUNKED);
     // set chunk size
     hid_t cs = H5Pset_chunk(p, ndims, chunk_dims.data());
+    h5p_set_compression(p, compression_level, use_zstd);
     // create the dataset
     dataset = H5Dcreate(grp, aname.c_str(), h5d_type_id, dataspace, H5P_DEFAULT, p, H5P_DEFAULT);
     // create memory dataspace, size of current buffer
@@ -90,3 +90,33 @@ TEST_CASE("hdf_write_reshape_with_matrix", "[hdf]")
   CHECK(vec_cplx[4] == ComplexApprox(v_cplx[4]));
   CHECK(vec_cplx[5] == ComplexApprox(v_cplx[5]));
 }
+
+TEST_CASE("hdf_write_chunked_compressed", "[hdf]")
+{
+  hdf_archive hd;
+  bool okay = hd.create("test_write_chunked.hdf");
+  REQUIRE(okay);
+
+  std::vector<double> v(5 * 3);
+  for (int i = 0; i < v.size(); i++)
+    v[i] = 0.5 * i;
+
+  std::array<size_t, 2> shape{5, 3};
+  hd.writeSlabChunked(v, shape, 2, 4, "chunked_deflate");
+  hd.writeSlabChunked(v, shape, 8, 0, "chunked_plain");
+  // an existing dataset is replaced
+  hd.writeSlabChunked(v, shape, 3, 1, "chunked_plain");
+  hd.close();
+
+  hdf_archive hd2;
+  hd2.open("test_write_chunked.hdf");
+  for (const std::string name : {"chunked_deflate", "chunked_plain"})
+  {
+    Matrix<double> m;
+    hd2.read(m, name);
+    REQUIRE(m.rows() == 5);
+    REQUIRE(m.cols() == 3);
+    for (int i = 0; i < v.size(); i++)
+      CHECK(m.data()[i] == Approx(v[i]));
+  }
+}
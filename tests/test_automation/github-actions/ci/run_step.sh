@@ -167,6 +167,17 @@ case "$1" in
               -DCMAKE_BUILD_TYPE=RelWithDebInfo \
               ${GITHUB_WORKSPACE}
       ;;
+      *"GCC11-NoMPI-Philox-"*)
+        echo 'Configure for the Philox random number engine -DQMC_RNG_PHILOX=ON'
+        cmake -GNinja \
+              -DCMAKE_C_COMPILER=gcc \
+              -DCMAKE_CXX_COMPILER=g++ \
+              -DQMC_MPI=0 \
+              -DQMC_RNG_PHILOX=ON \
+              -DQMC_COMPLEX=$IS_COMPLEX \
+              -DCMAKE_BUILD_TYPE=RelWithDebInfo \
+              ${GITHUB_WORKSPACE}
+      ;;
       *"San-"*) # Sanitize with clang compilers
         cmake -GNinja \
               -DCMAKE_C_COMPILER=clang \
@@ -336,6 +347,12 @@ case "$1" in
        TEST_LABEL="-L unit"
     fi
 
+    if [[ "${GH_JOBNAME}" =~ (Philox) ]]
+    then
+       # Reference values of the deterministic integration tests are generated with std::mt19937
+       TEST_LABEL="-L unit"
+    fi
+
     if [[ "${GH_JOBNAME}" =~ (CUDA) ]]
     then
       if [[ "${GH_JOBNAME}" =~ (-Offload) ]]